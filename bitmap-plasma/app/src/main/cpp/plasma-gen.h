@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef PLASMA_GEN_H
+#define PLASMA_GEN_H
+
+/* Plasma generator shared by bitmap-plasma and native-plasma.
+ *
+ * This file has no Android dependency: it only writes into a caller
+ * provided pixel buffer, so the same code can run on the host.
+ */
+
+/* Each format has its own palette, computed at the precision of the
+ * format, and its own store loop.
+ */
+typedef enum {
+    PLASMA_FORMAT_RGB565,       /* uint16_t per pixel */
+    PLASMA_FORMAT_RGBA8888,     /* R,G,B,A bytes per pixel, A = 0xff, also RGBX */
+    PLASMA_FORMAT_RGBA1010102,  /* uint32_t per pixel, R in the low bits, A = 3 */
+    PLASMA_FORMAT_COUNT
+} PlasmaFormat;
+
+typedef enum {
+    PLASMA_MODE_REFERENCE,    /* plasma_fill_reference() */
+    PLASMA_MODE_SIMD,         /* plasma_fill() */
+    PLASMA_MODE_SEPARABLE,    /* plasma_fill_separable() */
+} PlasmaMode;
+
+/* Fill the sine and palette tables, must be called once before rendering */
+void plasma_init_tables(void);
+
+int  plasma_bytes_per_pixel(PlasmaFormat format);
+
+/* Render the plasma at time 't' (in milliseconds) into 'pixels'.
+ * 'stride' is the distance between two rows in bytes.
+ *
+ * plasma_fill() computes the sines of a column once for all the rows and
+ * the colors with NEON or SSE2 when the target supports them. It produces
+ * exactly the same pixels as plasma_fill_reference(), which is the
+ * original one-pixel-at-a-time loop.
+ */
+void plasma_fill(void* pixels, int width, int height, int stride,
+                 PlasmaFormat format, double t);
+void plasma_fill_reference(void* pixels, int width, int height, int stride,
+                           PlasmaFormat format, double t);
+
+/* Same as plasma_fill(), restricted to the width x height rectangle at
+ * (x,y). 'pixels' still points to the top-left corner of the whole frame,
+ * so a frame can be rendered as independent tiles.
+ */
+void plasma_fill_rect(void* pixels, int stride, PlasmaFormat format, double t,
+                      int x, int y, int width, int height);
+
+/* Separable rendering: the plasma is the sum of a term that only depends
+ * on the row and one that only depends on the column. PlasmaTerms holds
+ * both for a whole frame; it only allocates when the frame grows.
+ */
+typedef struct PlasmaTerms PlasmaTerms;
+
+PlasmaTerms* plasma_terms_create(void);
+void         plasma_terms_destroy(PlasmaTerms* terms);
+
+/* Compute the terms of a width x height frame at time 't'.
+ * Returns 0 on success, -1 if the tables could not be grown.
+ */
+int  plasma_terms_update(PlasmaTerms* terms, int width, int height, double t);
+
+/* Render a rectangle of the frame described by the last update, with the
+ * same 'pixels' convention as plasma_fill_rect().
+ */
+void plasma_fill_terms_rect(const PlasmaTerms* terms, void* pixels, int stride,
+                            PlasmaFormat format, int x, int y, int width, int height);
+
+/* plasma_terms_update() + plasma_fill_terms_rect() over the whole frame,
+ * pixel-exact with plasma_fill_reference().
+ */
+void plasma_fill_separable(PlasmaTerms* terms, void* pixels, int width, int height,
+                           int stride, PlasmaFormat format, double t);
+
+/* Render a frame with 'mode' and with the reference implementation, and
+ * return the number of pixels that differ, or -1 if the buffers could not
+ * be allocated.
+ */
+int  plasma_verify(int width, int height, PlasmaFormat format, PlasmaMode mode,
+                   double t);
+
+/* Renders a whole width x height frame into 'pixels', e.g. with the tiled
+ * renderer, for plasma_verify_fill().
+ */
+typedef void (*PlasmaFillFunc)(void* ctx, void* pixels, int width, int height,
+                               int stride, PlasmaFormat format, double t);
+
+/* plasma_verify() for a renderer outside of this file */
+int  plasma_verify_fill(PlasmaFillFunc fill, void* ctx, int width, int height,
+                        PlasmaFormat format, double t);
+
+#endif /* PLASMA_GEN_H */
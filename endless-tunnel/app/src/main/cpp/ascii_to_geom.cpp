@@ -18,7 +18,13 @@
 #define GEOM_DEBUG LOGD
 //#define GEOM_DEBUG
 
-SimpleGeom* AsciiArtToGeom(const char *art, float scale) {
+// number of floats per vertex of the arrays below: x, y, z, r, g, b, a
+#define ART_VERTEX_FLOATS 7
+
+// Parses the ASCII art into an array of vertices and an array of indices (pairs of
+// them are lines). The caller must delete[] both.
+static void _ascii_art_to_arrays(const char *art, float scale, GLfloat **outVertices,
+        int *outVertexCount, GLushort **outIndices, int *outIndexCount) {
     // figure out width and height
     LOGD("Creating geometry from ASCII art.");
     GEOM_DEBUG("Ascii art source:\n%s", art);
@@ -94,8 +100,7 @@ SimpleGeom* AsciiArtToGeom(const char *art, float scale) {
     GEOM_DEBUG("Total vertices: %d, total indices %d", vertices, indices);
 
     // allocate arrays for the vertices and lines
-    const int VERTICES_STRIDE = sizeof(GLfloat) * 7;
-    const int VERTICES_COLOR_OFFSET = sizeof(GLfloat) * 3;
+    const int VERTICES_STRIDE = sizeof(GLfloat) * ART_VERTEX_FLOATS;
     GLfloat *verticesArray = new GLfloat[vertices * VERTICES_STRIDE];
     GLushort *indicesArray = new GLushort[indices];
     vertices = indices = 0; // current count of vertices and lines
@@ -209,6 +214,20 @@ SimpleGeom* AsciiArtToGeom(const char *art, float scale) {
         }
     }
 
+    *outVertices = verticesArray;
+    *outVertexCount = vertices;
+    *outIndices = indicesArray;
+    *outIndexCount = indices;
+}
+
+SimpleGeom* AsciiArtToGeom(const char *art, float scale) {
+    const int VERTICES_STRIDE = sizeof(GLfloat) * ART_VERTEX_FLOATS;
+    const int VERTICES_COLOR_OFFSET = sizeof(GLfloat) * 3;
+    GLfloat *verticesArray;
+    GLushort *indicesArray;
+    int vertices, indices;
+    _ascii_art_to_arrays(art, scale, &verticesArray, &vertices, &indicesArray, &indices);
+
     // create the buffers
     GEOM_DEBUG("Creating output VBO (%d vertices) and IBO (%d indices).", vertices, indices);
     SimpleGeom* out = new SimpleGeom(new VertexBuf(verticesArray, vertices * sizeof(GLfloat) *
@@ -228,3 +247,22 @@ SimpleGeom* AsciiArtToGeom(const char *art, float scale) {
     return out;
 }
 
+int AsciiArtToLines(const char *art, float scale, GLfloat **outLines) {
+    GLfloat *verticesArray;
+    GLushort *indicesArray;
+    int vertices, indices;
+    _ascii_art_to_arrays(art, scale, &verticesArray, &vertices, &indicesArray, &indices);
+
+    // look up the x,y of both ends of each line
+    GLfloat *lines = new GLfloat[indices * 2];
+    for (int i = 0; i < indices; i++) {
+        lines[i * 2] = verticesArray[indicesArray[i] * ART_VERTEX_FLOATS];
+        lines[i * 2 + 1] = verticesArray[indicesArray[i] * ART_VERTEX_FLOATS + 1];
+    }
+
+    delete [] verticesArray;
+    delete [] indicesArray;
+
+    *outLines = lines;
+    return indices / 2;
+}
@@ -38,5 +38,10 @@
  */
 SimpleGeom* AsciiArtToGeom(const char *art, float scale);
 
+/* Same as AsciiArtToGeom, but leaves the lines in memory rather than in GL buffers: *outLines
+ * receives the x,y of both ends of each line (4 floats per line) and must be deleted with
+ * delete[]. Returns the number of lines. */
+int AsciiArtToLines(const char *art, float scale, GLfloat **outLines);
+
 #endif
 
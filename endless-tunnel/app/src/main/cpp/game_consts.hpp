@@ -52,6 +52,9 @@
 // maximum delta T between two frames
 #define MAX_DELTA_T 0.05f
 
+// the game logic advances by steps of this many seconds, whatever the frame rate
+#define SIM_TIMESTEP (1.0f / 60.0f)
+
 // player's speed
 #define PLAYER_SPEED 80.0f
 
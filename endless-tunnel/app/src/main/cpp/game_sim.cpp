@@ -0,0 +1,205 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "game_sim.hpp"
+
+GameSim::GameSim(uint32_t seed) : mObstacleRing(seed) {
+    mPlayerPos = mPrevPlayerPos = glm::vec3(0.0f, 0.0f, 0.0f);
+    mLives = PLAYER_LIVES;
+    mDifficulty = 0;
+    mFirstSection = 0;
+    mFirstObstacle = 0;
+    mObstacleCount = 0;
+    mFilteredSteerX = mFilteredSteerZ = 0.0f;
+    mRollAngle = mPrevRollAngle = 0.0f;
+    mPlayerSpeed = 0.0f;
+    mBonusInARow = 0;
+    mLastCrashSection = -1;
+    mLastAmbientBeepEmitted = 0;
+    mStepCount = 0;
+    SetScore(0);
+}
+
+void GameSim::StartAtDifficulty(int difficulty) {
+    mDifficulty = difficulty;
+    SetScore(SCORE_PER_LEVEL * mDifficulty);
+}
+
+float GameSim::GetRollAngle(float alpha) const {
+    // the angle is kept in [0, 2pi], go the short way around
+    float delta = mRollAngle - mPrevRollAngle;
+    if (delta > M_PI) {
+        delta -= 2 * M_PI;
+    } else if (delta < -M_PI) {
+        delta += 2 * M_PI;
+    }
+    return mPrevRollAngle + delta * alpha;
+}
+
+int GameSim::Step(const SimInput &input) {
+    const float deltaT = SIM_TIMESTEP;
+    float previousY = mPlayerPos.y;
+    mPrevPlayerPos = mPlayerPos;
+    mPrevRollAngle = mRollAngle;
+    mStepCount++;
+
+    // update speed
+    float targetSpeed = PLAYER_SPEED + PLAYER_SPEED_INC_PER_LEVEL * mDifficulty;
+    float accel = mPlayerSpeed >= 0.0f ? PLAYER_ACCELERATION_POSITIVE_SPEED :
+            PLAYER_ACCELERATION_NEGATIVE_SPEED;
+    if (mLives <= 0) {
+        targetSpeed = 0.0f;
+    }
+    mPlayerSpeed = Approach(mPlayerSpeed, targetSpeed, deltaT * accel);
+
+    // apply noise filter on steering
+    mFilteredSteerX = (mFilteredSteerX * (NOISE_FILTER_SAMPLES - 1) + input.steerX)
+            / NOISE_FILTER_SAMPLES;
+    mFilteredSteerZ = (mFilteredSteerZ * (NOISE_FILTER_SAMPLES - 1) + input.steerZ)
+            / NOISE_FILTER_SAMPLES;
+
+    // move player
+    if (mLives > 0) {
+        float steerX = mFilteredSteerX, steerZ = mFilteredSteerZ;
+        if (input.steering == STEERING_TOUCH) {
+            // touch steering
+            mPlayerPos.x = Approach(mPlayerPos.x, steerX, PLAYER_MAX_LAT_SPEED * deltaT);
+            mPlayerPos.z = Approach(mPlayerPos.z, steerZ, PLAYER_MAX_LAT_SPEED * deltaT);
+        } else if (input.steering == STEERING_JOY) {
+            // joystick steering
+            mPlayerPos.x += deltaT * steerX;
+            mPlayerPos.z += deltaT * steerZ;
+        }
+    }
+    mPlayerPos.y += deltaT * mPlayerSpeed;
+
+    // make sure player didn't leave tunnel
+    mPlayerPos.x = Clamp(mPlayerPos.x, PLAYER_MIN_X, PLAYER_MAX_X);
+    mPlayerPos.z = Clamp(mPlayerPos.z, PLAYER_MIN_Z, PLAYER_MAX_Z);
+
+    // shift sections if needed
+    ShiftIfNeeded();
+
+    // generate more obstacles!
+    GenObstacles();
+
+    // detect collisions
+    int events = DetectCollisions(previousY);
+
+    // update ship's roll speed according to level
+    static const float roll_speeds[] = ROLL_SPEEDS;
+    int count = sizeof(roll_speeds) / sizeof(float);
+    float speed = roll_speeds[mDifficulty % count];
+    mRollAngle += deltaT * speed;
+    while (mRollAngle < 0) {
+        mRollAngle += 2 * M_PI;
+    }
+    while (mRollAngle > 2 * M_PI) {
+        mRollAngle -= 2 * M_PI;
+    }
+
+    // is an ambient sound due?
+    int soundPoint = (int)floor(mPlayerPos.y / (TUNNEL_SECTION_LENGTH/3));
+    if (soundPoint % 3 != 0 && soundPoint > mLastAmbientBeepEmitted) {
+        mLastAmbientBeepEmitted = soundPoint;
+        events |= EVENT_AMBIENT;
+    }
+    return events;
+}
+
+void GameSim::GenObstacles() {
+    while (mObstacleCount < MAX_OBS) {
+        // generate a new obstacle
+        int index = (mFirstObstacle + mObstacleCount) % MAX_OBS;
+
+        int section = mFirstSection + mObstacleCount;
+        if (section < OBS_START_SECTION) {
+            // generate an empty obstacle
+            mObstacleCircBuf[index].Reset();
+            mObstacleCircBuf[index].style = Obstacle::STYLE_NULL;
+        } else {
+            // generate a normal obstacle
+            mObstacleRing.Get(section, mDifficulty, &mObstacleCircBuf[index]);
+        }
+        mObstacleCount++;
+    }
+}
+
+void GameSim::ShiftIfNeeded() {
+    // is it time to discard a section and shift forward?
+    while (mPlayerPos.y > GetSectionEndY(mFirstSection) + SHIFT_THRESH) {
+        // shift to the next turnnel section
+        mFirstSection++;
+
+        // discard obstacle corresponding to the deleted section
+        if (mObstacleCount > 0) {
+            // discarding first object (shifting) is easy because it's a circular buffer!
+            mFirstObstacle = (mFirstObstacle + 1) % MAX_OBS;
+            --mObstacleCount;
+        }
+    }
+}
+
+int GameSim::DetectCollisions(float previousY) {
+    Obstacle *o = GetObstacleAt(0);
+    float obsCenter = GetSectionCenterY(mFirstSection);
+    float obsMin = obsCenter - OBS_BOX_SIZE;
+    float curY = mPlayerPos.y;
+
+    if (!o || !(previousY < obsMin && curY >= obsMin)) {
+        // no collision
+        return 0;
+    }
+
+    // what row/column is the player on?
+    int col = o->GetColAt(mPlayerPos.x);
+    int row = o->GetRowAt(mPlayerPos.z);
+    int events = 0;
+
+    if (o->HasBox(col, row)) {
+        // crashed against obstacle
+        mLives--;
+        events |= EVENT_CRASHED;
+        if (mLives <= 0) {
+            events |= EVENT_GAME_OVER;
+        }
+        mPlayerPos.y = obsMin - PLAYER_RECEDE_AFTER_COLLISION;
+        mPlayerSpeed = PLAYER_SPEED_AFTER_COLLISION;
+
+        mLastCrashSection = mFirstSection;
+
+    } else if (row == o->bonusRow && col == o->bonusCol) {
+        events |= EVENT_BONUS;
+        o->DeleteBonus();
+        AddScore(BONUS_POINTS);
+        mBonusInARow++;
+
+        if (mBonusInARow >= 10) {
+            mBonusInARow = 0;
+        }
+
+        // update difficulty level, if applicable
+        int score = GetScore();
+        if (mDifficulty < score / SCORE_PER_LEVEL) {
+            mDifficulty = score / SCORE_PER_LEVEL;
+            events |= EVENT_LEVEL_UP;
+        }
+
+    } else if (o->HasBonus()) {
+        // player missed bonus!
+        mBonusInARow = 0;
+    }
+    return events;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef endlesstunnel_game_sim_hpp
+#define endlesstunnel_game_sim_hpp
+
+#include "game_consts.hpp"
+#include "obstacle.hpp"
+#include "obstacle_ring.hpp"
+#include "util.hpp"
+
+// The player's input, as it stands during one step of the simulation
+struct SimInput {
+    int steering;  // GameSim::STEERING_*
+    float steerX, steerZ; // target x,z of ship (when using touch control) or
+                          // velocity vector (when using joystick)
+};
+
+/* The game logic of PlayScene -- the player flying down the tunnel, obstacles being
+ * generated, hit or dodged, bonuses being collected -- with no rendering, sound or
+ * input handling, so that it also runs without a GL context (see ../host).
+ *
+ * It advances by fixed steps of SIM_TIMESTEP seconds and all of its randomness comes
+ * from the seed, so a game played with the same seed and the same input is the same
+ * game, however fast it is stepped. */
+class GameSim {
+    public:
+        // how the player is steering
+        static const int STEERING_NONE = 0, STEERING_TOUCH = 1, STEERING_JOY = 2;
+
+        // what happened during a step (bits of what Step() returns)
+        static const int EVENT_CRASHED = 1;   // player hit an obstacle and lost a life
+        static const int EVENT_GAME_OVER = 2; // ... and that was the last one
+        static const int EVENT_BONUS = 4;     // player got a bonus
+        static const int EVENT_LEVEL_UP = 8;  // ... which raised the difficulty level
+        static const int EVENT_AMBIENT = 16;  // an ambient beep is due, see GetAmbientBeep()
+
+        // circular buffer of obstacles (mObstacleCircBuf[mFirstObstacle...])
+        // There is exactly one obstacle for each tunnel section:
+        // obstacle 0 is at section mFirstSection
+        // obstacle 1 is at section mFirstSection + 1
+        // and so on and so forth.
+        static const int MAX_OBS = RENDER_TUNNEL_SECTION_COUNT * 2;
+
+        GameSim(uint32_t seed);
+
+        // starts at the given difficulty level, with the score it takes (resuming
+        // from a checkpoint)
+        void StartAtDifficulty(int difficulty);
+
+        // generates the obstacles ahead on a thread of their own, rather than when the
+        // player gets to their section; the game is the same either way
+        void StartObstacleThread() { mObstacleRing.StartThread(); }
+
+        // advances the game by SIM_TIMESTEP; returns the EVENT_* bits of what happened
+        int Step(const SimInput &input);
+
+        // player's position, alpha of the way from the previous step to the last one
+        glm::vec3 GetPlayerPos(float alpha) const {
+            return mPrevPlayerPos + (mPlayerPos - mPrevPlayerPos) * alpha;
+        }
+        const glm::vec3& GetPlayerPos() const { return mPlayerPos; }
+
+        // current roll angle, in radians, counterclockwise from original; alpha as above
+        float GetRollAngle(float alpha) const;
+        float GetRollAngle() const { return mRollAngle; }
+
+        float GetPlayerSpeed() const { return mPlayerSpeed; }
+        int GetLives() const { return mLives; }
+        int GetDifficulty() const { return mDifficulty; }
+        int GetBonusInARow() const { return mBonusInARow; }
+        int GetLastCrashSection() const { return mLastCrashSection; }
+        int GetAmbientBeep() const { return mLastAmbientBeepEmitted; }
+        unsigned GetStepCount() const { return mStepCount; }
+
+        // get current score
+        int GetScore() const {
+            return (int)(mEncryptedScore ^ 0x600673);
+        }
+
+        // what is the first tunnel section that is still ahead (or just behind)
+        int GetFirstSection() const { return mFirstSection; }
+        int GetObstacleCount() const { return mObstacleCount; }
+        const ObstacleRing& GetObstacleRing() const { return mObstacleRing; }
+        Obstacle* GetObstacleAt(int i) {
+            return &mObstacleCircBuf[(mFirstObstacle + i) % MAX_OBS];
+        }
+        const Obstacle* GetObstacleAt(int i) const {
+            return &mObstacleCircBuf[(mFirstObstacle + i) % MAX_OBS];
+        }
+
+        static float GetSectionCenterY(int i) {
+            return (float)i * TUNNEL_SECTION_LENGTH;
+        }
+        static float GetSectionEndY(int i) {
+            return GetSectionCenterY(i) + 0.5f * TUNNEL_SECTION_LENGTH;
+        }
+
+    private:
+        // player's position, now and before the last step
+        glm::vec3 mPlayerPos, mPrevPlayerPos;
+
+        // lives left
+        int mLives;
+
+        // player's score. As a trivial form of protection (just to give crackers a
+        // hard time), we *actually* store the score encrypted in mEncryptedScore, but have a
+        // fake variable mFakeScore that stores a copy of it. This serves as a honeypot to
+        // an attacker who's trying to crack the game using a memory editor.
+        unsigned mFakeScore;
+        unsigned mEncryptedScore;
+
+        // current difficulty level
+        int mDifficulty;
+
+        int mFirstSection;
+        int mFirstObstacle;
+        int mObstacleCount;
+        Obstacle mObstacleCircBuf[MAX_OBS];
+
+        // where the obstacles come from
+        ObstacleRing mObstacleRing;
+
+        // moving average filter for input (on steerX and steerZ)
+        static const int NOISE_FILTER_SAMPLES = 5;
+        float mFilteredSteerX, mFilteredSteerZ;
+
+        // roll angle, now and before the last step
+        float mRollAngle, mPrevRollAngle;
+
+        // current speed
+        float mPlayerSpeed;
+
+        // how many bonuses were collected without missing one?
+        int mBonusInARow;
+
+        // what was the section number of the last obstacle with which the player crashed?
+        int mLastCrashSection;
+
+        // last subsection were an ambient sound was emitted
+        int mLastAmbientBeepEmitted;
+
+        // steps taken so far
+        unsigned mStepCount;
+
+        // set current score
+        void SetScore(int s) {
+            mFakeScore = (unsigned)s;
+            mEncryptedScore = mFakeScore ^ 0x600673;
+        }
+
+        // add to current score
+        void AddScore(int s) {
+            SetScore(GetScore() + s);
+        }
+
+        // generate new obstacles as needed
+        void GenObstacles();
+
+        // Shift tunnel sections if needed (this means discarding the ones the
+        // player has already past and generating the obstacles for the new ones
+        // that came into view)
+        void ShiftIfNeeded();
+
+        // detect if the player hit obstacles or got the bonus; returns EVENT_* bits
+        int DetectCollisions(float previousY);
+};
+
+#endif
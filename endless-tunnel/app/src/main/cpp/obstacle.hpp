@@ -16,7 +16,8 @@
 #ifndef endlesstunnel_obstacle_hpp
 #define endlesstunnel_obstacle_hpp
 
-#include "engine.hpp"
+#include <stdint.h>
+#include "glm/glm.hpp"
 #include "game_consts.hpp"
 #include "util.hpp"
 
@@ -25,37 +26,58 @@
 // a bonus when hit.
 //
 // The obstacle grid lies on the XZ plane.
+//
+// The grid is a bitmask, one bit per cell, row after row, so that filling a row or a
+// column is a single operation and so is testing a cell for a collision.
 class Obstacle {
     public:
-        bool grid[OBS_GRID_SIZE][OBS_GRID_SIZE]; // indexed as [col][row]
+        uint32_t boxes; // bit (row * OBS_GRID_SIZE + col) is set if that cell has a box
         int style;  // obstacle style (currently, this specifies its color).
         int bonusRow, bonusCol;
         const static int STYLE_NULL = 0;  // a null obstacle (not displayed)
 
-        glm::vec3 GetBoxCenter(int gridCol, int gridRow, float posY) {
+        // all the cells, the cells of row 0 and the cells of column 0
+        const static uint32_t ALL_BITS = (1u << (OBS_GRID_SIZE * OBS_GRID_SIZE)) - 1;
+        const static uint32_t ROW_BITS = (1u << OBS_GRID_SIZE) - 1;
+        const static uint32_t COL_BITS = ALL_BITS / ROW_BITS;  // 1 + 2^N + 2^2N + ...
+
+        static uint32_t GetCellBit(int gridCol, int gridRow) {
+            return 1u << (gridRow * OBS_GRID_SIZE + gridCol);
+        }
+
+        bool HasBox(int gridCol, int gridRow) const {
+            return (boxes & GetCellBit(gridCol, gridRow)) != 0;
+        }
+
+        void SetBox(int gridCol, int gridRow) { boxes |= GetCellBit(gridCol, gridRow); }
+        void ClearBox(int gridCol, int gridRow) { boxes &= ~GetCellBit(gridCol, gridRow); }
+        void FillRow(int gridRow) { boxes |= ROW_BITS << (gridRow * OBS_GRID_SIZE); }
+        void FillCol(int gridCol) { boxes |= COL_BITS << gridCol; }
+
+        glm::vec3 GetBoxCenter(int gridCol, int gridRow, float posY) const {
             return glm::vec3(-TUNNEL_HALF_W + (gridCol + 0.5f) * OBS_CELL_SIZE, posY,
                     -TUNNEL_HALF_H + (gridRow + 0.5f) * OBS_CELL_SIZE);
         }
 
-        glm::vec3 GetBoxSize(int gridCol, int gridRow) {
+        glm::vec3 GetBoxSize(int gridCol, int gridRow) const {
             return glm::vec3(OBS_BOX_SIZE, OBS_BOX_SIZE, OBS_BOX_SIZE);
         }
 
-        int GetRowAt(float z) {
+        int GetRowAt(float z) const {
             return Clamp((int)floor((z + TUNNEL_HALF_H) / OBS_CELL_SIZE), 0, OBS_GRID_SIZE - 1);
         }
 
-        int GetColAt(float x) {
+        int GetColAt(float x) const {
             return Clamp((int)floor((x + TUNNEL_HALF_W) / OBS_CELL_SIZE), 0, OBS_GRID_SIZE - 1);
         }
 
-        float GetMinY(float posY) { return posY - OBS_BOX_SIZE * 0.5f; }
-        float GetMaxY(float posY) { return posY + OBS_BOX_SIZE * 0.5f; }
+        float GetMinY(float posY) const { return posY - OBS_BOX_SIZE * 0.5f; }
+        float GetMaxY(float posY) const { return posY + OBS_BOX_SIZE * 0.5f; }
 
         void Reset() {
             style = STYLE_NULL;
             bonusRow = bonusCol = -1;
-            memset(grid, 0, sizeof(grid));
+            boxes = 0;
         }
 
         void SetBonus(int col, int row) {
@@ -63,18 +85,20 @@ class Obstacle {
             bonusRow = row;
         }
 
-        void PutRandomBonus();
+        void PutRandomBonus(RandomGen *random);
 
         void DeleteBonus() {
             bonusCol = bonusRow = -1;
         }
 
-        bool HasBonus() {
+        bool HasBonus() const {
             return bonusRow >= 0 && bonusRow < OBS_GRID_SIZE &&
                     bonusCol >= 0 && bonusCol < OBS_GRID_SIZE &&
-                    !grid[bonusCol][bonusRow];
+                    !HasBox(bonusCol, bonusRow);
         }
 };
 
+static_assert(OBS_GRID_SIZE * OBS_GRID_SIZE < 32, "obstacle grid does not fit the bitmask");
+
 #endif
 
@@ -17,7 +17,7 @@
 #include "game_consts.hpp"
 #include "obstacle_generator.hpp"
 
-void ObstacleGenerator::Generate(Obstacle *result) {
+void ObstacleGenerator::Generate(int section, int difficulty, Obstacle *result) const {
     static const int PROB_TABLE[] = {
     // EASY   MED  INT  HARD
         100,   0,   0,   0,  // difficulty 0
@@ -34,151 +34,151 @@ void ObstacleGenerator::Generate(Obstacle *result) {
           0,   0,  25,  75,  // difficulty 11
           0,   0,   0, 100   // difficulty 12+
     };
+    // each section has a stream of random numbers of its own
+    uint32_t hash = mSeed ^ ((uint32_t)section * 0x9e3779b9u);
+    hash = (hash ^ (hash >> 16)) * 0x85ebca6bu;
+    hash = (hash ^ (hash >> 13)) * 0xc2b2ae35u;
+    RandomGen random(hash ^ (hash >> 16));
+
     result->Reset();
-    result->style = 1 + Random(7);
+    result->style = 1 + random.Next(7);
 
-    int d = Clamp(mDifficulty, 0, 12);
+    int d = Clamp(difficulty, 0, 12);
     int easyProb = PROB_TABLE[d * 4];
     int medProb = PROB_TABLE[d * 4 + 1];
     int intermediateProb = PROB_TABLE[d * 4 + 2];
-    int roll = Random(100);
+    int roll = random.Next(100);
     if (roll <= easyProb) {
-        GenEasy(result);
+        GenEasy(&random, result);
     } else if (roll <= easyProb + medProb) {
-        GenMedium(result);
+        GenMedium(&random, result);
     } else if (roll <= easyProb + medProb + intermediateProb) {
-        GenIntermediate(result);
+        GenIntermediate(&random, result);
     } else {
-        GenHard(result);
-    }
-    result->PutRandomBonus();
-}
-
-void ObstacleGenerator::FillRow(Obstacle *result, int row) {
-    for (int i = 0; i < OBS_GRID_SIZE; ++i) {
-        result->grid[i][row] = true;
-    }
-}
-
-void ObstacleGenerator::FillCol(Obstacle *result, int col) {
-    for (int i = 0; i < OBS_GRID_SIZE; ++i) {
-        result->grid[col][i] = true;
+        GenHard(&random, result);
     }
+    result->PutRandomBonus(&random);
 }
 
-void ObstacleGenerator::GenEasy(Obstacle *result) {
-    int n = Random(4);
+void ObstacleGenerator::GenEasy(RandomGen *random, Obstacle *result) {
+    int n = random->Next(4);
     int i, j;
-    Obstacle *o = result; // shorthand
     switch (n) {
         case 0:
-            i = Random(1, OBS_GRID_SIZE - 1); // i is the row of the bonus
-            FillRow(result, i + (Random(2) ? 1 : -1)); // horizontal bar next to i
+            i = random->Next(1, OBS_GRID_SIZE - 1); // i is the row of the bonus
+            result->FillRow(i + (random->Next(2) ? 1 : -1)); // horizontal bar next to i
             break;
         case 1:
-            i = Random(1, OBS_GRID_SIZE - 1); // i is the column of the bonus
-            FillCol(result, i + (Random(2) ? 1 : -1)); // vertical bar next to i
+            i = random->Next(1, OBS_GRID_SIZE - 1); // i is the column of the bonus
+            result->FillCol(i + (random->Next(2) ? 1 : -1)); // vertical bar next to i
             break;
         case 2:
-            FillRow(result, 0);
-            FillRow(result, OBS_GRID_SIZE - 1);
-            FillCol(result, 0);
-            FillCol(result, OBS_GRID_SIZE - 1);
+            result->FillRow(0);
+            result->FillRow(OBS_GRID_SIZE - 1);
+            result->FillCol(0);
+            result->FillCol(OBS_GRID_SIZE - 1);
             break;
         default:
-            i = Random(0, OBS_GRID_SIZE - 2); // i is the row of the bonus
-            j = Random(0, OBS_GRID_SIZE - 2); // i is the row of the bonus
-            o->grid[i][j] = o->grid[i+1][j] = o->grid[i][j+1] = o->grid[i+1][j+1] = true;
+            i = random->Next(0, OBS_GRID_SIZE - 2); // i is the row of the bonus
+            j = random->Next(0, OBS_GRID_SIZE - 2); // i is the row of the bonus
+            result->SetBox(i, j);
+            result->SetBox(i + 1, j);
+            result->SetBox(i, j + 1);
+            result->SetBox(i + 1, j + 1);
             break;
     }
 }
 
-void ObstacleGenerator::GenMedium(Obstacle *result) {
-    int n = Random(3);
+void ObstacleGenerator::GenMedium(RandomGen *random, Obstacle *result) {
+    int n = random->Next(3);
     int i;
     switch (n) {
         case 0:
-            i = Random(1, OBS_GRID_SIZE - 1); // i is the row of the bonus
-            FillRow(result, i + 1);
-            FillRow(result, i - 1);
+            i = random->Next(1, OBS_GRID_SIZE - 1); // i is the row of the bonus
+            result->FillRow(i + 1);
+            result->FillRow(i - 1);
             break;
         case 1:
-            i = Random(1, OBS_GRID_SIZE - 1); // i is the column of the bonus
-            FillCol(result, i - 1);
-            FillCol(result, i + 1);
+            i = random->Next(1, OBS_GRID_SIZE - 1); // i is the column of the bonus
+            result->FillCol(i - 1);
+            result->FillCol(i + 1);
             break;
         default:
-            i = Random(1, OBS_GRID_SIZE - 1); // i is the column of the bonus
-            FillRow(result, i);
-            FillCol(result, i);
+            i = random->Next(1, OBS_GRID_SIZE - 1); // i is the column of the bonus
+            result->FillRow(i);
+            result->FillCol(i);
             break;
 
     }
 }
 
-void ObstacleGenerator::GenIntermediate(Obstacle *result) {
-    int n = Random(3);
+void ObstacleGenerator::GenIntermediate(RandomGen *random, Obstacle *result) {
+    int n = random->Next(3);
     int i;
     switch (n) {
         case 0:
-            i = Random(0, OBS_GRID_SIZE - 2);
-            FillRow(result, i);
-            FillRow(result, i + 1);
-            FillRow(result, i + 2);
+            i = random->Next(0, OBS_GRID_SIZE - 2);
+            result->FillRow(i);
+            result->FillRow(i + 1);
+            result->FillRow(i + 2);
             break;
         case 1:
-            i = Random(0, OBS_GRID_SIZE - 2); // i is the column of the bonus
-            FillCol(result, i);
-            FillCol(result, i + 1);
-            FillCol(result, i + 2);
+            i = random->Next(0, OBS_GRID_SIZE - 2); // i is the column of the bonus
+            result->FillCol(i);
+            result->FillCol(i + 1);
+            result->FillCol(i + 2);
             break;
         default:
-            i = Random(1, OBS_GRID_SIZE - 2); // i is the column of the bonus
-            FillCol(result, i - 1);
-            FillCol(result, i + 1);
-            FillCol(result, i + 2);
+            i = random->Next(1, OBS_GRID_SIZE - 2); // i is the column of the bonus
+            result->FillCol(i - 1);
+            result->FillCol(i + 1);
+            result->FillCol(i + 2);
             break;
     }
 }
 
-void ObstacleGenerator::GenHard(Obstacle *result) {
-    int n = Random(4);
+void ObstacleGenerator::GenHard(RandomGen *random, Obstacle *result) {
+    int n = random->Next(4);
     int i;
     int j;
     switch (n) {
         case 0:
-            i = Random(0, OBS_GRID_SIZE - 3);
-            FillRow(result, i);
-            FillRow(result, i + 1);
-            FillRow(result, i + 2);
-            FillRow(result, i + 3);
-            result->grid[Random(0, OBS_GRID_SIZE)][Random(0, OBS_GRID_SIZE)] = false;
+            i = random->Next(0, OBS_GRID_SIZE - 3);
+            result->FillRow(i);
+            result->FillRow(i + 1);
+            result->FillRow(i + 2);
+            result->FillRow(i + 3);
+            j = random->Next(0, OBS_GRID_SIZE);
+            result->ClearBox(j, random->Next(0, OBS_GRID_SIZE)); // a gap, somewhere
             break;
         case 1:
-            i = Random(0, OBS_GRID_SIZE - 3);
-            FillCol(result, i);
-            FillCol(result, i + 1);
-            FillCol(result, i + 2);
-            FillCol(result, i + 3);
-            result->grid[Random(0, OBS_GRID_SIZE)][Random(0, OBS_GRID_SIZE)] = false;
+            i = random->Next(0, OBS_GRID_SIZE - 3);
+            result->FillCol(i);
+            result->FillCol(i + 1);
+            result->FillCol(i + 2);
+            result->FillCol(i + 3);
+            j = random->Next(0, OBS_GRID_SIZE);
+            result->ClearBox(j, random->Next(0, OBS_GRID_SIZE)); // a gap, somewhere
             break;
         case 2:
-            i = Random(0, OBS_GRID_SIZE);
+            i = random->Next(0, OBS_GRID_SIZE);
             for (j = 0; j < OBS_GRID_SIZE; j++) {
                 if (i != j) {
-                    FillCol(result, i);
+                    result->FillCol(i);
                 }
             }
-            result->grid[Random(0, OBS_GRID_SIZE)][Random(0, OBS_GRID_SIZE)] = false;
+            j = random->Next(0, OBS_GRID_SIZE);
+            result->ClearBox(j, random->Next(0, OBS_GRID_SIZE)); // a gap, somewhere
             break;
         default:
-            i = Random(0, OBS_GRID_SIZE);
+            i = random->Next(0, OBS_GRID_SIZE);
             for (j = 0; j < OBS_GRID_SIZE; j++) {
                 if (i != j) {
-                    FillRow(result, i);
+                    result->FillRow(i);
                 }
             }
-            result->grid[Random(0, OBS_GRID_SIZE)][Random(0, OBS_GRID_SIZE)] = false;
+            j = random->Next(0, OBS_GRID_SIZE);
+            result->ClearBox(j, random->Next(0, OBS_GRID_SIZE)); // a gap, somewhere
             break;
     }
 }
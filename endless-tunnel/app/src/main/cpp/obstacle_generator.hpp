@@ -16,33 +16,32 @@
 #ifndef endlesstunnel_obstacle_generator_hpp
 #define endlesstunnel_obstacle_generator_hpp
 
-#include "engine.hpp"
 #include "obstacle.hpp"
+#include "util.hpp"
 
-// Generates obstacles given a difficulty level.
+// Generates obstacles given a difficulty level. An obstacle only depends on the seed, the
+// tunnel section it is for and the difficulty level, so obstacles can be generated ahead,
+// in any order and on any thread (see ObstacleRing).
 class ObstacleGenerator {
     private:
-        int mDifficulty;
+        uint32_t mSeed;
     public:
         ObstacleGenerator() {
-            mDifficulty = 0;
+            mSeed = 1;
         }
 
-        void SetDifficulty(int dif) {
-            mDifficulty = dif;
+        void Seed(uint32_t seed) {
+            mSeed = seed;
         }
 
-        // generate a new obstacle.
-        void Generate(Obstacle *result);
+        // generate the obstacle of the given tunnel section.
+        void Generate(int section, int difficulty, Obstacle *result) const;
 
     private:
-        void GenEasy(Obstacle *result);
-        void GenMedium(Obstacle *result);
-        void GenIntermediate(Obstacle *result);
-        void GenHard(Obstacle *result);
-
-        void FillRow(Obstacle *result, int row);
-        void FillCol(Obstacle *result, int col);
+        static void GenEasy(RandomGen *random, Obstacle *result);
+        static void GenMedium(RandomGen *random, Obstacle *result);
+        static void GenIntermediate(RandomGen *random, Obstacle *result);
+        static void GenHard(RandomGen *random, Obstacle *result);
 };
 
 #endif
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "obstacle_ring.hpp"
+
+ObstacleRing::ObstacleRing(uint32_t seed) {
+    mGenerator.Seed(seed);
+    for (int i = 0; i < SIZE; i++) {
+        mSlots[i].section = -1;
+    }
+    mNextSection = 0;
+    mDifficulty = 0;
+    mHits = mMisses = 0;
+    mStopping = false;
+}
+
+ObstacleRing::~ObstacleRing() {
+    StopThread();
+}
+
+void ObstacleRing::StartThread() {
+    if (!mThread.joinable()) {
+        mStopping = false;
+        mThread = std::thread(&ObstacleRing::ThreadMain, this);
+    }
+}
+
+void ObstacleRing::StopThread() {
+    if (mThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mWakeUp.notify_one();
+        mThread.join();
+    }
+}
+
+void ObstacleRing::Get(int section, int difficulty, Obstacle *result) {
+    bool ready, wake;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const Slot &slot = mSlots[section % SIZE];
+        ready = slot.section == section && slot.difficulty == difficulty;
+        if (ready) {
+            *result = slot.obstacle;
+        }
+        wake = !ready || difficulty != mDifficulty || mNextSection % (SIZE / 2) == 0;
+        mNextSection = section + 1;
+        mDifficulty = difficulty;
+    }
+    if (wake) {
+        mWakeUp.notify_one();
+    }
+
+    if (ready) {
+        mHits++;
+    } else {
+        mMisses++;
+        mGenerator.Generate(section, difficulty, result);
+    }
+}
+
+void ObstacleRing::ThreadMain() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mStopping) {
+        // find the first section ahead that is not ready
+        int section = -1, difficulty = mDifficulty;
+        for (int s = mNextSection; s < mNextSection + SIZE; s++) {
+            const Slot &slot = mSlots[s % SIZE];
+            if (slot.section != s || slot.difficulty != difficulty) {
+                section = s;
+                break;
+            }
+        }
+        if (section < 0) {
+            mWakeUp.wait(lock);
+            continue;
+        }
+
+        Obstacle obstacle;
+        lock.unlock();
+        mGenerator.Generate(section, difficulty, &obstacle);
+        lock.lock();
+
+        // don't store it if the player has gone past it or leveled up meanwhile
+        if (section >= mNextSection && section < mNextSection + SIZE &&
+                difficulty == mDifficulty) {
+            Slot &slot = mSlots[section % SIZE];
+            slot.section = section;
+            slot.difficulty = difficulty;
+            slot.obstacle = obstacle;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef endlesstunnel_obstacle_ring_hpp
+#define endlesstunnel_obstacle_ring_hpp
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "obstacle.hpp"
+#include "obstacle_generator.hpp"
+
+/* Hands out the obstacles of the tunnel sections, in order. Once StartThread() is called,
+ * a thread of its own keeps the next SIZE of them generated ahead, at the difficulty level
+ * of the last one taken, so taking one is only a copy; otherwise (or if the thread did not
+ * get to it, or the difficulty level changed since) it is generated on the spot.
+ *
+ * Either way, the obstacle of a section is the one ObstacleGenerator makes for it: the
+ * game does not depend on the thread or its timing. */
+class ObstacleRing {
+    public:
+        static const int SIZE = 8;
+
+        ObstacleRing(uint32_t seed);
+        ~ObstacleRing();
+
+        void StartThread();
+        void StopThread();
+
+        // get the obstacle of the given tunnel section, at the given difficulty level.
+        // Sections are expected in increasing order.
+        void Get(int section, int difficulty, Obstacle *result);
+
+        // how many obstacles were ready when taken, and how many were not
+        int GetHitCount() const { return mHits; }
+        int GetMissCount() const { return mMisses; }
+
+    private:
+        struct Slot {
+            int section;  // -1 if none
+            int difficulty;
+            Obstacle obstacle;
+        };
+
+        ObstacleGenerator mGenerator;
+        Slot mSlots[SIZE]; // the obstacle of section s goes in mSlots[s % SIZE]
+
+        // the section after the last one taken, and the difficulty level it was taken at:
+        // the thread fills mNextSection ... mNextSection + SIZE - 1 at mDifficulty
+        int mNextSection;
+        int mDifficulty;
+        int mHits, mMisses;
+
+        std::mutex mMutex;
+        std::condition_variable mWakeUp;
+        std::thread mThread;
+        bool mStopping;
+
+        void ThreadMain();
+};
+
+#endif
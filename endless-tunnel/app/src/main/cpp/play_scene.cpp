@@ -57,24 +57,20 @@ static const char* TONE_BONUS[] = {
     "d70 f550. f650. f750. f850."
 };
 
-PlayScene::PlayScene() : Scene() {
+PlayScene::PlayScene() : Scene(), mSim((uint32_t)rand()) {
     mOurShader = NULL;
     mTrivialShader = NULL;
     mTextRenderer = NULL;
     mShapeRenderer = NULL;
     mShipSteerX = mShipSteerZ = 0.0f;
-    mFilteredSteerX = mFilteredSteerZ = 0.0f;
 
     mPlayerDir = glm::vec3(0.0f, 1.0f, 0.0f); // forward
-    mDifficulty = 0;
     mUseCloudSave = false;
 
     mCubeGeom = NULL;
     mTunnelGeom = NULL;
 
-    mObstacleCount = 0;
-    mFirstObstacle = 0;
-    mFirstSection = 0;
+    mSimTime = 0.0f;
     mSteering = STEERING_NONE;
     mPointerId = -1;
     mPointerAnchorX = mPointerAnchorY = 0.0f;
@@ -99,25 +95,14 @@ PlayScene::PlayScene() : Scene() {
     mShowedHowto = false;
     mLifeGeom = NULL;
 
-    mLives = PLAYER_LIVES;
-
-    mRollAngle = 0.0f;
-
-    mPlayerSpeed = 0.0f;
     mBlinkingHeart = false;
     mGameStartTime = Clock();
 
-    mBonusInARow = 0;
-    mLastCrashSection = -1;
-
     mFrameClock.SetMaxDelta(MAX_DELTA_T);
-    mLastAmbientBeepEmitted = 0;
     mMenuTouchActive = false;
 
     mCheckpointSignPending = false;
 
-    SetScore(0);
-
     /*
      * where do I put the program???
      */
@@ -193,26 +178,26 @@ void PlayScene::WriteSaveFile(int level) {
 }
 
 void PlayScene::SaveProgress() {
-    if (mDifficulty <= mSavedCheckpoint) {
+    if (mSim.GetDifficulty() <= mSavedCheckpoint) {
         // nothing to do
-        LOGD("No need to save level, current = %d, saved = %d", mDifficulty, mSavedCheckpoint);
+        LOGD("No need to save level, current = %d, saved = %d", mSim.GetDifficulty(), mSavedCheckpoint);
         return;
     } else if (!IsCheckpointLevel()) {
-        LOGD("Current level %d is not a checkpoint level. Nothing to save.", mDifficulty);
+        LOGD("Current level %d is not a checkpoint level. Nothing to save.", mSim.GetDifficulty());
         return;
     }
 
-    mSavedCheckpoint = mDifficulty;
+    mSavedCheckpoint = mSim.GetDifficulty();
 
     // Save state locally or to the cloud, depending on configuration:
     if (mUseCloudSave) {
-        LOGD("Saving progress to the cloud: level %d", mDifficulty);
+        LOGD("Saving progress to the cloud: level %d", mSim.GetDifficulty());
         /*
          * No where to save
          */
     } else {
-        LOGD("Saving progress to LOCAL FILE: level %d", mDifficulty);
-        WriteSaveFile(mDifficulty);
+        LOGD("Saving progress to LOCAL FILE: level %d", mSim.GetDifficulty());
+        WriteSaveFile(mSim.GetDifficulty());
     }
 
     // Show a "checkpoint saved" sign when possible. We don't show it right away
@@ -284,18 +269,23 @@ void PlayScene::OnKillGraphics() {
 
 void PlayScene::DoFrame() {
     float deltaT = mFrameClock.ReadDelta();
-    float previousY = mPlayerPos.y;
 
     // clear screen
     glClearColor(0.0, 0.0, 0.0, 1.0);
     glEnable(GL_DEPTH_TEST);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // the game logic runs in fixed steps, so show the player where it is between the last
+    // two of them, at the time left over from the last frame
+    float alpha = mSimTime / SIM_TIMESTEP;
+    glm::vec3 playerPos = mSim.GetPlayerPos(alpha);
+    float rollAngle = mSim.GetRollAngle(alpha);
+
     // rotate the view matrix according to current roll angle
-    glm::vec3 upVec = glm::vec3(-sin(mRollAngle), 0, cos(mRollAngle));
+    glm::vec3 upVec = glm::vec3(-sin(rollAngle), 0, cos(rollAngle));
 
     // set up view matrix according to player's ship position and direction
-    mViewMat = glm::lookAt(mPlayerPos, mPlayerPos + mPlayerDir, upVec);
+    mViewMat = glm::lookAt(playerPos, playerPos + mPlayerDir, upVec);
 
     // render tunnel walls
     RenderTunnel();
@@ -327,7 +317,7 @@ void PlayScene::DoFrame() {
     }
 
     // did we already show the howto?
-    if (!mShowedHowto && mDifficulty == 0) {
+    if (!mShowedHowto && mSim.GetDifficulty() == 0) {
         mShowedHowto = true;
         ShowSign(S_HOWTO_WITHOUT_JOY, SIGN_DURATION);
     }
@@ -337,83 +327,64 @@ void PlayScene::DoFrame() {
         mBlinkingHeart = false;
     }
 
-    // update speed
-    float targetSpeed = PLAYER_SPEED + PLAYER_SPEED_INC_PER_LEVEL * mDifficulty;
-    float accel = mPlayerSpeed >= 0.0f ? PLAYER_ACCELERATION_POSITIVE_SPEED :
-            PLAYER_ACCELERATION_NEGATIVE_SPEED;
-    if (mLives <= 0) {
-        targetSpeed = 0.0f;
-    }
-    mPlayerSpeed = Approach(mPlayerSpeed, targetSpeed, deltaT * accel);
-
-    // apply noise filter on steering
-    mFilteredSteerX = (mFilteredSteerX * (NOISE_FILTER_SAMPLES - 1) + mShipSteerX)
-            / NOISE_FILTER_SAMPLES;
-    mFilteredSteerZ = (mFilteredSteerZ * (NOISE_FILTER_SAMPLES - 1) + mShipSteerZ)
-            / NOISE_FILTER_SAMPLES;
-
-    // move player
-    if (mLives > 0) {
-        float steerX = mFilteredSteerX, steerZ = mFilteredSteerZ;
-        if (mSteering == STEERING_TOUCH) {
-            // touch steering
-            mPlayerPos.x = Approach(mPlayerPos.x, steerX, PLAYER_MAX_LAT_SPEED * deltaT);
-            mPlayerPos.z = Approach(mPlayerPos.z, steerZ, PLAYER_MAX_LAT_SPEED * deltaT);
-        } else if (mSteering == STEERING_JOY) {
-            // joystick steering
-            mPlayerPos.x += deltaT * steerX;
-            mPlayerPos.z += deltaT * steerZ;
-        }
+    // advance the game logic by the time that passed
+    SimInput input;
+    input.steering = mSteering;
+    input.steerX = mShipSteerX;
+    input.steerZ = mShipSteerZ;
+    mSimTime += deltaT;
+    while (mSimTime >= SIM_TIMESTEP) {
+        mSimTime -= SIM_TIMESTEP;
+        HandleSimEvents(mSim.Step(input));
     }
-    mPlayerPos.y += deltaT * mPlayerSpeed;
 
-    // make sure player didn't leave tunnel
-    mPlayerPos.x = Clamp(mPlayerPos.x, PLAYER_MIN_X, PLAYER_MAX_X);
-    mPlayerPos.z = Clamp(mPlayerPos.z, PLAYER_MIN_Z, PLAYER_MAX_Z);
-
-    // shift sections if needed
-    ShiftIfNeeded();
-
-    // generate more obstacles!
-    GenObstacles();
-
-    // detect collisions
-    DetectCollisions(previousY);
+    // did the game expire?
+    if (mSim.GetLives() <= 0 && Clock() > mGameOverExpire) {
+        SceneManager::GetInstance()->RequestNewScene(new WelcomeScene());
 
-    // update ship's roll speed according to level
-    static float roll_speeds[] = ROLL_SPEEDS;
-    int count = sizeof(roll_speeds) / sizeof(float);
-    float speed = roll_speeds[mDifficulty % count];
-    mRollAngle += deltaT * speed;
-    while (mRollAngle < 0) {
-        mRollAngle += 2 * M_PI;
     }
-    while (mRollAngle > 2 * M_PI) {
-        mRollAngle -= 2 * M_PI;
+}
+
+void PlayScene::HandleSimEvents(int events) {
+    if (events & GameSim::EVENT_CRASHED) {
+        if (events & GameSim::EVENT_GAME_OVER) {
+            // say "Game Over"
+            ShowSign(S_GAME_OVER, SIGN_DURATION_GAME_OVER);
+            SfxMan::GetInstance()->PlayTone(TONE_GAME_OVER);
+            mGameOverExpire = Clock() + GAME_OVER_EXPIRE;
+        } else {
+            ShowSign(S_OUCH, SIGN_DURATION);
+            SfxMan::GetInstance()->PlayTone(TONE_CRASHED);
+        }
+        mBlinkingHeart = true;
+        mBlinkingHeartExpire = Clock() + BLINKING_HEART_DURATION;
     }
 
-    // did the game expire?
-    if (mLives <= 0 && Clock() > mGameOverExpire) {
-        SceneManager::GetInstance()->RequestNewScene(new WelcomeScene());
+    if (events & GameSim::EVENT_BONUS) {
+        ShowSign(S_GOT_BONUS, SIGN_DURATION_BONUS);
+        if (events & GameSim::EVENT_LEVEL_UP) {
+            ShowLevelSign();
+            SfxMan::GetInstance()->PlayTone(TONE_LEVEL_UP);
 
+            // save progress, if needed
+            SaveProgress();
+        } else {
+            int score = mSim.GetScore();
+            int tone = (score % SCORE_PER_LEVEL) / BONUS_POINTS - 1;
+            tone = tone < 0 ? 0 :
+                   tone >= static_cast<int>(sizeof(TONE_BONUS)/sizeof(char*)) ?
+                   static_cast<int>(sizeof(TONE_BONUS)/sizeof(char*) - 1) : tone;
+            SfxMan::GetInstance()->PlayTone(TONE_BONUS[tone]);
+        }
     }
 
     // produce the ambient sound
-    int soundPoint = (int)floor(mPlayerPos.y / (TUNNEL_SECTION_LENGTH/3));
-    if (soundPoint % 3 != 0 && soundPoint > mLastAmbientBeepEmitted) {
-        mLastAmbientBeepEmitted = soundPoint;
+    if (events & GameSim::EVENT_AMBIENT) {
+        int soundPoint = mSim.GetAmbientBeep();
         SfxMan::GetInstance()->PlayTone(soundPoint % 2 ? TONE_AMBIENT_0 : TONE_AMBIENT_1);
     }
 }
 
-static float GetSectionCenterY(int i) {
-    return (float)i * TUNNEL_SECTION_LENGTH;
-}
-
-static float GetSectionEndY(int i) {
-    return GetSectionCenterY(i) + 0.5f * TUNNEL_SECTION_LENGTH;
-}
-
 static void _get_obs_color(int style, float *r, float *g, float *b) {
     style = Clamp(style, 1, 6);
     *r = OBS_COLORS[style * 3];
@@ -428,12 +399,13 @@ void PlayScene::RenderTunnel() {
 
     mOurShader->BeginRender(mTunnelGeom->vbuf);
     mOurShader->SetTexture(mWallTexture);
-    for (i = mFirstSection, oi = 0; i <= mFirstSection + RENDER_TUNNEL_SECTION_COUNT; ++i, ++oi) {
-        float segCenterY = GetSectionCenterY(i);
+    int firstSection = mSim.GetFirstSection();
+    for (i = firstSection, oi = 0; i <= firstSection + RENDER_TUNNEL_SECTION_COUNT; ++i, ++oi) {
+        float segCenterY = GameSim::GetSectionCenterY(i);
         modelMat = glm::translate(glm::mat4(1.0), glm::vec3(0.0, segCenterY, 0.0));
         mvpMat = mProjMat * mViewMat * modelMat;
 
-        Obstacle *o = oi >= mObstacleCount ? NULL : GetObstacleAt(oi);
+        const Obstacle *o = oi >= mSim.GetObstacleCount() ? NULL : mSim.GetObstacleAt(oi);
 
         // the point light is given in model coordinates, which is 0,0,0 is ok (center of
         // tunnel section)
@@ -461,9 +433,9 @@ void PlayScene::RenderObstacles() {
     mOurShader->BeginRender(mCubeGeom->vbuf);
     mOurShader->SetTexture(mWallTexture);
 
-    for (i = 0; i < mObstacleCount; i++) {
-        Obstacle *o = GetObstacleAt(i);
-        float posY = GetSectionCenterY(mFirstSection + i);
+    for (i = 0; i < mSim.GetObstacleCount(); i++) {
+        Obstacle *o = mSim.GetObstacleAt(i);
+        float posY = GameSim::GetSectionCenterY(mSim.GetFirstSection() + i);
 
         if (o->style == Obstacle::STYLE_NULL) {
             // don't render null obstacles
@@ -473,7 +445,7 @@ void PlayScene::RenderObstacles() {
         for (r = 0; r < OBS_GRID_SIZE; r++) {
             for (c = 0; c < OBS_GRID_SIZE; c++) {
                 bool isBonus = r == o->bonusRow && c == o->bonusCol;
-                if (o->grid[c][r]) {
+                if (o->HasBox(c, r)) {
                     // set up matrices
                     modelMat = glm::translate(glm::mat4(1.0f), o->GetBoxCenter(c, r, posY));
                     modelMat = glm::scale(modelMat, o->GetBoxSize(c, r));
@@ -502,39 +474,6 @@ void PlayScene::RenderObstacles() {
     mOurShader->EndRender();
 }
 
-void PlayScene::GenObstacles() {
-    while (mObstacleCount < MAX_OBS) {
-        // generate a new obstacle
-        int index = (mFirstObstacle + mObstacleCount) % MAX_OBS;
-
-        int section = mFirstSection + mObstacleCount;
-        if (section < OBS_START_SECTION) {
-            // generate an empty obstacle
-            mObstacleCircBuf[index].Reset();
-            mObstacleCircBuf[index].style = Obstacle::STYLE_NULL;
-        } else {
-            // generate a normal obstacle
-            mObstacleGen.Generate(&mObstacleCircBuf[index]);
-        }
-        mObstacleCount++;
-    }
-}
-
-void PlayScene::ShiftIfNeeded() {
-    // is it time to discard a section and shift forward?
-    while (mPlayerPos.y > GetSectionEndY(mFirstSection) + SHIFT_THRESH) {
-        // shift to the next turnnel section
-        mFirstSection++;
-
-        // discard obstacle corresponding to the deleted section
-        if (mObstacleCount > 0) {
-            // discarding first object (shifting) is easy because it's a circular buffer!
-            mFirstObstacle = (mFirstObstacle + 1) % MAX_OBS;
-            --mObstacleCount;
-        }
-    }
-}
-
 void PlayScene::UpdateMenuSelFromTouch(float x, float y) {
     float sh = SceneManager::GetInstance()->GetScreenHeight();
     int item = (int)floor((y / sh) * (mMenuItemCount));
@@ -552,8 +491,8 @@ void PlayScene::OnPointerDown(int pointerId, const struct PointerCoords *coords)
         mPointerId = pointerId;
         mPointerAnchorX = x;
         mPointerAnchorY = y;
-        mShipAnchorX = mPlayerPos.x;
-        mShipAnchorZ = mPlayerPos.z;
+        mShipAnchorX = mSim.GetPlayerPos().x;
+        mShipAnchorZ = mSim.GetPlayerPos().z;
         mSteering = STEERING_TOUCH;
     }
 }
@@ -580,8 +519,9 @@ void PlayScene::OnPointerMove(int pointerId, const struct PointerCoords *coords)
     else if (mSteering == STEERING_TOUCH && pointerId == mPointerId) {
         float deltaX = (x - mPointerAnchorX) * TOUCH_CONTROL_SENSIVITY / rangeY;
         float deltaY = -(y - mPointerAnchorY) * TOUCH_CONTROL_SENSIVITY / rangeY;
-        float rotatedDx = cos(mRollAngle) * deltaX - sin(mRollAngle) * deltaY;
-        float rotatedDy = sin(mRollAngle) * deltaX + cos(mRollAngle) * deltaY;
+        float rollAngle = mSim.GetRollAngle();
+        float rotatedDx = cos(rollAngle) * deltaX - sin(rollAngle) * deltaY;
+        float rotatedDy = sin(rollAngle) * deltaX + cos(rollAngle) * deltaY;
 
         mShipSteerX = mShipAnchorX + rotatedDx;
         mShipSteerZ = mShipAnchorZ + rotatedDy;
@@ -599,12 +539,13 @@ void PlayScene::RenderHUD() {
     // render score digits
     int i, unit;
     static char score_str[6];
-    int score = GetScore();
+    int score = mSim.GetScore();
     for (i = 0, unit = 10000; i < 5; i++, unit /= 10) {
         score_str[i] = '0' + (score / unit) % 10;
     }
     score_str[i] = '\0';
 
+    mTextRenderer->BeginBatch();
     mTextRenderer->SetFontScale(SCORE_FONT_SCALE);
     mTextRenderer->RenderText(score_str, SCORE_POS_X, SCORE_POS_Y);
 
@@ -625,13 +566,15 @@ void PlayScene::RenderHUD() {
         mTextRenderer->RenderText(mSignText, aspect * 0.5f, 0.5f);
         mTextRenderer->ResetMatrix();
     }
+    mTextRenderer->EndBatch();
 
     // render life icons
     glLineWidth(LIFE_LINE_WIDTH);
     float lifeX = LIFE_POS_X < 0.0f ? aspect + LIFE_POS_X : LIFE_POS_X;
     modelMat = glm::translate(glm::mat4(1.0), glm::vec3(lifeX, LIFE_POS_Y, 0.0f));
     modelMat = glm::scale(modelMat, glm::vec3(1.0f, LIFE_SCALE_Y, 1.0f));
-    int ubound = (mBlinkingHeart && BlinkFunc(0.2f)) ? mLives + 1 : mLives;
+    int lives = mSim.GetLives();
+    int ubound = (mBlinkingHeart && BlinkFunc(0.2f)) ? lives + 1 : lives;
     for (int i = 0; i < ubound; i++) {
         mat = orthoMat * modelMat;
         mTrivialShader->RenderSimpleGeom(&mat, mLifeGeom);
@@ -653,6 +596,7 @@ void PlayScene::RenderMenu() {
     float scaleFactor = SineWave(1.0f, MENUITEM_PULSE_AMOUNT, MENUITEM_PULSE_PERIOD, 0.0f);
 
     int i;
+    mTextRenderer->BeginBatch();
     for (i = 0; i < mMenuItemCount; i++) {
         float thisFactor = (mMenuSel == i) ? scaleFactor : 1.0f;
         float y = 1.0f - (i + 1) / ((float)mMenuItemCount + 1);
@@ -661,95 +605,12 @@ void PlayScene::RenderMenu() {
         mTextRenderer->SetColor(mMenuSel == i ? MENUITEM_SEL_COLOR : MENUITEM_COLOR);
         mTextRenderer->RenderText(mMenuItemText[mMenuItems[i]], x, y);
     }
+    mTextRenderer->EndBatch();
     mTextRenderer->ResetColor();
 
     glEnable(GL_DEPTH_TEST);
 }
 
-void PlayScene::DetectCollisions(float previousY) {
-    Obstacle *o = GetObstacleAt(0);
-    float obsCenter = GetSectionCenterY(mFirstSection);
-    float obsMin = obsCenter - OBS_BOX_SIZE;
-    float curY = mPlayerPos.y;
-
-    if (!o || !(previousY < obsMin && curY >= obsMin)) {
-        // no collision
-        return;
-    }
-
-    // what row/column is the player on?
-    int col = o->GetColAt(mPlayerPos.x);
-    int row = o->GetRowAt(mPlayerPos.z);
-
-    if (o->grid[col][row]) {
-        // crashed against obstacle
-        mLives--;
-        if (mLives > 0) {
-            ShowSign(S_OUCH, SIGN_DURATION);
-            SfxMan::GetInstance()->PlayTone(TONE_CRASHED);
-        } else {
-            // say "Game Over"
-            ShowSign(S_GAME_OVER, SIGN_DURATION_GAME_OVER);
-            SfxMan::GetInstance()->PlayTone(TONE_GAME_OVER);
-            mGameOverExpire = Clock() + GAME_OVER_EXPIRE;
-        }
-        mPlayerPos.y = obsMin - PLAYER_RECEDE_AFTER_COLLISION;
-        mPlayerSpeed = PLAYER_SPEED_AFTER_COLLISION;
-        mBlinkingHeart = true;
-        mBlinkingHeartExpire = Clock() + BLINKING_HEART_DURATION;
-
-        mLastCrashSection = mFirstSection;
-
-    } else if (row == o->bonusRow && col == o->bonusCol) {
-        ShowSign(S_GOT_BONUS, SIGN_DURATION_BONUS);
-        o->DeleteBonus();
-        AddScore(BONUS_POINTS);
-        mBonusInARow++;
-
-        if (mBonusInARow >= 10) {
-            mBonusInARow = 0;
-        }
-
-        // update difficulty level, if applicable
-        int score = GetScore();
-        if (mDifficulty < score / SCORE_PER_LEVEL) {
-            mDifficulty = score / SCORE_PER_LEVEL;
-            ShowLevelSign();
-            mObstacleGen.SetDifficulty(mDifficulty);
-            SfxMan::GetInstance()->PlayTone(TONE_LEVEL_UP);
-
-            // save progress, if needed
-            SaveProgress();
-        } else {
-            int tone = (score % SCORE_PER_LEVEL) / BONUS_POINTS - 1;
-            tone = tone < 0 ? 0 :
-                   tone >= static_cast<int>(sizeof(TONE_BONUS)/sizeof(char*)) ?
-                   static_cast<int>(sizeof(TONE_BONUS)/sizeof(char*) - 1) : tone;
-            SfxMan::GetInstance()->PlayTone(TONE_BONUS[tone]);
-        }
-
-    } else if (o->HasBonus()) {
-        // player missed bonus!
-        mBonusInARow = 0;
-    }
-
-    // was it a close call?
-    if (!o->grid[col][row]) {
-        bool isCloseCall = false;
-        for (int i = -1; i <= 1 && !isCloseCall; i++) {
-            for (int j = -1; j <= 1; j++) {
-                int other_row = o->GetColAt(mPlayerPos.x + i * CLOSE_CALL_CALC_DELTA);
-                int other_col = o->GetRowAt(mPlayerPos.z + j * CLOSE_CALL_CALC_DELTA);
-                if (o->grid[other_col][other_row]) {
-                    isCloseCall = true;
-                    break;
-                }
-            }
-        }
-
-    }
-}
-
 bool PlayScene::OnBackKeyPressed() {
     if (mMenu) {
         // reset frame clock so that the animation doesn't jump:
@@ -769,8 +630,9 @@ void PlayScene::OnJoy(float joyX, float joyY) {
     if (!mSteering || mSteering == STEERING_JOY) {
         float deltaX = joyX * JOYSTICK_CONTROL_SENSIVITY;
         float deltaY = joyY * JOYSTICK_CONTROL_SENSIVITY;
-        float rotatedDx = cos(-mRollAngle) * deltaX - sin(-mRollAngle) * deltaY;
-        float rotatedDy = sin(-mRollAngle) * deltaX + cos(-mRollAngle) * deltaY;
+        float rollAngle = mSim.GetRollAngle();
+        float rotatedDx = cos(-rollAngle) * deltaX - sin(-rollAngle) * deltaY;
+        float rotatedDy = sin(-rollAngle) * deltaX + cos(-rollAngle) * deltaY;
         mShipSteerX = rotatedDx;
         mShipSteerZ = -rotatedDy;
         mSteering = STEERING_JOY;
@@ -778,9 +640,10 @@ void PlayScene::OnJoy(float joyX, float joyY) {
         // If player is going faster than the reference speed, PLAYER_SPEED, adjust it.
         // This makes the steering react faster as the ship accelerates in more difficult
         // levels.
-        if (mPlayerSpeed > PLAYER_SPEED) {
-            mShipSteerX *= mPlayerSpeed / PLAYER_SPEED;
-            mShipSteerZ *= mPlayerSpeed / PLAYER_SPEED;
+        float playerSpeed = mSim.GetPlayerSpeed();
+        if (playerSpeed > PLAYER_SPEED) {
+            mShipSteerX *= playerSpeed / PLAYER_SPEED;
+            mShipSteerZ *= playerSpeed / PLAYER_SPEED;
         }
     }
 }
@@ -830,9 +693,8 @@ void PlayScene::HandleMenu(int menuItem) {
             break;
         case MENUITEM_RESUME:
             // resume from saved level
-            mDifficulty = (mSavedCheckpoint / LEVELS_PER_CHECKPOINT) * LEVELS_PER_CHECKPOINT;
-            SetScore(SCORE_PER_LEVEL * mDifficulty);
-            mObstacleGen.SetDifficulty(mDifficulty);
+            mSim.StartAtDifficulty(
+                    (mSavedCheckpoint / LEVELS_PER_CHECKPOINT) * LEVELS_PER_CHECKPOINT);
             ShowLevelSign();
             ShowMenu(MENU_NONE);
             break;
@@ -845,7 +707,7 @@ void PlayScene::HandleMenu(int menuItem) {
 
 void PlayScene::ShowLevelSign() {
     static char level_str[] = "LEVEL XX";
-    int level = mDifficulty + 1;
+    int level = mSim.GetDifficulty() + 1;
     level_str[6] = '0' + ((level > 9) ? (level / 10) % 10 : level % 10);
     level_str[7] = (level > 9) ? ('0' + level % 10) : '\0';
     level_str[8] = '\0';
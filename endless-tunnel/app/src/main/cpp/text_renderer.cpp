@@ -28,7 +28,8 @@
 
 TextRenderer::TextRenderer(TrivialShader *t) {
     mTrivialShader = t;
-    memset(mCharGeom, 0, sizeof(mCharGeom));
+    memset(mGlyphLines, 0, sizeof(mGlyphLines));
+    memset(mGlyphLineCount, 0, sizeof(mGlyphLineCount));
     mFontScale = 1.0f;
     mMatrix = glm::mat4(1.0f);
     mColor[0] = mColor[1] = mColor[2] = 1.0f;
@@ -38,16 +39,28 @@ TextRenderer::TextRenderer(TrivialShader *t) {
     for (i = 0; i < CHAR_CODES; ++i) {
         if (ALPHABET_ART[i]) {
             LOGD("Creating glyph for chr %d.", i);
-            mCharGeom[i] = AsciiArtToGeom(ALPHABET_ART[i], ALPHABET_SCALE);
+            mGlyphLineCount[i] = AsciiArtToLines(ALPHABET_ART[i], ALPHABET_SCALE,
+                    &mGlyphLines[i]);
         }
     }
+
+    mBatch = new GLfloat[MAX_BATCH_LINES * 2 * BATCH_VERTEX_FLOATS];
+    mBatchLines = 0;
+    mBatching = false;
+    mBatchBuf = new VertexBuf(NULL, 0, BATCH_VERTEX_FLOATS * sizeof(GLfloat));
+    mBatchBuf->SetPrimitive(GL_LINES);
+    mBatchBuf->SetColorsOffset(3 * sizeof(GLfloat));
 }
 
 TextRenderer::~TextRenderer() {
     int i;
     for (i = 0; i < CHAR_CODES; i++) {
-        CleanUp(&mCharGeom[i]);
+        delete [] mGlyphLines[i];
+        mGlyphLines[i] = NULL;
     }
+    delete [] mBatch;
+    mBatch = NULL;
+    CleanUp(&mBatchBuf);
 }
 
 TextRenderer* TextRenderer::SetFontScale(float scale) {
@@ -91,23 +104,12 @@ void TextRenderer::MeasureText(const char *str, float fontScale, float *outWidth
 }
 
 TextRenderer* TextRenderer::RenderText(const char *str, float centerX, float centerY) {
-    float aspect = SceneManager::GetInstance()->GetScreenAspect();
-    glm::mat4 orthoMat = glm::ortho(0.0f, aspect, 0.0f, 1.0f);
-    glm::mat4 modelMat, mat, scaleMat;
+    glm::mat4 mat;
     int cols, rows;
-    bool hadDepthTest;
 
     centerY += CORRECTION_Y * mFontScale;
 
-    glLineWidth(TEXT_LINE_WIDTH);
-
-    hadDepthTest = glIsEnabled(GL_DEPTH_TEST);
-    glDisable(GL_DEPTH_TEST);
-
-    mTrivialShader->SetTintColor(mColor[0], mColor[1], mColor[2]);
-
     _count_rows_cols(str, &cols, &rows);
-    scaleMat = glm::scale(glm::mat4(1.0f), glm::vec3(mFontScale, mFontScale, 1.0f));
     float charWidth = ALPHABET_GLYPH_COLS * ALPHABET_SCALE * mFontScale;
     float charHeight = ALPHABET_GLYPH_ROWS * ALPHABET_SCALE * mFontScale;
     float charSpacing = CHAR_SPACING_F * charWidth;
@@ -116,27 +118,87 @@ TextRenderer* TextRenderer::RenderText(const char *str, float centerX, float cen
     float height = rows * charHeight + (rows - 1) * lineSpacing;
     float startX = centerX - width * 0.5f + 0.5f * charWidth;
     float startY = centerY + height * 0.5f - 0.5f * charHeight;
+    float x = startX;
     float y = startY;
 
-    modelMat = glm::translate(glm::mat4(1.0f), glm::vec3(startX, startY, 0.0f));
+    // from glyph coordinates to the screen, but for the position of the glyph
+    mat = glm::scale(glm::mat4(1.0f), glm::vec3(mFontScale, mFontScale, 1.0f)) * mMatrix;
     for (; *str; ++str) {
         if (*str == '\n') {
             y -= charHeight + lineSpacing;
-            modelMat = glm::translate(glm::mat4(1.0f), glm::vec3(startX, y, 0.0f));
+            x = startX;
         } else {
             int code = (int) *str;
-            if (code >= 0 && code < CHAR_CODES && mCharGeom[code]) {
-                mat = orthoMat * modelMat * scaleMat * mMatrix;
-                mTrivialShader->RenderSimpleGeom(&mat, mCharGeom[code]);
+            if (code >= 0 && code < CHAR_CODES && mGlyphLines[code]) {
+                QueueGlyph(mat, x, y, code);
             }
-            modelMat = glm::translate(modelMat, glm::vec3(charWidth + charSpacing, 0.0f, 0.0f));
+            x += charWidth + charSpacing;
         }
     }
 
+    if (!mBatching) {
+        Flush();
+    }
+    return this;
+}
+
+TextRenderer* TextRenderer::BeginBatch() {
+    mBatching = true;
+    return this;
+}
+
+TextRenderer* TextRenderer::EndBatch() {
+    mBatching = false;
+    Flush();
+    return this;
+}
+
+void TextRenderer::QueueGlyph(const glm::mat4 &mat, float x, float y, int code) {
+    int lines = mGlyphLineCount[code];
+    if (mBatchLines + lines > MAX_BATCH_LINES) {
+        Flush();
+    }
+
+    const GLfloat *src = mGlyphLines[code];
+    GLfloat *dst = mBatch + mBatchLines * 2 * BATCH_VERTEX_FLOATS;
+    int i;
+    for (i = 0; i < lines * 2; ++i, src += 2, dst += BATCH_VERTEX_FLOATS) {
+        glm::vec4 p = mat * glm::vec4(src[0], src[1], 0.0f, 1.0f);
+        dst[0] = p.x + x;
+        dst[1] = p.y + y;
+        dst[2] = p.z;
+        dst[3] = mColor[0];
+        dst[4] = mColor[1];
+        dst[5] = mColor[2];
+    }
+    mBatchLines += lines;
+}
+
+void TextRenderer::Flush() {
+    if (mBatchLines == 0) {
+        return;
+    }
+
+    float aspect = SceneManager::GetInstance()->GetScreenAspect();
+    glm::mat4 orthoMat = glm::ortho(0.0f, aspect, 0.0f, 1.0f);
+    bool hadDepthTest;
+
+    glLineWidth(TEXT_LINE_WIDTH);
+
+    hadDepthTest = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+
+    mBatchBuf->SetData(mBatch, mBatchLines * 2 * BATCH_VERTEX_FLOATS * sizeof(GLfloat));
+    mBatchLines = 0;
+
+    // the text's colors are in the vertices
+    mTrivialShader->SetTintColor(1.0f, 1.0f, 1.0f);
+    mTrivialShader->BeginRender(mBatchBuf);
+    mTrivialShader->Render(&orthoMat);
+    mTrivialShader->EndRender();
+
     glLineWidth(1);
     if (hadDepthTest) {
         glEnable(GL_DEPTH_TEST);
     }
-    return this;
 }
-
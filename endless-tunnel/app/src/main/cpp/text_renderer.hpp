@@ -19,17 +19,38 @@
 #include "engine.hpp"
 
 /* Renders text to the screen. Uses the "normalized 2D coordinate system" as
- * described in the README. */
+ * described in the README.
+ *
+ * Text is drawn as lines. RenderText() lays out the lines of the glyphs on the CPU and
+ * queues them into a single vertex buffer, which is drawn with a single draw call: right
+ * away, or, between BeginBatch() and EndBatch(), once for all the text of the batch. */
 class TextRenderer {
     private:
         static const int CHAR_CODES = 128;
-        SimpleGeom* mCharGeom[CHAR_CODES];
+
+        // lines of each glyph, as the x,y of both ends (see AsciiArtToLines)
+        GLfloat *mGlyphLines[CHAR_CODES];
+        int mGlyphLineCount[CHAR_CODES];
         TrivialShader *mTrivialShader;
 
+        // lines queued for drawing, two vertices of BATCH_VERTEX_FLOATS (x,y,z,r,g,b) each
+        static const int MAX_BATCH_LINES = 2048;
+        static const int BATCH_VERTEX_FLOATS = 6;
+        GLfloat *mBatch;
+        int mBatchLines;
+        VertexBuf *mBatchBuf;
+        bool mBatching;
+
         float mFontScale;
         float mColor[3];
         glm::mat4 mMatrix;
 
+        // queue the lines of a glyph, transformed by mat and then moved by x,y
+        void QueueGlyph(const glm::mat4 &mat, float x, float y, int code);
+
+        // draw the queued lines
+        void Flush();
+
     public:
         TextRenderer(TrivialShader *t);
         ~TextRenderer();
@@ -37,6 +58,12 @@ class TextRenderer {
         TextRenderer* SetMatrix(glm::mat4 mat);
         TextRenderer* SetFontScale(float size);
         TextRenderer* RenderText(const char *str, float centerX, float centerY);
+
+        // Until EndBatch(), RenderText() only queues the text; EndBatch() draws all of it
+        // at once. Only batch text that nothing drawn in the meantime should cover.
+        TextRenderer* BeginBatch();
+        TextRenderer* EndBatch();
+
         void SetColor(float r, float g, float b) {
             mColor[0] = r, mColor[1] = g, mColor[2] = b;
         }
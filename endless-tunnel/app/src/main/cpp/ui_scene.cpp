@@ -137,13 +137,15 @@ void UiScene::DoFrame() {
     // and 1 when we've finished the transition
     float tf = Clamp((Clock() - mTransitionStart) / TRANSITION_DURATION, 0.0f, 1.0f);
 
-    // render ALL the widgets!
+    // render ALL the widgets! (their text goes on top, all of it in one go)
     int i;
+    mTextRenderer->BeginBatch();
     for (i = 0; i < mWidgetCount; ++i) {
         mWidgets[i]->Render(mTrivialShader, mTextRenderer, mShapeRenderer,
                 (mFocusWidget < 0) ? UiWidget::FOCUS_NOT_APPLICABLE :
                 (mFocusWidget == i) ? UiWidget::FOCUS_YES : UiWidget::FOCUS_NO, tf);
     }
+    mTextRenderer->EndBatch();
 
     glEnable(GL_DEPTH_TEST);
 }
@@ -16,6 +16,7 @@
 #ifndef endlesstunnel_util_hpp
 #define endlesstunnel_util_hpp
 
+#include <stdint.h>
 #include <ctime>
 #include <cmath>
 
@@ -30,6 +31,31 @@ template<typename T> void CleanUp(T** pptr) {
 int Random(int uboundExclusive);
 int Random(int lbound, int uboundExclusive);
 
+// Random numbers from a state of its own (xorshift32), unlike Random(), which shares
+// rand()'s. The game logic draws from one of these, so a game started from the same
+// seed always plays out the same.
+class RandomGen {
+    private:
+        uint32_t mState;
+    public:
+        RandomGen(uint32_t seed = 1) {
+            Seed(seed);
+        }
+        void Seed(uint32_t seed) {
+            // xorshift never leaves 0
+            mState = seed ? seed : 0x9e3779b9u;
+        }
+        int Next(int uboundExclusive) {
+            mState ^= mState << 13;
+            mState ^= mState >> 17;
+            mState ^= mState << 5;
+            return (int)(mState % (uint32_t)uboundExclusive);
+        }
+        int Next(int lbound, int uboundExclusive) {
+            return lbound + Next(uboundExclusive - lbound);
+        }
+};
+
 template<typename T> T Max(T a, T b) { return a > b ? a : b; }
 template<typename T> T Min(T a, T b) { return a < b ? a : b; }
 template<typename T> T Clamp(T v, T min, T max) {
@@ -31,6 +31,17 @@ VertexBuf::VertexBuf(GLfloat *geomData, int dataSize, int stride) {
     UnbindBuffer();
 }
 
+void VertexBuf::SetData(GLfloat *geomData, int dataSize) {
+    MY_ASSERT(dataSize % mStride == 0);
+    mCount = dataSize / mStride;
+
+    // respecifying the whole buffer lets the driver give us fresh storage rather than
+    // waiting for draws that still use the old data
+    BindBuffer();
+    glBufferData(GL_ARRAY_BUFFER, dataSize, geomData, GL_STREAM_DRAW);
+    UnbindBuffer();
+}
+
 void VertexBuf::BindBuffer() {
     glBindBuffer(GL_ARRAY_BUFFER, mVbo);
 }
@@ -32,6 +32,9 @@ class VertexBuf {
         VertexBuf(GLfloat *geomData, int dataSize, int stride);
         ~VertexBuf();
 
+        // Replaces the contents of the buffer, for geometry that changes every frame.
+        void SetData(GLfloat *geomData, int dataSize);
+
         void BindBuffer();
         void UnbindBuffer();
 
@@ -0,0 +1,351 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <android/log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "gl-record.hpp"
+
+// Locations the shim gives the attributes and uniforms of the game's shaders
+static const GLint POSITION_LOC = 0, COLOR_LOC = 1, TEXCOORD_LOC = 2;
+static const GLint MVP_LOC = 0, TINT_LOC = 1, OTHER_UNIFORM_LOC = 2;
+static const int MAX_ATTRIBS = 3;
+
+struct Attrib {
+    bool enabled;
+    GLuint buffer;
+    GLint size;
+    GLsizei stride;
+    size_t offset;
+};
+
+struct Program {
+    float mvp[16];  // column-major
+    float tint[4];
+};
+
+GLRecord gGLRecord;
+
+static std::map<GLuint, std::vector<unsigned char> > sBuffers;
+static std::map<GLuint, Program> sPrograms;
+static std::set<GLenum> sEnabled;
+static GLuint sNextName = 1;
+static GLuint sArrayBuffer = 0, sElementBuffer = 0, sProgram = 0;
+static float sLineWidth = 1.0f;
+static Attrib sAttribs[MAX_ATTRIBS];
+
+static void Fail(const char *what) {
+    fprintf(stderr, "gl-record: %s\n", what);
+    exit(1);
+}
+
+static void CountCall() {
+    ++gGLRecord.counts.calls;
+}
+
+static Program *CurrentProgram() {
+    if (sProgram == 0 || sPrograms.find(sProgram) == sPrograms.end()) {
+        Fail("no program in use");
+    }
+    return &sPrograms[sProgram];
+}
+
+static std::vector<unsigned char> *BoundBuffer(GLenum target) {
+    GLuint name = target == GL_ARRAY_BUFFER ? sArrayBuffer : sElementBuffer;
+    if (name == 0 || sBuffers.find(name) == sBuffers.end()) {
+        Fail("no buffer bound");
+    }
+    return &sBuffers[name];
+}
+
+// Reads count floats of vertex index of an attribute, 0 0 0 1 for the missing ones
+static void FetchAttrib(const Attrib &a, int index, float *out) {
+    out[0] = out[1] = out[2] = 0.0f;
+    out[3] = 1.0f;
+    if (!a.enabled) {
+        Fail("draw with an attribute disabled");
+    }
+    const std::vector<unsigned char> &data = sBuffers[a.buffer];
+    size_t stride = a.stride ? a.stride : a.size * sizeof(float);
+    size_t start = a.offset + index * stride;
+    if (start + a.size * sizeof(float) > data.size()) {
+        Fail("vertex out of the buffer");
+    }
+    memcpy(out, &data[start], a.size * sizeof(float));
+}
+
+static void RecordVertex(int index) {
+    const Program *p = CurrentProgram();
+    float pos[4], color[4];
+    FetchAttrib(sAttribs[POSITION_LOC], index, pos);
+    FetchAttrib(sAttribs[COLOR_LOC], index, color);
+
+    float clip[4];
+    for (int row = 0; row < 4; ++row) {
+        clip[row] = 0.0f;
+        for (int k = 0; k < 4; ++k) {
+            clip[row] += p->mvp[k * 4 + row] * pos[k];
+        }
+    }
+    GLRecordVertex v;
+    v.x = clip[0] / clip[3];
+    v.y = clip[1] / clip[3];
+    v.z = clip[2] / clip[3];
+    v.r = color[0] * p->tint[0];
+    v.g = color[1] * p->tint[1];
+    v.b = color[2] * p->tint[2];
+    gGLRecord.lines.push_back(v);
+}
+
+static void RecordDraw(GLenum mode, int count, const GLushort *indices) {
+    GLRecordDraw draw;
+    draw.mode = mode;
+    draw.lineWidth = sLineWidth;
+    draw.lines = 0;
+    if (mode == GL_LINES) {
+        for (int i = 0; i < count - count % 2; ++i) {
+            RecordVertex(indices ? indices[i] : i);
+        }
+        draw.lines = count / 2;
+    }
+    ++gGLRecord.counts.draws;
+    gGLRecord.draws.push_back(draw);
+}
+
+void GLRecordReset() {
+    memset(&gGLRecord.counts, 0, sizeof(gGLRecord.counts));
+    gGLRecord.lines.clear();
+    gGLRecord.draws.clear();
+}
+
+int __android_log_print(int prio, const char *tag, const char *fmt, ...) {
+    return 0;
+}
+
+
+// Buffers.
+
+void glGenBuffers(GLsizei n, GLuint *buffers) {
+    CountCall();
+    for (int i = 0; i < n; ++i) {
+        buffers[i] = sNextName++;
+        sBuffers[buffers[i]];
+    }
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint *buffers) {
+    CountCall();
+    for (int i = 0; i < n; ++i) {
+        sBuffers.erase(buffers[i]);
+    }
+}
+
+void glBindBuffer(GLenum target, GLuint buffer) {
+    CountCall();
+    ++gGLRecord.counts.bufferBinds;
+    (target == GL_ARRAY_BUFFER ? sArrayBuffer : sElementBuffer) = buffer;
+}
+
+void glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+    CountCall();
+    ++gGLRecord.counts.bufferUploads;
+    std::vector<unsigned char> *buffer = BoundBuffer(target);
+    buffer->assign(size, 0);
+    if (data && size > 0) {
+        memcpy(buffer->data(), data, size);
+    }
+}
+
+
+// Shaders and programs, which always compile and link.
+
+GLuint glCreateShader(GLenum type) {
+    CountCall();
+    return sNextName++;
+}
+
+void glShaderSource(GLuint shader, GLsizei count, const GLchar *const *string,
+        const GLint *length) {
+    CountCall();
+}
+
+void glCompileShader(GLuint shader) {
+    CountCall();
+}
+
+void glGetShaderiv(GLuint shader, GLenum pname, GLint *params) {
+    CountCall();
+    *params = GL_TRUE;
+}
+
+void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog) {
+    CountCall();
+    if (bufSize > 0) {
+        infoLog[0] = '\0';
+    }
+}
+
+void glDeleteShader(GLuint shader) {
+    CountCall();
+}
+
+GLuint glCreateProgram() {
+    CountCall();
+    GLuint name = sNextName++;
+    Program &p = sPrograms[name];
+    memset(&p, 0, sizeof(p));
+    return name;
+}
+
+void glAttachShader(GLuint program, GLuint shader) {
+    CountCall();
+}
+
+void glLinkProgram(GLuint program) {
+    CountCall();
+}
+
+void glGetProgramiv(GLuint program, GLenum pname, GLint *params) {
+    CountCall();
+    *params = GL_TRUE;
+}
+
+void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog) {
+    CountCall();
+    if (bufSize > 0) {
+        infoLog[0] = '\0';
+    }
+}
+
+void glDeleteProgram(GLuint program) {
+    CountCall();
+    sPrograms.erase(program);
+}
+
+void glUseProgram(GLuint program) {
+    CountCall();
+    ++gGLRecord.counts.programBinds;
+    sProgram = program;
+}
+
+GLint glGetAttribLocation(GLuint program, const GLchar *name) {
+    CountCall();
+    std::string n(name);
+    return n == "a_Position" ? POSITION_LOC : n == "a_Color" ? COLOR_LOC :
+            n == "a_TexCoord" ? TEXCOORD_LOC : -1;
+}
+
+GLint glGetUniformLocation(GLuint program, const GLchar *name) {
+    CountCall();
+    std::string n(name);
+    return n == "u_MVP" ? MVP_LOC : n == "u_Tint" ? TINT_LOC : OTHER_UNIFORM_LOC;
+}
+
+void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose,
+        const GLfloat *value) {
+    CountCall();
+    ++gGLRecord.counts.uniforms;
+    if (location == MVP_LOC) {
+        memcpy(CurrentProgram()->mvp, value, sizeof(CurrentProgram()->mvp));
+    }
+}
+
+void glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {
+    CountCall();
+    ++gGLRecord.counts.uniforms;
+    if (location == TINT_LOC) {
+        float *tint = CurrentProgram()->tint;
+        tint[0] = v0, tint[1] = v1, tint[2] = v2, tint[3] = v3;
+    }
+}
+
+
+// Vertex attributes.
+
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+        GLsizei stride, const void *pointer) {
+    CountCall();
+    if (index >= (GLuint) MAX_ATTRIBS || type != GL_FLOAT) {
+        Fail("unexpected vertex attribute");
+    }
+    BoundBuffer(GL_ARRAY_BUFFER);
+    sAttribs[index].buffer = sArrayBuffer;
+    sAttribs[index].size = size;
+    sAttribs[index].stride = stride;
+    sAttribs[index].offset = (const char *) pointer - (const char *) NULL;
+}
+
+void glEnableVertexAttribArray(GLuint index) {
+    CountCall();
+    if (index >= (GLuint) MAX_ATTRIBS) {
+        Fail("unexpected vertex attribute");
+    }
+    sAttribs[index].enabled = true;
+}
+
+
+// Draw calls.
+
+void glDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    CountCall();
+    if (first != 0) {
+        Fail("glDrawArrays() from a first vertex");
+    }
+    RecordDraw(mode, count, NULL);
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) {
+    CountCall();
+    if (type != GL_UNSIGNED_SHORT) {
+        Fail("indices other than GL_UNSIGNED_SHORT");
+    }
+    const std::vector<unsigned char> *buffer = BoundBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    size_t offset = (const char *) indices - (const char *) NULL;
+    if (offset + count * sizeof(GLushort) > buffer->size()) {
+        Fail("indices out of the buffer");
+    }
+    std::vector<GLushort> copy(count);
+    memcpy(copy.data(), &(*buffer)[offset], count * sizeof(GLushort));
+    RecordDraw(mode, count, copy.data());
+}
+
+
+// Other state.
+
+void glEnable(GLenum cap) {
+    CountCall();
+    sEnabled.insert(cap);
+}
+
+void glDisable(GLenum cap) {
+    CountCall();
+    sEnabled.erase(cap);
+}
+
+GLboolean glIsEnabled(GLenum cap) {
+    CountCall();
+    return sEnabled.count(cap) ? GL_TRUE : GL_FALSE;
+}
+
+void glLineWidth(GLfloat width) {
+    CountCall();
+    sLineWidth = width;
+}
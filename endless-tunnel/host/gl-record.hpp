@@ -0,0 +1,61 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef endlesstunnel_host_gl_record_hpp
+#define endlesstunnel_host_gl_record_hpp
+
+#include <GLES2/gl2.h>
+
+#include <vector>
+
+/* Recording implementation of the OpenGL ES 2 calls of stubs/GLES2/gl2.h, for host checks.
+ * Nothing is rendered: the shim keeps the buffers, the vertex attributes and the uniforms of
+ * each program, and counts the calls. Each GL_LINES draw is recorded as the lines it would
+ * rasterize, run through the TrivialShader program: positions transformed by u_MVP, colors
+ * a_Color * u_Tint. */
+
+// One end of a recorded line, in normalized device coordinates
+struct GLRecordVertex {
+    float x, y, z;
+    float r, g, b;
+};
+
+struct GLRecordDraw {
+    GLenum mode;
+    float lineWidth;
+    int lines;  // recorded for GL_LINES only
+};
+
+struct GLRecordCounts {
+    long calls;          // every GL call
+    long draws;
+    long uniforms;       // glUniform*() calls
+    long bufferBinds;    // glBindBuffer() calls
+    long bufferUploads;  // glBufferData() calls
+    long programBinds;   // glUseProgram() calls
+};
+
+struct GLRecord {
+    GLRecordCounts counts;
+    std::vector<GLRecordVertex> lines;  // two vertices per line
+    std::vector<GLRecordDraw> draws;    // in order
+};
+
+extern GLRecord gGLRecord;
+
+// Clears the counts and the lines, the GL state is kept.
+void GLRecordReset();
+
+#endif
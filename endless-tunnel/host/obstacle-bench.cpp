@@ -0,0 +1,141 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// obstacle-bench: what obstacles cost the game.
+// - generate: ObstacleGenerator::Generate(), over all the difficulty levels;
+// - collide: the cell the ship is in and whether it has a box, as
+//   GameSim::DetectCollisions() does, at random places on random obstacles;
+// - shift: what the frame pays for the obstacle of a new section, with the
+//   obstacles generated on the spot and with the obstacle thread of
+//   ObstacleRing ahead of it (one section per -f frames of 1/60 s).
+//
+//   obstacle-bench [-n obstacles] [-q queries] [-f frames per section]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "obstacle_generator.hpp"
+#include "obstacle_ring.hpp"
+
+// Results of the timed loops go here, so that they aren't optimized away
+static volatile unsigned sink;
+
+static double NowNs() {
+    return std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Takes count obstacles from a ring, one section every framesPerSection frames, and
+// prints what each take cost the frame
+static void BenchShift(const char *name, bool thread, int count, int framesPerSection) {
+    ObstacleRing ring(1);
+    if (thread) {
+        ring.StartThread();
+    }
+    std::vector<double> ns;
+    Obstacle o;
+    unsigned sum = 0;
+    for (int section = 0; section < count; section++) {
+        double t0 = NowNs();
+        ring.Get(section, section / 50 % 13, &o);
+        ns.push_back(NowNs() - t0);
+        sum += o.boxes;
+        // the frames until the next section (at 60 Hz, or as fast as -f 0 allows)
+        if (framesPerSection > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(
+                    framesPerSection * 1000000 / 60));
+        }
+    }
+    std::sort(ns.begin(), ns.end());
+    sink = sum;
+    printf("  shift, %-9s median %6.0f ns, p99 %6.0f ns, max %6.0f ns; %d ready, %d not\n",
+            name, ns[ns.size() / 2], ns[ns.size() * 99 / 100], ns.back(), ring.GetHitCount(),
+            ring.GetMissCount());
+}
+
+int main(int argc, char **argv) {
+    int count = 2000000;
+    int queries = 50000000;
+    int framesPerSection = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:q:f:")) != -1) {
+        switch (opt) {
+            case 'n':
+                count = Max(1, atoi(optarg));
+                break;
+            case 'q':
+                queries = Max(1, atoi(optarg));
+                break;
+            case 'f':
+                framesPerSection = Max(0, atoi(optarg));
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n obstacles] [-q queries] [-f frames per section]\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+
+    // generate
+    ObstacleGenerator generator;
+    generator.Seed(1);
+    Obstacle o;
+    unsigned sum = 0;
+    double t0 = NowNs();
+    for (int i = 0; i < count; i++) {
+        generator.Generate(i, i % 13, &o);
+        sum += o.boxes + o.bonusCol;
+    }
+    double t1 = NowNs();
+    sink = sum;
+    printf("%zu bytes per obstacle\n", sizeof(Obstacle));
+    printf("  generate  %7.1f ns per obstacle\n", (t1 - t0) / count);
+
+    // collide
+    static const int OBSTACLES = 64, PLACES = 1024;
+    Obstacle obstacles[OBSTACLES];
+    for (int i = 0; i < OBSTACLES; i++) {
+        generator.Generate(i, i % 13, &obstacles[i]);
+    }
+    RandomGen random(7);
+    float xs[PLACES], zs[PLACES];
+    for (int i = 0; i < PLACES; i++) {
+        xs[i] = (random.Next(2001) - 1000) / 1000.0f * TUNNEL_HALF_W;
+        zs[i] = (random.Next(2001) - 1000) / 1000.0f * TUNNEL_HALF_H;
+    }
+    t0 = NowNs();
+    for (int i = 0; i < queries; i++) {
+        const Obstacle &q = obstacles[i % OBSTACLES];
+        int col = q.GetColAt(xs[i % PLACES]);
+        int row = q.GetRowAt(zs[(i >> 3) % PLACES]);
+        sum += q.HasBox(col, row);
+    }
+    t1 = NowNs();
+    sink = sum;
+    printf("  collide   %7.2f ns per query\n", (t1 - t0) / queries);
+
+    int shifts = Min(count, framesPerSection > 0 ? 600 : 200000);
+    BenchShift("inline", false, shifts, framesPerSection);
+    BenchShift("threaded", true, shifts, framesPerSection);
+    return 0;
+}
@@ -0,0 +1,390 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// text-draw-check: draws the text of three frames of the game through the recording GL shim
+// of gl-record.cpp, once with the former TextRenderer, which drew every glyph as its own
+// SimpleGeom, and once with the batched TextRenderer of the game:
+// - hud: the score and a sign, as PlayScene::RenderHUD() does,
+// - menu: the 3 items of the pause menu, as PlayScene::RenderMenu(),
+// - widgets: the 4 widgets of the welcome scene, as UiScene::DoFrame().
+// Each batch must be drawn with a single draw call, and draw the same lines in any order,
+// with the same colors and line width, as the former renderer, to within 1e-4. Outside a
+// batch, RenderText() must draw right away, once per call, and the depth test must be left
+// as it was. Prints the GL calls of both; exits with 1 if a check fails.
+//
+//   text-draw-check
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "ascii_to_geom.hpp"
+#include "game_consts.hpp"
+#include "gl-record.hpp"
+#include "text_renderer.hpp"
+#include "util.hpp"
+
+#include "alphabet.inl"
+#include "strings.inl"
+
+// Largest difference allowed between the coordinates or colors of two vertices
+#define VERTEX_TOLERANCE 1e-4f
+
+// Same as text_renderer.cpp
+#define ALPHABET_SCALE 0.01f
+#define CHAR_SPACING_F 0.1f
+#define LINE_SPACING_F 0.1f
+#define TEXT_LINE_WIDTH 4.0f
+#define CORRECTION_Y -0.02f
+
+// 1920x1080, the aspect ratio TextRenderer and the frames use
+#define SCREEN_WIDTH 1920
+#define SCREEN_HEIGHT 1080
+
+static const float MENUITEM_SEL_COLOR[] = { 1.0f, 1.0f, 0.0f };
+static const float MENUITEM_COLOR[] = { 1.0f, 1.0f, 1.0f };
+static const float TITLE_COLOR[] = { 0.0f, 1.0f, 0.0f };
+static const float BUTTON_COLOR[] = { 0.0f, 1.0f, 0.0f };
+static const float BUTTON_FOCUS_COLOR[] = { 1.0f, 1.0f, 0.0f };
+
+static int sFailures = 0;
+
+static void Check(bool ok, const char *frame, const char *what) {
+    if (!ok) {
+        printf("  %s: %s FAILED\n", frame, what);
+        ++sFailures;
+    }
+}
+
+// TextRenderer only asks the scene manager for the aspect ratio, so the check stands in for
+// scene_manager.cpp, which would bring in the whole game.
+SceneManager::SceneManager() {
+    mCurScene = NULL;
+    mScreenWidth = SCREEN_WIDTH;
+    mScreenHeight = SCREEN_HEIGHT;
+    mHasGraphics = true;
+    mSceneToInstall = NULL;
+}
+
+SceneManager* SceneManager::GetInstance() {
+    static SceneManager instance;
+    return &instance;
+}
+
+// TextRenderer before batching, as it was in text_renderer.cpp
+class LegacyTextRenderer {
+    private:
+        static const int CHAR_CODES = 128;
+        SimpleGeom *mCharGeom[CHAR_CODES];
+        TrivialShader *mTrivialShader;
+        float mFontScale;
+        float mColor[3];
+        glm::mat4 mMatrix;
+
+    public:
+        LegacyTextRenderer(TrivialShader *t) {
+            mTrivialShader = t;
+            memset(mCharGeom, 0, sizeof(mCharGeom));
+            mFontScale = 1.0f;
+            mMatrix = glm::mat4(1.0f);
+            mColor[0] = mColor[1] = mColor[2] = 1.0f;
+            for (int i = 0; i < CHAR_CODES; ++i) {
+                if (ALPHABET_ART[i]) {
+                    mCharGeom[i] = AsciiArtToGeom(ALPHABET_ART[i], ALPHABET_SCALE);
+                }
+            }
+        }
+
+        ~LegacyTextRenderer() {
+            for (int i = 0; i < CHAR_CODES; i++) {
+                CleanUp(&mCharGeom[i]);
+            }
+        }
+
+        // it had no batches
+        LegacyTextRenderer* BeginBatch() { return this; }
+        LegacyTextRenderer* EndBatch() { return this; }
+
+        LegacyTextRenderer* SetFontScale(float scale) {
+            mFontScale = scale;
+            return this;
+        }
+        LegacyTextRenderer* SetMatrix(glm::mat4 m) {
+            mMatrix = m;
+            return this;
+        }
+        LegacyTextRenderer* ResetMatrix() {
+            return SetMatrix(glm::mat4(1.0f));
+        }
+        void SetColor(const float *c) {
+            mColor[0] = c[0], mColor[1] = c[1], mColor[2] = c[2];
+        }
+        void ResetColor() {
+            mColor[0] = mColor[1] = mColor[2] = 1.0f;
+        }
+
+        LegacyTextRenderer* RenderText(const char *str, float centerX, float centerY) {
+            float aspect = SceneManager::GetInstance()->GetScreenAspect();
+            glm::mat4 orthoMat = glm::ortho(0.0f, aspect, 0.0f, 1.0f);
+            glm::mat4 modelMat, mat, scaleMat;
+            bool hadDepthTest;
+
+            centerY += CORRECTION_Y * mFontScale;
+
+            glLineWidth(TEXT_LINE_WIDTH);
+
+            hadDepthTest = glIsEnabled(GL_DEPTH_TEST);
+            glDisable(GL_DEPTH_TEST);
+
+            mTrivialShader->SetTintColor(mColor[0], mColor[1], mColor[2]);
+
+            int cols = 0, rows = 1, curCols = 0;
+            for (const char *p = str; *p; ++p) {
+                if (*p == '\n') {
+                    ++rows;
+                    curCols = 0;
+                } else if (++curCols > cols) {
+                    cols = curCols;
+                }
+            }
+            scaleMat = glm::scale(glm::mat4(1.0f), glm::vec3(mFontScale, mFontScale, 1.0f));
+            float charWidth = ALPHABET_GLYPH_COLS * ALPHABET_SCALE * mFontScale;
+            float charHeight = ALPHABET_GLYPH_ROWS * ALPHABET_SCALE * mFontScale;
+            float charSpacing = CHAR_SPACING_F * charWidth;
+            float lineSpacing = LINE_SPACING_F * charHeight;
+            float width = cols * charWidth + (cols - 1) * charSpacing;
+            float height = rows * charHeight + (rows - 1) * lineSpacing;
+            float startX = centerX - width * 0.5f + 0.5f * charWidth;
+            float startY = centerY + height * 0.5f - 0.5f * charHeight;
+            float y = startY;
+
+            modelMat = glm::translate(glm::mat4(1.0f), glm::vec3(startX, startY, 0.0f));
+            for (; *str; ++str) {
+                if (*str == '\n') {
+                    y -= charHeight + lineSpacing;
+                    modelMat = glm::translate(glm::mat4(1.0f), glm::vec3(startX, y, 0.0f));
+                } else {
+                    int code = (int) *str;
+                    if (code >= 0 && code < CHAR_CODES && mCharGeom[code]) {
+                        mat = orthoMat * modelMat * scaleMat * mMatrix;
+                        mTrivialShader->RenderSimpleGeom(&mat, mCharGeom[code]);
+                    }
+                    modelMat = glm::translate(modelMat,
+                            glm::vec3(charWidth + charSpacing, 0.0f, 0.0f));
+                }
+            }
+
+            glLineWidth(1);
+            if (hadDepthTest) {
+                glEnable(GL_DEPTH_TEST);
+            }
+            return this;
+        }
+};
+
+// The text of the frames, with the renderer's batches when batched is set. Returns the
+// number of RenderText() calls.
+
+template <class Renderer> static int DrawHud(Renderer *r, bool batched) {
+    float aspect = SceneManager::GetInstance()->GetScreenAspect();
+    if (batched) r->BeginBatch();
+    r->SetFontScale(SCORE_FONT_SCALE);
+    r->RenderText("01250", SCORE_POS_X, SCORE_POS_Y);
+
+    // the sign half way through its animation
+    r->SetMatrix(glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 0.5f, 1.0f)));
+    r->SetFontScale(SIGN_FONT_SCALE);
+    r->RenderText(S_CHECKPOINT_SAVED, aspect * 0.5f, 0.5f);
+    r->ResetMatrix();
+    if (batched) r->EndBatch();
+    return 2;
+}
+
+template <class Renderer> static int DrawMenu(Renderer *r, bool batched) {
+    static const char *items[] = { S_UNPAUSE, S_START_OVER, S_QUIT };
+    const int count = sizeof(items) / sizeof(items[0]);
+    const int sel = 0;
+    const float pulse = 1.05f;
+    float aspect = SceneManager::GetInstance()->GetScreenAspect();
+
+    if (batched) r->BeginBatch();
+    for (int i = 0; i < count; i++) {
+        float y = 1.0f - (i + 1) / ((float)count + 1);
+        r->SetFontScale((sel == i ? pulse : 1.0f) * MENUITEM_FONT_SCALE);
+        r->SetColor(sel == i ? MENUITEM_SEL_COLOR : MENUITEM_COLOR);
+        r->RenderText(items[i], aspect * 0.5f, y);
+    }
+    if (batched) r->EndBatch();
+    r->ResetColor();
+    return count;
+}
+
+template <class Renderer> static int DrawWidgets(Renderer *r, bool batched) {
+    // as laid out by WelcomeScene, with the play button in focus
+    float center = 0.5f * SceneManager::GetInstance()->GetScreenAspect();
+    float sideWidth = center - 0.4f;
+    struct {
+        const char *text;
+        float x, y, fontScale;
+        const float *color;
+    } widgets[] = {
+        { S_TITLE, center, 0.85f, 1.0f, TITLE_COLOR },
+        { S_PLAY, center, 0.5f, 1.0f, BUTTON_FOCUS_COLOR },
+        { S_STORY, 0.1f + 0.5f * sideWidth, 0.5f, 0.5f, BUTTON_COLOR },
+        { S_ABOUT, center + 0.3f + 0.5f * sideWidth, 0.5f, 0.5f, BUTTON_COLOR },
+    };
+    const int count = sizeof(widgets) / sizeof(widgets[0]);
+
+    if (batched) r->BeginBatch();
+    for (int i = 0; i < count; ++i) {
+        r->SetColor(widgets[i].color);
+        r->SetFontScale(widgets[i].fontScale);
+        r->RenderText(widgets[i].text, widgets[i].x, widgets[i].y);
+    }
+    if (batched) r->EndBatch();
+    r->ResetColor();
+    return count;
+}
+
+static bool SameVertex(const GLRecordVertex &a, const GLRecordVertex &b) {
+    return fabsf(a.x - b.x) <= VERTEX_TOLERANCE && fabsf(a.y - b.y) <= VERTEX_TOLERANCE &&
+            fabsf(a.z - b.z) <= VERTEX_TOLERANCE && fabsf(a.r - b.r) <= VERTEX_TOLERANCE &&
+            fabsf(a.g - b.g) <= VERTEX_TOLERANCE && fabsf(a.b - b.b) <= VERTEX_TOLERANCE;
+}
+
+// Same line, either way round
+static bool SameLine(const GLRecordVertex *a, const GLRecordVertex *b) {
+    return (SameVertex(a[0], b[0]) && SameVertex(a[1], b[1])) ||
+            (SameVertex(a[0], b[1]) && SameVertex(a[1], b[0]));
+}
+
+// Returns the number of lines of expected with no match in actual.
+static int CompareLines(const GLRecord &expected, const GLRecord &actual) {
+    int lines = (int) expected.lines.size() / 2, missing = 0;
+    std::vector<bool> matched(actual.lines.size() / 2, false);
+
+    for (int e = 0; e < lines; ++e) {
+        int a;
+        for (a = 0; a < (int) matched.size(); ++a) {
+            if (!matched[a] && SameLine(&expected.lines[e * 2], &actual.lines[a * 2])) {
+                matched[a] = true;
+                break;
+            }
+        }
+        if (a == (int) matched.size()) {
+            ++missing;
+        }
+    }
+    return missing;
+}
+
+static bool AllLinesOfWidth(const GLRecord &record, float width) {
+    for (size_t i = 0; i < record.draws.size(); ++i) {
+        if (record.draws[i].mode != GL_LINES || record.draws[i].lineWidth != width) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void PrintCounts(const char *frame, const char *renderer, const GLRecordCounts &c) {
+    printf("  %-8s %-8s %8ld %6ld %9ld %13ld %8ld %14ld\n", frame, renderer, c.calls,
+            c.draws, c.uniforms, c.bufferBinds, c.bufferUploads, c.programBinds);
+}
+
+template <class Renderer> static GLRecord Record(Renderer *r,
+        int (*draw)(Renderer *, bool), bool batched, int *texts) {
+    glEnable(GL_DEPTH_TEST);
+    GLRecordReset();
+    *texts = draw(r, batched);
+    GLRecord record = gGLRecord;
+    if (!glIsEnabled(GL_DEPTH_TEST)) {
+        record.counts.calls = -1;  // flagged below
+    }
+    return record;
+}
+
+struct Frame {
+    const char *name;
+    int (*legacy)(LegacyTextRenderer *, bool);
+    int (*current)(TextRenderer *, bool);
+};
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        fprintf(stderr, "usage: %s\n", argv[0]);
+        return 1;
+    }
+
+    TrivialShader shader;
+    shader.Compile();
+    LegacyTextRenderer legacy(&shader);
+    TextRenderer current(&shader);
+
+    const Frame frames[] = {
+        { "hud", DrawHud<LegacyTextRenderer>, DrawHud<TextRenderer> },
+        { "menu", DrawMenu<LegacyTextRenderer>, DrawMenu<TextRenderer> },
+        { "widgets", DrawWidgets<LegacyTextRenderer>, DrawWidgets<TextRenderer> },
+    };
+    GLRecordCounts totals[2];
+    memset(totals, 0, sizeof(totals));
+    long vertices = 0;
+
+    printf("  %-8s %-8s %8s %6s %9s %13s %8s %14s\n", "frame", "renderer", "GL calls",
+            "draws", "uniforms", "buffer binds", "uploads", "program binds");
+    for (size_t f = 0; f < sizeof(frames) / sizeof(frames[0]); ++f) {
+        const char *name = frames[f].name;
+        int texts;
+        GLRecord former = Record(&legacy, frames[f].legacy, false, &texts);
+        GLRecord batched = Record(&current, frames[f].current, true, &texts);
+        GLRecord unbatched = Record(&current, frames[f].current, false, &texts);
+
+        Check(former.counts.calls >= 0 && batched.counts.calls >= 0 &&
+                unbatched.counts.calls >= 0, name, "depth test left disabled");
+        Check(batched.counts.draws == 1, name, "one draw for the batch");
+        Check(unbatched.counts.draws == texts, name, "one draw per RenderText() unbatched");
+        Check(!former.lines.empty() && batched.lines.size() == former.lines.size() &&
+                CompareLines(former, batched) == 0, name, "same lines as the former renderer");
+        Check(unbatched.lines.size() == former.lines.size() &&
+                CompareLines(former, unbatched) == 0, name, "same lines unbatched");
+        Check(AllLinesOfWidth(former, TEXT_LINE_WIDTH) &&
+                AllLinesOfWidth(batched, TEXT_LINE_WIDTH) &&
+                AllLinesOfWidth(unbatched, TEXT_LINE_WIDTH), name, "lines 4 pixels wide");
+
+        PrintCounts(name, "former", former.counts);
+        PrintCounts(name, "batched", batched.counts);
+        const GLRecordCounts *counts[2] = { &former.counts, &batched.counts };
+        for (int i = 0; i < 2; ++i) {
+            totals[i].calls += counts[i]->calls;
+            totals[i].draws += counts[i]->draws;
+            totals[i].uniforms += counts[i]->uniforms;
+            totals[i].bufferBinds += counts[i]->bufferBinds;
+            totals[i].bufferUploads += counts[i]->bufferUploads;
+            totals[i].programBinds += counts[i]->programBinds;
+        }
+        vertices += (long) batched.lines.size();
+    }
+    PrintCounts("total", "former", totals[0]);
+    PrintCounts("total", "batched", totals[1]);
+    printf("3 frames of text, %ld line vertices\n", vertices);
+
+    if (sFailures) {
+        printf("%d checks FAILED\n", sFailures);
+    }
+    return sFailures != 0;
+}
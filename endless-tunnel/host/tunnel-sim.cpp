@@ -0,0 +1,319 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// tunnel-sim: plays games of GameSim headless, as fast as it can, with a bot
+// at the controls. Each game is seeded by its number, so any of them can be
+// replayed with -s. After every step the state is checked against invariants
+// of the game, and a fingerprint of how all the games ended is printed: when
+// the logic changes, the fingerprint does, and -x turns that into a failure.
+//
+//   tunnel-sim [-n games] [-s first seed] [-b auto|random] [-e error %]
+//              [-t max seconds] [-x fingerprint] [-g] [-v]
+//
+// -b auto steers (by touch) for the bonus or a free cell of the next obstacle,
+//    picking a random cell instead for -e percent of the obstacles;
+//    random moves the joystick at random twice a second.
+// -g generates the obstacles on a thread, as the game does; the fingerprint must
+//    not change.
+// -v prints what happens during each game.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+
+#include "game_sim.hpp"
+
+static const int BOT_AUTO = 0, BOT_RANDOM = 1;
+
+// Steers the ship the way a player might, from its own random numbers
+class Bot {
+    private:
+        int mKind;
+        int mErrorPercent;
+        RandomGen mRandom;
+        int mTargetSection; // section of the obstacle mInput aims at
+        SimInput mInput;
+
+    public:
+        Bot(int kind, int errorPercent, uint32_t seed) : mRandom(seed) {
+            mKind = kind;
+            mErrorPercent = errorPercent;
+            mTargetSection = -1;
+            memset(&mInput, 0, sizeof(mInput));
+        }
+
+        const SimInput& Play(const GameSim &sim) {
+            if (mKind == BOT_RANDOM) {
+                if (sim.GetStepCount() % (int)(0.5f / SIM_TIMESTEP) == 0) {
+                    mInput.steering = GameSim::STEERING_JOY;
+                    mInput.steerX = JOYSTICK_CONTROL_SENSIVITY * (mRandom.Next(201) - 100) / 100;
+                    mInput.steerZ = JOYSTICK_CONTROL_SENSIVITY * (mRandom.Next(201) - 100) / 100;
+                }
+                return mInput;
+            }
+
+            // the first obstacle the ship has not reached yet
+            float playerY = sim.GetPlayerPos().y;
+            int i = 0;
+            while (i < sim.GetObstacleCount() - 1 && playerY >= GameSim::GetSectionCenterY(
+                    sim.GetFirstSection() + i) - OBS_BOX_SIZE) {
+                i++;
+            }
+            int section = sim.GetFirstSection() + i;
+            if (section == mTargetSection) {
+                return mInput;
+            }
+            mTargetSection = section;
+
+            const Obstacle *o = sim.GetObstacleAt(i);
+            int col = -1, row = -1;
+            if (mRandom.Next(100) < mErrorPercent) {
+                col = mRandom.Next(OBS_GRID_SIZE);
+                row = mRandom.Next(OBS_GRID_SIZE);
+            } else if (o->bonusCol >= 0 && !o->HasBox(o->bonusCol, o->bonusRow)) {
+                col = o->bonusCol;
+                row = o->bonusRow;
+            } else {
+                // the free cell closest to the ship
+                int c0 = o->GetColAt(sim.GetPlayerPos().x);
+                int r0 = o->GetRowAt(sim.GetPlayerPos().z);
+                int best = -1;
+                for (int c = 0; c < OBS_GRID_SIZE; c++) {
+                    for (int r = 0; r < OBS_GRID_SIZE; r++) {
+                        int d = (c - c0) * (c - c0) + (r - r0) * (r - r0);
+                        if (!o->HasBox(c, r) && (best < 0 || d < best)) {
+                            best = d;
+                            col = c;
+                            row = r;
+                        }
+                    }
+                }
+                if (best < 0) {
+                    col = c0;
+                    row = r0;
+                }
+            }
+            glm::vec3 center = o->GetBoxCenter(col, row, 0.0f);
+            mInput.steering = GameSim::STEERING_TOUCH;
+            mInput.steerX = center.x;
+            mInput.steerZ = center.z;
+            return mInput;
+        }
+};
+
+// Returns what is wrong with the state of the game, if anything
+static const char* CheckInvariants(const GameSim &sim) {
+    const glm::vec3 &pos = sim.GetPlayerPos();
+    if (!std::isfinite(pos.x) || !std::isfinite(pos.y) || !std::isfinite(pos.z)) {
+        return "player position is not finite";
+    }
+    if (pos.x < PLAYER_MIN_X || pos.x > PLAYER_MAX_X ||
+            pos.z < PLAYER_MIN_Z || pos.z > PLAYER_MAX_Z) {
+        return "player left the tunnel";
+    }
+    if (pos.y > GameSim::GetSectionEndY(sim.GetFirstSection()) + SHIFT_THRESH) {
+        return "tunnel sections were not shifted";
+    }
+    if (sim.GetObstacleCount() != GameSim::MAX_OBS) {
+        return "obstacles were not generated";
+    }
+    if (sim.GetLives() < 0 || sim.GetLives() > PLAYER_LIVES) {
+        return "lives out of range";
+    }
+    if (sim.GetScore() < 0 || sim.GetScore() % BONUS_POINTS != 0) {
+        return "score is not a number of bonuses";
+    }
+    if (sim.GetDifficulty() != sim.GetScore() / SCORE_PER_LEVEL) {
+        return "difficulty does not match the score";
+    }
+    return NULL;
+}
+
+struct GameResult {
+    unsigned steps;
+    int score;
+    int difficulty;
+    int sections;
+    uint64_t hash;
+    const char *failure; // broken invariant, NULL if none
+    int obstaclesReady, obstaclesLate; // taken from the obstacle thread, or generated
+};
+
+static uint64_t Hash(uint64_t hash, const void *data, size_t size) {
+    // FNV-1a
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static GameResult PlayGame(uint32_t seed, int botKind, int errorPercent, unsigned maxSteps,
+        bool obstacleThread, bool verbose) {
+    GameSim sim(seed);
+    if (obstacleThread) {
+        sim.StartObstacleThread();
+    }
+    Bot bot(botKind, errorPercent, seed ^ 0x5bd1e995u);
+    GameResult result;
+    result.failure = NULL;
+    while (sim.GetLives() > 0 && sim.GetStepCount() < maxSteps) {
+        int events = sim.Step(bot.Play(sim));
+        result.failure = CheckInvariants(sim);
+        if (result.failure) {
+            break;
+        }
+        if (verbose && (events & ~GameSim::EVENT_AMBIENT)) {
+            printf("  %8.2f s  section %4d  %s%s%s  score %5d  lives %d\n",
+                    sim.GetStepCount() * SIM_TIMESTEP, sim.GetFirstSection(),
+                    (events & GameSim::EVENT_CRASHED) ? "crash" : "bonus",
+                    (events & GameSim::EVENT_LEVEL_UP) ? ", level up" : "",
+                    (events & GameSim::EVENT_GAME_OVER) ? ", game over" : "",
+                    sim.GetScore(), sim.GetLives());
+        }
+    }
+
+    result.steps = sim.GetStepCount();
+    result.score = sim.GetScore();
+    result.difficulty = sim.GetDifficulty();
+    result.sections = sim.GetFirstSection();
+    result.obstaclesReady = sim.GetObstacleRing().GetHitCount();
+    result.obstaclesLate = sim.GetObstacleRing().GetMissCount();
+    int lives = sim.GetLives();
+    glm::vec3 pos = sim.GetPlayerPos();
+    float roll = sim.GetRollAngle();
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = Hash(hash, &result.steps, sizeof(result.steps));
+    hash = Hash(hash, &result.score, sizeof(result.score));
+    hash = Hash(hash, &result.sections, sizeof(result.sections));
+    hash = Hash(hash, &lives, sizeof(lives));
+    hash = Hash(hash, &pos[0], sizeof(float) * 3);
+    hash = Hash(hash, &roll, sizeof(roll));
+    result.hash = hash;
+    return result;
+}
+
+int main(int argc, char **argv) {
+    int games = 1000;
+    uint32_t firstSeed = 1;
+    int botKind = BOT_AUTO;
+    int errorPercent = 10;
+    float maxSeconds = 600.0f;
+    const char *expected = NULL;
+    bool obstacleThread = false;
+    bool verbose = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:b:e:t:x:gv")) != -1) {
+        switch (opt) {
+            case 'n':
+                games = Max(1, atoi(optarg));
+                break;
+            case 's':
+                firstSeed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                botKind = strcmp(optarg, "random") == 0 ? BOT_RANDOM : BOT_AUTO;
+                break;
+            case 'e':
+                errorPercent = Clamp(atoi(optarg), 0, 100);
+                break;
+            case 't':
+                maxSeconds = (float)atof(optarg);
+                break;
+            case 'x':
+                expected = optarg;
+                break;
+            case 'g':
+                obstacleThread = true;
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n games] [-s first seed] [-b auto|random] "
+                        "[-e error %%] [-t max seconds] [-x fingerprint] [-g] [-v]\n", argv[0]);
+                return 1;
+        }
+    }
+    unsigned maxSteps = (unsigned)(maxSeconds / SIM_TIMESTEP);
+
+    uint64_t fingerprint = 0xcbf29ce484222325ull;
+    uint64_t totalSteps = 0;
+    double totalScore = 0.0, totalSections = 0.0;
+    int maxScore = 0, maxDifficulty = 0;
+    uint64_t firstHash = 0;
+    uint64_t obstaclesReady = 0, obstaclesLate = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < games; i++) {
+        uint32_t seed = firstSeed + i;
+        if (verbose) {
+            printf("game %u\n", seed);
+        }
+        GameResult r = PlayGame(seed, botKind, errorPercent, maxSteps, obstacleThread, verbose);
+        if (r.failure) {
+            printf("FAILED: game %u, step %u: %s (replay with -s %u -n 1 -v)\n", seed,
+                    r.steps, r.failure, seed);
+            return 1;
+        }
+        if (i == 0) {
+            firstHash = r.hash;
+        }
+        fingerprint = Hash(fingerprint, &r.hash, sizeof(r.hash));
+        totalSteps += r.steps;
+        totalScore += r.score;
+        totalSections += r.sections;
+        maxScore = Max(maxScore, r.score);
+        maxDifficulty = Max(maxDifficulty, r.difficulty);
+        obstaclesReady += r.obstaclesReady;
+        obstaclesLate += r.obstaclesLate;
+    }
+    double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - t0).count();
+
+    // the same seed must play the same game
+    bool deterministic = PlayGame(firstSeed, botKind, errorPercent, maxSteps, false,
+            false).hash == firstHash;
+
+    printf("%d games, seeds %u..%u, %s bot", games, firstSeed, firstSeed + games - 1,
+            botKind == BOT_RANDOM ? "random" : "auto");
+    if (botKind == BOT_AUTO) {
+        printf(" (%d%% errors)", errorPercent);
+    }
+    printf("\n  %.0f s of play in %.1f ms: %.0f games/s, %.2f M steps/s (%.0f ns/step)\n",
+            totalSteps * SIM_TIMESTEP, ms, games * 1000.0 / ms, totalSteps / ms / 1000.0,
+            ms * 1e6 / totalSteps);
+    printf("  score mean %.0f, max %d; difficulty max %d; sections mean %.1f\n",
+            totalScore / games, maxScore, maxDifficulty, totalSections / games);
+    if (obstacleThread) {
+        printf("  obstacles: %llu taken from the thread, %llu generated on the spot\n",
+                (unsigned long long)obstaclesReady, (unsigned long long)obstaclesLate);
+    }
+    printf("  fingerprint %016llx\n", (unsigned long long)fingerprint);
+    if (!deterministic) {
+        printf("FAILED: replaying game %u gave a different game\n", firstSeed);
+        return 1;
+    }
+    if (expected && strtoull(expected, NULL, 16) != fingerprint) {
+        printf("FAILED: expected fingerprint %s\n", expected);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "helloneon-threads.h"
+
+struct fir_pool {
+    pthread_t*       workers;
+    int              numThreads;
+
+    pthread_mutex_t  lock;
+    pthread_cond_t   startCond;
+    pthread_cond_t   doneCond;
+    unsigned         generation;   /* bumped for every new job */
+    int              busyWorkers;  /* workers still inside the current job */
+    int              quit;
+
+    /* current job, only written while no worker is busy */
+    fir_filter_func  filter;
+    short*           output;
+    const short*     input;
+    const short*     kernel;
+    int              width;
+    int              kernelSize;
+    int              numChunks;
+    atomic_int       nextChunk;
+};
+
+/* Grab chunks until the job is exhausted. Output ranges never overlap and
+ * inputs are read-only, so no further synchronization is needed here.
+ */
+static void
+fir_pool_drain(fir_pool* pool)
+{
+    for (;;) {
+        int chunk = atomic_fetch_add_explicit(&pool->nextChunk, 1,
+                                              memory_order_relaxed);
+        int start, count;
+        if (chunk >= pool->numChunks)
+            break;
+        start = chunk * FIR_CHUNK_SIZE;
+        count = pool->width - start;
+        if (count > FIR_CHUNK_SIZE)
+            count = FIR_CHUNK_SIZE;
+        pool->filter(pool->output + start, pool->input + start,
+                     pool->kernel, count, pool->kernelSize);
+    }
+}
+
+static void*
+fir_pool_worker(void* arg)
+{
+    fir_pool* pool = (fir_pool*)arg;
+    unsigned  seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->quit && pool->generation == seen)
+            pthread_cond_wait(&pool->startCond, &pool->lock);
+        if (pool->quit)
+            break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        fir_pool_drain(pool);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busyWorkers == 0)
+            pthread_cond_signal(&pool->doneCond);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+fir_pool*
+fir_pool_create(int numThreads)
+{
+    fir_pool* pool;
+    int       nn;
+
+    if (numThreads < 1)
+        numThreads = 1;
+
+    pool = calloc(1, sizeof(*pool));
+    if (pool == NULL)
+        return NULL;
+
+    pool->workers = calloc(numThreads, sizeof(pthread_t));
+    if (pool->workers == NULL) {
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->startCond, NULL);
+    pthread_cond_init(&pool->doneCond, NULL);
+    atomic_init(&pool->nextChunk, 0);
+
+    /* The calling thread is worker #0 */
+    pool->numThreads = 1;
+    for (nn = 1; nn < numThreads; nn++) {
+        if (pthread_create(&pool->workers[nn], NULL, fir_pool_worker, pool) != 0)
+            break;
+        pool->numThreads++;
+    }
+    return pool;
+}
+
+void
+fir_pool_destroy(fir_pool* pool)
+{
+    int nn;
+
+    if (pool == NULL)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = 1;
+    pthread_cond_broadcast(&pool->startCond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (nn = 1; nn < pool->numThreads; nn++)
+        pthread_join(pool->workers[nn], NULL);
+
+    pthread_cond_destroy(&pool->doneCond);
+    pthread_cond_destroy(&pool->startCond);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool);
+}
+
+int
+fir_pool_threads(const fir_pool* pool)
+{
+    return pool->numThreads;
+}
+
+void
+fir_filter_parallel(fir_pool* pool, fir_filter_func filter,
+                    short *output, const short* input,
+                    const short* kernel, int width, int kernelSize)
+{
+    int numChunks = (width + FIR_CHUNK_SIZE - 1) / FIR_CHUNK_SIZE;
+
+    /* Not worth waking anybody up */
+    if (pool->numThreads == 1 || numChunks <= 1) {
+        filter(output, input, kernel, width, kernelSize);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->filter     = filter;
+    pool->output     = output;
+    pool->input      = input;
+    pool->kernel     = kernel;
+    pool->width      = width;
+    pool->kernelSize = kernelSize;
+    pool->numChunks  = numChunks;
+    atomic_store_explicit(&pool->nextChunk, 0, memory_order_relaxed);
+    pool->busyWorkers = pool->numThreads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->startCond);
+    pthread_mutex_unlock(&pool->lock);
+
+    fir_pool_drain(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busyWorkers > 0)
+        pthread_cond_wait(&pool->doneCond, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef HELLONEON_THREADS_H
+#define HELLONEON_THREADS_H
+
+/* Signature shared by fir_filter_c and fir_filter_neon_intrinsics.
+ * 'input' must be readable from input[-kernelSize/2] up to
+ * input[width - kernelSize/2 + kernelSize - 1].
+ */
+typedef void (*fir_filter_func)(short *output, const short* input,
+                                const short* kernel, int width, int kernelSize);
+
+/* Number of output samples handled by one work item. 4096 shorts of output
+ * plus the same amount of input stay well inside a 32KB L1 data cache.
+ */
+#define FIR_CHUNK_SIZE  4096
+
+typedef struct fir_pool fir_pool;
+
+/* Create a pool that runs filters on 'numThreads' threads in total, the
+ * calling thread included (so numThreads-1 workers are spawned).
+ * Returns NULL on failure.
+ */
+fir_pool* fir_pool_create(int numThreads);
+void      fir_pool_destroy(fir_pool* pool);
+int       fir_pool_threads(const fir_pool* pool);
+
+/* Run 'filter' over 'width' output samples, split into FIR_CHUNK_SIZE
+ * chunks distributed over the pool. Every chunk reads its own kernel-length
+ * halo straight from 'input', so the result is bit-identical to a single
+ * filter(output, input, kernel, width, kernelSize) call.
+ * Blocks until the whole range has been written.
+ */
+void fir_filter_parallel(fir_pool* pool, fir_filter_func filter,
+                         short *output, const short* input,
+                         const short* kernel, int width, int kernelSize);
+
+#endif /* HELLONEON_THREADS_H */
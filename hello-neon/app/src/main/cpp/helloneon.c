@@ -22,6 +22,7 @@
 
 #include <cpu-features.h>
 #include "helloneon-intrinsics.h"
+#include "helloneon-threads.h"
 
 #define DEBUG 0
 
@@ -72,6 +73,81 @@ static short        fir_input_0[FIR_INPUT_SIZE];
 static const short* fir_input = fir_input_0 + (FIR_KERNEL_SIZE/2);
 static short        fir_output_expected[FIR_OUTPUT_SIZE];
 
+/* one minute of 48kHz audio, processed through fir_filter_parallel() */
+#define  FIR_LONG_OUTPUT_SIZE  (48000*60)
+#define  FIR_LONG_INPUT_SIZE   (FIR_LONG_OUTPUT_SIZE + FIR_KERNEL_SIZE)
+#define  FIR_LONG_ITERATIONS   4
+
+/* Benchmark 'filter' over a long signal with 1 to all cores and append the
+ * timings to 'buffer'. Every run is compared against the serial output.
+ */
+static void
+fir_benchmark_threads(char* buffer, size_t size, fir_filter_func filter)
+{
+    short*  input_0  = malloc(FIR_LONG_INPUT_SIZE * sizeof(short));
+    short*  output   = malloc(FIR_LONG_OUTPUT_SIZE * sizeof(short));
+    short*  expected = malloc(FIR_LONG_OUTPUT_SIZE * sizeof(short));
+    const short* input = input_0 + (FIR_KERNEL_SIZE/2);
+    int     cores = android_getCpuCount();
+    int     threads, nn;
+    double  t0, time_serial = 0.;
+    char*   str;
+
+    if (input_0 == NULL || output == NULL || expected == NULL) {
+        strlcat(buffer, "Out of memory for threaded benchmark\n", size);
+        goto EXIT;
+    }
+
+    for (nn = 0; nn < FIR_LONG_INPUT_SIZE; nn++) {
+        input_0[nn] = (5*nn) & 255;
+    }
+    filter(expected, input, fir_kernel, FIR_LONG_OUTPUT_SIZE, FIR_KERNEL_SIZE);
+
+    asprintf(&str, "\nThreaded FIR, %d samples:\n", FIR_LONG_OUTPUT_SIZE);
+    strlcat(buffer, str, size);
+    free(str);
+
+    for (threads = 1; threads <= cores; threads++) {
+        fir_pool* pool = fir_pool_create(threads);
+        double    time_mt;
+        int       count, fails = 0;
+
+        if (pool == NULL)
+            break;
+
+        memset(output, 0, FIR_LONG_OUTPUT_SIZE * sizeof(short));
+        t0 = now_ms();
+        for (count = FIR_LONG_ITERATIONS; count > 0; count--) {
+            fir_filter_parallel(pool, filter, output, input, fir_kernel,
+                                FIR_LONG_OUTPUT_SIZE, FIR_KERNEL_SIZE);
+        }
+        time_mt = now_ms() - t0;
+        if (threads == 1)
+            time_serial = time_mt;
+
+        if (memcmp(output, expected, FIR_LONG_OUTPUT_SIZE * sizeof(short)) != 0) {
+            for (nn = 0; nn < FIR_LONG_OUTPUT_SIZE; nn++) {
+                if (output[nn] != expected[nn] && ++fails < 16)
+                    D("mt[%d] = %d expected %d", nn, output[nn], expected[nn]);
+            }
+        }
+
+        asprintf(&str, "%2d thread(s)   : %g ms (x%g)%s\n",
+                 fir_pool_threads(pool), time_mt,
+                 time_serial / (time_mt < 1e-6 ? 1. : time_mt),
+                 fails ? " MISMATCH" : "");
+        strlcat(buffer, str, size);
+        free(str);
+
+        fir_pool_destroy(pool);
+    }
+
+EXIT:
+    free(expected);
+    free(output);
+    free(input_0);
+}
+
 /* This is a trivial JNI example where we use a native method
  * to return a new VM String. See the corresponding Java source
  * file located at:
@@ -85,8 +161,9 @@ Java_com_example_helloneon_HelloNeon_stringFromJNI( JNIEnv* env,
     char*  str;
     AndroidCpuFamily family;
     uint64_t features;
-    char buffer[512];
+    char buffer[1024];
     double  t0, t1, time_c, time_neon;
+    fir_filter_func fastest = fir_filter_c;
 
     /* setup FIR input - whatever */
     {
@@ -152,6 +229,7 @@ Java_com_example_helloneon_HelloNeon_stringFromJNI( JNIEnv* env,
     asprintf(&str, "%g ms (x%g faster)\n", time_neon, time_c / (time_neon < 1e-6 ? 1. : time_neon));
     strlcat(buffer, str, sizeof buffer);
     free(str);
+    fastest = fir_filter_neon_intrinsics;
 
     /* check the result, just in case */
     {
@@ -168,6 +246,9 @@ Java_com_example_helloneon_HelloNeon_stringFromJNI( JNIEnv* env,
     strlcat(buffer, "Program not compiled with ARMv7 support !\n", sizeof buffer);
 #endif /* !HAVE_NEON */
 EXIT:
+    /* scale the fastest available filter over all cores */
+    fir_benchmark_threads(buffer, sizeof buffer, fastest);
+
     D("%s",  buffer);
     return (*env)->NewStringUTF(env, buffer);
 }
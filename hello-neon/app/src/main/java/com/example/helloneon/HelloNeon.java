@@ -11,8 +11,26 @@ public class HelloNeon extends AppCompatActivity {
         super.onCreate(savedInstanceState);
         setContentView(R.layout.activity_hello_neon);
 
-        ((TextView)findViewById(R.id.text_view_hello_neon))
-                .setText(stringFromJNI());
+        final TextView textView = (TextView)findViewById(R.id.text_view_hello_neon);
+        textView.setText(R.string.running_benchmarks);
+
+        // The benchmarks take seconds: run them off the UI thread, one run at a
+        // time since the native side works in static buffers.
+        new Thread(new Runnable() {
+            @Override
+            public void run() {
+                final String result;
+                synchronized (HelloNeon.class) {
+                    result = stringFromJNI();
+                }
+                runOnUiThread(new Runnable() {
+                    @Override
+                    public void run() {
+                        textView.setText(result);
+                    }
+                });
+            }
+        }).start();
     }
 
     public native String stringFromJNI();
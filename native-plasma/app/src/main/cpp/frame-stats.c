@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+
+#include "frame-stats.h"
+
+#define  HALF_COUNT  (FRAME_STATS_SUB_COUNT/2)
+
+/* A bucket index is shift * HALF_COUNT + (v >> shift), where 'shift' is the
+ * number of low bits dropped to fit 'v' in FRAME_STATS_SUB_BITS bits.
+ * Small values are stored exactly (shift = 0).
+ */
+static int bucket_index(uint32_t v)
+{
+    int  shift;
+
+    if (v < FRAME_STATS_SUB_COUNT)
+        return (int)v;
+    shift = 31 - __builtin_clz(v) - (FRAME_STATS_SUB_BITS - 1);
+    return shift * HALF_COUNT + (int)(v >> shift);
+}
+
+/* Smallest value stored in bucket 'idx', and the bucket width */
+static uint32_t bucket_low(int idx, uint32_t* width)
+{
+    int  shift;
+
+    if (idx < FRAME_STATS_SUB_COUNT) {
+        *width = 1;
+        return (uint32_t)idx;
+    }
+    shift = idx / HALF_COUNT - 1;
+    *width = (uint32_t)1 << shift;
+    return (uint32_t)(idx - shift * HALF_COUNT) << shift;
+}
+
+static uint32_t ms_to_us(double ms)
+{
+    double  us = ms * 1000. + 0.5;
+
+    if (us < 0.)
+        return 0;
+    if (us >= 4294967295.)
+        return UINT32_MAX;
+    return (uint32_t)us;
+}
+
+static void histogram_reset(FrameHistogram* h)
+{
+    uint32_t  threshold = h->thresholdUs;
+
+    memset(h, 0, sizeof(*h));
+    h->thresholdUs = threshold;
+    h->minUs = UINT32_MAX;
+}
+
+void frame_stats_init(FrameStats* s, double targetPeriodMs)
+{
+    s->targetPeriodMs = targetPeriodMs;
+    s->render.thresholdUs = ms_to_us(targetPeriodMs);
+    s->frame.thresholdUs  = ms_to_us(targetPeriodMs * 1.5);
+    frame_stats_reset(s);
+}
+
+void frame_stats_reset(FrameStats* s)
+{
+    histogram_reset(&s->render);
+    histogram_reset(&s->frame);
+}
+
+void frame_stats_record(FrameStats* s, double renderMs, double frameMs)
+{
+    frame_histogram_record(&s->render, renderMs);
+    frame_histogram_record(&s->frame, frameMs);
+}
+
+void frame_histogram_record(FrameHistogram* h, double ms)
+{
+    uint32_t  us = ms_to_us(ms);
+
+    h->counts[bucket_index(us)]++;
+    h->count++;
+    h->sumUs += us;
+    if (us < h->minUs)
+        h->minUs = us;
+    if (us > h->maxUs)
+        h->maxUs = us;
+    if (us > h->thresholdUs)
+        h->overThreshold++;
+}
+
+/* Return the value under which 'percent' of the samples fall, in ms.
+ * The middle of the matching bucket is returned, clamped to the recorded
+ * extremes so that p0 and p100 are exact.
+ */
+double frame_histogram_percentile(const FrameHistogram* h, double percent)
+{
+    uint64_t  rank, seen = 0;
+    int       idx;
+
+    if (h->count == 0)
+        return 0.;
+    if (percent >= 100.)
+        return h->maxUs / 1000.;
+
+    rank = (uint64_t)(percent / 100. * h->count + 0.5);
+    if (rank < 1)
+        rank = 1;
+
+    for (idx = 0; idx < FRAME_STATS_BUCKETS; idx++) {
+        seen += h->counts[idx];
+        if (seen >= rank) {
+            uint32_t  width;
+            uint32_t  value = bucket_low(idx, &width);
+            value += (width - 1) / 2;
+            if (value < h->minUs)
+                value = h->minUs;
+            if (value > h->maxUs)
+                value = h->maxUs;
+            return value / 1000.;
+        }
+    }
+    return h->maxUs / 1000.;
+}
+
+void frame_histogram_summary(const FrameHistogram* h, FrameSummary* out)
+{
+    out->count  = h->count;
+    out->minMs  = h->count ? h->minUs / 1000. : 0.;
+    out->avgMs  = h->count ? (double)h->sumUs / h->count / 1000. : 0.;
+    out->p50Ms  = frame_histogram_percentile(h, 50.);
+    out->p90Ms  = frame_histogram_percentile(h, 90.);
+    out->p99Ms  = frame_histogram_percentile(h, 99.);
+    out->p999Ms = frame_histogram_percentile(h, 99.9);
+    out->maxMs  = h->maxUs / 1000.;
+    out->janky  = h->overThreshold;
+}
+
+static void write_csv_line(FILE* out, const char* name, const FrameHistogram* h)
+{
+    FrameSummary  sum;
+
+    frame_histogram_summary(h, &sum);
+    fprintf(out, "%s,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%llu\n",
+            name, (unsigned long long)sum.count, sum.minMs, sum.avgMs,
+            sum.p50Ms, sum.p90Ms, sum.p99Ms, sum.p999Ms, sum.maxMs,
+            h->thresholdUs / 1000., (unsigned long long)sum.janky);
+}
+
+int frame_stats_write_csv(const FrameStats* s, FILE* out)
+{
+    fprintf(out, "metric,count,min_ms,avg_ms,p50_ms,p90_ms,p99_ms,p99_9_ms,"
+                 "max_ms,threshold_ms,janky\n");
+    write_csv_line(out, "render", &s->render);
+    write_csv_line(out, "frame", &s->frame);
+    return ferror(out) ? -1 : 0;
+}
+
+static void write_json_histogram(FILE* out, const char* name, const FrameHistogram* h)
+{
+    FrameSummary  sum;
+    const char*   sep = "";
+    int           idx;
+
+    frame_histogram_summary(h, &sum);
+    fprintf(out, "  \"%s\": {\n", name);
+    fprintf(out, "    \"count\": %llu, \"min_ms\": %.3f, \"avg_ms\": %.3f,\n",
+            (unsigned long long)sum.count, sum.minMs, sum.avgMs);
+    fprintf(out, "    \"p50_ms\": %.3f, \"p90_ms\": %.3f, \"p99_ms\": %.3f, "
+                 "\"p99_9_ms\": %.3f, \"max_ms\": %.3f,\n",
+            sum.p50Ms, sum.p90Ms, sum.p99Ms, sum.p999Ms, sum.maxMs);
+    fprintf(out, "    \"threshold_ms\": %.3f, \"janky\": %llu,\n",
+            h->thresholdUs / 1000., (unsigned long long)sum.janky);
+
+    /* [lowest value in ms, count] for every non-empty bucket */
+    fprintf(out, "    \"buckets\": [");
+    for (idx = 0; idx < FRAME_STATS_BUCKETS; idx++) {
+        uint32_t  width;
+        if (h->counts[idx] == 0)
+            continue;
+        fprintf(out, "%s[%.3f, %u]", sep, bucket_low(idx, &width) / 1000.,
+                h->counts[idx]);
+        sep = ", ";
+    }
+    fprintf(out, "]\n  }");
+}
+
+int frame_stats_write_json(const FrameStats* s, FILE* out)
+{
+    fprintf(out, "{\n  \"target_period_ms\": %.3f,\n", s->targetPeriodMs);
+    write_json_histogram(out, "render", &s->render);
+    fprintf(out, ",\n");
+    write_json_histogram(out, "frame", &s->frame);
+    fprintf(out, "\n}\n");
+    return ferror(out) ? -1 : 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Frame timing statistics.
+ *
+ * Durations are recorded in microseconds into a log-linear histogram, in
+ * the spirit of HdrHistogram: values below 2^FRAME_STATS_SUB_BITS get one
+ * bucket each, above that every power of two is split into
+ * 2^(FRAME_STATS_SUB_BITS-1) buckets. This keeps the relative error under
+ * 1.6% from 1us to over an hour, in a fixed-size array, so recording never
+ * allocates and percentiles stay exact enough to see single stutters that
+ * an average would hide.
+ */
+#define  FRAME_STATS_SUB_BITS     7
+#define  FRAME_STATS_SUB_COUNT    (1 << FRAME_STATS_SUB_BITS)
+#define  FRAME_STATS_BUCKETS      ((32 - FRAME_STATS_SUB_BITS + 2) * (FRAME_STATS_SUB_COUNT/2))
+
+typedef struct {
+    uint32_t  counts[FRAME_STATS_BUCKETS];
+    uint64_t  count;
+    uint64_t  sumUs;
+    uint32_t  minUs;
+    uint32_t  maxUs;
+    uint32_t  thresholdUs;     /* samples above this are counted as janky */
+    uint64_t  overThreshold;
+} FrameHistogram;
+
+typedef struct {
+    FrameHistogram  render;    /* time spent producing a frame */
+    FrameHistogram  frame;     /* time between two consecutive frames */
+    double          targetPeriodMs;
+} FrameStats;
+
+typedef struct {
+    uint64_t  count;
+    double    minMs;
+    double    avgMs;
+    double    p50Ms;
+    double    p90Ms;
+    double    p99Ms;
+    double    p999Ms;
+    double    maxMs;
+    uint64_t  janky;
+} FrameSummary;
+
+/* 'targetPeriodMs' is the display refresh period, e.g. 1000/60.
+ * A render is janky when it takes longer than one period; a frame interval
+ * is janky when it is more than 1.5 periods, i.e. a vsync was missed.
+ */
+void   frame_stats_init(FrameStats* s, double targetPeriodMs);
+void   frame_stats_reset(FrameStats* s);
+void   frame_stats_record(FrameStats* s, double renderMs, double frameMs);
+
+void   frame_histogram_record(FrameHistogram* h, double ms);
+double frame_histogram_percentile(const FrameHistogram* h, double percent);
+void   frame_histogram_summary(const FrameHistogram* h, FrameSummary* out);
+
+/* Write the summary of both histograms. The JSON output also contains the
+ * non-empty buckets. Both return 0 on success, -1 on I/O error.
+ */
+int    frame_stats_write_csv(const FrameStats* s, FILE* out);
+int    frame_stats_write_json(const FrameStats* s, FILE* out);
+
+#endif /* FRAME_STATS_H */
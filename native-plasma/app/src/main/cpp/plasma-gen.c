@@ -0,0 +1,804 @@
+/*
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "plasma-gen.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#  define PLASMA_NEON 1
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#  define PLASMA_SSE2 1
+#endif
+
+/* Set to 1 to optimize memory stores when generating plasma. */
+#define OPTIMIZE_WRITES  1
+
+/* We're going to perform computations for every pixel of the target
+ * bitmap. floating-point operations are very slow on ARMv5, and not
+ * too bad on ARMv7 with the exception of trigonometric functions.
+ *
+ * For better performance on all platforms, we're going to use fixed-point
+ * arithmetic and all kinds of tricks
+ */
+
+typedef int32_t  Fixed;
+
+#define  FIXED_BITS           16
+#define  FIXED_ONE            (1 << FIXED_BITS)
+#define  FIXED_AVERAGE(x,y)   (((x) + (y)) >> 1)
+
+#define  FIXED_FROM_INT(x)    ((x) << FIXED_BITS)
+#define  FIXED_TO_INT(x)      ((x) >> FIXED_BITS)
+
+#define  FIXED_FROM_FLOAT(x)  ((Fixed)((x)*FIXED_ONE))
+#define  FIXED_TO_FLOAT(x)    ((x)/(1.*FIXED_ONE))
+
+#define  FIXED_MUL(x,y)       (((int64_t)(x) * (y)) >> FIXED_BITS)
+#define  FIXED_DIV(x,y)       (((int64_t)(x) * FIXED_ONE) / (y))
+
+#define  FIXED_DIV2(x)        ((x) >> 1)
+#define  FIXED_AVERAGE(x,y)   (((x) + (y)) >> 1)
+
+#define  FIXED_FRAC(x)        ((x) & ((1 << FIXED_BITS)-1))
+#define  FIXED_TRUNC(x)       ((x) & ~((1 << FIXED_BITS)-1))
+
+#define  FIXED_FROM_INT_FLOAT(x,f)   (Fixed)((x)*(FIXED_ONE*(f)))
+
+typedef int32_t  Angle;
+
+#define  ANGLE_BITS              9
+
+#if ANGLE_BITS < 8
+#  error ANGLE_BITS must be at least 8
+#endif
+
+#define  ANGLE_2PI               (1 << ANGLE_BITS)
+#define  ANGLE_PI                (1 << (ANGLE_BITS-1))
+#define  ANGLE_PI2               (1 << (ANGLE_BITS-2))
+#define  ANGLE_PI4               (1 << (ANGLE_BITS-3))
+
+#define  ANGLE_FROM_FLOAT(x)   (Angle)((x)*ANGLE_PI/M_PI)
+#define  ANGLE_TO_FLOAT(x)     ((x)*M_PI/ANGLE_PI)
+
+#if ANGLE_BITS <= FIXED_BITS
+#  define  ANGLE_FROM_FIXED(x)     (Angle)((x) >> (FIXED_BITS - ANGLE_BITS))
+#  define  ANGLE_TO_FIXED(x)       (Fixed)((x) << (FIXED_BITS - ANGLE_BITS))
+#else
+#  define  ANGLE_FROM_FIXED(x)     (Angle)((x) << (ANGLE_BITS - FIXED_BITS))
+#  define  ANGLE_TO_FIXED(x)       (Fixed)((x) >> (ANGLE_BITS - FIXED_BITS))
+#endif
+
+static Fixed  angle_sin_tab[ANGLE_2PI+1];
+
+static void init_angles(void)
+{
+    int  nn;
+    for (nn = 0; nn < ANGLE_2PI+1; nn++) {
+        double  radians = nn*M_PI/ANGLE_PI;
+        angle_sin_tab[nn] = FIXED_FROM_FLOAT(sin(radians));
+    }
+}
+
+static __inline__ Fixed angle_sin( Angle  a )
+{
+    return angle_sin_tab[(uint32_t)a & (ANGLE_2PI-1)];
+}
+
+static __inline__ Fixed angle_cos( Angle  a )
+{
+    return angle_sin(a + ANGLE_PI2);
+}
+
+static __inline__ Fixed fixed_sin( Fixed  f )
+{
+    return angle_sin(ANGLE_FROM_FIXED(f));
+}
+
+static __inline__ Fixed  fixed_cos( Fixed  f )
+{
+    return angle_cos(ANGLE_FROM_FIXED(f));
+}
+
+/* Color palette used for rendering the plasma */
+#define  PALETTE_BITS   8
+#define  PALETTE_SIZE   (1 << PALETTE_BITS)
+
+#if PALETTE_BITS > FIXED_BITS
+#  error PALETTE_BITS must be smaller than FIXED_BITS
+#endif
+
+/* One precomputed palette per output format, see PlasmaBackend below */
+static uint16_t  palette[PALETTE_SIZE];
+static uint32_t  palette_8888[PALETTE_SIZE];
+static uint32_t  palette_1010102[PALETTE_SIZE];
+
+static uint16_t  make565(int red, int green, int blue)
+{
+    return (uint16_t)( ((red   << 8) & 0xf800) |
+                       ((green << 3) & 0x07e0) |
+                       ((blue  >> 3) & 0x001f) );
+}
+
+/* R,G,B,A in memory order on a little-endian CPU */
+static uint32_t  make8888(int red, int green, int blue)
+{
+    return 0xff000000u | ((uint32_t)blue << 16) |
+           ((uint32_t)green << 8) | (uint32_t)red;
+}
+
+/* R in bits 0-9, G in 10-19, B in 20-29 and A in 30-31, as in
+ * AHARDWAREBUFFER_FORMAT_R10G10B10A2_UNORM
+ */
+static uint32_t  make1010102(int red, int green, int blue)
+{
+    return 0xc0000000u | ((uint32_t)blue << 20) |
+           ((uint32_t)green << 10) | (uint32_t)red;
+}
+
+static void set_palette_8bit(int nn, int red, int green, int blue)
+{
+    palette[nn]      = make565(red, green, blue);
+    palette_8888[nn] = make8888(red, green, blue);
+}
+
+static void set_palette_10bit(int nn, int red, int green, int blue)
+{
+    palette_1010102[nn] = make1010102(red, green, blue);
+}
+
+/* Build the color ramps with channels in [0, maxValue], so that formats
+ * with more than 8 bits per channel get their own rounding instead of an
+ * upscaled 8-bit palette.
+ */
+static void init_palette(int maxValue, void (*set_palette)(int nn, int red, int green, int blue))
+{
+    int  nn, mm = 0;
+    /* fun with colors */
+    for (nn = 0; nn < PALETTE_SIZE/4; nn++) {
+        int  jj = (nn-mm)*4*maxValue/PALETTE_SIZE;
+        set_palette(nn, maxValue, jj, maxValue-jj);
+    }
+
+    for ( mm = nn; nn < PALETTE_SIZE/2; nn++ ) {
+        int  jj = (nn-mm)*4*maxValue/PALETTE_SIZE;
+        set_palette(nn, maxValue-jj, maxValue, jj);
+    }
+
+    for ( mm = nn; nn < PALETTE_SIZE*3/4; nn++ ) {
+        int  jj = (nn-mm)*4*maxValue/PALETTE_SIZE;
+        set_palette(nn, 0, maxValue-jj, maxValue);
+    }
+
+    for ( mm = nn; nn < PALETTE_SIZE; nn++ ) {
+        int  jj = (nn-mm)*4*maxValue/PALETTE_SIZE;
+        set_palette(nn, jj, 0, maxValue);
+    }
+}
+
+static __inline__ int  palette_index( Fixed  x )
+{
+    if (x < 0) x = -x;
+    if (x >= FIXED_ONE) x = FIXED_ONE-1;
+    int  idx = FIXED_FRAC(x) >> (FIXED_BITS - PALETTE_BITS);
+    return idx & (PALETTE_SIZE-1);
+}
+
+static __inline__ uint16_t  palette_from_fixed( Fixed  x )
+{
+    return palette[palette_index(x)];
+}
+
+/* Angles expressed as fixed point radians */
+
+void plasma_init_tables(void)
+{
+    init_palette(255, set_palette_8bit);
+    init_palette(1023, set_palette_10bit);
+    init_angles();
+}
+
+#define  YT1_INCR   FIXED_FROM_FLOAT(1/100.)
+#define  YT2_INCR   FIXED_FROM_FLOAT(1/163.)
+
+#define  XT1_INCR  FIXED_FROM_FLOAT(1/173.)
+#define  XT2_INCR  FIXED_FROM_FLOAT(1/242.)
+
+/* Output backends: palette indices are turned into pixels of the target
+ * format. Neither NEON nor SSE2 can gather from a 256-entry table, but the
+ * palette is made of four linear ramps (see init_palette()), so the vector
+ * paths compute the channels of 8 pixels from their indices with the same
+ * integer arithmetic, and only the tail of a span uses the tables.
+ */
+#if defined(PLASMA_NEON)
+typedef uint16x8_t  Channels;
+#elif defined(PLASMA_SSE2)
+typedef __m128i     Channels;
+#endif
+
+#if defined(PLASMA_NEON)
+static __inline__ void ramp_channels(const uint8_t* indices, int maxValue,
+                                     Channels* red, Channels* green, Channels* blue)
+{
+    const uint16x8_t  vmax = vdupq_n_u16((uint16_t)maxValue);
+    uint16x8_t  idx = vmovl_u8(vld1_u8(indices));
+    uint16x8_t  quarter = vshrq_n_u16(idx, PALETTE_BITS-2);
+    /* jj in init_palette(), below 2^16 for maxValue <= 1023 */
+    uint16x8_t  up = vshrq_n_u16(vmulq_u16(vandq_u16(idx, vdupq_n_u16(PALETTE_SIZE/4-1)),
+                                           vmax), PALETTE_BITS-2);
+    uint16x8_t  down = vsubq_u16(vmax, up);
+    uint16x8_t  q0 = vceqq_u16(quarter, vdupq_n_u16(0));
+    uint16x8_t  q1 = vceqq_u16(quarter, vdupq_n_u16(1));
+    uint16x8_t  q2 = vceqq_u16(quarter, vdupq_n_u16(2));
+    uint16x8_t  q3 = vceqq_u16(quarter, vdupq_n_u16(3));
+
+    *red   = vorrq_u16(vandq_u16(q0, vmax),
+                       vorrq_u16(vandq_u16(q1, down), vandq_u16(q3, up)));
+    *green = vorrq_u16(vandq_u16(q0, up),
+                       vorrq_u16(vandq_u16(q1, vmax), vandq_u16(q2, down)));
+    *blue  = vorrq_u16(vandq_u16(q0, down),
+                       vorrq_u16(vandq_u16(q1, up), vandq_u16(vorrq_u16(q2, q3), vmax)));
+}
+#elif defined(PLASMA_SSE2)
+static __inline__ void ramp_channels(const uint8_t* indices, int maxValue,
+                                     Channels* red, Channels* green, Channels* blue)
+{
+    const __m128i  vmax = _mm_set1_epi16((short)maxValue);
+    __m128i  idx = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)indices),
+                                     _mm_setzero_si128());
+    __m128i  quarter = _mm_srli_epi16(idx, PALETTE_BITS-2);
+    /* jj in init_palette(), below 2^16 for maxValue <= 1023 */
+    __m128i  up = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(idx,
+                                     _mm_set1_epi16(PALETTE_SIZE/4-1)), vmax),
+                                 PALETTE_BITS-2);
+    __m128i  down = _mm_sub_epi16(vmax, up);
+    __m128i  q0 = _mm_cmpeq_epi16(quarter, _mm_setzero_si128());
+    __m128i  q1 = _mm_cmpeq_epi16(quarter, _mm_set1_epi16(1));
+    __m128i  q2 = _mm_cmpeq_epi16(quarter, _mm_set1_epi16(2));
+    __m128i  q3 = _mm_cmpeq_epi16(quarter, _mm_set1_epi16(3));
+
+    *red   = _mm_or_si128(_mm_and_si128(q0, vmax),
+                 _mm_or_si128(_mm_and_si128(q1, down), _mm_and_si128(q3, up)));
+    *green = _mm_or_si128(_mm_and_si128(q0, up),
+                 _mm_or_si128(_mm_and_si128(q1, vmax), _mm_and_si128(q2, down)));
+    *blue  = _mm_or_si128(_mm_and_si128(q0, down),
+                 _mm_or_si128(_mm_and_si128(q1, up),
+                              _mm_and_si128(_mm_or_si128(q2, q3), vmax)));
+}
+#endif
+
+static void expand_565(void* line, const uint8_t* indices, int count)
+{
+    uint16_t*  dst = (uint16_t*)line;
+    int        nn = 0;
+
+#if defined(PLASMA_NEON)
+    for (; nn + 8 <= count; nn += 8) {
+        Channels  r, g, b;
+        ramp_channels(indices + nn, 255, &r, &g, &b);
+        vst1q_u16(dst + nn,
+                  vorrq_u16(vandq_u16(vshlq_n_u16(r, 8), vdupq_n_u16(0xf800)),
+                            vorrq_u16(vandq_u16(vshlq_n_u16(g, 3), vdupq_n_u16(0x07e0)),
+                                      vshrq_n_u16(b, 3))));
+    }
+#elif defined(PLASMA_SSE2)
+    for (; nn + 8 <= count; nn += 8) {
+        Channels  r, g, b;
+        ramp_channels(indices + nn, 255, &r, &g, &b);
+        _mm_storeu_si128((__m128i*)(dst + nn),
+            _mm_or_si128(_mm_and_si128(_mm_slli_epi16(r, 8), _mm_set1_epi16((short)0xf800)),
+                _mm_or_si128(_mm_and_si128(_mm_slli_epi16(g, 3), _mm_set1_epi16(0x07e0)),
+                             _mm_srli_epi16(b, 3))));
+    }
+#endif
+    for (; nn < count; nn++)
+        dst[nn] = palette[indices[nn]];
+}
+
+static void expand_8888(void* line, const uint8_t* indices, int count)
+{
+    uint32_t*  dst = (uint32_t*)line;
+    int        nn = 0;
+
+#if defined(PLASMA_NEON)
+    for (; nn + 8 <= count; nn += 8) {
+        Channels     r, g, b;
+        uint16x8x2_t  halves;
+        ramp_channels(indices + nn, 255, &r, &g, &b);
+        /* low half R,G and high half B,A of every pixel, interleaved */
+        halves.val[0] = vorrq_u16(r, vshlq_n_u16(g, 8));
+        halves.val[1] = vorrq_u16(b, vdupq_n_u16(0xff00));
+        vst2q_u16((uint16_t*)(dst + nn), halves);
+    }
+#elif defined(PLASMA_SSE2)
+    for (; nn + 8 <= count; nn += 8) {
+        Channels  r, g, b;
+        __m128i   lo, hi;
+        ramp_channels(indices + nn, 255, &r, &g, &b);
+        lo = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+        hi = _mm_or_si128(b, _mm_set1_epi16((short)0xff00));
+        _mm_storeu_si128((__m128i*)(dst + nn),     _mm_unpacklo_epi16(lo, hi));
+        _mm_storeu_si128((__m128i*)(dst + nn + 4), _mm_unpackhi_epi16(lo, hi));
+    }
+#endif
+    for (; nn < count; nn++)
+        dst[nn] = palette_8888[indices[nn]];
+}
+
+static void expand_1010102(void* line, const uint8_t* indices, int count)
+{
+    uint32_t*  dst = (uint32_t*)line;
+    int        nn = 0;
+
+#if defined(PLASMA_NEON)
+    const uint32x4_t  alpha = vdupq_n_u32(0xc0000000u);
+    for (; nn + 8 <= count; nn += 8) {
+        Channels  r, g, b;
+        ramp_channels(indices + nn, 1023, &r, &g, &b);
+        vst1q_u32(dst + nn,
+                  vorrq_u32(vorrq_u32(vmovl_u16(vget_low_u16(r)),
+                                      vshlq_n_u32(vmovl_u16(vget_low_u16(g)), 10)),
+                            vorrq_u32(vshlq_n_u32(vmovl_u16(vget_low_u16(b)), 20), alpha)));
+        vst1q_u32(dst + nn + 4,
+                  vorrq_u32(vorrq_u32(vmovl_u16(vget_high_u16(r)),
+                                      vshlq_n_u32(vmovl_u16(vget_high_u16(g)), 10)),
+                            vorrq_u32(vshlq_n_u32(vmovl_u16(vget_high_u16(b)), 20), alpha)));
+    }
+#elif defined(PLASMA_SSE2)
+    const __m128i  alpha = _mm_set1_epi32((int)0xc0000000u);
+    const __m128i  zero = _mm_setzero_si128();
+    for (; nn + 8 <= count; nn += 8) {
+        Channels  r, g, b;
+        ramp_channels(indices + nn, 1023, &r, &g, &b);
+        _mm_storeu_si128((__m128i*)(dst + nn),
+            _mm_or_si128(_mm_or_si128(_mm_unpacklo_epi16(r, zero),
+                                      _mm_slli_epi32(_mm_unpacklo_epi16(g, zero), 10)),
+                         _mm_or_si128(_mm_slli_epi32(_mm_unpacklo_epi16(b, zero), 20), alpha)));
+        _mm_storeu_si128((__m128i*)(dst + nn + 4),
+            _mm_or_si128(_mm_or_si128(_mm_unpackhi_epi16(r, zero),
+                                      _mm_slli_epi32(_mm_unpackhi_epi16(g, zero), 10)),
+                         _mm_or_si128(_mm_slli_epi32(_mm_unpackhi_epi16(b, zero), 20), alpha)));
+    }
+#endif
+    for (; nn < count; nn++)
+        dst[nn] = palette_1010102[indices[nn]];
+}
+
+typedef struct {
+    int    bytesPerPixel;
+    void (*expand)(void* line, const uint8_t* indices, int count);
+} PlasmaBackend;
+
+/* indexed by PlasmaFormat */
+static const PlasmaBackend  backends[PLASMA_FORMAT_COUNT] = {
+    { 2, expand_565 },       /* PLASMA_FORMAT_RGB565 */
+    { 4, expand_8888 },      /* PLASMA_FORMAT_RGBA8888 */
+    { 4, expand_1010102 },   /* PLASMA_FORMAT_RGBA1010102 */
+};
+
+int plasma_bytes_per_pixel(PlasmaFormat format)
+{
+    return backends[format].bytesPerPixel;
+}
+
+/* The reference implementation: one pixel at a time, as the sample has
+ * always done it.
+ */
+static void fill_line_565(uint16_t* line, int width, Fixed base, Fixed xt1, Fixed xt2)
+{
+#if OPTIMIZE_WRITES
+    /* optimize memory writes by generating one aligned 32-bit store
+     * for every pair of pixels.
+     */
+    uint16_t*  line_end = line + width;
+
+    if (line < line_end) {
+        if (((uint32_t)(uintptr_t)line & 3) != 0) {
+            Fixed ii = base + fixed_sin(xt1) + fixed_sin(xt2);
+
+            xt1 += XT1_INCR;
+            xt2 += XT2_INCR;
+
+            line[0] = palette_from_fixed(ii >> 2);
+            line++;
+        }
+
+        while (line + 2 <= line_end) {
+            Fixed i1 = base + fixed_sin(xt1) + fixed_sin(xt2);
+            xt1 += XT1_INCR;
+            xt2 += XT2_INCR;
+
+            Fixed i2 = base + fixed_sin(xt1) + fixed_sin(xt2);
+            xt1 += XT1_INCR;
+            xt2 += XT2_INCR;
+
+            /* little-endian: the first pixel goes in the low half */
+            uint32_t  pixel = ((uint32_t)palette_from_fixed(i2 >> 2) << 16) |
+                               (uint32_t)palette_from_fixed(i1 >> 2);
+
+            ((uint32_t*)line)[0] = pixel;
+            line += 2;
+        }
+
+        if (line < line_end) {
+            Fixed ii = base + fixed_sin(xt1) + fixed_sin(xt2);
+            line[0] = palette_from_fixed(ii >> 2);
+            line++;
+        }
+    }
+#else /* !OPTIMIZE_WRITES */
+    int xx;
+    for (xx = 0; xx < width; xx++) {
+
+        Fixed ii = base + fixed_sin(xt1) + fixed_sin(xt2);
+
+        xt1 += XT1_INCR;
+        xt2 += XT2_INCR;
+
+        line[xx] = palette_from_fixed(ii >> 2);
+    }
+#endif /* !OPTIMIZE_WRITES */
+}
+
+static void fill_line_32(uint32_t* line, int width, Fixed base, Fixed xt1, Fixed xt2,
+                         const uint32_t* palette32)
+{
+    int xx;
+    for (xx = 0; xx < width; xx++) {
+
+        Fixed ii = base + fixed_sin(xt1) + fixed_sin(xt2);
+
+        xt1 += XT1_INCR;
+        xt2 += XT2_INCR;
+
+        line[xx] = palette32[palette_index(ii >> 2)];
+    }
+}
+
+void plasma_fill_reference(void* pixels, int width, int height, int stride,
+                           PlasmaFormat format, double t)
+{
+    Fixed yt1 = FIXED_FROM_FLOAT(t/1230.);
+    Fixed yt2 = yt1;
+    Fixed xt10 = FIXED_FROM_FLOAT(t/3000.);
+    Fixed xt20 = xt10;
+
+    int  yy;
+    for (yy = 0; yy < height; yy++) {
+        Fixed      base = fixed_sin(yt1) + fixed_sin(yt2);
+
+        yt1 += YT1_INCR;
+        yt2 += YT2_INCR;
+
+        if (format == PLASMA_FORMAT_RGB565)
+            fill_line_565((uint16_t*)pixels, width, base, xt10, xt20);
+        else
+            fill_line_32((uint32_t*)pixels, width, base, xt10, xt20,
+                         format == PLASMA_FORMAT_RGBA8888 ? palette_8888
+                                                          : palette_1010102);
+
+        // go to next line
+        pixels = (char*)pixels + stride;
+    }
+}
+
+/* The vectorized implementation works on spans of up to PLASMA_SPAN
+ * columns. The x terms of a span (the two sines of the column) are the
+ * same on every row, so they are computed once per span and reused down
+ * the rectangle, which leaves no table lookup in the per pixel loop:
+ * pack_indices() adds the row term and clamps 8 pixels at a time, then the
+ * backend computes the colors from the indices.
+ */
+#define  PLASMA_SPAN   256
+
+/* palette_index((base + sum[nn]) >> 2) for 8 consecutive pixels */
+#if defined(PLASMA_NEON)
+static __inline__ void pack_indices(uint8_t* out, const int32_t* sum, Fixed base)
+{
+    const int32x4_t  vbase = vdupq_n_s32(base);
+    const int32x4_t  vmax  = vdupq_n_s32(FIXED_ONE-1);
+
+    int32x4_t  lo = vshrq_n_s32(vaddq_s32(vbase, vld1q_s32(sum)), 2);
+    int32x4_t  hi = vshrq_n_s32(vaddq_s32(vbase, vld1q_s32(sum+4)), 2);
+    lo = vminq_s32(vabsq_s32(lo), vmax);
+    hi = vminq_s32(vabsq_s32(hi), vmax);
+    lo = vshrq_n_s32(lo, FIXED_BITS-PALETTE_BITS);
+    hi = vshrq_n_s32(hi, FIXED_BITS-PALETTE_BITS);
+
+    uint16x8_t  idx = vcombine_u16(vmovn_u32(vreinterpretq_u32_s32(lo)),
+                                   vmovn_u32(vreinterpretq_u32_s32(hi)));
+    vst1_u8(out, vmovn_u16(idx));
+}
+#elif defined(PLASMA_SSE2)
+static __inline__ __m128i clamp_index(__m128i v, __m128i vmax)
+{
+    /* abs() and min() are SSSE3/SSE4.1, do it the SSE2 way */
+    __m128i  sign = _mm_srai_epi32(v, 31);
+    __m128i  over;
+
+    v    = _mm_sub_epi32(_mm_xor_si128(v, sign), sign);
+    over = _mm_cmpgt_epi32(v, vmax);
+    v    = _mm_or_si128(_mm_and_si128(over, vmax), _mm_andnot_si128(over, v));
+    return _mm_srai_epi32(v, FIXED_BITS-PALETTE_BITS);
+}
+
+static __inline__ void pack_indices(uint8_t* out, const int32_t* sum, Fixed base)
+{
+    const __m128i  vbase = _mm_set1_epi32(base);
+    const __m128i  vmax  = _mm_set1_epi32(FIXED_ONE-1);
+
+    __m128i  lo = _mm_srai_epi32(_mm_add_epi32(vbase,
+                      _mm_loadu_si128((const __m128i*)sum)), 2);
+    __m128i  hi = _mm_srai_epi32(_mm_add_epi32(vbase,
+                      _mm_loadu_si128((const __m128i*)(sum+4))), 2);
+
+    __m128i  idx = _mm_packs_epi32(clamp_index(lo, vmax), clamp_index(hi, vmax));
+    _mm_storel_epi64((__m128i*)out, _mm_packus_epi16(idx, idx));
+}
+#endif
+
+/* palette indices of a span, the x terms already summed up */
+static void span_indices_terms(uint8_t* out, int count, Fixed base, const Fixed* xterms)
+{
+#if defined(PLASMA_NEON) || defined(PLASMA_SSE2)
+    for (; count >= 8; count -= 8) {
+        pack_indices(out, xterms, base);
+        out += 8;
+        xterms += 8;
+    }
+#endif
+    for (; count > 0; count--)
+        *out++ = (uint8_t)palette_index((base + *xterms++) >> 2);
+}
+
+static __inline__ void expand_span(void* line, PlasmaFormat format,
+                                   const uint8_t* indices, int count)
+{
+    backends[format].expand(line, indices, count);
+}
+
+void plasma_fill_rect(void* pixels, int stride, PlasmaFormat format, double t,
+                      int x, int y, int width, int height)
+{
+    /* Every increment is an exact integer, so jumping straight to (x,y)
+     * gives the same angles as stepping there pixel by pixel.
+     */
+    Fixed yt10 = FIXED_FROM_FLOAT(t/1230.) + y*YT1_INCR;
+    Fixed yt20 = FIXED_FROM_FLOAT(t/1230.) + y*YT2_INCR;
+    Fixed xt1 = FIXED_FROM_FLOAT(t/3000.) + x*XT1_INCR;
+    Fixed xt2 = FIXED_FROM_FLOAT(t/3000.) + x*XT2_INCR;
+    int   bpp = plasma_bytes_per_pixel(format);
+
+    Fixed    xterms[PLASMA_SPAN];
+    uint8_t  indices[PLASMA_SPAN];
+
+    pixels = (char*)pixels + (size_t)y*stride + x*bpp;
+
+    int  xx;
+    for (xx = 0; xx < width; xx += PLASMA_SPAN) {
+        char*  line = (char*)pixels + xx*bpp;
+        Fixed  yt1 = yt10;
+        Fixed  yt2 = yt20;
+        int    count = width - xx;
+        int    nn, yy;
+
+        if (count > PLASMA_SPAN)
+            count = PLASMA_SPAN;
+
+        for (nn = 0; nn < count; nn++) {
+            xterms[nn] = fixed_sin(xt1) + fixed_sin(xt2);
+            xt1 += XT1_INCR;
+            xt2 += XT2_INCR;
+        }
+
+        for (yy = 0; yy < height; yy++) {
+            Fixed  base = fixed_sin(yt1) + fixed_sin(yt2);
+
+            yt1 += YT1_INCR;
+            yt2 += YT2_INCR;
+
+            span_indices_terms(indices, count, base, xterms);
+            expand_span(line, format, indices, count);
+
+            // go to next line
+            line += stride;
+        }
+    }
+}
+
+void plasma_fill(void* pixels, int width, int height, int stride,
+                 PlasmaFormat format, double t)
+{
+    plasma_fill_rect(pixels, stride, format, t, 0, 0, width, height);
+}
+
+/* The plasma value of a pixel is base(y) + xterm(x): the row term only
+ * depends on y and the column term only on x, both through the frame time.
+ * Computing them once per frame turns the inner loop into an add, the
+ * vectorized clamp of pack_indices() and the palette lookup.
+ */
+struct PlasmaTerms {
+    int     width;
+    int     height;
+    int     capacityX;
+    int     capacityY;
+    Fixed*  xterms;
+    Fixed*  yterms;
+};
+
+PlasmaTerms* plasma_terms_create(void)
+{
+    return calloc(1, sizeof(PlasmaTerms));
+}
+
+void plasma_terms_destroy(PlasmaTerms* terms)
+{
+    if (terms == NULL)
+        return;
+    free(terms->xterms);
+    free(terms->yterms);
+    free(terms);
+}
+
+int plasma_terms_update(PlasmaTerms* terms, int width, int height, double t)
+{
+    Fixed yt1 = FIXED_FROM_FLOAT(t/1230.);
+    Fixed yt2 = yt1;
+    Fixed xt1 = FIXED_FROM_FLOAT(t/3000.);
+    Fixed xt2 = xt1;
+    int   nn;
+
+    /* only reallocate when the frame grows */
+    if (width > terms->capacityX) {
+        Fixed*  xterms = realloc(terms->xterms, width * sizeof(Fixed));
+        if (xterms == NULL)
+            return -1;
+        terms->xterms = xterms;
+        terms->capacityX = width;
+    }
+    if (height > terms->capacityY) {
+        Fixed*  yterms = realloc(terms->yterms, height * sizeof(Fixed));
+        if (yterms == NULL)
+            return -1;
+        terms->yterms = yterms;
+        terms->capacityY = height;
+    }
+    terms->width  = width;
+    terms->height = height;
+
+    for (nn = 0; nn < width; nn++) {
+        terms->xterms[nn] = fixed_sin(xt1) + fixed_sin(xt2);
+        xt1 += XT1_INCR;
+        xt2 += XT2_INCR;
+    }
+    for (nn = 0; nn < height; nn++) {
+        terms->yterms[nn] = fixed_sin(yt1) + fixed_sin(yt2);
+        yt1 += YT1_INCR;
+        yt2 += YT2_INCR;
+    }
+    return 0;
+}
+
+void plasma_fill_terms_rect(const PlasmaTerms* terms, void* pixels, int stride,
+                            PlasmaFormat format, int x, int y, int width, int height)
+{
+    int      bpp = plasma_bytes_per_pixel(format);
+    uint8_t  indices[PLASMA_SPAN];
+    int      yy, xx;
+
+    pixels = (char*)pixels + (size_t)y*stride + x*bpp;
+
+    for (yy = 0; yy < height; yy++) {
+        Fixed  base = terms->yterms[y + yy];
+
+        for (xx = 0; xx < width; xx += PLASMA_SPAN) {
+            int  count = width - xx;
+            if (count > PLASMA_SPAN)
+                count = PLASMA_SPAN;
+
+            span_indices_terms(indices, count, base, terms->xterms + x + xx);
+            expand_span((char*)pixels + xx*bpp, format, indices, count);
+        }
+
+        // go to next line
+        pixels = (char*)pixels + stride;
+    }
+}
+
+void plasma_fill_separable(PlasmaTerms* terms, void* pixels, int width, int height,
+                           int stride, PlasmaFormat format, double t)
+{
+    if (plasma_terms_update(terms, width, height, t) != 0) {
+        plasma_fill(pixels, width, height, stride, format, t);
+        return;
+    }
+    plasma_fill_terms_rect(terms, pixels, stride, format, 0, 0, width, height);
+}
+
+typedef struct {
+    PlasmaMode    mode;
+    PlasmaTerms*  terms;
+} VerifyMode;
+
+static void fill_mode(void* ctx, void* pixels, int width, int height, int stride,
+                      PlasmaFormat format, double t)
+{
+    VerifyMode*  v = ctx;
+
+    switch (v->mode) {
+        case PLASMA_MODE_REFERENCE:
+            plasma_fill_reference(pixels, width, height, stride, format, t);
+            break;
+        case PLASMA_MODE_SIMD:
+            plasma_fill(pixels, width, height, stride, format, t);
+            break;
+        case PLASMA_MODE_SEPARABLE:
+            plasma_fill_separable(v->terms, pixels, width, height, stride, format, t);
+            break;
+    }
+}
+
+int plasma_verify(int width, int height, PlasmaFormat format, PlasmaMode mode,
+                  double t)
+{
+    VerifyMode  v;
+    int         fails;
+
+    v.mode = mode;
+    v.terms = plasma_terms_create();
+    if (v.terms == NULL)
+        return -1;
+    fails = plasma_verify_fill(fill_mode, &v, width, height, format, t);
+    plasma_terms_destroy(v.terms);
+    return fails;
+}
+
+int plasma_verify_fill(PlasmaFillFunc fill, void* ctx, int width, int height,
+                       PlasmaFormat format, double t)
+{
+    int    bpp = plasma_bytes_per_pixel(format);
+    int    stride = width*bpp;
+    char*  expected = malloc((size_t)stride*height);
+    char*  actual = malloc((size_t)stride*height);
+    int    fails = 0;
+
+    if (expected == NULL || actual == NULL) {
+        free(expected);
+        free(actual);
+        return -1;
+    }
+
+    plasma_fill_reference(expected, width, height, stride, format, t);
+    fill(ctx, actual, width, height, stride, format, t);
+
+    if (memcmp(expected, actual, (size_t)stride*height) != 0) {
+        int  nn;
+        for (nn = 0; nn < width*height; nn++) {
+            if (memcmp(expected + (size_t)nn*bpp, actual + (size_t)nn*bpp, bpp) != 0)
+                fails++;
+        }
+    }
+
+    free(expected);
+    free(actual);
+    return fails;
+}
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "plasma-tiles.h"
+
+/* The tiles owned by one thread for the current frame, as the half-open
+ * range [begin, end) packed in a single 64-bit word: begin in the low half,
+ * end in the high half. The owner takes tiles from the front and thieves
+ * from the back, both with a compare-and-swap on the whole range.
+ *
+ * Padded to 64 bytes and allocated on a 64-byte boundary so that two
+ * queues never share a cache line.
+ */
+typedef struct {
+    atomic_uint_fast64_t  range;
+    PlasmaTiles*          owner;
+    int                   index;
+    char                  pad[64 - sizeof(atomic_uint_fast64_t)
+                              - sizeof(PlasmaTiles*) - sizeof(int)];
+} TileQueue;
+
+struct PlasmaTiles {
+    pthread_t*       threads;
+    TileQueue*       queues;
+    int              numThreads;
+
+    pthread_mutex_t  lock;
+    pthread_cond_t   startCond;
+    pthread_cond_t   doneCond;
+    unsigned         generation;   /* bumped for every frame */
+    int              busyThreads;  /* workers still inside the current frame */
+    int              quit;
+
+    /* current frame, only written while no worker is busy */
+    PlasmaTerms*     terms;
+    int              separable;    /* 0 if the terms could not be computed */
+    void*            pixels;
+    int              width;
+    int              height;
+    int              stride;
+    PlasmaFormat     format;
+    double           t;
+    int              tilesX;
+};
+
+#define  RANGE_PACK(begin, end)  (((uint64_t)(uint32_t)(end) << 32) | (uint32_t)(begin))
+#define  RANGE_BEGIN(range)      ((int)(uint32_t)(range))
+#define  RANGE_END(range)        ((int)((range) >> 32))
+
+/* Return the first tile of the queue, or -1 if it is empty */
+static int queue_pop(TileQueue* q)
+{
+    uint64_t  range = atomic_load_explicit(&q->range, memory_order_relaxed);
+    for (;;) {
+        int  begin = RANGE_BEGIN(range);
+        int  end   = RANGE_END(range);
+        if (begin >= end)
+            return -1;
+        if (atomic_compare_exchange_weak_explicit(&q->range, &range,
+                RANGE_PACK(begin + 1, end),
+                memory_order_relaxed, memory_order_relaxed))
+            return begin;
+    }
+}
+
+/* Return the last tile of the queue, or -1 if it is empty */
+static int queue_steal(TileQueue* q)
+{
+    uint64_t  range = atomic_load_explicit(&q->range, memory_order_relaxed);
+    for (;;) {
+        int  begin = RANGE_BEGIN(range);
+        int  end   = RANGE_END(range);
+        if (begin >= end)
+            return -1;
+        if (atomic_compare_exchange_weak_explicit(&q->range, &range,
+                RANGE_PACK(begin, end - 1),
+                memory_order_relaxed, memory_order_relaxed))
+            return end - 1;
+    }
+}
+
+static void render_tile(PlasmaTiles* tiles, int tile)
+{
+    int  x = (tile % tiles->tilesX) * PLASMA_TILE_WIDTH;
+    int  y = (tile / tiles->tilesX) * PLASMA_TILE_HEIGHT;
+    int  w = tiles->width - x;
+    int  h = tiles->height - y;
+
+    if (w > PLASMA_TILE_WIDTH)
+        w = PLASMA_TILE_WIDTH;
+    if (h > PLASMA_TILE_HEIGHT)
+        h = PLASMA_TILE_HEIGHT;
+
+    if (tiles->separable)
+        plasma_fill_terms_rect(tiles->terms, tiles->pixels, tiles->stride,
+                               tiles->format, x, y, w, h);
+    else
+        plasma_fill_rect(tiles->pixels, tiles->stride, tiles->format, tiles->t,
+                         x, y, w, h);
+}
+
+/* Render our own tiles, then help the others. Queues only shrink during a
+ * frame, so a single pass over the victims is enough.
+ */
+static void run_queue(TileQueue* q)
+{
+    PlasmaTiles*  tiles = q->owner;
+    int           tile, nn;
+
+    while ((tile = queue_pop(q)) >= 0)
+        render_tile(tiles, tile);
+
+    for (nn = 1; nn < tiles->numThreads; nn++) {
+        TileQueue*  victim = &tiles->queues[(q->index + nn) % tiles->numThreads];
+        while ((tile = queue_steal(victim)) >= 0)
+            render_tile(tiles, tile);
+    }
+}
+
+static void* tiles_worker(void* arg)
+{
+    TileQueue*    q = (TileQueue*)arg;
+    PlasmaTiles*  tiles = q->owner;
+    unsigned      seen = 0;
+
+    pthread_mutex_lock(&tiles->lock);
+    for (;;) {
+        while (!tiles->quit && tiles->generation == seen)
+            pthread_cond_wait(&tiles->startCond, &tiles->lock);
+        if (tiles->quit)
+            break;
+        seen = tiles->generation;
+        pthread_mutex_unlock(&tiles->lock);
+
+        run_queue(q);
+
+        pthread_mutex_lock(&tiles->lock);
+        if (--tiles->busyThreads == 0)
+            pthread_cond_signal(&tiles->doneCond);
+    }
+    pthread_mutex_unlock(&tiles->lock);
+    return NULL;
+}
+
+PlasmaTiles* plasma_tiles_create(int numThreads)
+{
+    PlasmaTiles*  tiles;
+    int           nn;
+
+    if (numThreads <= 0)
+        numThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (numThreads <= 0)
+        numThreads = 1;
+
+    tiles = calloc(1, sizeof(*tiles));
+    if (tiles == NULL)
+        return NULL;
+
+    tiles->threads = calloc(numThreads, sizeof(pthread_t));
+    /* calloc() only guarantees the alignment of the fundamental types */
+    if (posix_memalign((void**)&tiles->queues, 64, numThreads * sizeof(TileQueue)) != 0)
+        tiles->queues = NULL;
+    tiles->terms   = plasma_terms_create();
+    if (tiles->threads == NULL || tiles->queues == NULL || tiles->terms == NULL) {
+        plasma_terms_destroy(tiles->terms);
+        free(tiles->threads);
+        free(tiles->queues);
+        free(tiles);
+        return NULL;
+    }
+
+    pthread_mutex_init(&tiles->lock, NULL);
+    pthread_cond_init(&tiles->startCond, NULL);
+    pthread_cond_init(&tiles->doneCond, NULL);
+
+    for (nn = 0; nn < numThreads; nn++) {
+        atomic_init(&tiles->queues[nn].range, 0);
+        tiles->queues[nn].owner = tiles;
+        tiles->queues[nn].index = nn;
+    }
+
+    /* The calling thread runs queue #0 */
+    tiles->numThreads = 1;
+    for (nn = 1; nn < numThreads; nn++) {
+        if (pthread_create(&tiles->threads[nn], NULL, tiles_worker,
+                           &tiles->queues[nn]) != 0)
+            break;
+        tiles->numThreads++;
+    }
+    return tiles;
+}
+
+void plasma_tiles_destroy(PlasmaTiles* tiles)
+{
+    int  nn;
+
+    if (tiles == NULL)
+        return;
+
+    pthread_mutex_lock(&tiles->lock);
+    tiles->quit = 1;
+    pthread_cond_broadcast(&tiles->startCond);
+    pthread_mutex_unlock(&tiles->lock);
+
+    for (nn = 1; nn < tiles->numThreads; nn++)
+        pthread_join(tiles->threads[nn], NULL);
+
+    pthread_cond_destroy(&tiles->doneCond);
+    pthread_cond_destroy(&tiles->startCond);
+    pthread_mutex_destroy(&tiles->lock);
+    plasma_terms_destroy(tiles->terms);
+    free(tiles->queues);
+    free(tiles->threads);
+    free(tiles);
+}
+
+int plasma_tiles_threads(const PlasmaTiles* tiles)
+{
+    return tiles->numThreads;
+}
+
+void plasma_tiles_fill(PlasmaTiles* tiles, void* pixels, int width, int height,
+                       int stride, PlasmaFormat format, double t)
+{
+    int  tilesX = (width + PLASMA_TILE_WIDTH - 1) / PLASMA_TILE_WIDTH;
+    int  tilesY = (height + PLASMA_TILE_HEIGHT - 1) / PLASMA_TILE_HEIGHT;
+    int  numTiles = tilesX * tilesY;
+    int  nn;
+
+    if (tiles->numThreads == 1 || numTiles <= 1) {
+        plasma_fill_separable(tiles->terms, pixels, width, height, stride, format, t);
+        return;
+    }
+
+    pthread_mutex_lock(&tiles->lock);
+    /* the row and column terms are shared by all tiles of the frame */
+    tiles->separable = (plasma_terms_update(tiles->terms, width, height, t) == 0);
+    tiles->pixels = pixels;
+    tiles->width  = width;
+    tiles->height = height;
+    tiles->stride = stride;
+    tiles->format = format;
+    tiles->t      = t;
+    tiles->tilesX = tilesX;
+
+    /* Hand out contiguous runs of tiles, so that each thread starts by
+     * writing its own band of the frame.
+     */
+    for (nn = 0; nn < tiles->numThreads; nn++) {
+        int  begin = (int)((int64_t)numTiles * nn / tiles->numThreads);
+        int  end   = (int)((int64_t)numTiles * (nn + 1) / tiles->numThreads);
+        atomic_store_explicit(&tiles->queues[nn].range, RANGE_PACK(begin, end),
+                              memory_order_relaxed);
+    }
+
+    tiles->busyThreads = tiles->numThreads - 1;
+    tiles->generation++;
+    pthread_cond_broadcast(&tiles->startCond);
+    pthread_mutex_unlock(&tiles->lock);
+
+    run_queue(&tiles->queues[0]);
+
+    pthread_mutex_lock(&tiles->lock);
+    while (tiles->busyThreads > 0)
+        pthread_cond_wait(&tiles->doneCond, &tiles->lock);
+    pthread_mutex_unlock(&tiles->lock);
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef PLASMA_TILES_H
+#define PLASMA_TILES_H
+
+#include "plasma-gen.h"
+
+/* Tile-parallel plasma renderer.
+ *
+ * A frame is cut into PLASMA_TILE_WIDTH x PLASMA_TILE_HEIGHT tiles (16KB of
+ * RGBA8888 pixels, small enough to stay in L1/L2 while being written).
+ * Each thread starts the frame with an even share of the tiles and, once
+ * it runs out, steals from the back of the other threads' shares.
+ * Tiles are rendered with the separable path, from row and column terms
+ * computed once per frame before the work is handed out.
+ *
+ * Everything is allocated by plasma_tiles_create(); rendering a frame only
+ * allocates when it is larger than all the previous ones.
+ */
+#define  PLASMA_TILE_WIDTH   256
+#define  PLASMA_TILE_HEIGHT  16
+
+typedef struct PlasmaTiles PlasmaTiles;
+
+/* 'numThreads' counts the calling thread, 0 means one per online core.
+ * Returns NULL on failure.
+ */
+PlasmaTiles* plasma_tiles_create(int numThreads);
+void         plasma_tiles_destroy(PlasmaTiles* tiles);
+int          plasma_tiles_threads(const PlasmaTiles* tiles);
+
+/* Same contract as plasma_fill(), returns once the whole frame is done. */
+void plasma_tiles_fill(PlasmaTiles* tiles, void* pixels, int width, int height,
+                       int stride, PlasmaFormat format, double t);
+
+#endif /* PLASMA_TILES_H */
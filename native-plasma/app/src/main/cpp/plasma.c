@@ -19,15 +19,23 @@
 
 #include <errno.h>
 #include <jni.h>
+#include <limits.h>
+#include <unistd.h>
 #include <sys/time.h>
 #include <time.h>
+#include <android/hardware_buffer.h>
 #include <android/log.h>
+#include <sys/system_properties.h>
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
+#include "frame-stats.h"
+#include "plasma-gen.h"
+#include "plasma-tiles.h"
+
 #define  LOG_TAG    "libplasma"
 #define  LOGI(...)  __android_log_print(ANDROID_LOG_INFO,LOG_TAG,__VA_ARGS__)
 #define  LOGW(...)  __android_log_print(ANDROID_LOG_WARN,LOG_TAG,__VA_ARGS__)
@@ -36,9 +44,6 @@
 /* Set to 1 to enable debug log traces. */
 #define DEBUG 0
 
-/* Set to 1 to optimize memory stores when generating plasma. */
-#define OPTIMIZE_WRITES  1
-
 /* Return current time in milliseconds */
 static double now_ms(void)
 {
@@ -47,251 +52,122 @@ static double now_ms(void)
     return tv.tv_sec*1000. + tv.tv_usec/1000.;
 }
 
-/* We're going to perform computations for every pixel of the target
- * bitmap. floating-point operations are very slow on ARMv5, and not
- * too bad on ARMv7 with the exception of trigonometric functions.
- *
- * For better performance on all platforms, we're going to use fixed-point
- * arithmetic and all kinds of tricks
+/* Map a window buffer format to the plasma output backend that renders
+ * it, returns -1 if there is none.
  */
-
-typedef int32_t  Fixed;
-
-#define  FIXED_BITS           16
-#define  FIXED_ONE            (1 << FIXED_BITS)
-#define  FIXED_AVERAGE(x,y)   (((x) + (y)) >> 1)
-
-#define  FIXED_FROM_INT(x)    ((x) << FIXED_BITS)
-#define  FIXED_TO_INT(x)      ((x) >> FIXED_BITS)
-
-#define  FIXED_FROM_FLOAT(x)  ((Fixed)((x)*FIXED_ONE))
-#define  FIXED_TO_FLOAT(x)    ((x)/(1.*FIXED_ONE))
-
-#define  FIXED_MUL(x,y)       (((int64_t)(x) * (y)) >> FIXED_BITS)
-#define  FIXED_DIV(x,y)       (((int64_t)(x) * FIXED_ONE) / (y))
-
-#define  FIXED_DIV2(x)        ((x) >> 1)
-#define  FIXED_AVERAGE(x,y)   (((x) + (y)) >> 1)
-
-#define  FIXED_FRAC(x)        ((x) & ((1 << FIXED_BITS)-1))
-#define  FIXED_TRUNC(x)       ((x) & ~((1 << FIXED_BITS)-1))
-
-#define  FIXED_FROM_INT_FLOAT(x,f)   (Fixed)((x)*(FIXED_ONE*(f)))
-
-typedef int32_t  Angle;
-
-#define  ANGLE_BITS              9
-
-#if ANGLE_BITS < 8
-#  error ANGLE_BITS must be at least 8
-#endif
-
-#define  ANGLE_2PI               (1 << ANGLE_BITS)
-#define  ANGLE_PI                (1 << (ANGLE_BITS-1))
-#define  ANGLE_PI2               (1 << (ANGLE_BITS-2))
-#define  ANGLE_PI4               (1 << (ANGLE_BITS-3))
-
-#define  ANGLE_FROM_FLOAT(x)   (Angle)((x)*ANGLE_PI/M_PI)
-#define  ANGLE_TO_FLOAT(x)     ((x)*M_PI/ANGLE_PI)
-
-#if ANGLE_BITS <= FIXED_BITS
-#  define  ANGLE_FROM_FIXED(x)     (Angle)((x) >> (FIXED_BITS - ANGLE_BITS))
-#  define  ANGLE_TO_FIXED(x)       (Fixed)((x) << (FIXED_BITS - ANGLE_BITS))
-#else
-#  define  ANGLE_FROM_FIXED(x)     (Angle)((x) << (ANGLE_BITS - FIXED_BITS))
-#  define  ANGLE_TO_FIXED(x)       (Fixed)((x) >> (ANGLE_BITS - FIXED_BITS))
-#endif
-
-static Fixed  angle_sin_tab[ANGLE_2PI+1];
-
-static void init_angles(void)
+static int plasma_format_from_window(int32_t windowFormat, PlasmaFormat* format)
 {
-    int  nn;
-    for (nn = 0; nn < ANGLE_2PI+1; nn++) {
-        double  radians = nn*M_PI/ANGLE_PI;
-        angle_sin_tab[nn] = FIXED_FROM_FLOAT(sin(radians));
+    switch (windowFormat) {
+        case WINDOW_FORMAT_RGBA_8888:
+        case WINDOW_FORMAT_RGBX_8888:
+            *format = PLASMA_FORMAT_RGBA8888;
+            return 0;
+        case WINDOW_FORMAT_RGB_565:
+            *format = PLASMA_FORMAT_RGB565;
+            return 0;
+        case AHARDWAREBUFFER_FORMAT_R10G10B10A2_UNORM:
+            *format = PLASMA_FORMAT_RGBA1010102;
+            return 0;
     }
+    return -1;
 }
 
-static __inline__ Fixed angle_sin( Angle  a )
-{
-    return angle_sin_tab[(uint32_t)a & (ANGLE_2PI-1)];
-}
-
-static __inline__ Fixed angle_cos( Angle  a )
-{
-    return angle_sin(a + ANGLE_PI2);
-}
-
-static __inline__ Fixed fixed_sin( Fixed  f )
-{
-    return angle_sin(ANGLE_FROM_FIXED(f));
-}
-
-static __inline__ Fixed  fixed_cos( Fixed  f )
-{
-    return angle_cos(ANGLE_FROM_FIXED(f));
-}
-
-/* Color palette used for rendering the plasma */
-#define  PALETTE_BITS   8
-#define  PALETTE_SIZE   (1 << PALETTE_BITS)
-
-#if PALETTE_BITS > FIXED_BITS
-#  error PALETTE_BITS must be smaller than FIXED_BITS 
-#endif
-
-static uint16_t  palette[PALETTE_SIZE];
-
-static uint16_t  make565(int red, int green, int blue)
-{
-    return (uint16_t)( ((red   << 8) & 0xf800) |
-                       ((green << 3) & 0x07e0) |
-                       ((blue  >> 3) & 0x001f) );
-}
-
-static void init_palette(void)
+/* Window format to render to: the "debug.plasma.format" system property
+ * (565, 8888 or 1010102) if set, otherwise the native format of the window
+ * when there is a backend for it, and RGB565 as a last resort.
+ *
+ *   adb shell setprop debug.plasma.format 1010102
+ */
+static int32_t select_window_format(ANativeWindow* window)
 {
-    int  nn, mm = 0;
-    /* fun with colors */
-    for (nn = 0; nn < PALETTE_SIZE/4; nn++) {
-        int  jj = (nn-mm)*4*255/PALETTE_SIZE;
-        palette[nn] = make565(255, jj, 255-jj);
-    }
-
-    for ( mm = nn; nn < PALETTE_SIZE/2; nn++ ) {
-        int  jj = (nn-mm)*4*255/PALETTE_SIZE;
-        palette[nn] = make565(255-jj, 255, jj);
+    char          value[PROP_VALUE_MAX];
+    PlasmaFormat  format;
+    int32_t       native = ANativeWindow_getFormat(window);
+
+    if (__system_property_get("debug.plasma.format", value) > 0) {
+        if (strcmp(value, "565") == 0)
+            return WINDOW_FORMAT_RGB_565;
+        if (strcmp(value, "8888") == 0)
+            return WINDOW_FORMAT_RGBX_8888;
+        if (strcmp(value, "1010102") == 0)
+            return AHARDWAREBUFFER_FORMAT_R10G10B10A2_UNORM;
+        LOGW("Ignoring debug.plasma.format=%s", value);
     }
-
-    for ( mm = nn; nn < PALETTE_SIZE*3/4; nn++ ) {
-        int  jj = (nn-mm)*4*255/PALETTE_SIZE;
-        palette[nn] = make565(0, 255-jj, 255);
-    }
-
-    for ( mm = nn; nn < PALETTE_SIZE; nn++ ) {
-        int  jj = (nn-mm)*4*255/PALETTE_SIZE;
-        palette[nn] = make565(jj, 0, 255);
-    }
-}
-
-static __inline__ uint16_t  palette_from_fixed( Fixed  x )
-{
-    if (x < 0) x = -x;
-    if (x >= FIXED_ONE) x = FIXED_ONE-1;
-    int  idx = FIXED_FRAC(x) >> (FIXED_BITS - PALETTE_BITS);
-    return palette[idx & (PALETTE_SIZE-1)];
-}
-
-/* Angles expressed as fixed point radians */
-
-static void init_tables(void)
-{
-    init_palette();
-    init_angles();
+    if (plasma_format_from_window(native, &format) == 0)
+        return native;
+    return WINDOW_FORMAT_RGB_565;
 }
 
-static void fill_plasma(ANativeWindow_Buffer* buffer, double  t)
+static void fill_plasma(PlasmaTiles* tiles, ANativeWindow_Buffer* buffer, double  t)
 {
-    Fixed yt1 = FIXED_FROM_FLOAT(t/1230.);
-    Fixed yt2 = yt1;
-    Fixed xt10 = FIXED_FROM_FLOAT(t/3000.);
-    Fixed xt20 = xt10;
-
-#define  YT1_INCR   FIXED_FROM_FLOAT(1/100.)
-#define  YT2_INCR   FIXED_FROM_FLOAT(1/163.)
-
-    void* pixels = buffer->bits;
     //LOGI("width=%d height=%d stride=%d format=%d", buffer->width, buffer->height,
     //        buffer->stride, buffer->format);
+    PlasmaFormat format;
 
-    int  yy;
-    for (yy = 0; yy < buffer->height; yy++) {
-        uint16_t*  line = (uint16_t*)pixels;
-        Fixed      base = fixed_sin(yt1) + fixed_sin(yt2);
-        Fixed      xt1 = xt10;
-        Fixed      xt2 = xt20;
-
-        yt1 += YT1_INCR;
-        yt2 += YT2_INCR;
-
-#define  XT1_INCR  FIXED_FROM_FLOAT(1/173.)
-#define  XT2_INCR  FIXED_FROM_FLOAT(1/242.)
-
-#if OPTIMIZE_WRITES
-        /* optimize memory writes by generating one aligned 32-bit store
-         * for every pair of pixels.
-         */
-        uint16_t*  line_end = line + buffer->width;
-
-        if (line < line_end) {
-            if (((uint32_t)(uintptr_t)line & 3) != 0) {
-                Fixed ii = base + fixed_sin(xt1) + fixed_sin(xt2);
-
-                xt1 += XT1_INCR;
-                xt2 += XT2_INCR;
-
-                line[0] = palette_from_fixed(ii >> 2);
-                line++;
-            }
-
-            while (line + 2 <= line_end) {
-                Fixed i1 = base + fixed_sin(xt1) + fixed_sin(xt2);
-                xt1 += XT1_INCR;
-                xt2 += XT2_INCR;
-
-                Fixed i2 = base + fixed_sin(xt1) + fixed_sin(xt2);
-                xt1 += XT1_INCR;
-                xt2 += XT2_INCR;
-
-                uint32_t  pixel = ((uint32_t)palette_from_fixed(i1 >> 2) << 16) |
-                                   (uint32_t)palette_from_fixed(i2 >> 2);
+    if (plasma_format_from_window(buffer->format, &format) != 0) {
+        LOGW("Unsupported window format %d", buffer->format);
+        return;
+    }
 
-                ((uint32_t*)line)[0] = pixel;
-                line += 2;
-            }
+    /* ANativeWindow_Buffer::stride is in pixels */
+    plasma_tiles_fill(tiles, buffer->bits, buffer->width, buffer->height,
+                      buffer->stride * plasma_bytes_per_pixel(format), format, t);
+}
 
-            if (line < line_end) {
-                Fixed ii = base + fixed_sin(xt1) + fixed_sin(xt2);
-                line[0] = palette_from_fixed(ii >> 2);
-                line++;
+#if DEBUG
+/* Log the tile renderer's frame time from 1 to all cores at 1080p and 4K */
+static void benchmark_tiles(void)
+{
+    static const int sizes[][2] = { { 1920, 1080 }, { 3840, 2160 } };
+    const int  frames = 20;
+    int        cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    size_t     ss;
+
+    for (ss = 0; ss < sizeof(sizes)/sizeof(sizes[0]); ss++) {
+        int    width = sizes[ss][0], height = sizes[ss][1];
+        int    stride = width * plasma_bytes_per_pixel(PLASMA_FORMAT_RGB565);
+        void*  pixels = malloc((size_t)stride * height);
+        double serial = 0.;
+        int    threads;
+
+        if (pixels == NULL)
+            return;
+
+        for (threads = 1; threads <= cores; threads++) {
+            PlasmaTiles* tiles = plasma_tiles_create(threads);
+            double       t0, ms;
+            int          nn;
+
+            if (tiles == NULL)
+                break;
+            t0 = now_ms();
+            for (nn = 0; nn < frames; nn++) {
+                plasma_tiles_fill(tiles, pixels, width, height, stride,
+                                  PLASMA_FORMAT_RGB565, nn * 16.);
             }
+            ms = (now_ms() - t0) / frames;
+            if (threads == 1)
+                serial = ms;
+            LOGI("tiles %dx%d: %d thread(s) %.2f ms/frame (x%.2f)",
+                 width, height, plasma_tiles_threads(tiles), ms, serial / ms);
+            plasma_tiles_destroy(tiles);
         }
-#else /* !OPTIMIZE_WRITES */
-        int xx;
-        for (xx = 0; xx < buffer->width; xx++) {
-
-            Fixed ii = base + fixed_sin(xt1) + fixed_sin(xt2);
-
-            xt1 += XT1_INCR;
-            xt2 += XT2_INCR;
-
-            line[xx] = palette_from_fixed(ii / 4);
-        }
-#endif /* !OPTIMIZE_WRITES */
-
-        // go to next line
-        pixels = (uint16_t*)pixels + buffer->stride;
+        free(pixels);
     }
 }
+#endif
 
 /* simple stats management */
-typedef struct {
-    double  renderTime;
-    double  frameTime;
-} FrameStats;
-
-#define  MAX_FRAME_STATS  200
-#define  MAX_PERIOD_MS    1500
+#define  TARGET_PERIOD_MS  (1000./60.)
+#define  MAX_PERIOD_MS     1500
 
 typedef struct {
     double  firstTime;
     double  lastTime;
     double  frameTime;
 
-    int         firstFrame;
-    int         numFrames;
-    FrameStats  frames[ MAX_FRAME_STATS ];
+    FrameStats  period;     /* logged and cleared every MAX_PERIOD_MS */
+    FrameStats  session;    /* everything since the engine started */
 } Stats;
 
 static void
@@ -299,8 +175,8 @@ stats_init( Stats*  s )
 {
     s->lastTime = now_ms();
     s->firstTime = 0.;
-    s->firstFrame = 0;
-    s->numFrames  = 0;
+    frame_stats_init(&s->period, TARGET_PERIOD_MS);
+    frame_stats_init(&s->session, TARGET_PERIOD_MS);
 }
 
 static void
@@ -309,65 +185,78 @@ stats_startFrame( Stats*  s )
     s->frameTime = now_ms();
 }
 
+static void
+stats_log( const FrameStats*  fs )
+{
+    FrameSummary  render, frame;
+
+    frame_histogram_summary(&fs->render, &render);
+    frame_histogram_summary(&fs->frame, &frame);
+    LOGI("frame ms (p50,p90,p99,p99.9,max) = (%.1f,%.1f,%.1f,%.1f,%.1f) "
+         "janky %llu/%llu\n",
+         frame.p50Ms, frame.p90Ms, frame.p99Ms, frame.p999Ms, frame.maxMs,
+         (unsigned long long)frame.janky, (unsigned long long)frame.count);
+    LOGI("render ms (p50,p90,p99,p99.9,max) = (%.1f,%.1f,%.1f,%.1f,%.1f) "
+         "over budget %llu/%llu\n",
+         render.p50Ms, render.p90Ms, render.p99Ms, render.p999Ms, render.maxMs,
+         (unsigned long long)render.janky, (unsigned long long)render.count);
+}
+
 static void
 stats_endFrame( Stats*  s )
 {
     double now = now_ms();
     double renderTime = now - s->frameTime;
     double frameTime  = now - s->lastTime;
-    int nn;
 
     if (now - s->firstTime >= MAX_PERIOD_MS) {
-        if (s->numFrames > 0) {
-            double minRender, maxRender, avgRender;
-            double minFrame, maxFrame, avgFrame;
-            int count;
-
-            nn = s->firstFrame;
-            minRender = maxRender = avgRender = s->frames[nn].renderTime;
-            minFrame  = maxFrame  = avgFrame  = s->frames[nn].frameTime;
-            for (count = s->numFrames; count > 0; count-- ) {
-                nn += 1;
-                if (nn >= MAX_FRAME_STATS)
-                    nn -= MAX_FRAME_STATS;
-                double render = s->frames[nn].renderTime;
-                if (render < minRender) minRender = render;
-                if (render > maxRender) maxRender = render;
-                double frame = s->frames[nn].frameTime;
-                if (frame < minFrame) minFrame = frame;
-                if (frame > maxFrame) maxFrame = frame;
-                avgRender += render;
-                avgFrame  += frame;
-            }
-            avgRender /= s->numFrames;
-            avgFrame  /= s->numFrames;
-
-            LOGI("frame/s (avg,min,max) = (%.1f,%.1f,%.1f) "
-                 "render time ms (avg,min,max) = (%.1f,%.1f,%.1f)\n",
-                 1000./avgFrame, 1000./maxFrame, 1000./minFrame,
-                 avgRender, minRender, maxRender);
-        }
-        s->numFrames  = 0;
-        s->firstFrame = 0;
-        s->firstTime  = now;
+        if (s->period.frame.count > 0)
+            stats_log(&s->period);
+        frame_stats_reset(&s->period);
+        s->firstTime = now;
     }
 
-    nn = s->firstFrame + s->numFrames;
-    if (nn >= MAX_FRAME_STATS)
-        nn -= MAX_FRAME_STATS;
+    frame_stats_record(&s->period, renderTime, frameTime);
+    frame_stats_record(&s->session, renderTime, frameTime);
 
-    s->frames[nn].renderTime = renderTime;
-    s->frames[nn].frameTime  = frameTime;
+    s->lastTime = now;
+}
 
-    if (s->numFrames < MAX_FRAME_STATS) {
-        s->numFrames += 1;
-    } else {
-        s->firstFrame += 1;
-        if (s->firstFrame >= MAX_FRAME_STATS)
-            s->firstFrame -= MAX_FRAME_STATS;
-    }
+/* Write the session statistics as frame-stats.csv and frame-stats.json in
+ * 'dir', which can then be pulled with 'adb shell run-as'.
+ */
+static void
+stats_dump( const Stats*  s, const char*  dir )
+{
+    static const struct {
+        const char*  name;
+        int        (*write)(const FrameStats*, FILE*);
+    } files[] = {
+        { "frame-stats.csv",  frame_stats_write_csv },
+        { "frame-stats.json", frame_stats_write_json },
+    };
+    size_t  nn;
+
+    if (dir == NULL || s->session.frame.count == 0)
+        return;
 
-    s->lastTime = now;
+    for (nn = 0; nn < sizeof(files)/sizeof(files[0]); nn++) {
+        char   path[PATH_MAX];
+        FILE*  f;
+        int    ret;
+
+        snprintf(path, sizeof(path), "%s/%s", dir, files[nn].name);
+        f = fopen(path, "w");
+        if (f == NULL) {
+            LOGW("Unable to open %s: %s", path, strerror(errno));
+            continue;
+        }
+        ret = files[nn].write(&s->session, f);
+        if (fclose(f) != 0 || ret != 0)
+            LOGW("Unable to write %s", path);
+        else
+            LOGI("Frame statistics written to %s", path);
+    }
 }
 
 // ----------------------------------------------------------------------
@@ -376,6 +265,7 @@ struct engine {
     struct android_app* app;
 
     Stats stats;
+    PlasmaTiles* tiles;
 
     int animating;
 };
@@ -401,7 +291,7 @@ static void engine_draw_frame(struct engine* engine) {
     time_ms -= start_ms;
 
     /* Now fill the values with a nice little plasma */
-    fill_plasma(&buffer, time_ms);
+    fill_plasma(engine->tiles, &buffer, time_ms);
 
     ANativeWindow_unlockAndPost(engine->app->window);
 
@@ -433,12 +323,22 @@ static void engine_handle_cmd(struct android_app* app, int32_t cmd) {
     switch (cmd) {
         case APP_CMD_INIT_WINDOW:
             if (engine->app->window != NULL) {
-                // fill_plasma() assumes 565 format, get it here
+                // save the original format, restored on APP_CMD_TERM_WINDOW
                 format = ANativeWindow_getFormat(app->window);
-                ANativeWindow_setBuffersGeometry(app->window,
+                int32_t selected = select_window_format(app->window);
+                if (ANativeWindow_setBuffersGeometry(app->window,
                               ANativeWindow_getWidth(app->window),
                               ANativeWindow_getHeight(app->window),
-                              WINDOW_FORMAT_RGB_565);
+                              selected) < 0 &&
+                    selected != WINDOW_FORMAT_RGB_565) {
+                    LOGW("Window format %d refused, using RGB565", selected);
+                    selected = WINDOW_FORMAT_RGB_565;
+                    ANativeWindow_setBuffersGeometry(app->window,
+                              ANativeWindow_getWidth(app->window),
+                              ANativeWindow_getHeight(app->window),
+                              selected);
+                }
+                LOGI("Rendering to window format %d", selected);
                 engine_draw_frame(engine);
             }
             break;
@@ -452,6 +352,7 @@ static void engine_handle_cmd(struct android_app* app, int32_t cmd) {
         case APP_CMD_LOST_FOCUS:
             engine->animating = 0;
             engine_draw_frame(engine);
+            stats_dump(&engine->stats, app->activity->internalDataPath);
             break;
     }
 }
@@ -468,10 +369,25 @@ void android_main(struct android_app* state) {
     engine.app = state;
 
     if (!init) {
-        init_tables();
+        plasma_init_tables();
+#if DEBUG
+        for (int ff = 0; ff < PLASMA_FORMAT_COUNT; ff++) {
+            LOGI("plasma_verify format %d: %d pixel(s) differ from the reference",
+                 ff, plasma_verify(1920, 1080, (PlasmaFormat)ff,
+                                   PLASMA_MODE_SEPARABLE, 0.));
+        }
+        benchmark_tiles();
+#endif
         init = 1;
     }
 
+    /* one render thread per core, the main thread included */
+    engine.tiles = plasma_tiles_create(0);
+    if (engine.tiles == NULL) {
+        LOGE("Unable to create the tile renderer");
+        return;
+    }
+
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
     start_ms = (((int64_t)now.tv_sec)*1000000000LL + now.tv_nsec)/1000000;
@@ -501,6 +417,7 @@ void android_main(struct android_app* state) {
             if (state->destroyRequested != 0) {
                 LOGI("Engine thread destroy requested!");
                 engine_term_display(&engine);
+                plasma_tiles_destroy(engine.tiles);
                 return;
             }
         }
@@ -0,0 +1,343 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Headless plasma benchmark: renders frames with the same generator as the
+ * app into a heap buffer and reports throughput and frame time percentiles.
+ *
+ *   plasma-bench [-w width] [-h height] [-n frames] [-f 565|8888|1010102|all]
+ *                [-m reference|simd|separable|tiles] [-t threads]
+ *                [-o frame.ppm] [-F frame_index] [-s stats.csv|stats.json] [-v]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "frame-stats.h"
+#include "plasma-gen.h"
+#include "plasma-tiles.h"
+
+/* Time step between two frames, in milliseconds (60Hz) */
+#define  FRAME_PERIOD_MS   (1000./60.)
+
+typedef enum {
+    MODE_REFERENCE,
+    MODE_SIMD,
+    MODE_SEPARABLE,
+    MODE_TILES,
+} Mode;
+
+static const char* mode_names[] = { "reference", "simd", "separable", "tiles" };
+
+/* indexed by PlasmaFormat */
+static const char* format_names[] = { "565", "8888", "1010102" };
+
+typedef struct {
+    int          width;
+    int          height;
+    int          frames;
+    int          verify;
+    const char*  dumpPath;
+    int          dumpFrame;
+    const char*  statsPath;
+} Options;
+
+typedef struct {
+    Mode          mode;
+    PlasmaTerms*  terms;
+    PlasmaTiles*  tiles;
+} Renderer;
+
+static void render(Renderer* r, void* pixels, int width, int height, int stride,
+                   PlasmaFormat format, double t)
+{
+    switch (r->mode) {
+        case MODE_REFERENCE:
+            plasma_fill_reference(pixels, width, height, stride, format, t);
+            break;
+        case MODE_SIMD:
+            plasma_fill(pixels, width, height, stride, format, t);
+            break;
+        case MODE_SEPARABLE:
+            plasma_fill_separable(r->terms, pixels, width, height, stride, format, t);
+            break;
+        case MODE_TILES:
+            plasma_tiles_fill(r->tiles, pixels, width, height, stride, format, t);
+            break;
+    }
+}
+
+static void fill_tiles(void* ctx, void* pixels, int width, int height, int stride,
+                       PlasmaFormat format, double t)
+{
+    plasma_tiles_fill((PlasmaTiles*)ctx, pixels, width, height, stride, format, t);
+}
+
+/* Render frame 't' with 'r' and the reference, return the number of
+ * differing pixels or -1 on allocation failure. The check is the app's own
+ * plasma_verify().
+ */
+static int verify(Renderer* r, int width, int height, PlasmaFormat format, double t)
+{
+    static const PlasmaMode  plasma_modes[] = {
+        PLASMA_MODE_REFERENCE, PLASMA_MODE_SIMD, PLASMA_MODE_SEPARABLE,
+    };
+
+    if (r->mode == MODE_TILES)
+        return plasma_verify_fill(fill_tiles, r->tiles, width, height, format, t);
+    return plasma_verify(width, height, format, plasma_modes[r->mode], t);
+}
+
+static double now_ms(void)
+{
+    struct timespec res;
+    clock_gettime(CLOCK_MONOTONIC, &res);
+    return 1000.0*res.tv_sec + (double)res.tv_nsec/1e6;
+}
+
+/* Write 'stats' as JSON if 'path' ends with .json, as CSV otherwise */
+static int write_stats(const char* path, const FrameStats* stats)
+{
+    size_t  len = strlen(path);
+    FILE*   f = fopen(path, "w");
+    int     ret;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    if (len >= 5 && strcmp(path + len - 5, ".json") == 0)
+        ret = frame_stats_write_json(stats, f);
+    else
+        ret = frame_stats_write_csv(stats, f);
+    if (fclose(f) != 0 || ret != 0) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+/* Write the frame as a binary 8-bit RGB PPM, expanding RGB565 to 8 bits
+ * per channel the same way the display would and truncating RGBA1010102.
+ */
+static int write_ppm(const char* path, const void* pixels, int width, int height,
+                     int stride, PlasmaFormat format)
+{
+    FILE*  f = fopen(path, "wb");
+    int    xx, yy;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", width, height);
+    for (yy = 0; yy < height; yy++) {
+        const uint8_t*  line = (const uint8_t*)pixels + (size_t)yy*stride;
+        for (xx = 0; xx < width; xx++) {
+            uint8_t  rgb[3];
+            if (format == PLASMA_FORMAT_RGBA8888) {
+                memcpy(rgb, line + xx*4, 3);
+            } else if (format == PLASMA_FORMAT_RGBA1010102) {
+                uint32_t  p;
+                memcpy(&p, line + xx*4, 4);
+                rgb[0] = (uint8_t)((p >> 2) & 0xff);
+                rgb[1] = (uint8_t)((p >> 12) & 0xff);
+                rgb[2] = (uint8_t)((p >> 22) & 0xff);
+            } else {
+                uint16_t  p = ((const uint16_t*)line)[xx];
+                int  r = (p >> 11) & 0x1f, g = (p >> 5) & 0x3f, b = p & 0x1f;
+                rgb[0] = (uint8_t)((r << 3) | (r >> 2));
+                rgb[1] = (uint8_t)((g << 2) | (g >> 4));
+                rgb[2] = (uint8_t)((b << 3) | (b >> 2));
+            }
+            fwrite(rgb, 1, 3, f);
+        }
+    }
+    if (fclose(f) != 0) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+static void usage(const char* argv0)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  -w WIDTH     frame width (default 1920)\n"
+        "  -h HEIGHT    frame height (default 1080)\n"
+        "  -n FRAMES    number of frames to render (default 100)\n"
+        "  -f FORMAT    565, 8888, 1010102 or all (default 565)\n"
+        "  -m MODE      reference, simd, separable or tiles (default tiles)\n"
+        "  -t THREADS   threads for the tiles mode, 0 = all cores (default 0)\n"
+        "  -o FILE      dump one frame as a PPM image\n"
+        "  -F INDEX     frame to dump with -o (default 0)\n"
+        "  -s FILE      write the frame statistics as CSV, or JSON for *.json\n"
+        "  -v           check the first frame against the reference\n",
+        argv0);
+}
+
+/* Render 'opt->frames' frames in 'format' and print the statistics.
+ * Returns 0 on success, 1 on error and 2 if the verification failed.
+ */
+static int run(Renderer* renderer, const Options* opt, PlasmaFormat format)
+{
+    static FrameStats  stats;
+    FrameSummary  summary;
+    int           width = opt->width, height = opt->height, frames = opt->frames;
+    int           stride, nn;
+    void*         pixels;
+    double        total = 0., last;
+
+    if (opt->verify) {
+        int  fails = verify(renderer, width, height, format, 0.);
+        printf("verify %s: %d pixel(s) differ from the reference\n",
+               format_names[format], fails);
+        if (fails != 0)
+            return 2;
+    }
+
+    stride = width * plasma_bytes_per_pixel(format);
+    pixels = malloc((size_t)stride * height);
+    if (pixels == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    /* a render is over budget when it could not sustain FRAME_PERIOD_MS */
+    frame_stats_init(&stats, FRAME_PERIOD_MS);
+    last = now_ms();
+    for (nn = 0; nn < frames; nn++) {
+        double  t = nn * FRAME_PERIOD_MS;
+        double  t0 = now_ms(), t1;
+
+        render(renderer, pixels, width, height, stride, format, t);
+        t1 = now_ms();
+        frame_stats_record(&stats, t1 - t0, t1 - last);
+        total += t1 - t0;
+        last = t1;
+
+        if (opt->dumpPath != NULL && nn == opt->dumpFrame &&
+            write_ppm(opt->dumpPath, pixels, width, height, stride, format) != 0) {
+            free(pixels);
+            return 1;
+        }
+    }
+    free(pixels);
+    frame_histogram_summary(&stats.render, &summary);
+
+    printf("%dx%d %s %s", width, height, format_names[format],
+           mode_names[renderer->mode]);
+    if (renderer->tiles != NULL)
+        printf(" (%d threads)", plasma_tiles_threads(renderer->tiles));
+    printf(", %d frames\n", frames);
+    printf("  %.1f Mpixel/s, %.1f frame/s\n",
+           (double)width * height * frames / (total * 1000.),
+           frames * 1000. / total);
+    printf("  frame ms: min %.3f p50 %.3f p90 %.3f p99 %.3f p99.9 %.3f max %.3f\n",
+           summary.minMs, summary.p50Ms, summary.p90Ms, summary.p99Ms,
+           summary.p999Ms, summary.maxMs);
+    printf("  %llu frame(s) over the %.1f ms budget\n",
+           (unsigned long long)summary.janky, FRAME_PERIOD_MS);
+
+    if (opt->statsPath != NULL && write_stats(opt->statsPath, &stats) != 0)
+        return 1;
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    Options       options = { 1920, 1080, 100, 0, NULL, 0, NULL };
+    int           threads = 0, allFormats = 0;
+    PlasmaFormat  format = PLASMA_FORMAT_RGB565;
+    Renderer      renderer = { MODE_TILES, NULL, NULL };
+    int           opt, nn, ret = 0;
+
+    while ((opt = getopt(argc, argv, "w:h:n:f:m:t:o:F:s:v")) != -1) {
+        switch (opt) {
+            case 'w': options.width = atoi(optarg); break;
+            case 'h': options.height = atoi(optarg); break;
+            case 'n': options.frames = atoi(optarg); break;
+            case 't': threads = atoi(optarg); break;
+            case 'o': options.dumpPath = optarg; break;
+            case 'F': options.dumpFrame = atoi(optarg); break;
+            case 's': options.statsPath = optarg; break;
+            case 'v': options.verify = 1; break;
+            case 'f':
+                for (nn = 0; nn < PLASMA_FORMAT_COUNT; nn++) {
+                    if (strcmp(optarg, format_names[nn]) == 0)
+                        break;
+                }
+                if (strcmp(optarg, "all") == 0) {
+                    allFormats = 1;
+                } else if (nn == PLASMA_FORMAT_COUNT) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                format = (PlasmaFormat)nn;
+                break;
+            case 'm':
+                for (nn = 0; nn < (int)(sizeof(mode_names)/sizeof(mode_names[0])); nn++) {
+                    if (strcmp(optarg, mode_names[nn]) == 0)
+                        break;
+                }
+                if (nn == (int)(sizeof(mode_names)/sizeof(mode_names[0]))) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                renderer.mode = (Mode)nn;
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (options.width <= 0 || options.height <= 0 || options.frames <= 0 ||
+        options.dumpFrame < 0 || options.dumpFrame >= options.frames) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (allFormats && (options.dumpPath != NULL || options.statsPath != NULL)) {
+        fprintf(stderr, "-o and -s need a single format\n");
+        return 1;
+    }
+
+    plasma_init_tables();
+
+    renderer.terms = plasma_terms_create();
+    if (renderer.mode == MODE_TILES)
+        renderer.tiles = plasma_tiles_create(threads);
+    if (renderer.terms == NULL ||
+        (renderer.mode == MODE_TILES && renderer.tiles == NULL)) {
+        fprintf(stderr, "unable to create the renderer\n");
+        return 1;
+    }
+
+    if (allFormats) {
+        for (nn = 0; nn < PLASMA_FORMAT_COUNT && ret == 0; nn++)
+            ret = run(&renderer, &options, (PlasmaFormat)nn);
+    } else {
+        ret = run(&renderer, &options, format);
+    }
+
+    plasma_tiles_destroy(renderer.tiles);
+    plasma_terms_destroy(renderer.terms);
+    return ret;
+}
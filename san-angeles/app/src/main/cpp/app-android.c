@@ -22,10 +22,14 @@
 #include <time.h>
 #include <android/log.h>
 #include <stdint.h>
+#include <string.h>
 #include "importgl.h"
 #include "app.h"
 
 int   gAppAlive   = 1;
+const char *gAppCacheDir = NULL;
+
+static char sCacheDir[512];
 
 static int  sWindowWidth  = 320;
 static int  sWindowHeight = 480;
@@ -45,8 +49,19 @@ _getTime(void)
 
 /* Call to initialize the graphics state */
 void
-Java_com_example_SanAngeles_DemoRenderer_nativeInit( JNIEnv*  env )
+Java_com_example_SanAngeles_DemoRenderer_nativeInit( JNIEnv*  env, jclass  clazz, jstring  cacheDir )
 {
+    const char*  dir = (*env)->GetStringUTFChars(env, cacheDir, NULL);
+
+    gAppCacheDir = NULL;
+    if (dir != NULL) {
+        if (strlen(dir) < sizeof(sCacheDir)) {
+            strcpy(sCacheDir, dir);
+            gAppCacheDir = sCacheDir;
+        }
+        (*env)->ReleaseStringUTFChars(env, cacheDir, dir);
+    }
+
     importGLInit();
     appInit();
     gAppAlive  = 1;
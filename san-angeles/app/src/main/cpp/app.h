@@ -47,6 +47,11 @@ extern void appRender(long tick, int width, int height);
  */
 extern int gAppAlive;
 
+/* Directory where the application can keep generated data between runs,
+ * or NULL. Defined by the application framework.
+ */
+extern const char *gAppCacheDir;
+
 
 #ifdef __cplusplus
 }
@@ -23,15 +23,21 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <float.h>
 #include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
 
 #include "importgl.h"
 
 #include "app.h"
 #include "shapes.h"
 #include "cams.h"
+#include "meshcache.h"
+#include "supershape.h"
 
 
 // Total run length is 20 * camera track base unit length (see cams.h).
@@ -77,12 +83,21 @@ typedef struct {
      * (i.e. tightly packed array). Color array is supposed to have 4
      * components per color with GL_UNSIGNED_BYTE datatype and stride 0.
      * Normal array is supposed to use GL_FIXED datatype and stride 0.
+     *
+     * When indexArray is non-NULL the object is drawn as indexCount / 3
+     * indexed triangles, and count is the number of distinct vertices.
+     *
+     * Objects loaded from the mesh cache point into its read-only
+     * mapping instead of owning their arrays.
      */
     GLfixed *vertexArray;
     GLubyte *colorArray;
     GLfixed *normalArray;
+    GLushort *indexArray;
     GLint vertexComponents;
     GLsizei count;
+    GLsizei indexCount;
+    MESHCACHEENTRY cacheEntry;
 } GLOBJECT;
 
 
@@ -96,19 +111,32 @@ static long sNextCamTrackStartTick = 0x7fffffff;
 static GLOBJECT *sSuperShapeObjects[SUPERSHAPE_COUNT] = { NULL };
 static GLOBJECT *sGroundPlane = NULL;
 
-
+// One building of the city, see recordModels().
 typedef struct {
-    float x, y, z;
-} VECTOR3;
+    const GLOBJECT *object;
+    GLfixed matrix[16];
+} MODELDRAW;
+
+#define CITY_SIZE 11
+#define MODELDRAW_COUNT (CITY_SIZE * CITY_SIZE)
+
+static MODELDRAW sModelDraws[MODELDRAW_COUNT];
+
 
 
 static void freeGLObject(GLOBJECT *object)
 {
     if (object == NULL)
         return;
-    free(object->normalArray);
-    free(object->colorArray);
-    free(object->vertexArray);
+    if (object->cacheEntry.mapping != NULL)
+        meshCacheRelease(&object->cacheEntry);
+    else
+    {
+        free(object->indexArray);
+        free(object->normalArray);
+        free(object->colorArray);
+        free(object->vertexArray);
+    }
     free(object);
 }
 
@@ -122,6 +150,9 @@ static GLOBJECT * newGLObject(long vertices, int vertexComponents,
         return NULL;
     result->count = vertices;
     result->vertexComponents = vertexComponents;
+    result->indexArray = NULL;
+    result->indexCount = 0;
+    memset(&result->cacheEntry, 0, sizeof(result->cacheEntry));
     result->vertexArray = (GLfixed *)malloc(vertices * vertexComponents *
                                             sizeof(GLfixed));
     result->colorArray = (GLubyte *)malloc(vertices * 4 * sizeof(GLubyte));
@@ -143,7 +174,8 @@ static GLOBJECT * newGLObject(long vertices, int vertexComponents,
 }
 
 
-static void drawGLObject(GLOBJECT *object)
+// Sets up the arrays of the object for drawBoundGLObject().
+static void bindGLObject(const GLOBJECT *object)
 {
     assert(object != NULL);
 
@@ -162,183 +194,110 @@ static void drawGLObject(GLOBJECT *object)
     }
     else
         glDisableClientState(GL_NORMAL_ARRAY);
-    glDrawArrays(GL_TRIANGLES, 0, object->count);
 }
 
 
-static void vector3Sub(VECTOR3 *dest, VECTOR3 *v1, VECTOR3 *v2)
+static void drawBoundGLObject(const GLOBJECT *object)
 {
-    dest->x = v1->x - v2->x;
-    dest->y = v1->y - v2->y;
-    dest->z = v1->z - v2->z;
+    if (object->indexArray)
+        glDrawElements(GL_TRIANGLES, object->indexCount, GL_UNSIGNED_SHORT,
+                       object->indexArray);
+    else
+        glDrawArrays(GL_TRIANGLES, 0, object->count);
 }
 
 
-static void superShapeMap(VECTOR3 *point, float r1, float r2, float t, float p)
+static void drawGLObject(const GLOBJECT *object)
 {
-    // sphere-mapping of supershape parameters
-    point->x = (float)(cos(t) * cos(p) / r1 / r2);
-    point->y = (float)(sin(t) * cos(p) / r1 / r2);
-    point->z = (float)(sin(p) / r2);
+    bindGLObject(object);
+    drawBoundGLObject(object);
 }
 
 
-static float ssFunc(const float t, const float *p)
+// Creates and returns a supershape object, see createSuperShapeMesh().
+static GLOBJECT * createSuperShape(const float *params, const float *baseColor)
 {
-    return (float)(pow(pow(fabs(cos(p[0] * t / 4)) / p[1], p[4]) +
-                       pow(fabs(sin(p[0] * t / 4)) / p[2], p[5]), 1 / p[3]));
+    GLOBJECT *result;
+    SUPERSHAPEMESH mesh;
+
+    result = (GLOBJECT *)malloc(sizeof(GLOBJECT));
+    if (result == NULL)
+        return NULL;
+    if (!createSuperShapeMesh(&mesh, params, baseColor))
+    {
+        free(result);
+        return NULL;
+    }
+    result->vertexArray = mesh.vertexArray;
+    result->colorArray = mesh.colorArray;
+    result->normalArray = mesh.normalArray;
+    result->indexArray = mesh.indexArray;
+    result->vertexComponents = 3;
+    result->count = mesh.vertexCount;
+    result->indexCount = mesh.indexCount;
+    memset(&result->cacheEntry, 0, sizeof(result->cacheEntry));
+    return result;
 }
 
 
-// Creates and returns a supershape object.
-// Based on Paul Bourke's POV-Ray implementation.
-// http://astronomy.swin.edu.au/~pbourke/povray/supershape/
-static GLOBJECT * createSuperShape(const float *params)
+// Returns the supershape from the mesh cache, or creates it and adds it
+// to the cache.
+static GLOBJECT * loadSuperShape(const float *params, const float *baseColor)
 {
-    const int resol1 = (int)params[SUPERSHAPE_PARAMS - 3];
-    const int resol2 = (int)params[SUPERSHAPE_PARAMS - 2];
-    // latitude 0 to pi/2 for no mirrored bottom
-    // (latitudeBegin==0 for -pi/2 to pi/2 originally)
-    const int latitudeBegin = resol2 / 4;
-    const int latitudeEnd = resol2 / 2;    // non-inclusive
-    const int longitudeCount = resol1;
-    const int latitudeCount = latitudeEnd - latitudeBegin;
-    const long triangleCount = longitudeCount * latitudeCount * 2;
-    const long vertices = triangleCount * 3;
+    unsigned long long key;
+    MESHCACHEENTRY entry;
     GLOBJECT *result;
-    float baseColor[3];
-    int a, longitude, latitude;
-    long currentVertex, currentQuad;
 
-    result = newGLObject(vertices, 3, 1);
-    if (result == NULL)
-        return NULL;
+    key = meshCacheHash(0, params, SUPERSHAPE_PARAMS * sizeof(float));
+    key = meshCacheHash(key, baseColor, 3 * sizeof(float));
 
-    for (a = 0; a < 3; ++a)
-        baseColor[a] = ((randomUInt() % 155) + 100) / 255.f;
+    if (meshCacheLoad(gAppCacheDir, key, &entry))
+    {
+        result = (GLOBJECT *)malloc(sizeof(GLOBJECT));
+        if (result != NULL)
+        {
+            // GL only reads the arrays, so they can stay in the mapping.
+            result->vertexArray = (GLfixed *)entry.vertexArray;
+            result->colorArray = (GLubyte *)entry.colorArray;
+            result->normalArray = (GLfixed *)entry.normalArray;
+            result->indexArray = (GLushort *)entry.indexArray;
+            result->vertexComponents = 3;
+            result->count = entry.vertexCount;
+            result->indexCount = entry.indexCount;
+            result->cacheEntry = entry;
+            return result;
+        }
+        meshCacheRelease(&entry);
+    }
 
-    currentQuad = 0;
-    currentVertex = 0;
+    result = createSuperShape(params, baseColor);
+    if (result != NULL)
+        meshCacheStore(gAppCacheDir, key, result->count, result->vertexArray,
+                       result->normalArray, result->colorArray,
+                       result->indexCount, result->indexArray);
+    return result;
+}
 
-    // longitude -pi to pi
-    for (longitude = 0; longitude < longitudeCount; ++longitude)
-    {
 
-        // latitude 0 to pi/2
-        for (latitude = latitudeBegin; latitude < latitudeEnd; ++latitude)
-        {
-            float t1 = -PI + longitude * 2 * PI / resol1;
-            float t2 = -PI + (longitude + 1) * 2 * PI / resol1;
-            float p1 = -PI / 2 + latitude * 2 * PI / resol2;
-            float p2 = -PI / 2 + (latitude + 1) * 2 * PI / resol2;
-            float r0, r1, r2, r3;
-
-            r0 = ssFunc(t1, params);
-            r1 = ssFunc(p1, &params[6]);
-            r2 = ssFunc(t2, params);
-            r3 = ssFunc(p2, &params[6]);
-
-            if (r0 != 0 && r1 != 0 && r2 != 0 && r3 != 0)
-            {
-                VECTOR3 pa, pb, pc, pd;
-                VECTOR3 v1, v2, n;
-                float ca;
-                int i;
-                //float lenSq, invLenSq;
-
-                superShapeMap(&pa, r0, r1, t1, p1);
-                superShapeMap(&pb, r2, r1, t2, p1);
-                superShapeMap(&pc, r2, r3, t2, p2);
-                superShapeMap(&pd, r0, r3, t1, p2);
-
-                // kludge to set lower edge of the object to fixed level
-                if (latitude == latitudeBegin + 1)
-                    pa.z = pb.z = 0;
-
-                vector3Sub(&v1, &pb, &pa);
-                vector3Sub(&v2, &pd, &pa);
-
-                // Calculate normal with cross product.
-                /*   i    j    k      i    j
-                 * v1.x v1.y v1.z | v1.x v1.y
-                 * v2.x v2.y v2.z | v2.x v2.y
-                 */
-
-                n.x = v1.y * v2.z - v1.z * v2.y;
-                n.y = v1.z * v2.x - v1.x * v2.z;
-                n.z = v1.x * v2.y - v1.y * v2.x;
-
-                /* Pre-normalization of the normals is disabled here because
-                 * they will be normalized anyway later due to automatic
-                 * normalization (GL_NORMALIZE). It is enabled because the
-                 * objects are scaled with glScale.
-                 */
-                /*
-                lenSq = n.x * n.x + n.y * n.y + n.z * n.z;
-                invLenSq = (float)(1 / sqrt(lenSq));
-                n.x *= invLenSq;
-                n.y *= invLenSq;
-                n.z *= invLenSq;
-                */
-
-                ca = pa.z + 0.5f;
-
-                for (i = currentVertex * 3;
-                     i < (currentVertex + 6) * 3;
-                     i += 3)
-                {
-                    result->normalArray[i] = FIXED(n.x);
-                    result->normalArray[i + 1] = FIXED(n.y);
-                    result->normalArray[i + 2] = FIXED(n.z);
-                }
-                for (i = currentVertex * 4;
-                     i < (currentVertex + 6) * 4;
-                     i += 4)
-                {
-                    int a, color[3];
-                    for (a = 0; a < 3; ++a)
-                    {
-                        color[a] = (int)(ca * baseColor[a] * 255);
-                        if (color[a] > 255) color[a] = 255;
-                    }
-                    result->colorArray[i] = (GLubyte)color[0];
-                    result->colorArray[i + 1] = (GLubyte)color[1];
-                    result->colorArray[i + 2] = (GLubyte)color[2];
-                    result->colorArray[i + 3] = 0;
-                }
-                result->vertexArray[currentVertex * 3] = FIXED(pa.x);
-                result->vertexArray[currentVertex * 3 + 1] = FIXED(pa.y);
-                result->vertexArray[currentVertex * 3 + 2] = FIXED(pa.z);
-                ++currentVertex;
-                result->vertexArray[currentVertex * 3] = FIXED(pb.x);
-                result->vertexArray[currentVertex * 3 + 1] = FIXED(pb.y);
-                result->vertexArray[currentVertex * 3 + 2] = FIXED(pb.z);
-                ++currentVertex;
-                result->vertexArray[currentVertex * 3] = FIXED(pd.x);
-                result->vertexArray[currentVertex * 3 + 1] = FIXED(pd.y);
-                result->vertexArray[currentVertex * 3 + 2] = FIXED(pd.z);
-                ++currentVertex;
-                result->vertexArray[currentVertex * 3] = FIXED(pb.x);
-                result->vertexArray[currentVertex * 3 + 1] = FIXED(pb.y);
-                result->vertexArray[currentVertex * 3 + 2] = FIXED(pb.z);
-                ++currentVertex;
-                result->vertexArray[currentVertex * 3] = FIXED(pc.x);
-                result->vertexArray[currentVertex * 3 + 1] = FIXED(pc.y);
-                result->vertexArray[currentVertex * 3 + 2] = FIXED(pc.z);
-                ++currentVertex;
-                result->vertexArray[currentVertex * 3] = FIXED(pd.x);
-                result->vertexArray[currentVertex * 3 + 1] = FIXED(pd.y);
-                result->vertexArray[currentVertex * 3 + 2] = FIXED(pd.z);
-                ++currentVertex;
-            } // r0 && r1 && r2 && r3
-            ++currentQuad;
-        } // latitude
-    } // longitude
+// Maximum number of threads creating the supershapes at startup,
+// the calling thread included.
+#define MAX_INIT_THREADS 4
 
-    // Set number of vertices in object to the actual amount created.
-    result->count = currentVertex;
+typedef struct {
+    float baseColors[SUPERSHAPE_COUNT][3];
+    atomic_int nextShape;
+} SHAPEJOBS;
 
-    return result;
+
+static void * superShapeWorker(void *arg)
+{
+    SHAPEJOBS *jobs = (SHAPEJOBS *)arg;
+    int a;
+
+    while ((a = atomic_fetch_add(&jobs->nextShape, 1)) < (int)SUPERSHAPE_COUNT)
+        sSuperShapeObjects[a] = loadSuperShape(sSuperShapeParams[a],
+                                               jobs->baseColors[a]);
+    return NULL;
 }
 
 
@@ -459,15 +418,78 @@ static void drawFadeQuad()
 }
 
 
+/* The buildings only depend on the random sequence seeded with 9, so
+ * their model matrices are computed once here instead of being rebuilt
+ * from glTranslatex/glRotatex/glScalex every frame. The list is sorted by
+ * shape so that drawModels() sets up the arrays of each shape only once.
+ */
+static void recordModels()
+{
+    const int translationScale = 9;
+    int shapes[MODELDRAW_COUNT];
+    float matrices[MODELDRAW_COUNT][16];
+    int a, i, x, y, count;
+
+    seedRandom(9);
+
+    a = 0;
+    for (y = -5; y <= 5; ++y)
+    {
+        for (x = -5; x <= 5; ++x)
+        {
+            float *m = matrices[a];
+            float scale, angle, c, s;
+
+            // Same sequence of random numbers as the drawing loop used.
+            shapes[a] = randomUInt() % SUPERSHAPE_COUNT;
+            angle = (randomUInt() % 360) * PI / 180;
+            scale = sSuperShapeParams[shapes[a]][SUPERSHAPE_PARAMS - 1];
+            c = (float)cos(angle);
+            s = (float)sin(angle);
+
+            // translate * rotate around Z * scale, in column-major order.
+            memset(m, 0, sizeof(matrices[a]));
+            m[0] = c * scale;
+            m[1] = s * scale;
+            m[4] = -s * scale;
+            m[5] = c * scale;
+            m[10] = scale;
+            m[12] = (float)(x * translationScale);
+            m[13] = (float)(y * translationScale);
+            m[15] = 1;
+            ++a;
+        }
+    }
+
+    count = 0;
+    for (i = 0; i < SUPERSHAPE_COUNT; ++i)
+    {
+        for (a = 0; a < MODELDRAW_COUNT; ++a)
+        {
+            int k;
+            if (shapes[a] != i)
+                continue;
+            sModelDraws[count].object = sSuperShapeObjects[i];
+            for (k = 0; k < 16; ++k)
+                sModelDraws[count].matrix[k] = FIXED(matrices[a][k]);
+            ++count;
+        }
+    }
+    assert(count == MODELDRAW_COUNT);
+}
+
+
 // Called from the app framework.
 void appInit()
 {
-    int a;
+    SHAPEJOBS jobs;
+    pthread_t threads[MAX_INIT_THREADS];
+    int a, b, threadCount;
 
     glEnable(GL_NORMALIZE);
     glEnable(GL_DEPTH_TEST);
     glDisable(GL_CULL_FACE);
-    glShadeModel(GL_FLAT);
+    glShadeModel(GL_SMOOTH);
 
     glEnable(GL_LIGHTING);
     glEnable(GL_LIGHT0);
@@ -479,13 +501,34 @@ void appInit()
 
     seedRandom(15);
 
+    // The colors are drawn here, in shape order, so that the random
+    // sequence doesn't depend on which thread creates which shape.
     for (a = 0; a < SUPERSHAPE_COUNT; ++a)
     {
-        sSuperShapeObjects[a] = createSuperShape(sSuperShapeParams[a]);
-        assert(sSuperShapeObjects[a] != NULL);
+        for (b = 0; b < 3; ++b)
+            jobs.baseColors[a][b] = ((randomUInt() % 155) + 100) / 255.f;
     }
+    atomic_init(&jobs.nextShape, 0);
+
+    threadCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threadCount > MAX_INIT_THREADS)
+        threadCount = MAX_INIT_THREADS;
+    for (a = 1; a < threadCount; ++a)
+    {
+        if (pthread_create(&threads[a], NULL, superShapeWorker, &jobs) != 0)
+            break;
+    }
+    threadCount = a;
+    superShapeWorker(&jobs);
+    for (a = 1; a < threadCount; ++a)
+        pthread_join(threads[a], NULL);
+
+    for (a = 0; a < SUPERSHAPE_COUNT; ++a)
+        assert(sSuperShapeObjects[a] != NULL);
     sGroundPlane = createGroundPlane();
     assert(sGroundPlane != NULL);
+
+    recordModels();
 }
 
 
@@ -560,35 +603,28 @@ static void configureLightAndMaterial()
 static void drawModels(float zScale)
 {
     const int translationScale = 9;
-    int x, y;
-
-    seedRandom(9);
+    const GLOBJECT *bound = NULL;
+    const GLOBJECT *ship = sSuperShapeObjects[SUPERSHAPE_COUNT - 1];
+    int a, x;
 
     glScalex(1 << 16, 1 << 16, (GLfixed)(zScale * 65536));
 
-    for (y = -5; y <= 5; ++y)
+    for (a = 0; a < MODELDRAW_COUNT; ++a)
     {
-        for (x = -5; x <= 5; ++x)
+        const MODELDRAW *draw = &sModelDraws[a];
+        if (draw->object != bound)
         {
-            float buildingScale;
-            GLfixed fixedScale;
-
-            int curShape = randomUInt() % SUPERSHAPE_COUNT;
-            buildingScale = sSuperShapeParams[curShape][SUPERSHAPE_PARAMS - 1];
-            fixedScale = (GLfixed)(buildingScale * 65536);
-
-            glPushMatrix();
-            glTranslatex((x * translationScale) * 65536,
-                         (y * translationScale) * 65536,
-                         0);
-            glRotatex((GLfixed)((randomUInt() % 360) << 16), 0, 0, 1 << 16);
-            glScalex(fixedScale, fixedScale, fixedScale);
-
-            drawGLObject(sSuperShapeObjects[curShape]);
-            glPopMatrix();
+            bound = draw->object;
+            bindGLObject(bound);
         }
+        glPushMatrix();
+        glMultMatrixx(draw->matrix);
+        drawBoundGLObject(bound);
+        glPopMatrix();
     }
 
+    if (ship != bound)
+        bindGLObject(ship);
     for (x = -2; x <= 2; ++x)
     {
         const int shipScale100 = translationScale * 500;
@@ -597,12 +633,12 @@ static void drawModels(float zScale)
         GLfixed fixedOffs = (GLfixed)(offs * 65536);
         glPushMatrix();
         glTranslatex(fixedOffs, -4 * 65536, 2 << 16);
-        drawGLObject(sSuperShapeObjects[SUPERSHAPE_COUNT - 1]);
+        drawBoundGLObject(ship);
         glPopMatrix();
         glPushMatrix();
         glTranslatex(-4 * 65536, fixedOffs, 4 << 16);
         glRotatex(90 << 16, 0, 0, 1 << 16);
-        drawGLObject(sSuperShapeObjects[SUPERSHAPE_COUNT - 1]);
+        drawBoundGLObject(ship);
         glPopMatrix();
     }
 }
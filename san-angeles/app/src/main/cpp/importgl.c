@@ -128,6 +128,7 @@ int importGLInit()
     IMPORT_FUNC(glDisable);
     IMPORT_FUNC(glDisableClientState);
     IMPORT_FUNC(glDrawArrays);
+    IMPORT_FUNC(glDrawElements);
     IMPORT_FUNC(glEnable);
     IMPORT_FUNC(glEnableClientState);
     IMPORT_FUNC(glFrustumx);
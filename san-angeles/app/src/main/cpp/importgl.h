@@ -85,6 +85,7 @@ FNDEF(void, glColorPointer, (GLint size, GLenum type, GLsizei stride, const GLvo
 FNDEF(void, glDisable, (GLenum cap));
 FNDEF(void, glDisableClientState, (GLenum array));
 FNDEF(void, glDrawArrays, (GLenum mode, GLint first, GLsizei count));
+FNDEF(void, glDrawElements, (GLenum mode, GLsizei count, GLenum type, const GLvoid *indices));
 FNDEF(void, glEnable, (GLenum cap));
 FNDEF(void, glEnableClientState, (GLenum array));
 FNDEF(void, glFrustumx, (GLfixed left, GLfixed right, GLfixed bottom, GLfixed top, GLfixed zNear, GLfixed zFar));
@@ -137,6 +138,7 @@ FNDEF(void, glViewport, (GLint x, GLint y, GLsizei width, GLsizei height));
 #define glDisable               FNPTR(glDisable)
 #define glDisableClientState    FNPTR(glDisableClientState)
 #define glDrawArrays            FNPTR(glDrawArrays)
+#define glDrawElements          FNPTR(glDrawElements)
 #define glEnable                FNPTR(glEnable)
 #define glEnableClientState     FNPTR(glEnableClientState)
 #define glFrustumx              FNPTR(glFrustumx)
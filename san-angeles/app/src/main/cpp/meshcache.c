@@ -0,0 +1,203 @@
+/* San Angeles Observation OpenGL ES version example
+ * Copyright 2009 The Android Open Source Project
+ * All rights reserved.
+ *
+ * This source is free software; you can redistribute it and/or
+ * modify it under the terms of EITHER:
+ *   (1) The GNU Lesser General Public License as published by the Free
+ *       Software Foundation; either version 2.1 of the License, or (at
+ *       your option) any later version. The text of the GNU Lesser
+ *       General Public License is included with this source in the
+ *       file LICENSE-LGPL.txt.
+ *   (2) The BSD-style license that is included with this source in
+ *       the file LICENSE-BSD.txt.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files
+ * LICENSE-LGPL.txt and LICENSE-BSD.txt for more details.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "meshcache.h"
+
+
+// Bump when the layout or the way meshes are generated changes.
+#define MESHCACHE_VERSION 1
+
+typedef struct {
+    char magic[4];              // "SAMC"
+    unsigned int version;
+    unsigned long long key;
+    unsigned int vertexCount;
+    unsigned int indexCount;
+} MESHCACHEHEADER;
+
+/* The header is followed by the vertex, normal, color and index arrays,
+ * in that order and tightly packed: every array but the last one has a
+ * size multiple of 4, so they are all naturally aligned in the mapping.
+ */
+static size_t meshFileSize(unsigned long vertexCount, unsigned long indexCount)
+{
+    return sizeof(MESHCACHEHEADER) +
+           vertexCount * (3 * sizeof(GLfixed) + 3 * sizeof(GLfixed) +
+                          4 * sizeof(GLubyte)) +
+           indexCount * sizeof(GLushort);
+}
+
+
+static void meshFilePath(char *path, size_t size, const char *dir,
+                         unsigned long long key)
+{
+    snprintf(path, size, "%s/supershape-%016llx.mesh", dir, key);
+}
+
+
+unsigned long long meshCacheHash(unsigned long long hash,
+                                 const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t i;
+
+    if (hash == 0)
+        hash = 0xcbf29ce484222325ULL;
+    for (i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+
+int meshCacheLoad(const char *dir, unsigned long long key,
+                  MESHCACHEENTRY *entry)
+{
+    char path[512];
+    struct stat st;
+    const MESHCACHEHEADER *header;
+    const char *data;
+    void *mapping;
+    long vertexCount, indexCount, i;
+    int fd;
+
+    memset(entry, 0, sizeof(*entry));
+    if (dir == NULL)
+        return 0;
+
+    meshFilePath(path, sizeof(path), dir, key);
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return 0;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(MESHCACHEHEADER))
+    {
+        close(fd);
+        return 0;
+    }
+    mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return 0;
+
+    // The counts are bounded before meshFileSize(), which could wrap
+    // around on 32-bit devices, and must fit a long for GL.
+    header = (const MESHCACHEHEADER *)mapping;
+    vertexCount = (long)header->vertexCount;
+    indexCount = (long)header->indexCount;
+    if (memcmp(header->magic, "SAMC", 4) != 0 ||
+        header->version != MESHCACHE_VERSION ||
+        header->key != key ||
+        vertexCount <= 0 || vertexCount > 65536 ||
+        indexCount < 0 ||
+        indexCount > (long)(st.st_size / sizeof(GLushort)) ||
+        meshFileSize(vertexCount, indexCount) != (size_t)st.st_size)
+    {
+        munmap(mapping, st.st_size);
+        return 0;
+    }
+
+    data = (const char *)(header + 1);
+    entry->mapping = mapping;
+    entry->mappingSize = st.st_size;
+    entry->vertexCount = vertexCount;
+    entry->indexCount = indexCount;
+    entry->vertexArray = (const GLfixed *)data;
+    data += entry->vertexCount * 3 * sizeof(GLfixed);
+    entry->normalArray = (const GLfixed *)data;
+    data += entry->vertexCount * 3 * sizeof(GLfixed);
+    entry->colorArray = (const GLubyte *)data;
+    data += entry->vertexCount * 4 * sizeof(GLubyte);
+    entry->indexArray = (const GLushort *)data;
+
+    // A truncated or stale file must not make GL read out of bounds.
+    for (i = 0; i < entry->indexCount; ++i)
+    {
+        if (entry->indexArray[i] >= entry->vertexCount)
+        {
+            meshCacheRelease(entry);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+int meshCacheStore(const char *dir, unsigned long long key,
+                   long vertexCount, const GLfixed *vertexArray,
+                   const GLfixed *normalArray, const GLubyte *colorArray,
+                   long indexCount, const GLushort *indexArray)
+{
+    char path[512], tmpPath[520];
+    MESHCACHEHEADER header;
+    FILE *file;
+    int ok;
+
+    if (dir == NULL)
+        return 0;
+
+    memcpy(header.magic, "SAMC", 4);
+    header.version = MESHCACHE_VERSION;
+    header.key = key;
+    header.vertexCount = (unsigned int)vertexCount;
+    header.indexCount = (unsigned int)indexCount;
+
+    // Write to a temporary file first so that readers never see half a mesh.
+    meshFilePath(path, sizeof(path), dir, key);
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    file = fopen(tmpPath, "wb");
+    if (file == NULL)
+        return 0;
+
+    ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+         fwrite(vertexArray, sizeof(GLfixed), vertexCount * 3, file) ==
+             (size_t)vertexCount * 3 &&
+         fwrite(normalArray, sizeof(GLfixed), vertexCount * 3, file) ==
+             (size_t)vertexCount * 3 &&
+         fwrite(colorArray, sizeof(GLubyte), vertexCount * 4, file) ==
+             (size_t)vertexCount * 4 &&
+         fwrite(indexArray, sizeof(GLushort), indexCount, file) ==
+             (size_t)indexCount;
+    if (fclose(file) != 0)
+        ok = 0;
+
+    if (!ok || rename(tmpPath, path) != 0)
+    {
+        unlink(tmpPath);
+        return 0;
+    }
+    return 1;
+}
+
+
+void meshCacheRelease(MESHCACHEENTRY *entry)
+{
+    if (entry->mapping != NULL)
+        munmap(entry->mapping, entry->mappingSize);
+    memset(entry, 0, sizeof(*entry));
+}
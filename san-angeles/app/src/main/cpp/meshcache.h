@@ -0,0 +1,66 @@
+/* San Angeles Observation OpenGL ES version example
+ * Copyright 2009 The Android Open Source Project
+ * All rights reserved.
+ *
+ * This source is free software; you can redistribute it and/or
+ * modify it under the terms of EITHER:
+ *   (1) The GNU Lesser General Public License as published by the Free
+ *       Software Foundation; either version 2.1 of the License, or (at
+ *       your option) any later version. The text of the GNU Lesser
+ *       General Public License is included with this source in the
+ *       file LICENSE-LGPL.txt.
+ *   (2) The BSD-style license that is included with this source in
+ *       the file LICENSE-BSD.txt.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files
+ * LICENSE-LGPL.txt and LICENSE-BSD.txt for more details.
+ */
+
+#ifndef MESHCACHE_H_INCLUDED
+#define MESHCACHE_H_INCLUDED
+
+#include <stddef.h>
+
+#include "importgl.h"
+
+
+/* On-disk cache of generated indexed meshes.
+ *
+ * Each mesh is stored in its own file named after a 64-bit key, which the
+ * caller derives from everything the mesh depends on with meshCacheHash().
+ * Loading maps the file read-only and points straight into the mapping,
+ * so a cached mesh costs no parsing and no copy. Files are native-endian
+ * and only meant to be read back on the device that wrote them.
+ */
+typedef struct {
+    void *mapping;          // NULL when the mesh is not mapped
+    size_t mappingSize;
+    const GLfixed *vertexArray;     // 3 per vertex
+    const GLfixed *normalArray;     // 3 per vertex
+    const GLubyte *colorArray;      // 4 per vertex
+    const GLushort *indexArray;
+    long vertexCount;
+    long indexCount;
+} MESHCACHEENTRY;
+
+
+// FNV-1a, start with hash = 0 and chain calls to hash several buffers.
+extern unsigned long long meshCacheHash(unsigned long long hash,
+                                        const void *data, size_t size);
+
+// Returns 1 and fills entry if 'dir' holds a valid mesh for 'key', 0 otherwise.
+extern int meshCacheLoad(const char *dir, unsigned long long key,
+                         MESHCACHEENTRY *entry);
+
+// Writes the mesh for 'key' to 'dir', returns 1 on success.
+extern int meshCacheStore(const char *dir, unsigned long long key,
+                          long vertexCount, const GLfixed *vertexArray,
+                          const GLfixed *normalArray, const GLubyte *colorArray,
+                          long indexCount, const GLushort *indexArray);
+
+extern void meshCacheRelease(MESHCACHEENTRY *entry);
+
+
+#endif // !MESHCACHE_H_INCLUDED
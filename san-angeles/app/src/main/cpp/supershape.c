@@ -0,0 +1,600 @@
+/* San Angeles Observation OpenGL ES version example
+ * Copyright 2009 The Android Open Source Project
+ * All rights reserved.
+ *
+ * This source is free software; you can redistribute it and/or
+ * modify it under the terms of EITHER:
+ *   (1) The GNU Lesser General Public License as published by the Free
+ *       Software Foundation; either version 2.1 of the License, or (at
+ *       your option) any later version. The text of the GNU Lesser
+ *       General Public License is included with this source in the
+ *       file LICENSE-LGPL.txt.
+ *   (2) The BSD-style license that is included with this source in
+ *       the file LICENSE-BSD.txt.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files
+ * LICENSE-LGPL.txt and LICENSE-BSD.txt for more details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#include "supershape.h"
+
+
+#undef PI
+#define PI 3.1415926535897932f
+
+
+// Capped conversion from float to fixed, as in demo.c.
+static long floatToFixed(float value)
+{
+    if (value < -32768) value = -32768;
+    if (value > 32767) value = 32767;
+    return (long)(value * 65536);
+}
+
+#define FIXED(value) floatToFixed(value)
+
+
+typedef struct {
+    float x, y, z;
+} VECTOR3;
+
+
+static void vector3Sub(VECTOR3 *dest, const VECTOR3 *v1, const VECTOR3 *v2)
+{
+    dest->x = v1->x - v2->x;
+    dest->y = v1->y - v2->y;
+    dest->z = v1->z - v2->z;
+}
+
+
+static float ssFunc(const float t, const float *p)
+{
+    return (float)(pow(pow(fabs(cos(p[0] * t / 4)) / p[1], p[4]) +
+                       pow(fabs(sin(p[0] * t / 4)) / p[2], p[5]), 1 / p[3]));
+}
+
+
+// Post-transform vertex cache size assumed by optimizeVertexCache().
+#define VERTEX_CACHE_SIZE 32
+
+// Shapes with up to this many latitude rows keep the order of the grid,
+// one longitude column after the other: the previous column is still in
+// the cache, so it already reuses about as many vertices as the
+// optimization would, at no cost.
+#define NATURAL_ORDER_MAX_ROWS 7
+
+
+// Active triangle counts below which vertex scores come from a table.
+#define VERTEX_VALENCE_TABLE_SIZE 16
+
+
+// Score terms of vertexCacheScore(), computed once per mesh.
+typedef struct {
+    float cache[VERTEX_CACHE_SIZE];
+    float valence[VERTEX_VALENCE_TABLE_SIZE];
+} VERTEXSCORETABLE;
+
+
+static float valenceScore(int activeTriangles)
+{
+    return 2 * (float)pow(activeTriangles, -0.5f);
+}
+
+
+static void initVertexScoreTable(VERTEXSCORETABLE *table)
+{
+    int i;
+
+    for (i = 0; i < VERTEX_CACHE_SIZE; ++i)
+    {
+        if (i < 3)
+            table->cache[i] = 0.75f;
+        else
+            table->cache[i] = (float)pow(1 - (i - 3) /
+                                         (float)(VERTEX_CACHE_SIZE - 3), 1.5f);
+    }
+    table->valence[0] = 0;
+    for (i = 1; i < VERTEX_VALENCE_TABLE_SIZE; ++i)
+        table->valence[i] = valenceScore(i);
+}
+
+
+/* Score of a vertex for the vertex cache optimization, from Tom Forsyth's
+ * "Linear-Speed Vertex Cache Optimisation": vertices used by the last
+ * triangle get a fixed score, the others decay with their age in the
+ * cache, and vertices with few triangles left are boosted so that no
+ * lonely triangle gets left behind. Both terms are looked up in 'table',
+ * pow() is only called for vertices with many triangles.
+ */
+static float vertexCacheScore(const VERTEXSCORETABLE *table,
+                              int cachePosition, int activeTriangles)
+{
+    float score = 0;
+
+    if (activeTriangles == 0)
+        return -1;
+
+    if (cachePosition >= 0)
+        score = table->cache[cachePosition];
+    if (activeTriangles < VERTEX_VALENCE_TABLE_SIZE)
+        return score + table->valence[activeTriangles];
+    return score + valenceScore(activeTriangles);
+}
+
+
+/* Reorder the triangles of an indexed mesh so that consecutive triangles
+ * reuse the vertices still in the post-transform vertex cache. The mesh
+ * is left untouched if the working memory can't be allocated.
+ */
+static void optimizeVertexCache(GLushort *indices, long triangleCount,
+                                long vertexCount)
+{
+    long *firstTriangle = (long *)calloc(vertexCount + 1, sizeof(long));
+    long *vertexTriangles = (long *)malloc(triangleCount * 3 * sizeof(long));
+    int *activeTriangles = (int *)calloc(vertexCount, sizeof(int));
+    int *cachePosition = (int *)malloc(vertexCount * sizeof(int));
+    float *vertexScore = (float *)malloc(vertexCount * sizeof(float));
+    float *triangleScore = (float *)malloc(triangleCount * sizeof(float));
+    unsigned char *emitted = (unsigned char *)calloc(triangleCount, 1);
+    GLushort *output = (GLushort *)malloc(triangleCount * 3 * sizeof(GLushort));
+    long cache[VERTEX_CACHE_SIZE + 3];
+    VERTEXSCORETABLE scoreTable;
+    int cacheCount = 0;
+    long i, t, v, best = -1;
+
+    if (firstTriangle == NULL || vertexTriangles == NULL ||
+        activeTriangles == NULL || cachePosition == NULL ||
+        vertexScore == NULL || triangleScore == NULL ||
+        emitted == NULL || output == NULL)
+        goto done;
+
+    initVertexScoreTable(&scoreTable);
+
+    // Triangles using each vertex, as ranges of vertexTriangles.
+    for (i = 0; i < triangleCount * 3; ++i)
+        ++activeTriangles[indices[i]];
+    for (v = 0; v < vertexCount; ++v)
+        firstTriangle[v + 1] = firstTriangle[v] + activeTriangles[v];
+    for (v = 0; v < vertexCount; ++v)
+        activeTriangles[v] = 0;
+    for (i = 0; i < triangleCount * 3; ++i)
+    {
+        v = indices[i];
+        vertexTriangles[firstTriangle[v] + activeTriangles[v]++] = i / 3;
+    }
+
+    for (v = 0; v < vertexCount; ++v)
+    {
+        cachePosition[v] = -1;
+        vertexScore[v] = vertexCacheScore(&scoreTable, -1, activeTriangles[v]);
+    }
+    for (t = 0; t < triangleCount; ++t)
+        triangleScore[t] = vertexScore[indices[t * 3]] +
+                           vertexScore[indices[t * 3 + 1]] +
+                           vertexScore[indices[t * 3 + 2]];
+
+    for (i = 0; i < triangleCount; ++i)
+    {
+        long newCache[VERTEX_CACHE_SIZE + 3];
+        int newCount = 0, a, c;
+
+        // Nothing in the cache: restart from the best remaining triangle.
+        if (best < 0)
+        {
+            for (t = 0; t < triangleCount; ++t)
+            {
+                if (!emitted[t] &&
+                    (best < 0 || triangleScore[t] > triangleScore[best]))
+                    best = t;
+            }
+        }
+
+        emitted[best] = 1;
+        for (a = 0; a < 3; ++a)
+        {
+            long *tris;
+            int k;
+
+            v = indices[best * 3 + a];
+            output[i * 3 + a] = (GLushort)v;
+            newCache[newCount++] = v;
+
+            // Move the triangle out of the active range of the vertex.
+            tris = &vertexTriangles[firstTriangle[v]];
+            for (k = 0; tris[k] != best; ++k)
+                ;
+            tris[k] = tris[--activeTriangles[v]];
+            tris[activeTriangles[v]] = best;
+        }
+
+        // The triangle's vertices go to the front of the LRU cache.
+        for (c = 0; c < cacheCount; ++c)
+        {
+            v = cache[c];
+            if (v != newCache[0] && v != newCache[1] && v != newCache[2] &&
+                newCount < VERTEX_CACHE_SIZE + 3)
+                newCache[newCount++] = v;
+            else
+                cachePosition[v] = -1;
+        }
+        for (c = 0; c < newCount; ++c)
+        {
+            cache[c] = newCache[c];
+            cachePosition[cache[c]] = c < VERTEX_CACHE_SIZE ? c : -1;
+        }
+        cacheCount = newCount;
+
+        // Rescore the cached vertices and pick the next triangle among
+        // the ones they still belong to.
+        best = -1;
+        for (c = 0; c < cacheCount; ++c)
+        {
+            v = cache[c];
+            vertexScore[v] = vertexCacheScore(&scoreTable, cachePosition[v],
+                                              activeTriangles[v]);
+        }
+        for (c = 0; c < cacheCount; ++c)
+        {
+            long k;
+            v = cache[c];
+            for (k = 0; k < activeTriangles[v]; ++k)
+            {
+                t = vertexTriangles[firstTriangle[v] + k];
+                triangleScore[t] = vertexScore[indices[t * 3]] +
+                                   vertexScore[indices[t * 3 + 1]] +
+                                   vertexScore[indices[t * 3 + 2]];
+                if (best < 0 || triangleScore[t] > triangleScore[best])
+                    best = t;
+            }
+        }
+    }
+
+    memcpy(indices, output, triangleCount * 3 * sizeof(GLushort));
+
+done:
+    free(output);
+    free(emitted);
+    free(triangleScore);
+    free(vertexScore);
+    free(cachePosition);
+    free(activeTriangles);
+    free(vertexTriangles);
+    free(firstTriangle);
+}
+
+
+// Vertices of a supershape, merged by their fixed point position.
+typedef struct {
+    SUPERSHAPEMESH *mesh;
+    VECTOR3 *normalSums;    // sum of the adjacent face normals
+    float *heights;         // z, for the vertex color
+    long *hashTable;        // vertex index + 1, 0 for an empty slot
+    unsigned long hashMask;
+    long vertexCount;
+} SHAPEBUILDER;
+
+
+static long addShapeVertex(SHAPEBUILDER *builder, const VECTOR3 *p)
+{
+    GLfixed *vertexArray = builder->mesh->vertexArray;
+    const GLfixed x = FIXED(p->x), y = FIXED(p->y), z = FIXED(p->z);
+    unsigned long slot = ((unsigned long)x * 73856093UL ^
+                          (unsigned long)y * 19349663UL ^
+                          (unsigned long)z * 83492791UL) & builder->hashMask;
+    long v;
+
+    while (builder->hashTable[slot] != 0)
+    {
+        v = builder->hashTable[slot] - 1;
+        if (vertexArray[v * 3] == x && vertexArray[v * 3 + 1] == y &&
+            vertexArray[v * 3 + 2] == z)
+            return v;
+        slot = (slot + 1) & builder->hashMask;
+    }
+
+    v = builder->vertexCount++;
+    builder->hashTable[slot] = v + 1;
+    vertexArray[v * 3] = x;
+    vertexArray[v * 3 + 1] = y;
+    vertexArray[v * 3 + 2] = z;
+    builder->normalSums[v].x = 0;
+    builder->normalSums[v].y = 0;
+    builder->normalSums[v].z = 0;
+    builder->heights[v] = p->z;
+    return v;
+}
+
+
+// Adds the face normal of triangle (v1, v2, v3) to its vertices and
+// returns 1, or returns 0 if the triangle is degenerate.
+static int addShapeTriangle(SHAPEBUILDER *builder, GLushort *indices,
+                            long v1, long v2, long v3,
+                            const VECTOR3 *p1, const VECTOR3 *p2,
+                            const VECTOR3 *p3)
+{
+    VECTOR3 e1, e2, n;
+    long v[3];
+    int a;
+
+    if (v1 == v2 || v2 == v3 || v1 == v3)
+        return 0;
+
+    vector3Sub(&e1, p2, p1);
+    vector3Sub(&e2, p3, p1);
+
+    // Unnormalized cross product, so larger faces weigh more.
+    n.x = e1.y * e2.z - e1.z * e2.y;
+    n.y = e1.z * e2.x - e1.x * e2.z;
+    n.z = e1.x * e2.y - e1.y * e2.x;
+
+    v[0] = v1;
+    v[1] = v2;
+    v[2] = v3;
+    for (a = 0; a < 3; ++a)
+    {
+        builder->normalSums[v[a]].x += n.x;
+        builder->normalSums[v[a]].y += n.y;
+        builder->normalSums[v[a]].z += n.z;
+        indices[a] = (GLushort)v[a];
+    }
+    return 1;
+}
+
+
+// Points of the (longitude, latitude) grid of a supershape.
+//
+// The supershape radius is the product of a term that only depends on
+// the longitude and one that only depends on the latitude, so ssFunc() and
+// the trigonometry are evaluated once per grid column and row instead of
+// four times per quad. The points are then computed a row at a time over
+// plain arrays, which the compiler turns into vector code, with the same
+// arithmetic as the original per-quad sphere mapping so that the points
+// are bit-exact with it.
+typedef struct {
+    int columns, rows;
+    double *cosT, *sinT, *cosP, *sinP;
+    float *rT, *rP;
+    float *x, *y, *z;       // rows * columns
+} SHAPEGRID;
+
+
+static int initShapeGrid(SHAPEGRID *grid, const float *params,
+                         int latitudeBegin, int latitudeEnd)
+{
+    const int resol1 = (int)params[SUPERSHAPE_PARAMS - 3];
+    const int resol2 = (int)params[SUPERSHAPE_PARAMS - 2];
+    const int columns = resol1 + 1;
+    const int rows = latitudeEnd - latitudeBegin + 1;
+    double *doubles;
+    float *floats;
+    int i, j;
+
+    doubles = (double *)malloc((columns + rows) * 2 * sizeof(double) +
+                               (columns + rows + rows * columns * 3) *
+                               sizeof(float));
+    if (doubles == NULL)
+        return 0;
+    floats = (float *)(doubles + (columns + rows) * 2);
+
+    grid->columns = columns;
+    grid->rows = rows;
+    grid->cosT = doubles;
+    grid->sinT = grid->cosT + columns;
+    grid->cosP = grid->sinT + columns;
+    grid->sinP = grid->cosP + rows;
+    grid->rT = floats;
+    grid->rP = grid->rT + columns;
+    grid->x = grid->rP + rows;
+    grid->y = grid->x + rows * columns;
+    grid->z = grid->y + rows * columns;
+
+    // longitude -pi to pi
+    for (i = 0; i < columns; ++i)
+    {
+        const float t = -PI + i * 2 * PI / resol1;
+        grid->cosT[i] = cos(t);
+        grid->sinT[i] = sin(t);
+        grid->rT[i] = ssFunc(t, params);
+    }
+    // latitude 0 to pi/2
+    for (j = 0; j < rows; ++j)
+    {
+        const float p = -PI / 2 + (latitudeBegin + j) * 2 * PI / resol2;
+        grid->cosP[j] = cos(p);
+        grid->sinP[j] = sin(p);
+        grid->rP[j] = ssFunc(p, &params[6]);
+    }
+
+    // sphere-mapping of supershape parameters
+    for (j = 0; j < rows; ++j)
+    {
+        const double cosP = grid->cosP[j], sinP = grid->sinP[j];
+        const float rP = grid->rP[j];
+        const double *cosT = grid->cosT, *sinT = grid->sinT;
+        const float *rT = grid->rT;
+        float *x = grid->x + j * columns;
+        float *y = grid->y + j * columns;
+        float *z = grid->z + j * columns;
+
+        for (i = 0; i < columns; ++i)
+        {
+            x[i] = (float)(cosT[i] * cosP / rT[i] / rP);
+            y[i] = (float)(sinT[i] * cosP / rT[i] / rP);
+            z[i] = (float)(sinP / rP);
+        }
+    }
+    return 1;
+}
+
+
+static void getShapeGridPoint(VECTOR3 *point, const SHAPEGRID *grid,
+                              int column, int row)
+{
+    const int i = row * grid->columns + column;
+    point->x = grid->x[i];
+    point->y = grid->y[i];
+    point->z = grid->z[i];
+}
+
+
+// Based on Paul Bourke's POV-Ray implementation.
+// http://astronomy.swin.edu.au/~pbourke/povray/supershape/
+//
+// Quads share their corners: the vertices are merged by position and
+// drawn with an index array, each with the average normal of the faces
+// around it, and the triangles of shapes with more than
+// NATURAL_ORDER_MAX_ROWS rows are reordered for the vertex cache.
+// Only reads its arguments, so shapes can be created concurrently.
+int createSuperShapeMesh(SUPERSHAPEMESH *mesh, const float *params,
+                         const float *baseColor)
+{
+    const int resol1 = (int)params[SUPERSHAPE_PARAMS - 3];
+    const int resol2 = (int)params[SUPERSHAPE_PARAMS - 2];
+    // latitude 0 to pi/2 for no mirrored bottom
+    // (latitudeBegin==0 for -pi/2 to pi/2 originally)
+    const int latitudeBegin = resol2 / 4;
+    const int latitudeEnd = resol2 / 2;    // non-inclusive
+    const int longitudeCount = resol1;
+    const int latitudeCount = latitudeEnd - latitudeBegin;
+    const long triangleCount = longitudeCount * latitudeCount * 2;
+    // Grid corners, plus the lower edge of the second row which is
+    // flattened to z = 0 below.
+    const long maxVertices = (longitudeCount + 1) * (latitudeCount + 2);
+    SHAPEBUILDER builder;
+    SHAPEGRID grid;
+    unsigned long hashSize;
+    int a, longitude, latitude;
+    long currentIndex, v;
+
+    assert(maxVertices <= 65536);
+    mesh->vertexArray = (GLfixed *)malloc(maxVertices * 3 * sizeof(GLfixed));
+    mesh->normalArray = (GLfixed *)malloc(maxVertices * 3 * sizeof(GLfixed));
+    mesh->colorArray = (GLubyte *)malloc(maxVertices * 4 * sizeof(GLubyte));
+    mesh->indexArray = (GLushort *)malloc(triangleCount * 3 *
+                                          sizeof(GLushort));
+
+    for (hashSize = 1; hashSize < (unsigned long)maxVertices * 2; hashSize <<= 1)
+        ;
+    builder.mesh = mesh;
+    builder.normalSums = (VECTOR3 *)malloc(maxVertices * sizeof(VECTOR3));
+    builder.heights = (float *)malloc(maxVertices * sizeof(float));
+    builder.hashTable = (long *)calloc(hashSize, sizeof(long));
+    builder.hashMask = hashSize - 1;
+    builder.vertexCount = 0;
+
+    if (mesh->vertexArray == NULL || mesh->normalArray == NULL ||
+        mesh->colorArray == NULL || mesh->indexArray == NULL ||
+        builder.normalSums == NULL ||
+        builder.heights == NULL || builder.hashTable == NULL ||
+        !initShapeGrid(&grid, params, latitudeBegin, latitudeEnd))
+    {
+        free(builder.hashTable);
+        free(builder.heights);
+        free(builder.normalSums);
+        freeSuperShapeMesh(mesh);
+        return 0;
+    }
+
+    currentIndex = 0;
+
+    // longitude -pi to pi
+    for (longitude = 0; longitude < longitudeCount; ++longitude)
+    {
+
+        // latitude 0 to pi/2
+        for (latitude = latitudeBegin; latitude < latitudeEnd; ++latitude)
+        {
+            const int row = latitude - latitudeBegin;
+
+            if (grid.rT[longitude] != 0 && grid.rP[row] != 0 &&
+                grid.rT[longitude + 1] != 0 && grid.rP[row + 1] != 0)
+            {
+                VECTOR3 pa, pb, pc, pd;
+                long va, vb, vc, vd;
+
+                getShapeGridPoint(&pa, &grid, longitude, row);
+                getShapeGridPoint(&pb, &grid, longitude + 1, row);
+                getShapeGridPoint(&pc, &grid, longitude + 1, row + 1);
+                getShapeGridPoint(&pd, &grid, longitude, row + 1);
+
+                // kludge to set lower edge of the object to fixed level
+                if (latitude == latitudeBegin + 1)
+                    pa.z = pb.z = 0;
+
+                va = addShapeVertex(&builder, &pa);
+                vb = addShapeVertex(&builder, &pb);
+                vc = addShapeVertex(&builder, &pc);
+                vd = addShapeVertex(&builder, &pd);
+
+                currentIndex += 3 * addShapeTriangle(&builder,
+                        &mesh->indexArray[currentIndex],
+                        va, vb, vd, &pa, &pb, &pd);
+                currentIndex += 3 * addShapeTriangle(&builder,
+                        &mesh->indexArray[currentIndex],
+                        vb, vc, vd, &pb, &pc, &pd);
+            } // r0 && r1 && r2 && r3
+        } // latitude
+    } // longitude
+
+    free(grid.cosT);
+
+    for (v = 0; v < builder.vertexCount; ++v)
+    {
+        VECTOR3 *n = &builder.normalSums[v];
+        const float lenSq = n->x * n->x + n->y * n->y + n->z * n->z;
+        const float ca = builder.heights[v] + 0.5f;
+
+        if (lenSq > 0)
+        {
+            const float invLen = (float)(1 / sqrt(lenSq));
+            mesh->normalArray[v * 3] = FIXED(n->x * invLen);
+            mesh->normalArray[v * 3 + 1] = FIXED(n->y * invLen);
+            mesh->normalArray[v * 3 + 2] = FIXED(n->z * invLen);
+        }
+        else
+        {
+            mesh->normalArray[v * 3] = 0;
+            mesh->normalArray[v * 3 + 1] = 0;
+            mesh->normalArray[v * 3 + 2] = 0x10000;
+        }
+
+        for (a = 0; a < 3; ++a)
+        {
+            int color = (int)(ca * baseColor[a] * 255);
+            if (color > 255) color = 255;
+            mesh->colorArray[v * 4 + a] = (GLubyte)color;
+        }
+        mesh->colorArray[v * 4 + 3] = 0;
+    }
+
+    free(builder.hashTable);
+    free(builder.heights);
+    free(builder.normalSums);
+
+    // Set number of vertices and indices to the actual amounts created.
+    mesh->vertexCount = builder.vertexCount;
+    mesh->indexCount = currentIndex;
+
+    if (latitudeCount > NATURAL_ORDER_MAX_ROWS)
+        optimizeVertexCache(mesh->indexArray, currentIndex / 3,
+                            mesh->vertexCount);
+
+    return 1;
+}
+
+
+void freeSuperShapeMesh(SUPERSHAPEMESH *mesh)
+{
+    free(mesh->indexArray);
+    free(mesh->colorArray);
+    free(mesh->normalArray);
+    free(mesh->vertexArray);
+    memset(mesh, 0, sizeof(*mesh));
+}
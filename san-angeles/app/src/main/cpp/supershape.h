@@ -0,0 +1,50 @@
+/* San Angeles Observation OpenGL ES version example
+ * Copyright 2009 The Android Open Source Project
+ * All rights reserved.
+ *
+ * This source is free software; you can redistribute it and/or
+ * modify it under the terms of EITHER:
+ *   (1) The GNU Lesser General Public License as published by the Free
+ *       Software Foundation; either version 2.1 of the License, or (at
+ *       your option) any later version. The text of the GNU Lesser
+ *       General Public License is included with this source in the
+ *       file LICENSE-LGPL.txt.
+ *   (2) The BSD-style license that is included with this source in
+ *       the file LICENSE-BSD.txt.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files
+ * LICENSE-LGPL.txt and LICENSE-BSD.txt for more details.
+ */
+
+#ifndef SUPERSHAPE_H_INCLUDED
+#define SUPERSHAPE_H_INCLUDED
+
+#include "importgl.h"
+#include "shapes.h"
+
+
+/* Indexed supershape mesh. The generator makes no GL call, so it also
+ * builds on the host, see san-angeles/host.
+ */
+typedef struct {
+    GLfixed *vertexArray;   // 3 per vertex
+    GLfixed *normalArray;   // 3 per vertex
+    GLubyte *colorArray;    // 4 per vertex
+    GLushort *indexArray;   // indexCount / 3 triangles
+    long vertexCount;
+    long indexCount;
+} SUPERSHAPEMESH;
+
+
+/* Builds the supershape of 'params' (a row of sSuperShapeParams) colored
+ * with 'baseColor'. Returns 1 on success and 0 if out of memory.
+ */
+extern int createSuperShapeMesh(SUPERSHAPEMESH *mesh, const float *params,
+                                const float *baseColor);
+
+extern void freeSuperShapeMesh(SUPERSHAPEMESH *mesh);
+
+
+#endif // !SUPERSHAPE_H_INCLUDED
@@ -80,7 +80,7 @@ public class DemoActivity extends Activity {
 class DemoGLSurfaceView extends GLSurfaceView {
     public DemoGLSurfaceView(Context context) {
         super(context);
-        mRenderer = new DemoRenderer();
+        mRenderer = new DemoRenderer(context);
         setRenderer(mRenderer);
     }
 
@@ -112,8 +112,12 @@ class DemoGLSurfaceView extends GLSurfaceView {
 }
 
 class DemoRenderer implements GLSurfaceView.Renderer {
+    public DemoRenderer(Context context) {
+        mCacheDir = context.getCacheDir().getAbsolutePath();
+    }
+
     public void onSurfaceCreated(GL10 gl, EGLConfig config) {
-        nativeInit();
+        nativeInit(mCacheDir);
     }
 
     public void onSurfaceChanged(GL10 gl, int w, int h) {
@@ -125,7 +129,9 @@ class DemoRenderer implements GLSurfaceView.Renderer {
         nativeRender();
     }
 
-    private static native void nativeInit();
+    private String mCacheDir;
+
+    private static native void nativeInit(String cacheDir);
     private static native void nativeResize(int w, int h);
     private static native void nativeRender();
     private static native void nativeDone();
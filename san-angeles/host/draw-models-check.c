@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Replays the models of one frame of appRender() (the reflection, then
+ * the models themselves) through the GL recording shim of gl-record.c,
+ * once with the former drawModels(), which rebuilt every building from
+ * glTranslatex/glRotatex/glScalex in random shape order, and once with
+ * the drawModels() of demo.c, which replays the buildings recorded by
+ * recordModels() sorted by shape.
+ *
+ * Both must issue the same draws, in any order: the same arrays, count
+ * and mode, with modelview matrices within 0.001 of each other, and
+ * leave the same modelview matrix and stack depth. Prints the GL calls of
+ * both. Exits with 1 if the draws or the final matrices differ.
+ *
+ * demo.c is included to reach its static functions and state.
+ *
+ *   draw-models-check [-t tick]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "demo.c"
+#include "gl-record.h"
+
+// Largest difference allowed between two matrix elements.
+#define MATRIX_TOLERANCE 0.001
+
+int gAppAlive = 1;
+const char *gAppCacheDir = NULL;
+
+
+// drawModels() before recordModels(), as it was in demo.c.
+static void drawModelsLegacy(float zScale)
+{
+    const int translationScale = 9;
+    int x, y;
+
+    seedRandom(9);
+
+    glScalex(1 << 16, 1 << 16, (GLfixed)(zScale * 65536));
+
+    for (y = -5; y <= 5; ++y)
+    {
+        for (x = -5; x <= 5; ++x)
+        {
+            float buildingScale;
+            GLfixed fixedScale;
+
+            int curShape = randomUInt() % SUPERSHAPE_COUNT;
+            buildingScale = sSuperShapeParams[curShape][SUPERSHAPE_PARAMS - 1];
+            fixedScale = (GLfixed)(buildingScale * 65536);
+
+            glPushMatrix();
+            glTranslatex((x * translationScale) * 65536,
+                         (y * translationScale) * 65536,
+                         0);
+            glRotatex((GLfixed)((randomUInt() % 360) << 16), 0, 0, 1 << 16);
+            glScalex(fixedScale, fixedScale, fixedScale);
+
+            drawGLObject(sSuperShapeObjects[curShape]);
+            glPopMatrix();
+        }
+    }
+
+    for (x = -2; x <= 2; ++x)
+    {
+        const int shipScale100 = translationScale * 500;
+        const int offs100 = x * shipScale100 + (sTick % shipScale100);
+        float offs = offs100 * 0.01f;
+        GLfixed fixedOffs = (GLfixed)(offs * 65536);
+        glPushMatrix();
+        glTranslatex(fixedOffs, -4 * 65536, 2 << 16);
+        drawGLObject(sSuperShapeObjects[SUPERSHAPE_COUNT - 1]);
+        glPopMatrix();
+        glPushMatrix();
+        glTranslatex(-4 * 65536, fixedOffs, 4 << 16);
+        glRotatex(90 << 16, 0, 0, 1 << 16);
+        drawGLObject(sSuperShapeObjects[SUPERSHAPE_COUNT - 1]);
+        glPopMatrix();
+    }
+}
+
+
+typedef struct {
+    GLRECORD record;
+    double modelview[16];
+    int modelviewDepth;
+} FRAMEMODELS;
+
+
+// The models part of appRender() at 'tick', recorded into 'frame'.
+static void recordFrameModels(long tick, void (*draw)(float zScale),
+                              FRAMEMODELS *frame)
+{
+    // camTrack() moves on by at most one track per frame, so the camera
+    // is restarted and stepped up to 'tick' for both replays.
+    sTick = tick;
+    sCurrentCamTrack = 0;
+    sCurrentCamTrackStartTick = 0;
+    sNextCamTrackStartTick = 0x7fffffff;
+    prepareFrame(WINDOW_DEFAULT_WIDTH, WINDOW_DEFAULT_HEIGHT);
+    do
+        camTrack();
+    while (sNextCamTrackStartTick <= sTick);
+    configureLightAndMaterial();
+
+    glRecordReset();
+    glPushMatrix();
+    draw(-1);
+    glPopMatrix();
+    draw(1);
+
+    frame->record = gGLRecord;
+    glRecordGetMatrix(GL_MODELVIEW, frame->modelview);
+    frame->modelviewDepth = glRecordGetStackDepth(GL_MODELVIEW);
+}
+
+
+static double matrixDifference(const double *m1, const double *m2)
+{
+    double difference = 0;
+    int i;
+
+    for (i = 0; i < 16; ++i)
+    {
+        if (fabs(m1[i] - m2[i]) > difference)
+            difference = fabs(m1[i] - m2[i]);
+    }
+    return difference;
+}
+
+
+static int sameDraw(const GLRECORDDRAW *d1, const GLRECORDDRAW *d2)
+{
+    return d1->vertexPointer == d2->vertexPointer &&
+           d1->colorPointer == d2->colorPointer &&
+           d1->normalPointer == d2->normalPointer &&
+           d1->indices == d2->indices &&
+           d1->mode == d2->mode &&
+           d1->first == d2->first &&
+           d1->count == d2->count &&
+           matrixDifference(d1->modelview, d2->modelview) <= MATRIX_TOLERANCE;
+}
+
+
+// Returns the number of draws of 'expected' with no match in 'actual'.
+static int compareDraws(const GLRECORD *expected, const GLRECORD *actual)
+{
+    static unsigned char matched[GLRECORD_MAX_DRAWS];
+    int missing = 0, e, a;
+
+    memset(matched, 0, sizeof(matched));
+    for (e = 0; e < expected->drawCount; ++e)
+    {
+        for (a = 0; a < actual->drawCount; ++a)
+        {
+            if (!matched[a] &&
+                sameDraw(&expected->draws[e], &actual->draws[a]))
+            {
+                matched[a] = 1;
+                break;
+            }
+        }
+        if (a == actual->drawCount)
+        {
+            if (missing < 10)
+                printf("  draw %d of the former drawModels() has no match\n",
+                       e);
+            ++missing;
+        }
+    }
+    return missing;
+}
+
+
+static void printCounts(const char *name, const GLRECORDCOUNTS *counts)
+{
+    printf("  %-22s %6ld %14ld %13ld %11ld\n", name, counts->calls,
+           counts->stateChanges, counts->matrixCalls, counts->drawCalls);
+}
+
+
+int main(int argc, char **argv)
+{
+    static FRAMEMODELS legacy, current;
+    long tick = 10000;
+    int opt, failures = 0;
+
+    while ((opt = getopt(argc, argv, "t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            tick = atol(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-t tick]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (tick < 0 || tick >= RUN_LENGTH)
+    {
+        fprintf(stderr, "tick must be in [0, %d)\n", RUN_LENGTH);
+        return 1;
+    }
+
+    appInit();
+    recordFrameModels(tick, drawModelsLegacy, &legacy);
+    recordFrameModels(tick, drawModels, &current);
+
+    if (legacy.record.drawCount > GLRECORD_MAX_DRAWS ||
+        current.record.drawCount > GLRECORD_MAX_DRAWS)
+    {
+        printf("more than %d draws FAILED\n", GLRECORD_MAX_DRAWS);
+        ++failures;
+    }
+    else if (legacy.record.drawCount != current.record.drawCount)
+    {
+        printf("%d draws, %d with the former drawModels() FAILED\n",
+               current.record.drawCount, legacy.record.drawCount);
+        ++failures;
+    }
+    else if (compareDraws(&legacy.record, &current.record) != 0)
+    {
+        printf("draw lists differ FAILED\n");
+        ++failures;
+    }
+    if (legacy.modelviewDepth != current.modelviewDepth ||
+        matrixDifference(legacy.modelview, current.modelview) != 0)
+    {
+        printf("final modelview matrix or stack depth differs FAILED\n");
+        ++failures;
+    }
+
+    printf("models of the frame at tick %ld, %d draws\n", tick,
+           current.record.drawCount);
+    printf("  %-22s %6s %14s %13s %11s\n", "", "GL calls", "state changes",
+           "matrix calls", "draw calls");
+    printCounts("former drawModels()", &legacy.record.counts);
+    printCounts("drawModels()", &current.record.counts);
+
+    appDeinit();
+    return failures != 0;
+}
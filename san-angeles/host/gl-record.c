@@ -0,0 +1,366 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gl-record.h"
+
+
+// Depth of both matrix stacks.
+#define MATRIX_STACK_DEPTH 32
+
+typedef struct {
+    double matrices[MATRIX_STACK_DEPTH][16];
+    int depth;                  // index of the current matrix
+} MATRIXSTACK;
+
+GLRECORD gGLRecord;
+
+static MATRIXSTACK sModelview = { { { 1, 0, 0, 0, 0, 1, 0, 0,
+                                      0, 0, 1, 0, 0, 0, 0, 1 } }, 0 };
+static MATRIXSTACK sProjection = { { { 1, 0, 0, 0, 0, 1, 0, 0,
+                                       0, 0, 1, 0, 0, 0, 0, 1 } }, 0 };
+static MATRIXSTACK *sCurrentStack = &sModelview;
+
+static const void *sVertexPointer = NULL;
+static const void *sColorPointer = NULL;
+static const void *sNormalPointer = NULL;
+static int sNormalArrayEnabled = 0;
+
+
+static void fail(const char *what)
+{
+    fprintf(stderr, "gl-record: %s\n", what);
+    exit(1);
+}
+
+
+static double fromFixed(GLfixed value)
+{
+    return value / 65536.0;
+}
+
+
+static double *currentMatrix()
+{
+    return sCurrentStack->matrices[sCurrentStack->depth];
+}
+
+
+// Current matrix = current matrix * m, both column-major.
+static void multiply(const double *m)
+{
+    double *c = currentMatrix();
+    double result[16];
+    int row, column, k;
+
+    for (column = 0; column < 4; ++column)
+    {
+        for (row = 0; row < 4; ++row)
+        {
+            double sum = 0;
+            for (k = 0; k < 4; ++k)
+                sum += c[k * 4 + row] * m[column * 4 + k];
+            result[column * 4 + row] = sum;
+        }
+    }
+    memcpy(c, result, sizeof(result));
+}
+
+
+static void countMatrixCall()
+{
+    ++gGLRecord.counts.calls;
+    ++gGLRecord.counts.matrixCalls;
+}
+
+
+static void countStateChange()
+{
+    ++gGLRecord.counts.calls;
+    ++gGLRecord.counts.stateChanges;
+}
+
+
+static void recordDraw(GLenum mode, GLint first, GLsizei count,
+                       const void *indices)
+{
+    ++gGLRecord.counts.calls;
+    ++gGLRecord.counts.drawCalls;
+    if (gGLRecord.drawCount < GLRECORD_MAX_DRAWS)
+    {
+        GLRECORDDRAW *draw = &gGLRecord.draws[gGLRecord.drawCount];
+        draw->vertexPointer = sVertexPointer;
+        draw->colorPointer = sColorPointer;
+        draw->normalPointer = sNormalArrayEnabled ? sNormalPointer : NULL;
+        draw->indices = indices;
+        draw->mode = mode;
+        draw->first = first;
+        draw->count = count;
+        memcpy(draw->modelview, sModelview.matrices[sModelview.depth],
+               sizeof(draw->modelview));
+    }
+    ++gGLRecord.drawCount;
+}
+
+
+void glRecordReset()
+{
+    memset(&gGLRecord, 0, sizeof(gGLRecord));
+}
+
+
+void glRecordGetMatrix(GLenum mode, double *matrix)
+{
+    const MATRIXSTACK *stack =
+        mode == GL_PROJECTION ? &sProjection : &sModelview;
+    memcpy(matrix, stack->matrices[stack->depth], 16 * sizeof(double));
+}
+
+
+int glRecordGetStackDepth(GLenum mode)
+{
+    return (mode == GL_PROJECTION ? sProjection.depth : sModelview.depth) + 1;
+}
+
+
+// Matrix calls.
+
+void glMatrixMode(GLenum mode)
+{
+    countMatrixCall();
+    sCurrentStack = mode == GL_PROJECTION ? &sProjection : &sModelview;
+}
+
+void glLoadIdentity()
+{
+    double *c = currentMatrix();
+
+    countMatrixCall();
+    memset(c, 0, 16 * sizeof(double));
+    c[0] = c[5] = c[10] = c[15] = 1;
+}
+
+void glPushMatrix()
+{
+    countMatrixCall();
+    if (sCurrentStack->depth + 1 >= MATRIX_STACK_DEPTH)
+        fail("matrix stack overflow");
+    memcpy(sCurrentStack->matrices[sCurrentStack->depth + 1], currentMatrix(),
+           16 * sizeof(double));
+    ++sCurrentStack->depth;
+}
+
+void glPopMatrix()
+{
+    countMatrixCall();
+    if (sCurrentStack->depth == 0)
+        fail("matrix stack underflow");
+    --sCurrentStack->depth;
+}
+
+void glMultMatrixx(const GLfixed *m)
+{
+    double d[16];
+    int i;
+
+    countMatrixCall();
+    for (i = 0; i < 16; ++i)
+        d[i] = fromFixed(m[i]);
+    multiply(d);
+}
+
+void glTranslatex(GLfixed x, GLfixed y, GLfixed z)
+{
+    double m[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+    countMatrixCall();
+    m[12] = fromFixed(x);
+    m[13] = fromFixed(y);
+    m[14] = fromFixed(z);
+    multiply(m);
+}
+
+void glScalex(GLfixed x, GLfixed y, GLfixed z)
+{
+    double m[16] = { 0 };
+
+    countMatrixCall();
+    m[0] = fromFixed(x);
+    m[5] = fromFixed(y);
+    m[10] = fromFixed(z);
+    m[15] = 1;
+    multiply(m);
+}
+
+void glRotatex(GLfixed angle, GLfixed x, GLfixed y, GLfixed z)
+{
+    const double radians = fromFixed(angle) * 3.14159265358979323846 / 180;
+    const double c = cos(radians), s = sin(radians);
+    double ax = fromFixed(x), ay = fromFixed(y), az = fromFixed(z);
+    const double length = sqrt(ax * ax + ay * ay + az * az);
+    double m[16] = { 0 };
+
+    countMatrixCall();
+    if (length == 0)
+        return;
+    ax /= length;
+    ay /= length;
+    az /= length;
+    m[0] = ax * ax * (1 - c) + c;
+    m[1] = ay * ax * (1 - c) + az * s;
+    m[2] = az * ax * (1 - c) - ay * s;
+    m[4] = ax * ay * (1 - c) - az * s;
+    m[5] = ay * ay * (1 - c) + c;
+    m[6] = az * ay * (1 - c) + ax * s;
+    m[8] = ax * az * (1 - c) + ay * s;
+    m[9] = ay * az * (1 - c) - ax * s;
+    m[10] = az * az * (1 - c) + c;
+    m[15] = 1;
+    multiply(m);
+}
+
+void glFrustumx(GLfixed l, GLfixed r, GLfixed b, GLfixed t, GLfixed n,
+                GLfixed f)
+{
+    const double left = fromFixed(l), right = fromFixed(r);
+    const double bottom = fromFixed(b), top = fromFixed(t);
+    const double zNear = fromFixed(n), zFar = fromFixed(f);
+    double m[16] = { 0 };
+
+    countMatrixCall();
+    m[0] = 2 * zNear / (right - left);
+    m[5] = 2 * zNear / (top - bottom);
+    m[8] = (right + left) / (right - left);
+    m[9] = (top + bottom) / (top - bottom);
+    m[10] = -(zFar + zNear) / (zFar - zNear);
+    m[11] = -1;
+    m[14] = -2 * zFar * zNear / (zFar - zNear);
+    multiply(m);
+}
+
+
+// Client array state.
+
+void glVertexPointer(GLint size, GLenum type, GLsizei stride,
+                     const void *pointer)
+{
+    countStateChange();
+    sVertexPointer = pointer;
+}
+
+void glColorPointer(GLint size, GLenum type, GLsizei stride,
+                    const void *pointer)
+{
+    countStateChange();
+    sColorPointer = pointer;
+}
+
+void glNormalPointer(GLenum type, GLsizei stride, const void *pointer)
+{
+    countStateChange();
+    sNormalPointer = pointer;
+}
+
+void glEnableClientState(GLenum array)
+{
+    countStateChange();
+    if (array == GL_NORMAL_ARRAY)
+        sNormalArrayEnabled = 1;
+}
+
+void glDisableClientState(GLenum array)
+{
+    countStateChange();
+    if (array == GL_NORMAL_ARRAY)
+        sNormalArrayEnabled = 0;
+}
+
+
+// Draw calls.
+
+void glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    recordDraw(mode, first, count, NULL);
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type,
+                    const void *indices)
+{
+    recordDraw(mode, 0, count, indices);
+}
+
+
+// Other calls, only counted.
+
+void glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    ++gGLRecord.counts.calls;
+}
+
+void glClear(GLbitfield mask)
+{
+    ++gGLRecord.counts.calls;
+}
+
+void glClearColorx(GLfixed red, GLfixed green, GLfixed blue, GLfixed alpha)
+{
+    ++gGLRecord.counts.calls;
+}
+
+void glColor4x(GLfixed red, GLfixed green, GLfixed blue, GLfixed alpha)
+{
+    ++gGLRecord.counts.calls;
+}
+
+void glEnable(GLenum cap)
+{
+    ++gGLRecord.counts.calls;
+}
+
+void glDisable(GLenum cap)
+{
+    ++gGLRecord.counts.calls;
+}
+
+void glLightxv(GLenum light, GLenum pname, const GLfixed *params)
+{
+    ++gGLRecord.counts.calls;
+}
+
+void glMaterialx(GLenum face, GLenum pname, GLfixed param)
+{
+    ++gGLRecord.counts.calls;
+}
+
+void glMaterialxv(GLenum face, GLenum pname, const GLfixed *param)
+{
+    ++gGLRecord.counts.calls;
+}
+
+void glShadeModel(GLenum mode)
+{
+    ++gGLRecord.counts.calls;
+}
+
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    ++gGLRecord.counts.calls;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GLRECORD_H_INCLUDED
+#define GLRECORD_H_INCLUDED
+
+#include "importgl.h"
+
+
+/* Recording implementation of the OpenGL ES 1 calls made by demo.c, for
+ * host checks. Nothing is rendered: the shim keeps the modelview and
+ * projection stacks (in doubles) and the client array state, records each
+ * draw call with the arrays and the modelview matrix it uses, and counts
+ * the calls.
+ */
+
+#define GLRECORD_MAX_DRAWS 1024
+
+typedef struct {
+    const void *vertexPointer;
+    const void *colorPointer;
+    const void *normalPointer;  // NULL when the normal array is disabled
+    const void *indices;        // NULL for glDrawArrays()
+    GLenum mode;
+    GLint first;
+    GLsizei count;
+    double modelview[16];       // column-major
+} GLRECORDDRAW;
+
+typedef struct {
+    long calls;                 // every GL call
+    long stateChanges;          // array pointers and client states
+    long matrixCalls;           // matrix mode, stack and transform calls
+    long drawCalls;
+} GLRECORDCOUNTS;
+
+typedef struct {
+    GLRECORDDRAW draws[GLRECORD_MAX_DRAWS];
+    int drawCount;              // may exceed GLRECORD_MAX_DRAWS
+    GLRECORDCOUNTS counts;
+} GLRECORD;
+
+
+extern GLRECORD gGLRecord;
+
+// Clears the recorded draws and counts, the GL state is kept.
+extern void glRecordReset();
+
+// Current matrix and stack depth (1 for an empty stack) of 'mode'.
+extern void glRecordGetMatrix(GLenum mode, double *matrix);
+extern int glRecordGetStackDepth(GLenum mode);
+
+
+#endif // !GLRECORD_H_INCLUDED
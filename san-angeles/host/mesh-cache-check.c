@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Times the supershape creation of appInit() in demo.c, on one thread,
+ * with the base colors it draws:
+ *
+ * - without a cache: createSuperShapeMesh() only,
+ * - first launch: createSuperShapeMesh() then meshCacheStore(),
+ * - later launches: meshCacheLoad() of the mapped files.
+ *
+ * Every mapped mesh must match the generated one byte for byte, and
+ * meshCacheLoad() must reject damaged files: bad counts, a wrong key, a
+ * truncated file and out of range indices. Exits with 1 if any check
+ * fails. The cache files go to a new directory under 'dir' (default the
+ * current directory), which is removed at the end.
+ *
+ *   mesh-cache-check [-n rounds] [dir]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "meshcache.h"
+#include "supershape.h"
+
+// Header of a cache file, as written by meshCacheStore().
+typedef struct {
+    char magic[4];
+    unsigned int version;
+    unsigned long long key;
+    unsigned int vertexCount;
+    unsigned int indexCount;
+} HEADER;
+
+
+static int sFailures = 0;
+
+static void check(int ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("  %s FAILED\n", what);
+        ++sFailures;
+    }
+}
+
+
+static double nowMs()
+{
+    struct timespec res;
+    clock_gettime(CLOCK_MONOTONIC, &res);
+    return 1000.0 * res.tv_sec + (double)res.tv_nsec / 1e6;
+}
+
+
+// Same generator as demo.c.
+static unsigned long sRandomSeed = 0;
+
+static void seedRandom(unsigned long seed)
+{
+    sRandomSeed = seed;
+}
+
+static unsigned long randomUInt()
+{
+    sRandomSeed = sRandomSeed * 0x343fd + 0x269ec3;
+    return sRandomSeed >> 16;
+}
+
+
+static float sBaseColors[SUPERSHAPE_COUNT][3];
+static unsigned long long sKeys[SUPERSHAPE_COUNT];
+
+// Base colors and cache keys as in appInit() and loadSuperShape().
+static void initShapes()
+{
+    int a, b;
+
+    seedRandom(15);
+    for (a = 0; a < SUPERSHAPE_COUNT; ++a)
+    {
+        for (b = 0; b < 3; ++b)
+            sBaseColors[a][b] = ((randomUInt() % 155) + 100) / 255.f;
+        sKeys[a] = meshCacheHash(0, sSuperShapeParams[a],
+                                 SUPERSHAPE_PARAMS * sizeof(float));
+        sKeys[a] = meshCacheHash(sKeys[a], sBaseColors[a], 3 * sizeof(float));
+    }
+}
+
+
+static void createShapes(SUPERSHAPEMESH *meshes)
+{
+    int a;
+
+    for (a = 0; a < SUPERSHAPE_COUNT; ++a)
+    {
+        if (!createSuperShapeMesh(&meshes[a], sSuperShapeParams[a],
+                                  sBaseColors[a]))
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+}
+
+
+static void freeShapes(SUPERSHAPEMESH *meshes)
+{
+    int a;
+
+    for (a = 0; a < SUPERSHAPE_COUNT; ++a)
+        freeSuperShapeMesh(&meshes[a]);
+}
+
+
+static int storeShapes(const char *dir, const SUPERSHAPEMESH *meshes)
+{
+    int a, stored = 0;
+
+    for (a = 0; a < SUPERSHAPE_COUNT; ++a)
+    {
+        const SUPERSHAPEMESH *m = &meshes[a];
+        stored += meshCacheStore(dir, sKeys[a], m->vertexCount, m->vertexArray,
+                                 m->normalArray, m->colorArray,
+                                 m->indexCount, m->indexArray);
+    }
+    return stored;
+}
+
+
+static int loadShapes(const char *dir, MESHCACHEENTRY *entries)
+{
+    int a, loaded = 0;
+
+    for (a = 0; a < SUPERSHAPE_COUNT; ++a)
+        loaded += meshCacheLoad(dir, sKeys[a], &entries[a]);
+    return loaded;
+}
+
+
+static void releaseShapes(MESHCACHEENTRY *entries)
+{
+    int a;
+
+    for (a = 0; a < SUPERSHAPE_COUNT; ++a)
+        meshCacheRelease(&entries[a]);
+}
+
+
+static int sameMesh(const SUPERSHAPEMESH *mesh, const MESHCACHEENTRY *entry)
+{
+    const long v = mesh->vertexCount;
+
+    return entry->mapping != NULL &&
+           entry->vertexCount == v &&
+           entry->indexCount == mesh->indexCount &&
+           memcmp(entry->vertexArray, mesh->vertexArray,
+                  v * 3 * sizeof(GLfixed)) == 0 &&
+           memcmp(entry->normalArray, mesh->normalArray,
+                  v * 3 * sizeof(GLfixed)) == 0 &&
+           memcmp(entry->colorArray, mesh->colorArray,
+                  v * 4 * sizeof(GLubyte)) == 0 &&
+           memcmp(entry->indexArray, mesh->indexArray,
+                  mesh->indexCount * sizeof(GLushort)) == 0;
+}
+
+
+/* Overwrites the cache file of shape 0 with its original contents, changed
+ * by 'damage', and checks that meshCacheLoad() rejects it.
+ */
+static void checkDamaged(const char *dir, const char *path,
+                         const char *original, size_t size,
+                         void (*damage)(char *file, size_t *size),
+                         const char *what)
+{
+    char *file = (char *)malloc(size);
+    MESHCACHEENTRY entry;
+    FILE *out;
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    memcpy(file, original, size);
+    damage(file, &size);
+    out = fopen(path, "wb");
+    check(out != NULL && fwrite(file, 1, size, out) == size &&
+          fclose(out) == 0, what);
+    check(!meshCacheLoad(dir, sKeys[0], &entry) && entry.mapping == NULL,
+          what);
+    free(file);
+}
+
+
+static void noVertices(char *file, size_t *size)
+{
+    ((HEADER *)file)->vertexCount = 0;
+}
+
+static void hugeVertexCount(char *file, size_t *size)
+{
+    ((HEADER *)file)->vertexCount = 0x80000000u;
+}
+
+static void hugeIndexCount(char *file, size_t *size)
+{
+    // Makes meshFileSize() wrap around to the real size with a 32-bit size_t.
+    ((HEADER *)file)->indexCount += 0x80000000u;
+}
+
+static void otherKey(char *file, size_t *size)
+{
+    ((HEADER *)file)->key ^= 1;
+}
+
+static void truncated(char *file, size_t *size)
+{
+    *size -= 2;
+}
+
+static void badIndex(char *file, size_t *size)
+{
+    const HEADER *header = (const HEADER *)file;
+    GLushort index = (GLushort)header->vertexCount;
+    memcpy(file + *size - sizeof(index), &index, sizeof(index));
+}
+
+
+static void checkValidation(const char *dir)
+{
+    char path[512];
+    char *original;
+    size_t size;
+    long fileSize;
+    FILE *in;
+
+    snprintf(path, sizeof(path), "%s/supershape-%016llx.mesh", dir, sKeys[0]);
+    in = fopen(path, "rb");
+    if (in == NULL || fseek(in, 0, SEEK_END) != 0 ||
+        (fileSize = ftell(in)) < (long)sizeof(HEADER) ||
+        fseek(in, 0, SEEK_SET) != 0)
+    {
+        check(0, "cache file of shape 0");
+        if (in != NULL)
+            fclose(in);
+        return;
+    }
+    size = (size_t)fileSize;
+    original = (char *)malloc(size);
+    if (original == NULL || fread(original, 1, size, in) != size)
+    {
+        fprintf(stderr, "can't read %s\n", path);
+        exit(1);
+    }
+    fclose(in);
+
+    checkDamaged(dir, path, original, size, noVertices, "no vertices");
+    checkDamaged(dir, path, original, size, hugeVertexCount,
+                 "vertex count over 2^31");
+    checkDamaged(dir, path, original, size, hugeIndexCount,
+                 "index count over 2^31");
+    checkDamaged(dir, path, original, size, otherKey, "other key");
+    checkDamaged(dir, path, original, size, truncated, "truncated file");
+    checkDamaged(dir, path, original, size, badIndex, "index out of range");
+    free(original);
+}
+
+
+static void removeCache(const char *dir)
+{
+    char path[512];
+    int a;
+
+    for (a = 0; a < SUPERSHAPE_COUNT; ++a)
+    {
+        snprintf(path, sizeof(path), "%s/supershape-%016llx.mesh", dir,
+                 sKeys[a]);
+        unlink(path);
+    }
+    rmdir(dir);
+}
+
+
+int main(int argc, char **argv)
+{
+    SUPERSHAPEMESH meshes[SUPERSHAPE_COUNT];
+    MESHCACHEENTRY entries[SUPERSHAPE_COUNT];
+    double createMs = 1e9, storeMs = 1e9, loadMs = 1e9, t0;
+    char dir[256];
+    int rounds = 20, opt, r, a;
+
+    while ((opt = getopt(argc, argv, "n:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            rounds = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n rounds] [dir]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (rounds < 1)
+    {
+        fprintf(stderr, "need at least 1 round\n");
+        return 1;
+    }
+    snprintf(dir, sizeof(dir), "%s/mesh-cache-XXXXXX",
+             optind < argc ? argv[optind] : ".");
+    if (mkdtemp(dir) == NULL)
+    {
+        fprintf(stderr, "can't create a directory in %s\n",
+                optind < argc ? argv[optind] : ".");
+        return 1;
+    }
+
+    initShapes();
+    for (r = 0; r < rounds; ++r)
+    {
+        double ms;
+
+        t0 = nowMs();
+        createShapes(meshes);
+        ms = nowMs() - t0;
+        if (ms < createMs)
+            createMs = ms;
+        freeShapes(meshes);
+
+        removeCache(dir);
+        if (mkdir(dir, 0700) != 0)
+        {
+            fprintf(stderr, "can't create %s\n", dir);
+            return 1;
+        }
+        t0 = nowMs();
+        createShapes(meshes);
+        check(storeShapes(dir, meshes) == SUPERSHAPE_COUNT, "stored shapes");
+        ms = nowMs() - t0;
+        if (ms < storeMs)
+            storeMs = ms;
+
+        t0 = nowMs();
+        check(loadShapes(dir, entries) == SUPERSHAPE_COUNT, "loaded shapes");
+        ms = nowMs() - t0;
+        if (ms < loadMs)
+            loadMs = ms;
+        for (a = 0; a < SUPERSHAPE_COUNT; ++a)
+        {
+            if (!sameMesh(&meshes[a], &entries[a]))
+            {
+                printf("  shape %2d: mapped mesh differs from the generated "
+                       "one FAILED\n", a);
+                ++sFailures;
+            }
+        }
+        releaseShapes(entries);
+        if (r < rounds - 1)
+            freeShapes(meshes);
+    }
+
+    checkValidation(dir);
+    freeShapes(meshes);
+    removeCache(dir);
+
+    printf("%d shapes, minimum of %d rounds, 1 thread\n",
+           (int)SUPERSHAPE_COUNT, rounds);
+    printf("  %-28s %8.3f ms\n", "no cache", createMs);
+    printf("  %-28s %8.3f ms\n", "first launch (create, store)", storeMs);
+    printf("  %-28s %8.3f ms\n", "mapped cache", loadMs);
+    if (sFailures)
+        printf("%d checks FAILED\n", sFailures);
+    return sFailures != 0;
+}
@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Checks createSuperShapeMesh() against the original generator, which
+ * emitted 6 unshared vertices per quad, for every entry of
+ * sSuperShapeParams:
+ *
+ * - the indexed mesh has one vertex per distinct GL_FIXED position of the
+ *   original vertices,
+ * - once the original triangles are welded by position and the degenerate
+ *   ones dropped, both meshes hold the same triangles with the same
+ *   winding,
+ * - every index is in range and every normal has unit length.
+ *
+ * Also prints the time taken by both generators. Exits with 1 if any
+ * shape fails.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "supershape.h"
+
+#undef PI
+#define PI 3.1415926535897932f
+
+// Triangle as its three GL_FIXED corners, first corner the smallest.
+typedef struct {
+    GLfixed p[9];
+} TRIANGLE;
+
+
+static long floatToFixed(float value)
+{
+    if (value < -32768) value = -32768;
+    if (value > 32767) value = 32767;
+    return (long)(value * 65536);
+}
+
+#define FIXED(value) floatToFixed(value)
+
+
+static double nowMs()
+{
+    struct timespec res;
+    clock_gettime(CLOCK_MONOTONIC, &res);
+    return 1000.0 * res.tv_sec + (double)res.tv_nsec / 1e6;
+}
+
+
+/* The original generator, positions only: one quad per grid cell, as the
+ * two triangles (a, b, d) and (b, c, d), each with its own vertices.
+ */
+static float ssFunc(const float t, const float *p)
+{
+    return (float)(pow(pow(fabs(cos(p[0] * t / 4)) / p[1], p[4]) +
+                       pow(fabs(sin(p[0] * t / 4)) / p[2], p[5]), 1 / p[3]));
+}
+
+
+static void superShapeMap(float *point, float r1, float r2, float t, float p)
+{
+    point[0] = (float)(cos(t) * cos(p) / r1 / r2);
+    point[1] = (float)(sin(t) * cos(p) / r1 / r2);
+    point[2] = (float)(sin(p) / r2);
+}
+
+
+// Returns the number of vertices written to vertexArray (3 per vertex).
+static long createSuperShapeReference(const float *params, GLfixed *vertexArray)
+{
+    const int resol1 = (int)params[SUPERSHAPE_PARAMS - 3];
+    const int resol2 = (int)params[SUPERSHAPE_PARAMS - 2];
+    const int latitudeBegin = resol2 / 4;
+    const int latitudeEnd = resol2 / 2;    // non-inclusive
+    long currentVertex = 0;
+    int longitude, latitude;
+
+    for (longitude = 0; longitude < resol1; ++longitude)
+    {
+        for (latitude = latitudeBegin; latitude < latitudeEnd; ++latitude)
+        {
+            float t1 = -PI + longitude * 2 * PI / resol1;
+            float t2 = -PI + (longitude + 1) * 2 * PI / resol1;
+            float p1 = -PI / 2 + latitude * 2 * PI / resol2;
+            float p2 = -PI / 2 + (latitude + 1) * 2 * PI / resol2;
+            float r0, r1, r2, r3;
+
+            r0 = ssFunc(t1, params);
+            r1 = ssFunc(p1, &params[6]);
+            r2 = ssFunc(t2, params);
+            r3 = ssFunc(p2, &params[6]);
+
+            if (r0 != 0 && r1 != 0 && r2 != 0 && r3 != 0)
+            {
+                static const int quad[6] = { 0, 1, 3, 1, 2, 3 };
+                float corners[4][3];
+                int a, b;
+
+                superShapeMap(corners[0], r0, r1, t1, p1);
+                superShapeMap(corners[1], r2, r1, t2, p1);
+                superShapeMap(corners[2], r2, r3, t2, p2);
+                superShapeMap(corners[3], r0, r3, t1, p2);
+
+                // kludge to set lower edge of the object to fixed level
+                if (latitude == latitudeBegin + 1)
+                    corners[0][2] = corners[1][2] = 0;
+
+                for (a = 0; a < 6; ++a, ++currentVertex)
+                {
+                    for (b = 0; b < 3; ++b)
+                        vertexArray[currentVertex * 3 + b] =
+                            FIXED(corners[quad[a]][b]);
+                }
+            }
+        }
+    }
+    return currentVertex;
+}
+
+
+static int compareFixed3(const GLfixed *p1, const GLfixed *p2)
+{
+    int a;
+    for (a = 0; a < 3; ++a)
+    {
+        if (p1[a] != p2[a])
+            return p1[a] < p2[a] ? -1 : 1;
+    }
+    return 0;
+}
+
+
+static int compareVertex(const void *v1, const void *v2)
+{
+    return compareFixed3((const GLfixed *)v1, (const GLfixed *)v2);
+}
+
+
+static int compareTriangle(const void *t1, const void *t2)
+{
+    const TRIANGLE *a = (const TRIANGLE *)t1, *b = (const TRIANGLE *)t2;
+    int i, c;
+    for (i = 0; i < 3; ++i)
+    {
+        if ((c = compareFixed3(&a->p[i * 3], &b->p[i * 3])) != 0)
+            return c;
+    }
+    return 0;
+}
+
+
+/* Stores the triangle with corners p0, p1, p2 rotated so that the
+ * smallest corner comes first, which keeps the winding. Returns 0 for a
+ * triangle with two identical corners.
+ */
+static int makeTriangle(TRIANGLE *t, const GLfixed *p0, const GLfixed *p1,
+                        const GLfixed *p2)
+{
+    const GLfixed *p[3];
+    int first = 0, i;
+
+    p[0] = p0;
+    p[1] = p1;
+    p[2] = p2;
+    if (compareFixed3(p0, p1) == 0 || compareFixed3(p1, p2) == 0 ||
+        compareFixed3(p0, p2) == 0)
+        return 0;
+    for (i = 1; i < 3; ++i)
+    {
+        if (compareFixed3(p[i], p[first]) < 0)
+            first = i;
+    }
+    for (i = 0; i < 3; ++i)
+        memcpy(&t->p[i * 3], p[(first + i) % 3], 3 * sizeof(GLfixed));
+    return 1;
+}
+
+
+static long countDistinctVertices(GLfixed *vertexArray, long count)
+{
+    long distinct = 0, v;
+
+    qsort(vertexArray, count, 3 * sizeof(GLfixed), compareVertex);
+    for (v = 0; v < count; ++v)
+    {
+        if (v == 0 || compareFixed3(&vertexArray[v * 3],
+                                    &vertexArray[(v - 1) * 3]) != 0)
+            ++distinct;
+    }
+    return distinct;
+}
+
+
+static int checkShape(int shape, double *referenceMs, double *meshMs)
+{
+    static const float baseColor[3] = { 1, 1, 1 };
+    const float *params = sSuperShapeParams[shape];
+    const int resol1 = (int)params[SUPERSHAPE_PARAMS - 3];
+    const int resol2 = (int)params[SUPERSHAPE_PARAMS - 2];
+    const long maxVertices = (long)resol1 * (resol2 / 2 - resol2 / 4) * 6;
+    GLfixed *reference = (GLfixed *)malloc(maxVertices * 3 * sizeof(GLfixed));
+    TRIANGLE *referenceTriangles = (TRIANGLE *)malloc(maxVertices / 3 *
+                                                      sizeof(TRIANGLE));
+    TRIANGLE *meshTriangles = (TRIANGLE *)malloc(maxVertices / 3 *
+                                                 sizeof(TRIANGLE));
+    SUPERSHAPEMESH mesh;
+    long referenceCount, referenceTriangleCount = 0, distinct, i;
+    double t0;
+    int ok = 1;
+
+    if (reference == NULL || referenceTriangles == NULL ||
+        meshTriangles == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    t0 = nowMs();
+    referenceCount = createSuperShapeReference(params, reference);
+    *referenceMs += nowMs() - t0;
+    t0 = nowMs();
+    if (!createSuperShapeMesh(&mesh, params, baseColor))
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    *meshMs += nowMs() - t0;
+
+    for (i = 0; i < referenceCount; i += 3)
+    {
+        referenceTriangleCount += makeTriangle(
+            &referenceTriangles[referenceTriangleCount], &reference[i * 3],
+            &reference[(i + 1) * 3], &reference[(i + 2) * 3]);
+    }
+
+    for (i = 0; i < mesh.indexCount && ok; ++i)
+    {
+        if (mesh.indexArray[i] >= mesh.vertexCount)
+        {
+            printf("shape %2d: index %ld out of range\n", shape, i);
+            ok = 0;
+        }
+    }
+    for (i = 0; i < mesh.vertexCount && ok; ++i)
+    {
+        const GLfixed *n = &mesh.normalArray[i * 3];
+        const double len = sqrt((double)n[0] * n[0] + (double)n[1] * n[1] +
+                                (double)n[2] * n[2]) / 65536;
+        if (fabs(len - 1) > 1e-3)
+        {
+            printf("shape %2d: normal of vertex %ld has length %f\n",
+                   shape, i, len);
+            ok = 0;
+        }
+    }
+    for (i = 0; i < mesh.indexCount / 3 && ok; ++i)
+    {
+        const GLushort *t = &mesh.indexArray[i * 3];
+        if (!makeTriangle(&meshTriangles[i], &mesh.vertexArray[t[0] * 3],
+                          &mesh.vertexArray[t[1] * 3],
+                          &mesh.vertexArray[t[2] * 3]))
+        {
+            printf("shape %2d: degenerate triangle %ld\n", shape, i);
+            ok = 0;
+        }
+    }
+
+    distinct = countDistinctVertices(reference, referenceCount);
+    if (ok && distinct != mesh.vertexCount)
+    {
+        printf("shape %2d: %ld distinct original vertices, %ld in the mesh\n",
+               shape, distinct, mesh.vertexCount);
+        ok = 0;
+    }
+    if (ok && referenceTriangleCount != mesh.indexCount / 3)
+    {
+        printf("shape %2d: %ld welded original triangles, %ld in the mesh\n",
+               shape, referenceTriangleCount, mesh.indexCount / 3);
+        ok = 0;
+    }
+    if (ok)
+    {
+        qsort(referenceTriangles, referenceTriangleCount, sizeof(TRIANGLE),
+              compareTriangle);
+        qsort(meshTriangles, referenceTriangleCount, sizeof(TRIANGLE),
+              compareTriangle);
+        for (i = 0; i < referenceTriangleCount && ok; ++i)
+        {
+            if (compareTriangle(&referenceTriangles[i], &meshTriangles[i]) != 0)
+            {
+                printf("shape %2d: triangle sets differ\n", shape);
+                ok = 0;
+            }
+        }
+    }
+
+    printf("shape %2d: %5ld -> %4ld vertices, %4ld -> %4ld triangles %s\n",
+           shape, referenceCount, mesh.vertexCount, referenceCount / 3,
+           mesh.indexCount / 3, ok ? "ok" : "FAILED");
+
+    freeSuperShapeMesh(&mesh);
+    free(meshTriangles);
+    free(referenceTriangles);
+    free(reference);
+    return ok;
+}
+
+
+int main()
+{
+    double referenceMs = 0, meshMs = 0;
+    int shape, failures = 0;
+
+    for (shape = 0; shape < (int)SUPERSHAPE_COUNT; ++shape)
+        failures += !checkShape(shape, &referenceMs, &meshMs);
+
+    printf("original generator (positions only) %.3f ms, "
+           "indexed generator %.3f ms\n",
+           referenceMs, meshMs);
+    printf("%d of %d shapes failed\n", failures, (int)SUPERSHAPE_COUNT);
+    return failures != 0;
+}
@@ -386,6 +386,7 @@ void Engine::DrawFrame() {
   if (monitor_.Update(fps)) {
     UpdateFPS(fps);
   }
+  NDK_HELPER_PROFILE_ZONE("Engine::DrawFrame");
   renderer_.Update(monitor_.GetCurrentTime());
 
   // Just fill the screen with a color.
@@ -23,11 +23,6 @@
 //--------------------------------------------------------------------------------
 #include "TeapotRenderer.h"
 
-//--------------------------------------------------------------------------------
-// Teapot model data
-//--------------------------------------------------------------------------------
-#include "teapot.inl"
-
 //--------------------------------------------------------------------------------
 // Ctor
 //--------------------------------------------------------------------------------
@@ -46,35 +41,29 @@ void TeapotRenderer::Init() {
   LoadShaders(&shader_param_, "Shaders/VS_ShaderPlain.vsh",
               "Shaders/ShaderPlain.fsh");
 
-  // Create Index buffer
-  num_indices_ = sizeof(teapotIndices) / sizeof(teapotIndices[0]);
-  glGenBuffers(1, &ibo_);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(teapotIndices), teapotIndices,
-               GL_STATIC_DRAW);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-  // Create VBO
-  num_vertices_ = sizeof(teapotPositions) / sizeof(teapotPositions[0]) / 3;
-  int32_t stride = sizeof(TEAPOT_VERTEX);
-  int32_t index = 0;
-  TEAPOT_VERTEX* p = new TEAPOT_VERTEX[num_vertices_];
-  for (int32_t i = 0; i < num_vertices_; ++i) {
-    p[i].pos[0] = teapotPositions[index];
-    p[i].pos[1] = teapotPositions[index + 1];
-    p[i].pos[2] = teapotPositions[index + 2];
-
-    p[i].normal[0] = teapotNormals[index];
-    p[i].normal[1] = teapotNormals[index + 1];
-    p[i].normal[2] = teapotNormals[index + 2];
-    index += 3;
+  // Load the model, its vertex and index data are uploaded as stored
+  num_indices_ = 0;
+  num_vertices_ = 0;
+  if (mesh_.Load("Models/teapot.mesh")) {
+    num_indices_ = mesh_.GetIndexCount();
+    num_vertices_ = mesh_.GetVertexCount();
+
+    // Create Index buffer
+    glGenBuffers(1, &ibo_);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh_.GetIndexDataSize(),
+                 mesh_.GetIndices(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    // Create VBO
+    glGenBuffers(1, &vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferData(GL_ARRAY_BUFFER, mesh_.GetVertexDataSize(),
+                 mesh_.GetVertexData(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  } else {
+    LOGI("Failed to load the teapot model");
   }
-  glGenBuffers(1, &vbo_);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-  glBufferData(GL_ARRAY_BUFFER, stride * num_vertices_, p, GL_STATIC_DRAW);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-  delete[] p;
 
   UpdateViewport();
   mat_model_ = ndk_helper::Mat4::Translation(0, 0, -15.f);
@@ -118,9 +107,12 @@ void TeapotRenderer::Unload() {
     glDeleteProgram(shader_param_.program_);
     shader_param_.program_ = 0;
   }
+
+  mesh_.Release();
 }
 
 void TeapotRenderer::Update(double time) {
+  NDK_HELPER_PROFILE_ZONE("TeapotRenderer::Update");
   const float CAM_X = 0.f;
   const float CAM_Y = 0.f;
   const float CAM_Z = 700.f;
@@ -139,6 +131,7 @@ void TeapotRenderer::Update(double time) {
 }
 
 void TeapotRenderer::Render(float r, float g, float b) {
+  NDK_HELPER_PROFILE_ZONE("TeapotRenderer::Render");
   //
   // Feed Projection and Model View matrices to the shaders
   ndk_helper::Mat4 mat_vp = mat_projection_ * mat_view_;
@@ -146,15 +139,8 @@ void TeapotRenderer::Render(float r, float g, float b) {
   // Bind the VBO
   glBindBuffer(GL_ARRAY_BUFFER, vbo_);
 
-  int32_t iStride = sizeof(TEAPOT_VERTEX);
   // Pass the vertex data
-  glVertexAttribPointer(ATTRIB_VERTEX, 3, GL_FLOAT, GL_FALSE, iStride,
-                        BUFFER_OFFSET(0));
-  glEnableVertexAttribArray(ATTRIB_VERTEX);
-
-  glVertexAttribPointer(ATTRIB_NORMAL, 3, GL_FLOAT, GL_FALSE, iStride,
-                        BUFFER_OFFSET(3 * sizeof(GLfloat)));
-  glEnableVertexAttribArray(ATTRIB_NORMAL);
+  mesh_.SetVertexAttribPointers(ATTRIB_VERTEX, ATTRIB_NORMAL);
 
   // Bind the IB
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_);
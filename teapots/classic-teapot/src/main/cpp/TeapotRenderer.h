@@ -44,11 +44,6 @@
 
 #define BUFFER_OFFSET(i) ((char*)NULL + (i))
 
-struct TEAPOT_VERTEX {
-  float pos[3];
-  float normal[3];
-};
-
 enum SHADER_ATTRIBUTES {
   ATTRIB_VERTEX,
   ATTRIB_NORMAL,
@@ -77,6 +72,7 @@ class TeapotRenderer {
   int32_t num_vertices_;
   GLuint ibo_;
   GLuint vbo_;
+  ndk_helper::Mesh mesh_;
 
   SHADER_PARAMS shader_param_;
   bool LoadShaders(SHADER_PARAMS* params, const char* strVsh,
@@ -26,6 +26,7 @@
 #include <unistd.h>
 
 #include "gl3stub.h"
+#include "profiler.h"
 
 namespace ndk_helper {
 
@@ -159,6 +160,7 @@ bool GLContext::InitEGLContext() {
 }
 
 EGLint GLContext::Swap() {
+  NDK_HELPER_PROFILE_ZONE("GLContext::Swap");
   bool b = eglSwapBuffers(display_, surface_);
   if (!b) {
     EGLint err = eglGetError();
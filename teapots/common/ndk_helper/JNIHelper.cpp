@@ -18,9 +18,6 @@
 
 #include <string.h>
 
-#include <fstream>
-#include <iostream>
-
 #include <EGL/egl.h>
 #include <GLES2/gl2.h>
 
@@ -99,6 +96,21 @@ void JNIHelper::Init(ANativeActivity* activity, const char* helper_class_name) {
   const char* label = env->GetStringUTFChars(labelName, NULL);
   helper.app_label_ = std::string(label);
 
+  // The file locations don't change while the app runs, and Init() runs
+  // again at each android_main() while loader threads may still be in
+  // AssetReader::Open(): the directory list is only set up once.
+  if (helper.external_files_dir_.empty()) {
+    jstring files_dir = helper.GetExternalFilesDirJString(env);
+    if (files_dir) {
+      const char* path = env->GetStringUTFChars(files_dir, NULL);
+      helper.external_files_dir_ = std::string(path);
+      env->ReleaseStringUTFChars(files_dir, path);
+      env->DeleteLocalRef(files_dir);
+      helper.asset_reader_.AddDirectory(helper.external_files_dir_.c_str());
+    }
+  }
+  helper.asset_reader_.SetAssetManager(activity->assetManager);
+
   env->ReleaseStringUTFChars(packageName, appname);
   env->ReleaseStringUTFChars(labelName, label);
   env->DeleteLocalRef(packageName);
@@ -139,59 +151,26 @@ bool JNIHelper::ReadFile(const char* fileName,
     return false;
   }
 
-  // Lock mutex
-  std::lock_guard<std::mutex> lock(mutex_);
-
-  // First, try reading from externalFileDir;
-  JNIEnv* env = AttachCurrentThread();
-  jstring str_path = GetExternalFilesDirJString(env);
-
-  std::string s;
-  if(str_path) {
-    const char* path = env->GetStringUTFChars(str_path, NULL);
-    s = std::string(path);
-    if (fileName[0] != '/') {
-      s.append("/");
-    }
-    s.append(fileName);
-    env->ReleaseStringUTFChars(str_path, path);
-    env->DeleteLocalRef(str_path);
-  }
-  std::ifstream f(s.c_str(), std::ios::binary);
-  activity_->vm->DetachCurrentThread();
-  if (f) {
-    LOGI("reading:%s", s.c_str());
-    f.seekg(0, std::ifstream::end);
-    int32_t fileSize = f.tellg();
-    f.seekg(0, std::ifstream::beg);
-    buffer_ref->reserve(fileSize);
-    buffer_ref->assign(std::istreambuf_iterator<char>(f),
-                       std::istreambuf_iterator<char>());
-    f.close();
-    return true;
-  } else {
-    // Fallback to assetManager
-    AAssetManager* assetManager = activity_->assetManager;
-    AAsset* assetFile =
-        AAssetManager_open(assetManager, fileName, AASSET_MODE_BUFFER);
-    if (!assetFile) {
-      return false;
-    }
-    uint8_t* data = (uint8_t*)AAsset_getBuffer(assetFile);
-    int32_t size = AAsset_getLength(assetFile);
-    if (data == NULL) {
-      AAsset_close(assetFile);
-
-      LOGI("Failed to load:%s", fileName);
-      return false;
-    }
+  if (!asset_reader_.ReadFile(fileName, buffer_ref)) {
+    LOGI("Failed to load:%s", fileName);
+    return false;
+  }
+  return true;
+}
 
-    buffer_ref->reserve(size);
-    buffer_ref->assign(data, data + size);
+bool JNIHelper::OpenFile(const char* fileName, AssetData* data) {
+  if (activity_ == NULL) {
+    LOGI(
+        "JNIHelper has not been initialized. Call init() to initialize the "
+        "helper");
+    return false;
+  }
 
-    AAsset_close(assetFile);
-    return true;
+  if (!asset_reader_.Open(fileName, data)) {
+    LOGI("Failed to load:%s", fileName);
+    return false;
   }
+  return true;
 }
 
 std::string JNIHelper::GetExternalFilesDir() {
@@ -201,20 +180,7 @@ std::string JNIHelper::GetExternalFilesDir() {
         "helper");
     return std::string("");
   }
-
-  // Lock mutex
-  std::lock_guard<std::mutex> lock(mutex_);
-
-  // First, try reading from externalFileDir;
-  JNIEnv* env = AttachCurrentThread();
-
-  jstring strPath = GetExternalFilesDirJString(env);
-  const char* path = env->GetStringUTFChars(strPath, NULL);
-  std::string s(path);
-
-  env->ReleaseStringUTFChars(strPath, path);
-  env->DeleteLocalRef(strPath);
-  return s;
+  return external_files_dir_;
 }
 
 uint32_t JNIHelper::LoadTexture(const char* file_name, int32_t* outWidth,
@@ -27,6 +27,8 @@
 #include <android/log.h>
 #include <android_native_app_glue.h>
 
+#include "assetReader.h"
+
 #define LOGI(...)                                                           \
   ((void)__android_log_print(                                               \
       ANDROID_LOG_INFO, ndk_helper::JNIHelper::GetInstance()->GetAppName(), \
@@ -75,6 +77,10 @@ class JNIHelper {
 
   std::string app_label_;
 
+  // Resolved once in Init(), so that file reads need neither JNI nor mutex_
+  std::string external_files_dir_;
+  AssetReader asset_reader_;
+
   // mutex for synchronization
   // This class uses singleton pattern and can be invoked from multiple threads,
   // each methods locks the mutex for a thread safety
@@ -143,6 +149,8 @@ class JNIHelper {
    * First, the method tries to read the file from an external storage.
    * If it fails to read, it falls back to use assset manager and try to read
    * the file from APK asset.
+   * Unlike the other methods, it doesn't lock the helper and may run on any
+   * number of threads at once.
    *
    * arguments:
    * in: file_name, file name to read
@@ -156,6 +164,21 @@ class JNIHelper {
    */
   bool ReadFile(const char* file_name, std::vector<uint8_t>* buffer_ref);
 
+  /*
+   * ReadFile() without the copy.
+   * Files of the external storage are memory mapped, APK assets are used in
+   * their asset buffer, which is mapped from the APK when they are stored
+   * uncompressed. Thread safe and lock free like ReadFile().
+   *
+   * arguments:
+   * in: file_name, file name to read
+   * out: data, contents of the file, valid until it is released
+   * return:
+   * true when file read succeeded
+   * false when it failed to read the file
+   */
+  bool OpenFile(const char* file_name, AssetData* data);
+
   /*
    * Load and create OpenGL texture from given file name.
    * The method invokes BitmapFactory in Java so it can read jpeg/png formatted
@@ -225,7 +248,7 @@ class JNIHelper {
    */
   std::string ConvertString(const char* str, const char* encode);
   /*
-   * Retrieve external file directory through JNI call
+   * Retrieve external file directory, as queried through JNI in Init()
    *
    * return: std::string containing external file diretory
    */
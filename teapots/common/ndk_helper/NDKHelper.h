@@ -38,6 +38,14 @@
 #include "JNIHelper.h"        // JNI support
 #include "gestureDetector.h"  // Tap/Doubletap/Pinch detector
 #include "perfMonitor.h"      // FPS counter
+#include "profiler.h"         // CPU zone profiler
 #include "sensorManager.h"    // SensorManager
 #include "interpolator.h"     // Interpolator
+#include "interpolatorPool.h"  // Many interpolated values
+#include "jobSystem.h"        // Parallel loops
+#include "mesh.h"             // Binary meshes
+#include "meshOptimizer.h"    // Vertex cache ordering
+#include "mipmap.h"           // CPU mipmap chains
+#include "etc2.h"             // ETC2 block codec
+#include "textureFile.h"      // Baked textures
 #endif
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "assetReader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__ANDROID__)
+#include <android/asset_manager.h>
+#endif
+
+namespace ndk_helper {
+
+namespace {
+// Data of empty files, which can't be mapped
+const uint8_t kEmpty[1] = {0};
+}  // namespace
+
+//--------------------------------------------------------------------------------
+// AssetData
+//--------------------------------------------------------------------------------
+AssetData::AssetData()
+    : data_(NULL), size_(0), mapping_(NULL), asset_(NULL) {}
+
+AssetData::~AssetData() { Release(); }
+
+void AssetData::Release() {
+  if (mapping_ != NULL) munmap(mapping_, size_);
+#if defined(__ANDROID__)
+  if (asset_ != NULL) AAsset_close(asset_);
+#endif
+  data_ = NULL;
+  size_ = 0;
+  mapping_ = NULL;
+  asset_ = NULL;
+}
+
+//--------------------------------------------------------------------------------
+// AssetReader
+//--------------------------------------------------------------------------------
+AssetReader::AssetReader() : asset_manager_(NULL) {}
+
+void AssetReader::AddDirectory(const char* path) {
+  if (path != NULL && path[0] != '\0') directories_.push_back(path);
+}
+
+void AssetReader::SetAssetManager(AAssetManager* asset_manager) {
+  asset_manager_ = asset_manager;
+}
+
+bool AssetReader::MapFile(const char* path, AssetData* data) {
+  data->Release();
+
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return false;
+  }
+  if (st.st_size == 0) {
+    close(fd);
+    data->data_ = kEmpty;
+    return true;
+  }
+  void* mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) return false;
+
+  data->data_ = static_cast<const uint8_t*>(mapping);
+  data->size_ = st.st_size;
+  data->mapping_ = mapping;
+  return true;
+}
+
+bool AssetReader::Open(const char* file_name, AssetData* data) const {
+  data->Release();
+  if (file_name[0] == '/') return MapFile(file_name, data);
+
+  std::string path;
+  for (size_t i = 0; i < directories_.size(); ++i) {
+    path = directories_[i];
+    path.append("/");
+    path.append(file_name);
+    if (MapFile(path.c_str(), data)) return true;
+  }
+
+#if defined(__ANDROID__)
+  if (asset_manager_ != NULL) {
+    // AAssetManager_open() is thread safe. Assets stored uncompressed are
+    // mapped from the APK, compressed ones are inflated once by the asset.
+    AAsset* asset =
+        AAssetManager_open(asset_manager_, file_name, AASSET_MODE_BUFFER);
+    if (asset == NULL) return false;
+    const void* buffer = AAsset_getBuffer(asset);
+    if (buffer == NULL) {
+      AAsset_close(asset);
+      return false;
+    }
+    data->data_ = static_cast<const uint8_t*>(buffer);
+    data->size_ = AAsset_getLength(asset);
+    data->asset_ = asset;
+    return true;
+  }
+#endif
+  return false;
+}
+
+bool AssetReader::ReadFile(const char* file_name,
+                           std::vector<uint8_t>* buffer) const {
+  AssetData data;
+  if (!Open(file_name, &data)) return false;
+  buffer->assign(data.GetData(), data.GetData() + data.GetSize());
+  return true;
+}
+
+}  // namespace ndk_helper
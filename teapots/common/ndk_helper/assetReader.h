@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ASSETREADER_H_
+#define ASSETREADER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// From <android/asset_manager.h>, which host builds don't have
+struct AAsset;
+struct AAssetManager;
+
+namespace ndk_helper {
+
+/******************************************************************
+ * Read-only contents of a file opened by AssetReader
+ * The data stays where it is, in a mapping of the file or in the buffer of
+ * the APK asset, until Release() or destruction.
+ */
+class AssetData {
+ private:
+  const uint8_t* data_;
+  size_t size_;
+
+  // What backs data_
+  void* mapping_;
+  AAsset* asset_;
+
+  AssetData(const AssetData&);
+  AssetData& operator=(const AssetData&);
+
+  friend class AssetReader;
+
+ public:
+  AssetData();
+  ~AssetData();
+
+  void Release();
+
+  bool IsValid() const { return data_ != NULL; }
+  const uint8_t* GetData() const { return data_; }
+  size_t GetSize() const { return size_; }
+};
+
+/******************************************************************
+ * File and asset reader
+ * Looks a file up in a list of directories, then in the APK assets. The
+ * directories and the asset manager are set up once, after which Open()
+ * and ReadFile() may be called from any number of threads at once: they
+ * take no lock and make no JNI call. Without an asset manager, as in host
+ * builds, only the directories are searched.
+ */
+class AssetReader {
+ private:
+  std::vector<std::string> directories_;
+  AAssetManager* asset_manager_;
+
+  AssetReader(const AssetReader&);
+  AssetReader& operator=(const AssetReader&);
+
+ public:
+  AssetReader();
+
+  // Setup, not thread safe. Directories are searched in the order added.
+  void AddDirectory(const char* path);
+  void SetAssetManager(AAssetManager* asset_manager);
+
+  /*
+   * Open a file without copying it.
+   * Absolute paths are opened as they are, other names in the first
+   * directory that has them, else as an asset.
+   *
+   * arguments:
+   * in: file_name, file name to open
+   * out: data, contents of the file, released first
+   * return: true when the file was found and could be read
+   */
+  bool Open(const char* file_name, AssetData* data) const;
+
+  // Open() into a copy, for callers that need to modify the contents
+  bool ReadFile(const char* file_name, std::vector<uint8_t>* buffer) const;
+
+  // Map a file, the plain filesystem part of Open()
+  static bool MapFile(const char* path, AssetData* data);
+};
+
+}  // namespace ndk_helper
+#endif /* ASSETREADER_H_ */
@@ -0,0 +1,741 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "etc2.h"
+
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "jobSystem.h"
+
+namespace ndk_helper {
+
+namespace etc2 {
+
+namespace {
+
+// Intensity modifiers of the individual and differential modes, by table
+// then by selector
+const int32_t kModifiers[8][4] = {
+    {2, 8, -2, -8},     {5, 17, -5, -17},     {9, 29, -9, -29},
+    {13, 42, -13, -42}, {18, 60, -18, -60},   {24, 80, -24, -80},
+    {33, 106, -33, -106}, {47, 183, -47, -183}};
+
+// Paint color distances of the T and H modes
+const int32_t kDistances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+// EAC alpha modifiers, by table then by selector
+const int32_t kAlphaModifiers[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},  {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},  {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},  {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},   {-3, -5, -7, -9, 2, 4, 6, 8}};
+// Table and selector of kAlphaModifiers that add 0
+const int32_t kAlphaZeroTable = 13;
+const int32_t kAlphaZeroSelector = 4;
+
+inline int32_t Clamp255(const int32_t v) {
+  return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+inline int32_t Expand4(const int32_t c) { return (c << 4) | c; }
+inline int32_t Expand5(const int32_t c) { return (c << 3) | (c >> 2); }
+inline int32_t Expand6(const int32_t c) { return (c << 2) | (c >> 4); }
+inline int32_t Expand7(const int32_t c) { return (c << 1) | (c >> 6); }
+inline int32_t Signed3(const int32_t c) { return c >= 4 ? c - 8 : c; }
+inline int32_t Bits(const uint64_t v, const int32_t shift,
+                    const int32_t count) {
+  return static_cast<int32_t>((v >> shift) & ((1u << count) - 1));
+}
+
+// Blocks are stored big endian
+uint64_t ReadBlock(const uint8_t* p) {
+  uint64_t v = 0;
+  for (int32_t i = 0; i < 8; ++i) v = (v << 8) | p[i];
+  return v;
+}
+
+void WriteBlock(uint64_t v, uint8_t* p) {
+  for (int32_t i = 7; i >= 0; --i, v >>= 8) p[i] = static_cast<uint8_t>(v);
+}
+
+// Selectors and EAC indices go down the columns: texel i is at x = i / 4,
+// y = i % 4. Returns the offset of its RGBA in a 4x4 block, rows packed.
+inline int32_t TexelOffset(const int32_t i) {
+  return ((i & 3) * 4 + (i >> 2)) * 4;
+}
+
+// 2 bit selector of texel i
+inline int32_t Selector(const uint64_t v, const int32_t i) {
+  return (Bits(v, 16 + i, 1) << 1) | Bits(v, i, 1);
+}
+
+//--------------------------------------------------------------------------------
+// Decoding
+//--------------------------------------------------------------------------------
+void StoreTexel(const int32_t* color, uint8_t* texel) {
+  for (int32_t c = 0; c < 3; ++c) texel[c] = static_cast<uint8_t>(color[c]);
+  texel[3] = 255;
+}
+
+// T and H modes: each selector picks one of four paint colors
+void DecodePaint(const uint64_t v, const bool h_mode, uint8_t* texels) {
+  int32_t c1[3], c2[3], distance;
+  if (!h_mode) {
+    c1[0] = Expand4((Bits(v, 59, 2) << 2) | Bits(v, 56, 2));
+    c1[1] = Expand4(Bits(v, 52, 4));
+    c1[2] = Expand4(Bits(v, 48, 4));
+    c2[0] = Expand4(Bits(v, 44, 4));
+    c2[1] = Expand4(Bits(v, 40, 4));
+    c2[2] = Expand4(Bits(v, 36, 4));
+    distance = kDistances[(Bits(v, 34, 2) << 1) | Bits(v, 32, 1)];
+  } else {
+    const int32_t r1 = Bits(v, 59, 4);
+    const int32_t g1 = (Bits(v, 56, 3) << 1) | Bits(v, 52, 1);
+    const int32_t b1 = (Bits(v, 51, 1) << 3) | Bits(v, 47, 3);
+    const int32_t r2 = Bits(v, 43, 4);
+    const int32_t g2 = Bits(v, 39, 4);
+    const int32_t b2 = Bits(v, 35, 4);
+    // The order of the two colors holds the last bit of the distance
+    const int32_t order =
+        ((r1 << 8) | (g1 << 4) | b1) >= ((r2 << 8) | (g2 << 4) | b2);
+    distance =
+        kDistances[(Bits(v, 34, 1) << 2) | (Bits(v, 32, 1) << 1) | order];
+    c1[0] = Expand4(r1);
+    c1[1] = Expand4(g1);
+    c1[2] = Expand4(b1);
+    c2[0] = Expand4(r2);
+    c2[1] = Expand4(g2);
+    c2[2] = Expand4(b2);
+  }
+
+  int32_t paint[4][3];
+  for (int32_t c = 0; c < 3; ++c) {
+    if (!h_mode) {
+      paint[0][c] = c1[c];
+      paint[1][c] = Clamp255(c2[c] + distance);
+      paint[2][c] = c2[c];
+      paint[3][c] = Clamp255(c2[c] - distance);
+    } else {
+      paint[0][c] = Clamp255(c1[c] + distance);
+      paint[1][c] = Clamp255(c1[c] - distance);
+      paint[2][c] = Clamp255(c2[c] + distance);
+      paint[3][c] = Clamp255(c2[c] - distance);
+    }
+  }
+  for (int32_t i = 0; i < 16; ++i)
+    StoreTexel(paint[Selector(v, i)], texels + TexelOffset(i));
+}
+
+// Planar mode: three colors at the corners, interpolated over the block
+struct Planar {
+  int32_t o[3];  // 6, 7 and 6 bits
+  int32_t h[3];
+  int32_t v[3];
+};
+
+inline int32_t PlanarValue(const int32_t o, const int32_t h, const int32_t v,
+                           const int32_t x, const int32_t y) {
+  return Clamp255((x * (h - o) + y * (v - o) + 4 * o + 2) >> 2);
+}
+
+inline int32_t ExpandPlanar(const int32_t channel, const int32_t c) {
+  return channel == 1 ? Expand7(c) : Expand6(c);
+}
+
+void DecodePlanar(const uint64_t v, uint8_t* texels) {
+  Planar p;
+  p.o[0] = Bits(v, 57, 6);
+  p.o[1] = (Bits(v, 56, 1) << 6) | Bits(v, 49, 6);
+  p.o[2] = (Bits(v, 48, 1) << 5) | (Bits(v, 43, 2) << 3) | Bits(v, 39, 3);
+  p.h[0] = (Bits(v, 34, 5) << 1) | Bits(v, 32, 1);
+  p.h[1] = Bits(v, 25, 7);
+  p.h[2] = Bits(v, 19, 6);
+  p.v[0] = Bits(v, 13, 6);
+  p.v[1] = Bits(v, 6, 7);
+  p.v[2] = Bits(v, 0, 6);
+  for (int32_t c = 0; c < 3; ++c) {
+    const int32_t o = ExpandPlanar(c, p.o[c]);
+    const int32_t h = ExpandPlanar(c, p.h[c]);
+    const int32_t vv = ExpandPlanar(c, p.v[c]);
+    for (int32_t y = 0; y < 4; ++y) {
+      for (int32_t x = 0; x < 4; ++x) {
+        texels[(y * 4 + x) * 4 + c] =
+            static_cast<uint8_t>(PlanarValue(o, h, vv, x, y));
+      }
+    }
+  }
+  for (int32_t i = 0; i < 16; ++i) texels[i * 4 + 3] = 255;
+}
+
+void DecodeRgb(const uint64_t v, uint8_t* texels) {
+  const bool diff = Bits(v, 33, 1) != 0;
+  int32_t base[2][3];
+  if (diff) {
+    for (int32_t c = 0; c < 3; ++c) {
+      const int32_t color = Bits(v, 59 - 8 * c, 5);
+      const int32_t second = color + Signed3(Bits(v, 56 - 8 * c, 3));
+      // Out of range second colors select the ETC2 modes
+      if (second < 0 || second > 31) {
+        if (c == 2) {
+          DecodePlanar(v, texels);
+        } else {
+          DecodePaint(v, c == 1, texels);
+        }
+        return;
+      }
+      base[0][c] = Expand5(color);
+      base[1][c] = Expand5(second);
+    }
+  } else {
+    for (int32_t c = 0; c < 3; ++c) {
+      base[0][c] = Expand4(Bits(v, 60 - 8 * c, 4));
+      base[1][c] = Expand4(Bits(v, 56 - 8 * c, 4));
+    }
+  }
+
+  const int32_t table[2] = {Bits(v, 37, 3), Bits(v, 34, 3)};
+  const bool flip = Bits(v, 32, 1) != 0;
+  for (int32_t i = 0; i < 16; ++i) {
+    const int32_t half = flip ? (i & 3) >> 1 : i >> 3;
+    const int32_t modifier = kModifiers[table[half]][Selector(v, i)];
+    int32_t color[3];
+    for (int32_t c = 0; c < 3; ++c) color[c] = Clamp255(base[half][c] + modifier);
+    StoreTexel(color, texels + TexelOffset(i));
+  }
+}
+
+void DecodeAlpha(const uint64_t v, uint8_t* texels) {
+  const int32_t base = Bits(v, 56, 8);
+  const int32_t multiplier = Bits(v, 52, 4);
+  const int32_t* modifiers = kAlphaModifiers[Bits(v, 48, 4)];
+  for (int32_t i = 0; i < 16; ++i) {
+    const int32_t modifier = modifiers[Bits(v, 45 - 3 * i, 3)];
+    texels[TexelOffset(i) + 3] =
+        static_cast<uint8_t>(Clamp255(base + modifier * multiplier));
+  }
+}
+
+//--------------------------------------------------------------------------------
+// Encoding
+//--------------------------------------------------------------------------------
+typedef int32_t Texels[16][3];  // In selector order
+
+int32_t BlockError(const uint8_t* texels, const uint8_t* decoded) {
+  int32_t error = 0;
+  for (int32_t i = 0; i < 16; ++i) {
+    for (int32_t c = 0; c < 3; ++c) {
+      const int32_t d = texels[i * 4 + c] - decoded[i * 4 + c];
+      error += d * d;
+    }
+  }
+  return error;
+}
+
+// Texels of one half of a block, in selector order
+void HalfTexels(const bool flip, const int32_t half, int32_t* positions) {
+  int32_t n = 0;
+  for (int32_t i = 0; i < 16; ++i) {
+    if ((flip ? (i & 3) >> 1 : i >> 3) == half) positions[n++] = i;
+  }
+}
+
+/*
+ * Best table and selectors for the 8 texels of a half block around base.
+ * Errors leave out the clamping to [0, 255], which keeps them a quadratic
+ * of the modifier: d.d - 2 m sum(d) + 3 m^2 for a texel d away from base.
+ */
+int32_t FitHalf(const Texels& texels, const int32_t* positions,
+                const int32_t* base, int32_t* table, int32_t* selectors) {
+  int32_t sum[8], sum_squares[8];
+  for (int32_t k = 0; k < 8; ++k) {
+    sum[k] = sum_squares[k] = 0;
+    for (int32_t c = 0; c < 3; ++c) {
+      const int32_t d = texels[positions[k]][c] - base[c];
+      sum[k] += d;
+      sum_squares[k] += d * d;
+    }
+  }
+
+  int32_t best = INT_MAX;
+  for (int32_t t = 0; t < 8; ++t) {
+    int32_t error = 0;
+    int32_t chosen[8];
+    for (int32_t k = 0; k < 8 && error < best; ++k) {
+      int32_t texel_best = INT_MAX;
+      for (int32_t s = 0; s < 4; ++s) {
+        const int32_t m = kModifiers[t][s];
+        const int32_t e = sum_squares[k] - 2 * m * sum[k] + 3 * m * m;
+        if (e < texel_best) {
+          texel_best = e;
+          chosen[k] = s;
+        }
+      }
+      error += texel_best;
+    }
+    if (error < best) {
+      best = error;
+      *table = t;
+      for (int32_t k = 0; k < 8; ++k) selectors[positions[k]] = chosen[k];
+    }
+  }
+  return best;
+}
+
+// FitHalf() around the average of the half quantized to 'bits', and the
+// colors next to it
+int32_t FitHalfQuantized(const Texels& texels, const int32_t* positions,
+                         const int32_t bits, int32_t* color, int32_t* table,
+                         int32_t* selectors) {
+  const int32_t max = (1 << bits) - 1;
+  int32_t center[3];
+  for (int32_t c = 0; c < 3; ++c) {
+    int32_t sum = 0;
+    for (int32_t k = 0; k < 8; ++k) sum += texels[positions[k]][c];
+    center[c] = (sum * max + 8 * 255 / 2) / (8 * 255);
+  }
+
+  static const int32_t kSteps[9][3] = {{0, 0, 0},  {1, 0, 0},   {-1, 0, 0},
+                                       {0, 1, 0},  {0, -1, 0},  {0, 0, 1},
+                                       {0, 0, -1}, {1, 1, 1},   {-1, -1, -1}};
+  int32_t best = INT_MAX;
+  int32_t candidate_selectors[16];
+  for (int32_t s = 0; s < 9; ++s) {
+    int32_t candidate[3], base[3];
+    bool valid = true;
+    for (int32_t c = 0; c < 3; ++c) {
+      candidate[c] = center[c] + kSteps[s][c];
+      valid = valid && candidate[c] >= 0 && candidate[c] <= max;
+      base[c] = bits == 4 ? Expand4(candidate[c]) : Expand5(candidate[c]);
+    }
+    if (!valid) continue;
+    int32_t candidate_table;
+    const int32_t error = FitHalf(texels, positions, base, &candidate_table,
+                                  candidate_selectors);
+    if (error < best) {
+      best = error;
+      memcpy(color, candidate, sizeof(candidate));
+      *table = candidate_table;
+      for (int32_t k = 0; k < 8; ++k)
+        selectors[positions[k]] = candidate_selectors[positions[k]];
+    }
+  }
+  return best;
+}
+
+uint64_t PackEtc1(const bool diff, const bool flip, const int32_t color[2][3],
+                  const int32_t* table, const int32_t* selectors) {
+  uint64_t v = 0;
+  for (int32_t c = 0; c < 3; ++c) {
+    if (diff) {
+      v |= static_cast<uint64_t>(color[0][c]) << (59 - 8 * c);
+      v |= static_cast<uint64_t>((color[1][c] - color[0][c]) & 7)
+           << (56 - 8 * c);
+    } else {
+      v |= static_cast<uint64_t>(color[0][c]) << (60 - 8 * c);
+      v |= static_cast<uint64_t>(color[1][c]) << (56 - 8 * c);
+    }
+  }
+  v |= static_cast<uint64_t>(table[0]) << 37;
+  v |= static_cast<uint64_t>(table[1]) << 34;
+  v |= static_cast<uint64_t>(diff) << 33;
+  v |= static_cast<uint64_t>(flip) << 32;
+  for (int32_t i = 0; i < 16; ++i) {
+    v |= static_cast<uint64_t>(selectors[i] >> 1) << (16 + i);
+    v |= static_cast<uint64_t>(selectors[i] & 1) << i;
+  }
+  return v;
+}
+
+// Best individual or differential block, by the errors of FitHalf()
+uint64_t EncodeEtc1(const Texels& texels) {
+  int32_t best = INT_MAX;
+  uint64_t block = 0;
+  for (int32_t flip = 0; flip < 2; ++flip) {
+    int32_t positions[2][8];
+    HalfTexels(flip != 0, 0, positions[0]);
+    HalfTexels(flip != 0, 1, positions[1]);
+
+    // Individual: 4 bits per half
+    int32_t color[2][3], table[2], selectors[16];
+    int32_t error = 0;
+    for (int32_t half = 0; half < 2; ++half) {
+      error += FitHalfQuantized(texels, positions[half], 4, color[half],
+                                &table[half], selectors);
+    }
+    if (error < best) {
+      best = error;
+      block = PackEtc1(false, flip != 0, color, table, selectors);
+    }
+
+    // Differential: 5 bits, the second color within [-4, 3] of the first
+    error = 0;
+    for (int32_t half = 0; half < 2; ++half) {
+      error += FitHalfQuantized(texels, positions[half], 5, color[half],
+                                &table[half], selectors);
+    }
+    bool in_range = true;
+    for (int32_t c = 0; c < 3; ++c) {
+      const int32_t d = color[1][c] - color[0][c];
+      in_range = in_range && d >= -4 && d <= 3;
+    }
+    if (!in_range) {
+      // Keep either color and pull the other one in
+      const int32_t fitted[2][3] = {
+          {color[0][0], color[0][1], color[0][2]},
+          {color[1][0], color[1][1], color[1][2]}};
+      error = INT_MAX;
+      for (int32_t keep = 0; keep < 2; ++keep) {
+        int32_t c2[2][3], t2[2], s2[16];
+        memcpy(c2, fitted, sizeof(c2));
+        int32_t e = 0;
+        for (int32_t half = 0; half < 2; ++half) {
+          int32_t base[3];
+          for (int32_t c = 0; c < 3; ++c) {
+            if (half != keep) {
+              const int32_t lo = keep == 0 ? c2[0][c] - 4 : c2[1][c] - 3;
+              const int32_t hi = keep == 0 ? c2[0][c] + 3 : c2[1][c] + 4;
+              c2[half][c] = std::min(std::max(c2[half][c], lo), hi);
+              c2[half][c] = std::min(std::max(c2[half][c], 0), 31);
+            }
+            base[c] = Expand5(c2[half][c]);
+          }
+          e += FitHalf(texels, positions[half], base, &t2[half], s2);
+        }
+        if (e < error) {
+          error = e;
+          memcpy(color, c2, sizeof(c2));
+          memcpy(table, t2, sizeof(t2));
+          memcpy(selectors, s2, sizeof(s2));
+        }
+      }
+    }
+    if (error < best) {
+      best = error;
+      block = PackEtc1(true, flip != 0, color, table, selectors);
+    }
+  }
+  return block;
+}
+
+/*
+ * Least squares weights of the planar mode. A texel at (x, y) is
+ * o + x (h - o) / 4 + y (v - o) / 4, so o, h and v are solved from the 16
+ * texels with the inverse of the 3x3 normal matrix, the same for all blocks.
+ */
+struct PlanarSolver {
+  float weights[3][16];  // o, h, v = weights . texels
+
+  PlanarSolver() {
+    double a[3][3] = {{0}};
+    double w[16][3];
+    for (int32_t i = 0; i < 16; ++i) {
+      const double x = i >> 2, y = i & 3;
+      w[i][0] = 1.0 - x / 4 - y / 4;
+      w[i][1] = x / 4;
+      w[i][2] = y / 4;
+      for (int32_t r = 0; r < 3; ++r)
+        for (int32_t c = 0; c < 3; ++c) a[r][c] += w[i][r] * w[i][c];
+    }
+    // Inverse by cofactors
+    double inv[3][3];
+    const double det =
+        a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) -
+        a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0]) +
+        a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+    for (int32_t r = 0; r < 3; ++r) {
+      for (int32_t c = 0; c < 3; ++c) {
+        const int32_t r1 = (c + 1) % 3, r2 = (c + 2) % 3;
+        const int32_t c1 = (r + 1) % 3, c2 = (r + 2) % 3;
+        inv[r][c] = (a[r1][c1] * a[r2][c2] - a[r1][c2] * a[r2][c1]) / det;
+      }
+    }
+    for (int32_t r = 0; r < 3; ++r) {
+      for (int32_t i = 0; i < 16; ++i) {
+        double sum = 0.0;
+        for (int32_t c = 0; c < 3; ++c) sum += inv[r][c] * w[i][c];
+        weights[r][i] = static_cast<float>(sum);
+      }
+    }
+  }
+};
+
+const PlanarSolver& GetPlanarSolver() {
+  static const PlanarSolver solver;
+  return solver;
+}
+
+int32_t PlanarChannelError(const Texels& texels, const int32_t channel,
+                           const int32_t* q) {
+  const int32_t o = ExpandPlanar(channel, q[0]);
+  const int32_t h = ExpandPlanar(channel, q[1]);
+  const int32_t v = ExpandPlanar(channel, q[2]);
+  int32_t error = 0;
+  for (int32_t i = 0; i < 16; ++i) {
+    const int32_t d = PlanarValue(o, h, v, i >> 2, i & 3) - texels[i][channel];
+    error += d * d;
+  }
+  return error;
+}
+
+uint64_t EncodePlanar(const Texels& texels) {
+  const PlanarSolver& solver = GetPlanarSolver();
+  Planar p;
+  for (int32_t c = 0; c < 3; ++c) {
+    // The channels are independent: solve, round, then walk each of the
+    // three values by one step while that lowers the error
+    const int32_t max = c == 1 ? 127 : 63;
+    int32_t q[3];
+    for (int32_t r = 0; r < 3; ++r) {
+      float value = 0.f;
+      for (int32_t i = 0; i < 16; ++i)
+        value += solver.weights[r][i] * texels[i][c];
+      q[r] = static_cast<int32_t>(floorf(value * max / 255.f + 0.5f));
+      q[r] = std::min(std::max(q[r], 0), max);
+    }
+    int32_t error = PlanarChannelError(texels, c, q);
+    for (bool improved = true; improved;) {
+      improved = false;
+      for (int32_t r = 0; r < 3; ++r) {
+        for (int32_t step = -1; step <= 1; step += 2) {
+          if (q[r] + step < 0 || q[r] + step > max) continue;
+          q[r] += step;
+          const int32_t e = PlanarChannelError(texels, c, q);
+          if (e < error) {
+            error = e;
+            improved = true;
+          } else {
+            q[r] -= step;
+          }
+        }
+      }
+    }
+    p.o[c] = q[0];
+    p.h[c] = q[1];
+    p.v[c] = q[2];
+  }
+
+  uint64_t v = 0;
+  v |= static_cast<uint64_t>(p.o[0]) << 57;
+  v |= static_cast<uint64_t>(p.o[1] >> 6) << 56;
+  v |= static_cast<uint64_t>(p.o[1] & 63) << 49;
+  v |= static_cast<uint64_t>(p.o[2] >> 5) << 48;
+  v |= static_cast<uint64_t>((p.o[2] >> 3) & 3) << 43;
+  v |= static_cast<uint64_t>(p.o[2] & 7) << 39;
+  v |= static_cast<uint64_t>(p.h[0] >> 1) << 34;
+  v |= static_cast<uint64_t>(1) << 33;
+  v |= static_cast<uint64_t>(p.h[0] & 1) << 32;
+  v |= static_cast<uint64_t>(p.h[1]) << 25;
+  v |= static_cast<uint64_t>(p.h[2]) << 19;
+  v |= static_cast<uint64_t>(p.v[0]) << 13;
+  v |= static_cast<uint64_t>(p.v[1]) << 6;
+  v |= static_cast<uint64_t>(p.v[2]);
+
+  // The free bits keep the red and green second colors in range and put
+  // the blue one out, which is what selects the planar mode
+  if (Bits(v, 59, 5) + Signed3(Bits(v, 56, 3)) < 0)
+    v |= static_cast<uint64_t>(1) << 63;
+  if (Bits(v, 51, 5) + Signed3(Bits(v, 48, 3)) < 0)
+    v |= static_cast<uint64_t>(1) << 55;
+  if (Bits(v, 43, 2) + Bits(v, 40, 2) >= 4) {
+    v |= static_cast<uint64_t>(7) << 45;  // Above 31
+  } else {
+    v |= static_cast<uint64_t>(1) << 42;  // Below 0
+  }
+  return v;
+}
+
+uint64_t EncodeRgb(const uint8_t* texels) {
+  Texels t;
+  for (int32_t i = 0; i < 16; ++i) {
+    for (int32_t c = 0; c < 3; ++c) t[i][c] = texels[TexelOffset(i) + c];
+  }
+
+  // The candidates are compared on what they decode to
+  const uint64_t candidates[2] = {EncodeEtc1(t), EncodePlanar(t)};
+  uint64_t best_block = candidates[0];
+  int32_t best = INT_MAX;
+  for (int32_t k = 0; k < 2; ++k) {
+    uint8_t decoded[64];
+    DecodeRgb(candidates[k], decoded);
+    const int32_t error = BlockError(texels, decoded);
+    if (error < best) {
+      best = error;
+      best_block = candidates[k];
+    }
+  }
+  return best_block;
+}
+
+uint64_t PackAlpha(const int32_t base, const int32_t multiplier,
+                   const int32_t table, const int32_t* selectors) {
+  uint64_t v = static_cast<uint64_t>(base) << 56;
+  v |= static_cast<uint64_t>(multiplier) << 52;
+  v |= static_cast<uint64_t>(table) << 48;
+  for (int32_t i = 0; i < 16; ++i)
+    v |= static_cast<uint64_t>(selectors[i]) << (45 - 3 * i);
+  return v;
+}
+
+uint64_t EncodeAlpha(const uint8_t* texels) {
+  int32_t alpha[16];
+  int32_t lo = 255, hi = 0;
+  for (int32_t i = 0; i < 16; ++i) {
+    alpha[i] = texels[TexelOffset(i) + 3];
+    lo = std::min(lo, alpha[i]);
+    hi = std::max(hi, alpha[i]);
+  }
+  int32_t selectors[16];
+  if (lo == hi) {
+    for (int32_t i = 0; i < 16; ++i) selectors[i] = kAlphaZeroSelector;
+    return PackAlpha(lo, 1, kAlphaZeroTable, selectors);
+  }
+
+  // For each table, the multipliers that about span [lo, hi], and bases
+  // around the one that centers the table on it
+  int32_t best = INT_MAX;
+  uint64_t block = 0;
+  for (int32_t t = 0; t < 16; ++t) {
+    const int32_t* modifiers = kAlphaModifiers[t];
+    const int32_t span = modifiers[7] - modifiers[3];
+    const int32_t fit = (hi - lo + span - 1) / span;
+    for (int32_t m = std::max(fit - 1, 1); m <= std::min(fit + 1, 15); ++m) {
+      const int32_t center =
+          (lo + hi - (modifiers[7] + modifiers[3]) * m + 1) / 2;
+      for (int32_t base = center - 1; base <= center + 1; ++base) {
+        if (base < 0 || base > 255) continue;
+        int32_t error = 0;
+        int32_t chosen[16];
+        for (int32_t i = 0; i < 16 && error < best; ++i) {
+          int32_t texel_best = INT_MAX;
+          for (int32_t s = 0; s < 8; ++s) {
+            const int32_t d = Clamp255(base + modifiers[s] * m) - alpha[i];
+            if (d * d < texel_best) {
+              texel_best = d * d;
+              chosen[i] = s;
+            }
+          }
+          error += texel_best;
+        }
+        if (error < best) {
+          best = error;
+          block = PackAlpha(base, m, t, chosen);
+        }
+      }
+    }
+  }
+  return block;
+}
+
+}  // namespace
+
+//--------------------------------------------------------------------------------
+// Blocks
+//--------------------------------------------------------------------------------
+void EncodeRgbBlock(const uint8_t* texels, uint8_t* block) {
+  WriteBlock(EncodeRgb(texels), block);
+}
+
+void EncodeRgbaBlock(const uint8_t* texels, uint8_t* block) {
+  WriteBlock(EncodeAlpha(texels), block);
+  WriteBlock(EncodeRgb(texels), block + 8);
+}
+
+void DecodeRgbBlock(const uint8_t* block, uint8_t* texels) {
+  DecodeRgb(ReadBlock(block), texels);
+}
+
+void DecodeRgbaBlock(const uint8_t* block, uint8_t* texels) {
+  DecodeRgb(ReadBlock(block + 8), texels);
+  DecodeAlpha(ReadBlock(block), texels);
+}
+
+//--------------------------------------------------------------------------------
+// Images
+//--------------------------------------------------------------------------------
+size_t GetImageSize(const int32_t width, const int32_t height,
+                    const bool alpha) {
+  return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) *
+         (alpha ? kRgbaBlockSize : kRgbBlockSize);
+}
+
+void EncodeImage(const uint8_t* rgba, const int32_t width,
+                 const int32_t height, const bool alpha, uint8_t* blocks,
+                 JobSystem* jobs) {
+  const int32_t blocks_x = (width + 3) / 4;
+  const int32_t blocks_y = (height + 3) / 4;
+  const int32_t block_size = alpha ? kRgbaBlockSize : kRgbBlockSize;
+  auto encode_rows = [&](int32_t begin, int32_t end) {
+    uint8_t texels[64];
+    for (int32_t by = begin; by < end; ++by) {
+      for (int32_t bx = 0; bx < blocks_x; ++bx) {
+        for (int32_t y = 0; y < 4; ++y) {
+          const int32_t sy = std::min(by * 4 + y, height - 1);
+          for (int32_t x = 0; x < 4; ++x) {
+            const int32_t sx = std::min(bx * 4 + x, width - 1);
+            memcpy(texels + (y * 4 + x) * 4,
+                   rgba + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+          }
+        }
+        uint8_t* block =
+            blocks + (static_cast<size_t>(by) * blocks_x + bx) * block_size;
+        if (alpha) {
+          EncodeRgbaBlock(texels, block);
+        } else {
+          EncodeRgbBlock(texels, block);
+        }
+      }
+    }
+  };
+  if (jobs != NULL) {
+    jobs->ParallelFor(blocks_y, 1, encode_rows);
+  } else {
+    encode_rows(0, blocks_y);
+  }
+}
+
+void DecodeImage(const uint8_t* blocks, const int32_t width,
+                 const int32_t height, const bool alpha, uint8_t* rgba) {
+  const int32_t blocks_x = (width + 3) / 4;
+  const int32_t blocks_y = (height + 3) / 4;
+  const int32_t block_size = alpha ? kRgbaBlockSize : kRgbBlockSize;
+  uint8_t texels[64];
+  for (int32_t by = 0; by < blocks_y; ++by) {
+    for (int32_t bx = 0; bx < blocks_x; ++bx, blocks += block_size) {
+      if (alpha) {
+        DecodeRgbaBlock(blocks, texels);
+      } else {
+        DecodeRgbBlock(blocks, texels);
+      }
+      const int32_t w = std::min(4, width - bx * 4);
+      const int32_t h = std::min(4, height - by * 4);
+      for (int32_t y = 0; y < h; ++y) {
+        memcpy(rgba + ((static_cast<size_t>(by) * 4 + y) * width + bx * 4) * 4,
+               texels + y * 16, w * 4);
+      }
+    }
+  }
+}
+
+}  // namespace etc2
+
+}  // namespace ndk_helper
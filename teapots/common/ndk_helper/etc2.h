@@ -0,0 +1,77 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ETC2_H_
+#define ETC2_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ndk_helper {
+
+class JobSystem;
+
+namespace etc2 {
+
+/******************************************************************
+ * ETC2 block compression, the format every OpenGL ES 3 device samples
+ * namespace: ndkHelper::etc2
+ *
+ * RGB blocks are GL_COMPRESSED_RGB8_ETC2 (or its sRGB variant), 8 bytes for
+ * 4x4 texels; RGBA blocks are GL_COMPRESSED_RGBA8_ETC2_EAC, an EAC alpha
+ * block followed by an RGB block. No GL or Android dependency, so that the
+ * offline tools in teapots/host link it too.
+ *
+ * The encoder is meant for offline baking: it tries the ETC1 individual and
+ * differential modes in both block orientations and the ETC2 planar mode,
+ * and keeps whichever decodes closest. It never emits the T and H modes,
+ * which the decoder handles all the same.
+ */
+
+const int32_t kRgbBlockSize = 8;
+const int32_t kRgbaBlockSize = 16;
+
+/*
+ * One block of 4x4 RGBA8 texels, 64 bytes with rows packed. The RGB
+ * functions ignore alpha on input and decode it as 255.
+ */
+void EncodeRgbBlock(const uint8_t* texels, uint8_t* block);
+void EncodeRgbaBlock(const uint8_t* texels, uint8_t* block);
+void DecodeRgbBlock(const uint8_t* block, uint8_t* texels);
+void DecodeRgbaBlock(const uint8_t* block, uint8_t* texels);
+
+// Bytes of a compressed image, its blocks covering width x height
+size_t GetImageSize(const int32_t width, const int32_t height,
+                    const bool alpha);
+
+/*
+ * Whole images of width x height RGBA8 texels, rows packed. Blocks over the
+ * right and bottom edges repeat the last column and row.
+ *
+ * arguments:
+ *  in: jobs, threads to split the block rows over, may be NULL
+ *  out: blocks, GetImageSize() bytes
+ */
+void EncodeImage(const uint8_t* rgba, const int32_t width,
+                 const int32_t height, const bool alpha, uint8_t* blocks,
+                 JobSystem* jobs = NULL);
+void DecodeImage(const uint8_t* blocks, const int32_t width,
+                 const int32_t height, const bool alpha, uint8_t* rgba);
+
+}  // namespace etc2
+
+}  // namespace ndk_helper
+#endif /* ETC2_H_ */
@@ -15,22 +15,23 @@
  */
 
 #include "interpolator.h"
-#include <math.h>
-#include "interpolator.h"
 
 namespace ndk_helper {
 
 //-------------------------------------------------
 // Ctor
 //-------------------------------------------------
-Interpolator::Interpolator() { list_params_.clear(); }
+Interpolator::Interpolator() : next_param_(0) {}
 
 //-------------------------------------------------
 // Dtor
 //-------------------------------------------------
-Interpolator::~Interpolator() { list_params_.clear(); }
+Interpolator::~Interpolator() {}
 
-void Interpolator::Clear() { list_params_.clear(); }
+void Interpolator::Clear() {
+  params_.clear();
+  next_param_ = 0;
+}
 
 Interpolator& Interpolator::Set(const float start, const float dest,
                                 const INTERPOLATOR_TYPE type,
@@ -51,7 +52,7 @@ Interpolator& Interpolator::Add(const float dest, const INTERPOLATOR_TYPE type,
   param.dest_value_ = dest;
   param.type_ = type;
   param.duration_ = duration;
-  list_params_.push_back(param);
+  params_.push_back(param);
   return *this;
 }
 
@@ -59,95 +60,24 @@ bool Interpolator::Update(const double current_time, float& p) {
   bool bContinue;
   if (current_time >= dest_time_) {
     p = dest_value_;
-    if (list_params_.size()) {
-      InterpolatorParams& item = list_params_.front();
+    if (next_param_ < params_.size()) {
+      const InterpolatorParams item = params_[next_param_++];
       Set(dest_value_, item.dest_value_, item.type_, item.duration_);
-      list_params_.pop_front();
+      // Keep the storage for the next Add()
+      if (next_param_ == params_.size()) Clear();
 
       bContinue = true;
     } else {
       bContinue = false;
     }
   } else {
-    float t = (float)(current_time - start_time_);
-    float d = (float)(dest_time_ - start_time_);
-    float b = start_value_;
-    float c = dest_value_ - start_value_;
-    p = GetFormula(type_, t, b, d, c);
+    float u =
+        (float)((current_time - start_time_) / (dest_time_ - start_time_));
+    p = start_value_ + (dest_value_ - start_value_) * Ease(type_, u);
 
     bContinue = true;
   }
   return bContinue;
 }
 
-float Interpolator::GetFormula(const INTERPOLATOR_TYPE type, const float t,
-                               const float b, const float d, const float c) {
-  float t1;
-  switch (type) {
-    case INTERPOLATOR_TYPE_LINEAR:
-      // simple linear interpolation - no easing
-      return (c * t / d + b);
-
-    case INTERPOLATOR_TYPE_EASEINQUAD:
-      // quadratic (t^2) easing in - accelerating from zero velocity
-      t1 = t / d;
-      return (c * t1 * t1 + b);
-
-    case INTERPOLATOR_TYPE_EASEOUTQUAD:
-      // quadratic (t^2) easing out - decelerating to zero velocity
-      t1 = t / d;
-      return (-c * t1 * (t1 - 2) + b);
-
-    case INTERPOLATOR_TYPE_EASEINOUTQUAD:
-      // quadratic easing in/out - acceleration until halfway, then deceleration
-      t1 = t / d / 2;
-      if (t1 < 1)
-        return (c / 2 * t1 * t1 + b);
-      else {
-        t1 = t1 - 1;
-        return (-c / 2 * (t1 * (t1 - 2) - 1) + b);
-      }
-    case INTERPOLATOR_TYPE_EASEINCUBIC:
-      // cubic easing in - accelerating from zero velocity
-      t1 = t / d;
-      return (c * t1 * t1 * t1 + b);
-
-    case INTERPOLATOR_TYPE_EASEOUTCUBIC:
-      // cubic easing in - accelerating from zero velocity
-      t1 = t / d - 1;
-      return (c * (t1 * t1 * t1 + 1) + b);
-
-    case INTERPOLATOR_TYPE_EASEINOUTCUBIC:
-      // cubic easing in - accelerating from zero velocity
-      t1 = t / d / 2;
-
-      if (t1 < 1)
-        return (c / 2 * t1 * t1 * t1 + b);
-      else {
-        t1 -= 2;
-        return (c / 2 * (t1 * t1 * t1 + 2) + b);
-      }
-    case INTERPOLATOR_TYPE_EASEINQUART:
-      // quartic easing in - accelerating from zero velocity
-      t1 = t / d;
-      return (c * t1 * t1 * t1 * t1 + b);
-
-    case INTERPOLATOR_TYPE_EASEINEXPO:
-      // exponential (2^t) easing in - accelerating from zero velocity
-      if (t == 0)
-        return b;
-      else
-        return (c * powf(2, (10 * (t / d - 1))) + b);
-
-    case INTERPOLATOR_TYPE_EASEOUTEXPO:
-      // exponential (2^t) easing out - decelerating to zero velocity
-      if (t == d)
-        return (b + c);
-      else
-        return (c * (-powf(2, -10 * t / d) + 1) + b);
-    default:
-      return 0;
-  }
-}
-
 }  // namespace ndkHelper
@@ -22,31 +22,14 @@
 #include <time.h>
 #include "JNIHelper.h"
 #include "perfMonitor.h"
-#include <list>
+#include "interpolatorPool.h"
+#include <vector>
 
 namespace ndk_helper {
 
-enum INTERPOLATOR_TYPE {
-  INTERPOLATOR_TYPE_LINEAR,
-  INTERPOLATOR_TYPE_EASEINQUAD,
-  INTERPOLATOR_TYPE_EASEOUTQUAD,
-  INTERPOLATOR_TYPE_EASEINOUTQUAD,
-  INTERPOLATOR_TYPE_EASEINCUBIC,
-  INTERPOLATOR_TYPE_EASEOUTCUBIC,
-  INTERPOLATOR_TYPE_EASEINOUTCUBIC,
-  INTERPOLATOR_TYPE_EASEINQUART,
-  INTERPOLATOR_TYPE_EASEINEXPO,
-  INTERPOLATOR_TYPE_EASEOUTEXPO,
-};
-
-struct InterpolatorParams {
-  float dest_value_;
-  INTERPOLATOR_TYPE type_;
-  double duration_;
-};
-
 /******************************************************************
  * Interpolates values with several interpolation methods
+ * One value at a time, see InterpolatorPool to animate many of them.
  */
 class Interpolator {
  private:
@@ -56,10 +39,10 @@ class Interpolator {
 
   float start_value_;
   float dest_value_;
-  std::list<InterpolatorParams> list_params_;
 
-  float GetFormula(const INTERPOLATOR_TYPE type, const float t, const float b,
-                   const float d, const float c);
+  // Queued by Add(), params_[next_param_] comes next
+  std::vector<InterpolatorParams> params_;
+  size_t next_param_;
 
  public:
   Interpolator();
@@ -0,0 +1,311 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interpolatorPool.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace ndk_helper {
+
+namespace {
+
+// Start times are rebased before they get this old, which keeps them
+// within 16 us as floats
+const double kRebaseSeconds = 128.0;
+
+float Clamp01(const float u) { return std::min(std::max(u, 0.f), 1.f); }
+
+/*
+ * The loop of one group, with the type known at compile time so that Ease()
+ * folds to the formula. Returns whether any segment is over.
+ */
+template <int32_t kType>
+bool Evaluate(const int32_t count, const float now, const float* start,
+              const float* duration, const float* inv_duration,
+              const float* from, const float* delta, float* __restrict value,
+              uint8_t* __restrict done) {
+  int32_t any_done = 0;
+  for (int32_t i = 0; i < count; ++i) {
+    const float t = now - start[i];
+    const float u = Clamp01(t * inv_duration[i]);
+    value[i] =
+        from[i] + delta[i] * Ease(static_cast<INTERPOLATOR_TYPE>(kType), u);
+    done[i] = t >= duration[i];
+    any_done |= done[i];
+  }
+  return any_done != 0;
+}
+
+typedef bool (*EvaluateFunc)(const int32_t, const float, const float*,
+                             const float*, const float*, const float*,
+                             const float*, float*, uint8_t*);
+
+const EvaluateFunc kEvaluate[INTERPOLATOR_TYPE_COUNT] = {
+    Evaluate<INTERPOLATOR_TYPE_LINEAR>,
+    Evaluate<INTERPOLATOR_TYPE_EASEINQUAD>,
+    Evaluate<INTERPOLATOR_TYPE_EASEOUTQUAD>,
+    Evaluate<INTERPOLATOR_TYPE_EASEINOUTQUAD>,
+    Evaluate<INTERPOLATOR_TYPE_EASEINCUBIC>,
+    Evaluate<INTERPOLATOR_TYPE_EASEOUTCUBIC>,
+    Evaluate<INTERPOLATOR_TYPE_EASEINOUTCUBIC>,
+    Evaluate<INTERPOLATOR_TYPE_EASEINQUART>,
+    Evaluate<INTERPOLATOR_TYPE_EASEINEXPO>,
+    Evaluate<INTERPOLATOR_TYPE_EASEOUTEXPO>,
+};
+
+}  // namespace
+
+InterpolatorPool::InterpolatorPool()
+    : free_segment_(-1),
+      pending_count_(0),
+      time_base_(0.0),
+      has_time_base_(false) {}
+
+void InterpolatorPool::Reserve(const int32_t tracks, const int32_t segments) {
+  tracks_.reserve(tracks);
+  segments_.reserve(segments);
+}
+
+InterpolatorPool::Track InterpolatorPool::Create(const float value) {
+  Track track;
+  if (!free_tracks_.empty()) {
+    track = free_tracks_.back();
+    free_tracks_.pop_back();
+  } else {
+    track = static_cast<Track>(tracks_.size());
+    tracks_.push_back(TrackState());
+  }
+  TrackState& t = tracks_[track];
+  t.state = kIdle;
+  t.slot = 0;
+  t.queue_head = -1;
+  t.queue_tail = -1;
+  t.idle_value = value;
+  return track;
+}
+
+void InterpolatorPool::Release(const Track track) {
+  Stop(track);
+  tracks_[track].state = kReleased;
+  free_tracks_.push_back(track);
+}
+
+float InterpolatorPool::ToLocalTime(const double time) {
+  if (!has_time_base_) {
+    time_base_ = time;
+    has_time_base_ = true;
+  } else if (time - time_base_ > kRebaseSeconds) {
+    Rebase(time);
+  }
+  return static_cast<float>(time - time_base_);
+}
+
+void InterpolatorPool::Rebase(const double time) {
+  const float shift = static_cast<float>(time - time_base_);
+  time_base_ += shift;
+  for (auto& group : groups_) {
+    for (auto& start : group.start) start -= shift;
+  }
+}
+
+void InterpolatorPool::Insert(const Track track, const INTERPOLATOR_TYPE type,
+                              const float start, const float duration,
+                              const float from, const float dest,
+                              const float now) {
+  Group& group = groups_[type];
+  const float inv_duration = duration > 0.f ? 1.f / duration : 0.f;
+  tracks_[track].state = type;
+  tracks_[track].slot = static_cast<int32_t>(group.track.size());
+  group.start.push_back(start);
+  group.duration.push_back(duration);
+  group.inv_duration.push_back(inv_duration);
+  group.from.push_back(from);
+  group.delta.push_back(dest - from);
+  group.dest.push_back(dest);
+  group.value.push_back(
+      from + (dest - from) * Ease(type, Clamp01((now - start) * inv_duration)));
+  group.track.push_back(track);
+  group.done.push_back(0);
+}
+
+void InterpolatorPool::Remove(const Track track) {
+  TrackState& t = tracks_[track];
+  Group& group = groups_[t.state];
+  const int32_t slot = t.slot;
+  const int32_t last = static_cast<int32_t>(group.track.size()) - 1;
+  if (slot != last) {
+    group.start[slot] = group.start[last];
+    group.duration[slot] = group.duration[last];
+    group.inv_duration[slot] = group.inv_duration[last];
+    group.from[slot] = group.from[last];
+    group.delta[slot] = group.delta[last];
+    group.dest[slot] = group.dest[last];
+    group.value[slot] = group.value[last];
+    group.track[slot] = group.track[last];
+    group.done[slot] = group.done[last];
+    tracks_[group.track[slot]].slot = slot;
+  }
+  group.start.pop_back();
+  group.duration.pop_back();
+  group.inv_duration.pop_back();
+  group.from.pop_back();
+  group.delta.pop_back();
+  group.dest.pop_back();
+  group.value.pop_back();
+  group.track.pop_back();
+  group.done.pop_back();
+  t.state = kIdle;
+}
+
+void InterpolatorPool::FreeQueue(const Track track) {
+  TrackState& t = tracks_[track];
+  if (t.queue_head < 0) return;
+  segments_[t.queue_tail].next = free_segment_;
+  free_segment_ = t.queue_head;
+  t.queue_head = -1;
+  t.queue_tail = -1;
+}
+
+void InterpolatorPool::Set(const Track track, const float start,
+                           const float dest, const INTERPOLATOR_TYPE type,
+                           const double duration, const double current_time) {
+  const float now = ToLocalTime(current_time);
+  if (tracks_[track].state >= 0) Remove(track);
+  if (tracks_[track].state == kPending) --pending_count_;
+  Insert(track, type, now, static_cast<float>(duration), start, dest, now);
+}
+
+void InterpolatorPool::Add(const Track track, const float dest,
+                           const INTERPOLATOR_TYPE type,
+                           const double duration) {
+  int32_t index = free_segment_;
+  if (index >= 0) {
+    free_segment_ = segments_[index].next;
+  } else {
+    index = static_cast<int32_t>(segments_.size());
+    segments_.push_back(Segment());
+  }
+  Segment& segment = segments_[index];
+  segment.dest = dest;
+  segment.duration = static_cast<float>(duration);
+  segment.type = type;
+  segment.next = -1;
+
+  TrackState& t = tracks_[track];
+  if (t.queue_tail >= 0) {
+    segments_[t.queue_tail].next = index;
+  } else {
+    t.queue_head = index;
+  }
+  t.queue_tail = index;
+
+  if (t.state == kIdle) {
+    t.state = kPending;
+    pending_.push_back(track);
+    ++pending_count_;
+  }
+}
+
+void InterpolatorPool::Stop(const Track track) {
+  TrackState& t = tracks_[track];
+  if (t.state >= 0) {
+    t.idle_value = GetValue(track);
+    Remove(track);
+  }
+  if (t.state == kPending) --pending_count_;
+  t.state = kIdle;
+  FreeQueue(track);
+}
+
+void InterpolatorPool::Advance(const Track track, float end, float value,
+                               const float now) {
+  TrackState& t = tracks_[track];
+  for (;;) {
+    const int32_t index = t.queue_head;
+    if (index < 0) {
+      t.state = kIdle;
+      t.idle_value = value;
+      return;
+    }
+    const Segment segment = segments_[index];
+    t.queue_head = segment.next;
+    if (segment.next < 0) t.queue_tail = -1;
+    segments_[index].next = free_segment_;
+    free_segment_ = index;
+
+    if (now - end < segment.duration) {
+      Insert(track, segment.type, end, segment.duration, value, segment.dest,
+             now);
+      return;
+    }
+    // Skipped over entirely since the last Update()
+    end += segment.duration;
+    value = segment.dest;
+  }
+}
+
+void InterpolatorPool::Complete(const int32_t type, const float now) {
+  Group& group = groups_[type];
+  // Remove() moves the last segment to the one removed, which is looked at
+  // again. Segments inserted meanwhile are not done.
+  size_t i = 0;
+  for (;;) {
+    const uint8_t* done = group.done.data();
+    const void* next = memchr(done + i, 1, group.done.size() - i);
+    if (next == NULL) break;
+    i = static_cast<const uint8_t*>(next) - done;
+    const Track track = group.track[i];
+    const float end = group.start[i] + group.duration[i];
+    const float dest = group.dest[i];
+    Remove(track);
+    Advance(track, end, dest, now);
+  }
+}
+
+int32_t InterpolatorPool::Update(const double current_time) {
+  const float now = ToLocalTime(current_time);
+
+  for (const Track track : pending_) {
+    if (tracks_[track].state == kPending)
+      Advance(track, now, tracks_[track].idle_value, now);
+  }
+  pending_.clear();
+  pending_count_ = 0;
+
+  for (int32_t type = 0; type < INTERPOLATOR_TYPE_COUNT; ++type) {
+    Group& group = groups_[type];
+    const int32_t size = static_cast<int32_t>(group.track.size());
+    if (size == 0) continue;
+    if (kEvaluate[type](size, now, group.start.data(), group.duration.data(),
+                        group.inv_duration.data(), group.from.data(),
+                        group.delta.data(), group.value.data(),
+                        group.done.data())) {
+      Complete(type, now);
+    }
+  }
+  return GetAnimatedCount();
+}
+
+int32_t InterpolatorPool::GetAnimatedCount() const {
+  int32_t count = 0;
+  for (const auto& group : groups_)
+    count += static_cast<int32_t>(group.track.size());
+  return count + pending_count_;
+}
+
+}  // namespace ndk_helper
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INTERPOLATORPOOL_H_
+#define INTERPOLATORPOOL_H_
+
+#include <math.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace ndk_helper {
+
+enum INTERPOLATOR_TYPE {
+  INTERPOLATOR_TYPE_LINEAR,
+  INTERPOLATOR_TYPE_EASEINQUAD,
+  INTERPOLATOR_TYPE_EASEOUTQUAD,
+  INTERPOLATOR_TYPE_EASEINOUTQUAD,
+  INTERPOLATOR_TYPE_EASEINCUBIC,
+  INTERPOLATOR_TYPE_EASEOUTCUBIC,
+  INTERPOLATOR_TYPE_EASEINOUTCUBIC,
+  INTERPOLATOR_TYPE_EASEINQUART,
+  INTERPOLATOR_TYPE_EASEINEXPO,
+  INTERPOLATOR_TYPE_EASEOUTEXPO,
+  INTERPOLATOR_TYPE_COUNT
+};
+
+struct InterpolatorParams {
+  float dest_value_;
+  INTERPOLATOR_TYPE type_;
+  double duration_;
+};
+
+/******************************************************************
+ * Ease()
+ * Progress of an interpolation of the given type at u, the elapsed part of
+ * its duration in [0, 1]: 0 at the start and 1 at the end.
+ */
+inline float Ease(const INTERPOLATOR_TYPE type, const float u) {
+  float v;
+  switch (type) {
+    case INTERPOLATOR_TYPE_LINEAR:
+      // simple linear interpolation - no easing
+      return u;
+    case INTERPOLATOR_TYPE_EASEINQUAD:
+      // quadratic (t^2) easing in - accelerating from zero velocity
+      return u * u;
+    case INTERPOLATOR_TYPE_EASEOUTQUAD:
+      // quadratic (t^2) easing out - decelerating to zero velocity
+      return u * (2.f - u);
+    case INTERPOLATOR_TYPE_EASEINOUTQUAD:
+      // quadratic easing in/out - acceleration until halfway, then
+      // deceleration
+      v = 1.f - u;
+      return u < 0.5f ? 2.f * u * u : 1.f - 2.f * v * v;
+    case INTERPOLATOR_TYPE_EASEINCUBIC:
+      // cubic easing in - accelerating from zero velocity
+      return u * u * u;
+    case INTERPOLATOR_TYPE_EASEOUTCUBIC:
+      // cubic easing out - decelerating to zero velocity
+      v = u - 1.f;
+      return v * v * v + 1.f;
+    case INTERPOLATOR_TYPE_EASEINOUTCUBIC:
+      // cubic easing in/out - acceleration until halfway, then deceleration
+      v = u - 1.f;
+      return u < 0.5f ? 4.f * u * u * u : 4.f * v * v * v + 1.f;
+    case INTERPOLATOR_TYPE_EASEINQUART:
+      // quartic easing in - accelerating from zero velocity
+      v = u * u;
+      return v * v;
+    case INTERPOLATOR_TYPE_EASEINEXPO:
+      // exponential (2^t) easing in - accelerating from zero velocity
+      return u > 0.f ? exp2f(10.f * (u - 1.f)) : 0.f;
+    case INTERPOLATOR_TYPE_EASEOUTEXPO:
+      // exponential (2^t) easing out - decelerating to zero velocity
+      return u < 1.f ? 1.f - exp2f(-10.f * u) : 1.f;
+    default:
+      return 0.f;
+  }
+}
+
+/******************************************************************
+ * Pool of interpolated values
+ * Each track animates one float through a queue of segments, like an
+ * Interpolator. The tracks being animated are kept in structure-of-arrays
+ * groups, one per interpolation type, so that Update() evaluates each group
+ * in a single loop without branching on the type, which the compiler
+ * vectorizes for the polynomial easings.
+ * Segments are queued in a free list shared by all tracks, so that once the
+ * pool has grown to its working size nothing is allocated per segment.
+ * Queued segments start where the previous one ended, whenever Update() is
+ * called, so chained animations keep their timing.
+ * Times are in seconds, e.g. PerfMonitor::GetCurrentTime().
+ */
+class InterpolatorPool {
+ public:
+  typedef int32_t Track;
+  static const Track kInvalidTrack = -1;
+
+ private:
+  // Segments being evaluated, for one type. Start times are relative to
+  // time_base_, so that they keep their precision as floats.
+  struct Group {
+    std::vector<float> start;
+    std::vector<float> duration;
+    std::vector<float> inv_duration;
+    std::vector<float> from;
+    std::vector<float> delta;
+    std::vector<float> dest;
+    std::vector<float> value;
+    std::vector<Track> track;
+    std::vector<uint8_t> done;  // Set by Update() for the segments over
+  };
+
+  struct Segment {
+    float dest;
+    float duration;
+    INTERPOLATOR_TYPE type;
+    int32_t next;
+  };
+
+  // Track states besides the index of the group that evaluates them
+  enum { kIdle = -1, kPending = -2, kReleased = -3 };
+
+  Group groups_[INTERPOLATOR_TYPE_COUNT];
+
+  // Bookkeeping of a track, together as it is used together
+  struct TrackState {
+    int32_t state;  // Group index, or kIdle, kPending, kReleased
+    int32_t slot;   // In the group
+    int32_t queue_head;
+    int32_t queue_tail;
+    float idle_value;
+  };
+
+  std::vector<TrackState> tracks_;
+  std::vector<Track> free_tracks_;
+
+  // Queued segments, and the head of their free list
+  std::vector<Segment> segments_;
+  int32_t free_segment_;
+
+  // Idle tracks given segments, started by the next Update(). Tracks
+  // stopped meanwhile stay in the list, pending_count_ is exact.
+  std::vector<Track> pending_;
+  int32_t pending_count_;
+
+  double time_base_;
+  bool has_time_base_;
+
+  InterpolatorPool(const InterpolatorPool&);
+  InterpolatorPool& operator=(const InterpolatorPool&);
+
+  float ToLocalTime(const double time);
+  void Rebase(const double time);
+  void Insert(const Track track, const INTERPOLATOR_TYPE type,
+              const float start, const float duration, const float from,
+              const float dest, const float now);
+  void Remove(const Track track);
+  void FreeQueue(const Track track);
+  void Advance(const Track track, float end, float value, const float now);
+  void Complete(const int32_t type, const float now);
+
+ public:
+  InterpolatorPool();
+
+  void Reserve(const int32_t tracks, const int32_t segments);
+
+  // A new track, not animated, holding value
+  Track Create(const float value);
+  void Release(const Track track);
+
+  /*
+   * Animate a track from start to dest from current_time on, in place of
+   * its current segment. Queued segments are kept, as Interpolator::Set().
+   */
+  void Set(const Track track, const float start, const float dest,
+           const INTERPOLATOR_TYPE type, const double duration,
+           const double current_time);
+
+  // Queue a segment to dest after the others
+  void Add(const Track track, const float dest, const INTERPOLATOR_TYPE type,
+           const double duration);
+
+  // Stop a track where it is, and drop its queued segments
+  void Stop(const Track track);
+
+  /*
+   * Evaluate all the animated tracks at current_time, which must not go
+   * backwards.
+   * return: the number of tracks still animated
+   */
+  int32_t Update(const double current_time);
+
+  float GetValue(const Track track) const {
+    const TrackState& t = tracks_[track];
+    return t.state >= 0 ? groups_[t.state].value[t.slot] : t.idle_value;
+  }
+  // Whether the track has a segment to run
+  bool IsAnimated(const Track track) const {
+    return tracks_[track].state >= 0 || tracks_[track].state == kPending;
+  }
+  int32_t GetAnimatedCount() const;
+};
+
+}  // namespace ndk_helper
+#endif /* INTERPOLATORPOOL_H_ */
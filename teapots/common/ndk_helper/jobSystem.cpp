@@ -0,0 +1,109 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jobSystem.h"
+
+namespace ndk_helper {
+
+JobSystem::JobSystem(int32_t num_threads)
+    : func_(nullptr),
+      count_(0),
+      grain_(1),
+      generation_(0),
+      active_(false),
+      busy_workers_(0),
+      quit_(false),
+      next_(0) {
+  if (num_threads < 0) {
+    num_threads = static_cast<int32_t>(std::thread::hardware_concurrency()) - 1;
+    if (num_threads < 0) num_threads = 0;
+  }
+  for (int32_t i = 0; i < num_threads; ++i) {
+    threads_.push_back(std::thread(&JobSystem::WorkerMain, this));
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quit_ = true;
+  }
+  wake_.notify_all();
+  for (auto& thread : threads_) thread.join();
+}
+
+void JobSystem::RunRanges(const std::function<void(int32_t, int32_t)>& func,
+                          int32_t count, int32_t grain) {
+  for (;;) {
+    int32_t begin = next_.fetch_add(grain);
+    if (begin >= count) break;
+    func(begin, begin + grain < count ? begin + grain : count);
+  }
+}
+
+void JobSystem::WorkerMain() {
+  uint32_t seen = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    wake_.wait(lock,
+               [&] { return quit_ || (active_ && generation_ != seen); });
+    if (quit_) return;
+    seen = generation_;
+    ++busy_workers_;
+    const std::function<void(int32_t, int32_t)>& func = *func_;
+    const int32_t count = count_;
+    const int32_t grain = grain_;
+    lock.unlock();
+
+    RunRanges(func, count, grain);
+
+    lock.lock();
+    if (--busy_workers_ == 0) done_.notify_one();
+  }
+}
+
+void JobSystem::ParallelFor(int32_t count, int32_t grain,
+                            const std::function<void(int32_t, int32_t)>& func) {
+  if (count <= 0) return;
+  if (grain < 1) grain = 1;
+  if (threads_.empty() || count <= grain) {
+    for (int32_t begin = 0; begin < count; begin += grain)
+      func(begin, begin + grain < count ? begin + grain : count);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    func_ = &func;
+    count_ = count;
+    grain_ = grain;
+    next_.store(0);
+    ++generation_;
+    active_ = true;
+  }
+  wake_.notify_all();
+
+  RunRanges(func, count, grain);
+
+  // Workers that joined late may still be finding out that no range is
+  // left, wait for them before the loop state goes away.
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [&] { return busy_workers_ == 0; });
+  active_ = false;
+  func_ = nullptr;
+}
+
+}  // namespace ndk_helper
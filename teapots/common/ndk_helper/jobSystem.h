@@ -0,0 +1,79 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JOBSYSTEM_H_
+#define JOBSYSTEM_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ndk_helper {
+
+/******************************************************************
+ * Minimal job system for data-parallel loops
+ * Worker threads are created once and sleep between loops. The calling
+ * thread takes part in every ParallelFor(), so with no worker threads the
+ * loop simply runs inline.
+ * ParallelFor() must not be called from several threads at once, nor from
+ * inside a loop body.
+ */
+class JobSystem {
+ private:
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+
+  // Current loop, published under mutex_. Workers only join a loop while
+  // it is active, so none can touch it after ParallelFor() returns.
+  const std::function<void(int32_t, int32_t)>* func_;
+  int32_t count_;
+  int32_t grain_;
+  uint32_t generation_;
+  bool active_;
+  int32_t busy_workers_;
+  bool quit_;
+
+  std::atomic<int32_t> next_;
+
+  void WorkerMain();
+  void RunRanges(const std::function<void(int32_t, int32_t)>& func,
+                 int32_t count, int32_t grain);
+
+ public:
+  // num_threads is the number of worker threads, -1 for one per core but
+  // the calling one
+  explicit JobSystem(int32_t num_threads = -1);
+  virtual ~JobSystem();
+
+  // Calls func(begin, end) on ranges of at most 'grain' items covering
+  // [0, count), and returns once all of them are done.
+  void ParallelFor(int32_t count, int32_t grain,
+                   const std::function<void(int32_t, int32_t)>& func);
+
+  // Number of threads running a loop, the calling one included
+  int32_t GetThreadCount() const {
+    return static_cast<int32_t>(threads_.size()) + 1;
+  }
+};
+
+}  // namespace ndk_helper
+#endif /* JOBSYSTEM_H_ */
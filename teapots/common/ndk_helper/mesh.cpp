@@ -0,0 +1,158 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mesh.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "JNIHelper.h"
+
+namespace ndk_helper {
+
+Mesh::Mesh() : header_(NULL), data_(NULL), size_(0) {}
+
+Mesh::~Mesh() { Release(); }
+
+void Mesh::Release() {
+  file_.Release();
+  header_ = NULL;
+  data_ = NULL;
+  size_ = 0;
+}
+
+bool Mesh::Attach(const void* data, const size_t size) {
+  header_ = NULL;
+  data_ = NULL;
+  size_ = 0;
+
+  const MESH_HEADER* header = static_cast<const MESH_HEADER*>(data);
+  if (data == NULL || size < sizeof(MESH_HEADER) ||
+      (reinterpret_cast<uintptr_t>(data) & 3) != 0 ||
+      memcmp(header->magic, MESH_MAGIC, 4) != 0 ||
+      header->version != MESH_VERSION) {
+    return false;
+  }
+
+  // Everything the accessors and GL may read must be inside the data.
+  const uint64_t vertex_size =
+      static_cast<uint64_t>(header->vertex_count) * header->vertex_stride;
+  const uint64_t index_size =
+      static_cast<uint64_t>(header->index_count) * sizeof(uint16_t);
+  bool valid = header->vertex_count <= 65536 &&
+               header->vertex_stride >= 3 * sizeof(float) &&
+               header->vertex_stride % 4 == 0 &&
+               header->vertex_data_offset % 4 == 0 &&
+               header->index_data_offset % 4 == 0 &&
+               header->vertex_data_offset + vertex_size <= size &&
+               header->index_data_offset + index_size <= size;
+  if (header->attributes & MESH_ATTRIBUTE_NORMAL) {
+    valid = valid && header->normal_offset % 2 == 0 &&
+            header->normal_offset + 3 * sizeof(int16_t) <=
+                header->vertex_stride;
+  }
+  if (header->attributes & MESH_ATTRIBUTE_TEXCOORD) {
+    valid = valid && header->texcoord_offset % 4 == 0 &&
+            header->texcoord_offset + 2 * sizeof(float) <=
+                header->vertex_stride;
+  }
+  if (!valid) return false;
+
+  // A stale or truncated file must not make GL read out of bounds.
+  const uint16_t* indices = reinterpret_cast<const uint16_t*>(
+      static_cast<const uint8_t*>(data) + header->index_data_offset);
+  for (uint32_t i = 0; i < header->index_count; ++i) {
+    if (indices[i] >= header->vertex_count) return false;
+  }
+
+  header_ = header;
+  data_ = static_cast<const uint8_t*>(data);
+  size_ = size;
+  return true;
+}
+
+bool Mesh::LoadFile(const char* path) {
+  Release();
+  if (!AssetReader::MapFile(path, &file_) ||
+      !Attach(file_.GetData(), file_.GetSize())) {
+    file_.Release();
+    return false;
+  }
+  return true;
+}
+
+bool Mesh::Load(const char* file_name) {
+  Release();
+  if (!JNIHelper::GetInstance()->OpenFile(file_name, &file_)) return false;
+  if (!Attach(file_.GetData(), file_.GetSize())) {
+    LOGI("Mesh %s is invalid", file_name);
+    file_.Release();
+    return false;
+  }
+  return true;
+}
+
+Vec3 Mesh::GetPosition(const int32_t index) const {
+  const float* p = reinterpret_cast<const float*>(
+      data_ + header_->vertex_data_offset + index * header_->vertex_stride);
+  return Vec3(p[0], p[1], p[2]);
+}
+
+Vec3 Mesh::GetNormal(const int32_t index) const {
+  if (!HasNormals()) return Vec3();
+  const int16_t* n = reinterpret_cast<const int16_t*>(
+      data_ + header_->vertex_data_offset + index * header_->vertex_stride +
+      header_->normal_offset);
+  // Same decoding as GL ES 3 for normalized shorts
+  return Vec3(std::max(n[0] / 32767.f, -1.f), std::max(n[1] / 32767.f, -1.f),
+              std::max(n[2] / 32767.f, -1.f));
+}
+
+Vec2 Mesh::GetTexCoord(const int32_t index) const {
+  if (!HasTexCoords()) return Vec2();
+  const float* t = reinterpret_cast<const float*>(
+      data_ + header_->vertex_data_offset + index * header_->vertex_stride +
+      header_->texcoord_offset);
+  return Vec2(t[0], t[1]);
+}
+
+Vec3 Mesh::GetBoundsMin() const { return Vec3(header_->bounds_min); }
+
+Vec3 Mesh::GetBoundsMax() const { return Vec3(header_->bounds_max); }
+
+void Mesh::SetVertexAttribPointers(const GLint position, const GLint normal,
+                                   const GLint texcoord) const {
+  if (header_ == NULL) return;
+  const GLsizei stride = header_->vertex_stride;
+  const char* base = reinterpret_cast<const char*>(NULL);
+  if (position >= 0) {
+    glVertexAttribPointer(position, 3, GL_FLOAT, GL_FALSE, stride, base);
+    glEnableVertexAttribArray(position);
+  }
+  if (normal >= 0 && HasNormals()) {
+    glVertexAttribPointer(normal, 3, GL_SHORT, GL_TRUE, stride,
+                          base + header_->normal_offset);
+    glEnableVertexAttribArray(normal);
+  }
+  if (texcoord >= 0 && HasTexCoords()) {
+    glVertexAttribPointer(texcoord, 2, GL_FLOAT, GL_FALSE, stride,
+                          base + header_->texcoord_offset);
+    glEnableVertexAttribArray(texcoord);
+  }
+}
+
+}  // namespace ndk_helper
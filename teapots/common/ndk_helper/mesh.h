@@ -0,0 +1,111 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MESH_H_
+#define MESH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <GLES2/gl2.h>
+
+#include "assetReader.h"
+#include "meshFormat.h"
+#include "vecmath.h"
+
+namespace ndk_helper {
+
+/******************************************************************
+ * Read-only mesh in the binary format of meshFormat.h
+ * The file is mapped, not read: after a header check the vertex and index
+ * data are used where they are, ready for glBufferData(). Meshes are
+ * converted offline with teapots/host/mesh-convert.
+ */
+class Mesh {
+ private:
+  const MESH_HEADER* header_;
+  const uint8_t* data_;
+  size_t size_;
+
+  // What backs data_, if the mesh owns it
+  AssetData file_;
+
+  Mesh(const Mesh&);
+  Mesh& operator=(const Mesh&);
+
+ public:
+  Mesh();
+  virtual ~Mesh();
+
+  // Loads file_name through JNIHelper::OpenFile(): from the external files
+  // directory when it is there, so that models can be replaced without
+  // reinstalling, else from the APK. Store the meshes uncompressed in the
+  // APK (noCompress 'mesh') so that the asset manager maps them too.
+  bool Load(const char* file_name);
+
+  // Maps a file
+  bool LoadFile(const char* path);
+
+  // Uses a mesh already in memory, which must stay valid and 4 byte aligned
+  bool Attach(const void* data, const size_t size);
+
+  void Release();
+
+  bool IsLoaded() const { return header_ != NULL; }
+  bool HasNormals() const {
+    return (header_->attributes & MESH_ATTRIBUTE_NORMAL) != 0;
+  }
+  bool HasTexCoords() const {
+    return (header_->attributes & MESH_ATTRIBUTE_TEXCOORD) != 0;
+  }
+
+  int32_t GetVertexCount() const { return header_->vertex_count; }
+  int32_t GetIndexCount() const { return header_->index_count; }
+  int32_t GetVertexStride() const { return header_->vertex_stride; }
+
+  const void* GetVertexData() const {
+    return data_ + header_->vertex_data_offset;
+  }
+  size_t GetVertexDataSize() const {
+    return static_cast<size_t>(header_->vertex_count) * header_->vertex_stride;
+  }
+  const uint16_t* GetIndices() const {
+    return reinterpret_cast<const uint16_t*>(data_ +
+                                             header_->index_data_offset);
+  }
+  size_t GetIndexDataSize() const {
+    return header_->index_count * sizeof(uint16_t);
+  }
+
+  // Decoded attributes of one vertex
+  Vec3 GetPosition(const int32_t index) const;
+  Vec3 GetNormal(const int32_t index) const;
+  Vec2 GetTexCoord(const int32_t index) const;
+
+  Vec3 GetBoundsMin() const;
+  Vec3 GetBoundsMax() const;
+  float GetRadius() const { return header_->radius; }
+
+  // glVertexAttribPointer() and glEnableVertexAttribArray() for the mesh
+  // layout, with its vertex buffer bound. A location of -1 skips the
+  // attribute, as does an attribute the mesh doesn't have. Does nothing
+  // when no mesh is loaded.
+  void SetVertexAttribPointers(const GLint position, const GLint normal,
+                               const GLint texcoord = -1) const;
+};
+
+}  // namespace ndk_helper
+#endif /* MESH_H_ */
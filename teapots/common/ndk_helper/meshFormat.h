@@ -0,0 +1,64 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MESHFORMAT_H_
+#define MESHFORMAT_H_
+
+#include <stdint.h>
+
+/******************************************************************
+ * Binary mesh file layout, shared by ndk_helper::Mesh and the offline
+ * converter in teapots/host. It has no dependency so that host tools can
+ * include it.
+ *
+ * A file is a MESH_HEADER followed by the vertex data and the index data,
+ * at the offsets given in the header. Everything is little endian and
+ * laid out exactly as GL consumes it, so a loaded file is used in place:
+ * - vertices are interleaved, 'vertex_stride' bytes each, with the
+ *   position as 3 floats at offset 0, then the optional attributes at the
+ *   offsets of the header;
+ * - normals are 3 signed normalized shorts (GL_SHORT, normalized), padded
+ *   to 8 bytes;
+ * - texture coordinates are 2 floats;
+ * - indices are GL_UNSIGNED_SHORT triangle lists.
+ * Both data blocks start on a 16 byte boundary.
+ */
+#define MESH_MAGIC "NDKM"
+#define MESH_VERSION 1
+
+enum MESH_ATTRIBUTE {
+  MESH_ATTRIBUTE_NORMAL = 1,
+  MESH_ATTRIBUTE_TEXCOORD = 2,
+};
+
+struct MESH_HEADER {
+  char magic[4];  // MESH_MAGIC
+  uint32_t version;
+  uint32_t attributes;  // MESH_ATTRIBUTE bits
+  uint32_t vertex_count;
+  uint32_t index_count;
+  uint32_t vertex_stride;    // In bytes
+  uint32_t normal_offset;    // In a vertex, when MESH_ATTRIBUTE_NORMAL
+  uint32_t texcoord_offset;  // In a vertex, when MESH_ATTRIBUTE_TEXCOORD
+  uint32_t vertex_data_offset;  // From the start of the file
+  uint32_t index_data_offset;   // From the start of the file
+  float bounds_min[3];  // Axis aligned bounding box of the positions
+  float bounds_max[3];
+  float radius;  // Largest distance of a position to the origin
+  uint32_t reserved;
+};
+
+#endif /* MESHFORMAT_H_ */
@@ -0,0 +1,276 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "meshOptimizer.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <vector>
+
+namespace ndk_helper {
+
+namespace mesh_optimizer {
+
+namespace {
+
+// Forsyth's scoring: an LRU cache larger than the hardware FIFO, a flat
+// score for the last triangle's vertices (so that strips don't just turn
+// back on themselves) and a boost for vertices with few triangles left, so
+// that islands get finished instead of leaving lone triangles behind.
+const int32_t kCacheSize = 32;
+const float kCacheDecayPower = 1.5f;
+const float kLastTriangleScore = 0.75f;
+const float kValenceBoostScale = 2.f;
+const float kValenceBoostPower = 0.5f;
+const int32_t kMaxValence = 64;  // Larger valences use the last entry
+
+struct ScoreTables {
+  float cache[kCacheSize];
+  float valence[kMaxValence];
+
+  ScoreTables() {
+    for (int32_t i = 0; i < kCacheSize; ++i) {
+      if (i < 3) {
+        cache[i] = kLastTriangleScore;
+      } else {
+        const float scaler = 1.f / (kCacheSize - 3);
+        cache[i] = powf(1.f - (i - 3) * scaler, kCacheDecayPower);
+      }
+    }
+    valence[0] = 0.f;
+    for (int32_t i = 1; i < kMaxValence; ++i) {
+      valence[i] = kValenceBoostScale * powf(i, -kValenceBoostPower);
+    }
+  }
+
+  float Score(const int32_t cache_position, const uint32_t remaining) const {
+    // No triangle left: never pick it again
+    if (remaining == 0) return -1.f;
+    float score = cache_position >= 0 ? cache[cache_position] : 0.f;
+    return score + valence[remaining < kMaxValence ? remaining
+                                                   : kMaxValence - 1];
+  }
+};
+
+template <typename T>
+float ACMR(const T* indices, const int32_t index_count,
+           const int32_t vertex_count, const int32_t cache_size) {
+  if (index_count < 3) return 0.f;
+
+  // A vertex is cached while fewer than cache_size misses came after its own
+  std::vector<uint32_t> timestamps(vertex_count, 0);
+  uint32_t timestamp = cache_size + 1;
+  int32_t misses = 0;
+  for (int32_t i = 0; i < index_count; ++i) {
+    const T v = indices[i];
+    if (timestamp - timestamps[v] > static_cast<uint32_t>(cache_size)) {
+      timestamps[v] = timestamp++;
+      ++misses;
+    }
+  }
+  return static_cast<float>(misses) / (index_count / 3);
+}
+
+template <typename T>
+void VertexCache(T* indices, const int32_t index_count,
+                 const int32_t vertex_count) {
+  static const ScoreTables tables;
+  const int32_t triangle_count = index_count / 3;
+  if (triangle_count < 2) return;
+
+  // Triangles of each vertex, the live ones first in their range
+  std::vector<uint32_t> remaining(vertex_count, 0);
+  for (int32_t i = 0; i < triangle_count * 3; ++i) ++remaining[indices[i]];
+  std::vector<uint32_t> offsets(vertex_count + 1, 0);
+  for (int32_t v = 0; v < vertex_count; ++v)
+    offsets[v + 1] = offsets[v] + remaining[v];
+  std::vector<uint32_t> triangles(offsets[vertex_count]);
+  {
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (int32_t i = 0; i < triangle_count * 3; ++i)
+      triangles[fill[indices[i]]++] = i / 3;
+  }
+
+  std::vector<int32_t> cache_positions(vertex_count, -1);
+  std::vector<float> vertex_scores(vertex_count);
+  for (int32_t v = 0; v < vertex_count; ++v)
+    vertex_scores[v] = tables.Score(-1, remaining[v]);
+
+  // Triangle scores are the sums of their vertex scores, only needed for
+  // the candidates and so not stored.
+  std::vector<bool> emitted(triangle_count, false);
+  int32_t best = 0;
+  float best_score = -1.f;
+  for (int32_t t = 0; t < triangle_count; ++t) {
+    const float score = vertex_scores[indices[3 * t]] +
+                        vertex_scores[indices[3 * t + 1]] +
+                        vertex_scores[indices[3 * t + 2]];
+    if (score > best_score) {
+      best_score = score;
+      best = t;
+    }
+  }
+
+  std::vector<T> output(triangle_count * 3);
+  T cache[kCacheSize + 3];
+  int32_t cache_count = 0;
+  int32_t next_unemitted = 0;
+  for (int32_t n = 0; n < triangle_count; ++n) {
+    if (best < 0) {
+      // Nothing in the cache has triangles left: continue in input order
+      while (emitted[next_unemitted]) ++next_unemitted;
+      best = next_unemitted;
+    }
+    const T* triangle = indices + 3 * best;
+    memcpy(&output[3 * n], triangle, 3 * sizeof(T));
+    emitted[best] = true;
+
+    // The triangle's vertices go to the front of the cache
+    T new_cache[kCacheSize + 3];
+    int32_t new_count = 0;
+    for (int32_t k = 0; k < 3; ++k) {
+      const T v = triangle[k];
+      uint32_t* live = &triangles[offsets[v]];
+      for (uint32_t i = 0; i < remaining[v]; ++i) {
+        if (live[i] == static_cast<uint32_t>(best)) {
+          live[i] = live[--remaining[v]];
+          break;
+        }
+      }
+      bool duplicate = false;
+      for (int32_t i = 0; i < new_count; ++i)
+        duplicate = duplicate || new_cache[i] == v;
+      if (!duplicate) new_cache[new_count++] = v;
+    }
+    for (int32_t i = 0; i < cache_count; ++i) {
+      const T v = cache[i];
+      if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+        new_cache[new_count++] = v;
+    }
+
+    // Rescore the cached vertices, including those just pushed out, then
+    // their triangles, among which the next one is chosen.
+    for (int32_t i = 0; i < new_count; ++i) {
+      const T v = new_cache[i];
+      cache_positions[v] = i < kCacheSize ? i : -1;
+      vertex_scores[v] = tables.Score(cache_positions[v], remaining[v]);
+    }
+    best = -1;
+    best_score = -1.f;
+    for (int32_t i = 0; i < new_count; ++i) {
+      const T v = new_cache[i];
+      const uint32_t* live = &triangles[offsets[v]];
+      for (uint32_t j = 0; j < remaining[v]; ++j) {
+        const uint32_t t = live[j];
+        const float score = vertex_scores[indices[3 * t]] +
+                            vertex_scores[indices[3 * t + 1]] +
+                            vertex_scores[indices[3 * t + 2]];
+        if (score > best_score) {
+          best_score = score;
+          best = t;
+        }
+      }
+    }
+
+    cache_count = new_count < kCacheSize ? new_count : kCacheSize;
+    memcpy(cache, new_cache, cache_count * sizeof(T));
+  }
+
+  memcpy(indices, output.data(), triangle_count * 3 * sizeof(T));
+}
+
+template <typename T>
+int32_t VertexFetchRemap(T* indices, const int32_t index_count,
+                         const int32_t vertex_count, uint32_t* remap) {
+  for (int32_t v = 0; v < vertex_count; ++v) remap[v] = kUnusedVertex;
+  uint32_t next = 0;
+  for (int32_t i = 0; i < index_count; ++i) {
+    const T v = indices[i];
+    if (remap[v] == kUnusedVertex) remap[v] = next++;
+    indices[i] = static_cast<T>(remap[v]);
+  }
+  return next;
+}
+
+template <typename T>
+int32_t VertexFetch(void* vertices, T* indices, const int32_t index_count,
+                    const int32_t vertex_count, const int32_t vertex_stride) {
+  std::vector<uint32_t> remap(vertex_count);
+  const int32_t count =
+      VertexFetchRemap(indices, index_count, vertex_count, remap.data());
+
+  uint8_t* data = static_cast<uint8_t*>(vertices);
+  std::vector<uint8_t> source(data, data + vertex_count * vertex_stride);
+  for (int32_t v = 0; v < vertex_count; ++v) {
+    if (remap[v] != kUnusedVertex)
+      memcpy(data + remap[v] * vertex_stride, &source[v * vertex_stride],
+             vertex_stride);
+  }
+  return count;
+}
+
+}  // namespace
+
+float ComputeACMR(const uint16_t* indices, const int32_t index_count,
+                  const int32_t vertex_count, const int32_t cache_size) {
+  return ACMR(indices, index_count, vertex_count, cache_size);
+}
+
+float ComputeACMR(const uint32_t* indices, const int32_t index_count,
+                  const int32_t vertex_count, const int32_t cache_size) {
+  return ACMR(indices, index_count, vertex_count, cache_size);
+}
+
+void OptimizeVertexCache(uint16_t* indices, const int32_t index_count,
+                         const int32_t vertex_count) {
+  VertexCache(indices, index_count, vertex_count);
+}
+
+void OptimizeVertexCache(uint32_t* indices, const int32_t index_count,
+                         const int32_t vertex_count) {
+  VertexCache(indices, index_count, vertex_count);
+}
+
+int32_t OptimizeVertexFetchRemap(uint16_t* indices, const int32_t index_count,
+                                 const int32_t vertex_count, uint32_t* remap) {
+  return VertexFetchRemap(indices, index_count, vertex_count, remap);
+}
+
+int32_t OptimizeVertexFetchRemap(uint32_t* indices, const int32_t index_count,
+                                 const int32_t vertex_count, uint32_t* remap) {
+  return VertexFetchRemap(indices, index_count, vertex_count, remap);
+}
+
+int32_t OptimizeVertexFetch(void* vertices, uint16_t* indices,
+                            const int32_t index_count,
+                            const int32_t vertex_count,
+                            const int32_t vertex_stride) {
+  return VertexFetch(vertices, indices, index_count, vertex_count,
+                     vertex_stride);
+}
+
+int32_t OptimizeVertexFetch(void* vertices, uint32_t* indices,
+                            const int32_t index_count,
+                            const int32_t vertex_count,
+                            const int32_t vertex_stride) {
+  return VertexFetch(vertices, indices, index_count, vertex_count,
+                     vertex_stride);
+}
+
+}  // namespace mesh_optimizer
+
+}  // namespace ndk_helper
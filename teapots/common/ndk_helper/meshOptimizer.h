@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MESHOPTIMIZER_H_
+#define MESHOPTIMIZER_H_
+
+#include <stdint.h>
+
+namespace ndk_helper {
+
+namespace mesh_optimizer {
+
+/******************************************************************
+ * Index and vertex buffer reordering for the GPU vertex caches
+ * namespace: ndkHelper::mesh_optimizer
+ *
+ * Operates on indexed triangle lists only, with no GL or Android
+ * dependency so that the offline tools in teapots/host link it too.
+ * Triangles are reordered first, then vertices:
+ *   OptimizeVertexCache(indices, index_count, vertex_count);
+ *   OptimizeVertexFetch(vertices, indices, index_count, vertex_count, stride);
+ */
+
+// FIFO size used for ComputeACMR() by default, typical of mobile GPUs
+const int32_t kDefaultCacheSize = 16;
+
+// Marks a vertex no triangle uses in the remap table of
+// OptimizeVertexFetchRemap()
+const uint32_t kUnusedVertex = 0xffffffffu;
+
+/******************************************************************
+ * ComputeACMR()
+ * Average cache miss ratio: vertices transformed per triangle through a
+ * FIFO post-transform cache of cache_size entries. 0.5 is the ideal of a
+ * regular grid, 3 means no reuse at all.
+ */
+float ComputeACMR(const uint16_t* indices, const int32_t index_count,
+                  const int32_t vertex_count,
+                  const int32_t cache_size = kDefaultCacheSize);
+float ComputeACMR(const uint32_t* indices, const int32_t index_count,
+                  const int32_t vertex_count,
+                  const int32_t cache_size = kDefaultCacheSize);
+
+/******************************************************************
+ * OptimizeVertexCache()
+ * Reorders the triangles in place for the post-transform cache, with Tom
+ * Forsyth's "Linear-Speed Vertex Cache Optimisation". The order of the
+ * vertices within each triangle, and so its winding, is kept.
+ */
+void OptimizeVertexCache(uint16_t* indices, const int32_t index_count,
+                         const int32_t vertex_count);
+void OptimizeVertexCache(uint32_t* indices, const int32_t index_count,
+                         const int32_t vertex_count);
+
+/******************************************************************
+ * OptimizeVertexFetchRemap()
+ * Renumbers the vertices in the order the indices first use them, so that
+ * vertex fetches walk memory forward. Rewrites the indices and fills
+ * remap[vertex_count] with the new number of each old vertex, for meshes
+ * whose attributes are in several arrays.
+ * return: number of vertices used, unused ones are kUnusedVertex in remap
+ */
+int32_t OptimizeVertexFetchRemap(uint16_t* indices, const int32_t index_count,
+                                 const int32_t vertex_count, uint32_t* remap);
+int32_t OptimizeVertexFetchRemap(uint32_t* indices, const int32_t index_count,
+                                 const int32_t vertex_count, uint32_t* remap);
+
+/******************************************************************
+ * OptimizeVertexFetch()
+ * OptimizeVertexFetchRemap() for an interleaved vertex buffer, whose
+ * vertices are moved in place. Unused vertices are dropped from the end.
+ * return: number of vertices left
+ */
+int32_t OptimizeVertexFetch(void* vertices, uint16_t* indices,
+                            const int32_t index_count,
+                            const int32_t vertex_count,
+                            const int32_t vertex_stride);
+int32_t OptimizeVertexFetch(void* vertices, uint32_t* indices,
+                            const int32_t index_count,
+                            const int32_t vertex_count,
+                            const int32_t vertex_stride);
+
+}  // namespace mesh_optimizer
+
+}  // namespace ndk_helper
+#endif /* MESHOPTIMIZER_H_ */
@@ -0,0 +1,487 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mipmap.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+#include <string>
+
+#include "hash.h"
+#include "jobSystem.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MIPMAP_NEON
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define MIPMAP_SSE
+#endif
+
+namespace ndk_helper {
+
+namespace {
+
+//--------------------------------------------------------------------------------
+// One RGBA texel as 4 floats
+//--------------------------------------------------------------------------------
+#if defined(MIPMAP_NEON)
+typedef float32x4_t Float4;
+
+inline Float4 Load4(const float* p) { return vld1q_f32(p); }
+inline void Store4(float* p, Float4 v) { vst1q_f32(p, v); }
+inline Float4 Splat4(float f) { return vdupq_n_f32(f); }
+inline Float4 Add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 Mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+#elif defined(MIPMAP_SSE)
+typedef __m128 Float4;
+
+inline Float4 Load4(const float* p) { return _mm_loadu_ps(p); }
+inline void Store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+inline Float4 Splat4(float f) { return _mm_set1_ps(f); }
+inline Float4 Add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 Mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+#else
+struct Float4 {
+  float v[4];
+};
+
+inline Float4 Load4(const float* p) {
+  Float4 r = {{p[0], p[1], p[2], p[3]}};
+  return r;
+}
+inline void Store4(float* p, Float4 a) {
+  for (int32_t i = 0; i < 4; ++i) p[i] = a.v[i];
+}
+inline Float4 Splat4(float f) {
+  Float4 r = {{f, f, f, f}};
+  return r;
+}
+inline Float4 Add4(Float4 a, Float4 b) {
+  for (int32_t i = 0; i < 4; ++i) a.v[i] += b.v[i];
+  return a;
+}
+inline Float4 Mul4(Float4 a, Float4 b) {
+  for (int32_t i = 0; i < 4; ++i) a.v[i] *= b.v[i];
+  return a;
+}
+#endif
+
+//--------------------------------------------------------------------------------
+// sRGB conversions
+//--------------------------------------------------------------------------------
+double SrgbToLinear(const double c) {
+  return c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+}
+
+const int32_t kEncodeBuckets = 4096;
+
+struct SrgbTables {
+  // Linear value of each code
+  float to_linear[256];
+  // threshold[k] is where the nearest code goes from k - 1 to k, in linear
+  float threshold[257];
+  // Nearest code at the start of each of kEncodeBuckets linear intervals
+  uint8_t bucket[kEncodeBuckets + 1];
+
+  SrgbTables() {
+    for (int32_t k = 0; k < 256; ++k) {
+      to_linear[k] = static_cast<float>(SrgbToLinear(k / 255.0));
+      threshold[k] = static_cast<float>(SrgbToLinear((k - 0.5) / 255.0));
+    }
+    threshold[256] = 2.f;
+    int32_t code = 0;
+    for (int32_t i = 0; i <= kEncodeBuckets; ++i) {
+      const float v = static_cast<float>(i) / kEncodeBuckets;
+      while (v >= threshold[code + 1]) ++code;
+      bucket[i] = static_cast<uint8_t>(code);
+    }
+  }
+};
+
+const SrgbTables& GetSrgbTables() {
+  static const SrgbTables tables;
+  return tables;
+}
+
+/*
+ * Nearest sRGB code of a linear value. The sRGB curve is steepest at 0, by
+ * 12.92 * 255 codes per unit, so at most one threshold lies within a bucket
+ * and one comparison finishes the lookup.
+ */
+inline uint8_t LinearToSrgb8(const SrgbTables& tables, float v) {
+  v = std::min(std::max(v, 0.f), 1.f);
+  int32_t code = tables.bucket[static_cast<int32_t>(v * kEncodeBuckets)];
+  code += v >= tables.threshold[code + 1];
+  return static_cast<uint8_t>(code);
+}
+
+inline uint8_t ToUnorm8(const float v) {
+  return static_cast<uint8_t>(std::min(std::max(v, 0.f), 1.f) * 255.f + 0.5f);
+}
+
+//--------------------------------------------------------------------------------
+// Resampling of one dimension, from src texels to dst
+// Every dst texel has the same number of taps, padded with zero weights.
+//--------------------------------------------------------------------------------
+const double kKaiserRadius = 2.0;  // In dst texels
+const double kKaiserAlpha = 4.0;
+
+double BesselI0(const double x) {
+  double sum = 1.0, term = 1.0;
+  for (int32_t k = 1; k < 32; ++k) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+double Kaiser(const double x) {
+  if (fabs(x) >= kKaiserRadius) return 0.0;
+  const double sinc = x == 0.0 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+  const double r = x / kKaiserRadius;
+  return sinc * BesselI0(kKaiserAlpha * sqrt(1.0 - r * r)) /
+         BesselI0(kKaiserAlpha);
+}
+
+struct Filter {
+  int32_t taps;
+  std::vector<int32_t> index;  // Texel index of each tap, taps per dst texel
+  std::vector<float> weight;
+};
+
+void BuildFilter(const int32_t src, const int32_t dst,
+                 const MipmapOptions& options, Filter* filter) {
+  const double scale = static_cast<double>(src) / dst;
+  const double radius =
+      options.filter == MIPMAP_FILTER_BOX ? 0.5 * scale : kKaiserRadius * scale;
+  const int32_t max_taps = static_cast<int32_t>(ceil(2.0 * radius)) + 1;
+  std::vector<int32_t> index(dst * max_taps);
+  std::vector<float> weight(dst * max_taps, 0.f);
+  std::vector<int32_t> count(dst, 0);
+
+  std::vector<double> weights;
+  for (int32_t i = 0; i < dst; ++i) {
+    const double center = (i + 0.5) * scale;
+    const int32_t first = static_cast<int32_t>(floor(center - radius));
+    const int32_t last = static_cast<int32_t>(ceil(center + radius));
+    weights.clear();
+    double sum = 0.0;
+    for (int32_t j = first; j < last; ++j) {
+      double w;
+      if (options.filter == MIPMAP_FILTER_BOX) {
+        // Overlap of the texel with the footprint
+        w = std::min(j + 1.0, center + radius) -
+            std::max(j * 1.0, center - radius);
+        w = std::max(w, 0.0);
+      } else {
+        w = Kaiser((j + 0.5 - center) / scale);
+      }
+      weights.push_back(w);
+      sum += w;
+    }
+
+    for (int32_t j = first; j < last; ++j) {
+      const double w = weights[j - first];
+      if (w == 0.0) continue;
+      int32_t texel;
+      if (options.wrap) {
+        texel = ((j % src) + src) % src;
+      } else {
+        texel = std::min(std::max(j, 0), src - 1);
+      }
+      index[i * max_taps + count[i]] = texel;
+      weight[i * max_taps + count[i]] = static_cast<float>(w / sum);
+      ++count[i];
+    }
+  }
+
+  // As many taps as the widest texel needs, padding reads a valid texel
+  filter->taps = *std::max_element(count.begin(), count.end());
+  filter->index.resize(dst * filter->taps);
+  filter->weight.resize(dst * filter->taps);
+  for (int32_t i = 0; i < dst; ++i) {
+    for (int32_t t = 0; t < filter->taps; ++t) {
+      const bool used = t < count[i];
+      filter->index[i * filter->taps + t] = index[i * max_taps + (used ? t : 0)];
+      filter->weight[i * filter->taps + t] =
+          used ? weight[i * max_taps + t] : 0.f;
+    }
+  }
+}
+
+// One row of src_width texels into dst_width texels
+void FilterRow(const float* src_row, float* dst_row, const int32_t dst_width,
+               const Filter& filter) {
+  const int32_t taps = filter.taps;
+  const int32_t* index = filter.index.data();
+  const float* weight = filter.weight.data();
+  for (int32_t x = 0; x < dst_width; ++x, index += taps, weight += taps) {
+    Float4 sum = Mul4(Splat4(weight[0]), Load4(src_row + index[0] * 4));
+    for (int32_t t = 1; t < taps; ++t)
+      sum = Add4(sum, Mul4(Splat4(weight[t]), Load4(src_row + index[t] * 4)));
+    Store4(dst_row + x * 4, sum);
+  }
+}
+
+// One row of RGBA8 into linear light, color weighted by alpha
+void DecodeRow(const uint8_t* src, const float* to_linear, const int32_t width,
+               float* dst) {
+  for (int32_t x = 0; x < width; ++x, src += 4, dst += 4) {
+    const float alpha = src[3] * (1.f / 255.f);
+    dst[0] = to_linear[src[0]] * alpha;
+    dst[1] = to_linear[src[1]] * alpha;
+    dst[2] = to_linear[src[2]] * alpha;
+    dst[3] = alpha;
+  }
+}
+
+// Rows [begin, end) of dst from the rows of src, 'width' texels each
+void FilterColumns(const float* src, float* dst, const int32_t width,
+                   const Filter& filter, const int32_t begin,
+                   const int32_t end) {
+  const int32_t taps = filter.taps;
+  const size_t row_floats = static_cast<size_t>(width) * 4;
+  for (int32_t y = begin; y < end; ++y) {
+    const int32_t* index = &filter.index[y * taps];
+    const float* weight = &filter.weight[y * taps];
+    float* dst_row = dst + y * row_floats;
+    const Float4 w0 = Splat4(weight[0]);
+    const float* row = src + index[0] * row_floats;
+    for (size_t i = 0; i < row_floats; i += 4)
+      Store4(dst_row + i, Mul4(w0, Load4(row + i)));
+    for (int32_t t = 1; t < taps; ++t) {
+      if (weight[t] == 0.f) continue;
+      const Float4 w = Splat4(weight[t]);
+      row = src + index[t] * row_floats;
+      for (size_t i = 0; i < row_floats; i += 4)
+        Store4(dst_row + i, Add4(Load4(dst_row + i), Mul4(w, Load4(row + i))));
+    }
+  }
+}
+
+// Below this many texels a level is not worth splitting over threads
+const int32_t kParallelTexels = 128 * 128;
+const int32_t kRowGrain = 16;
+
+void ForRows(JobSystem* jobs, const int32_t rows, const int32_t width,
+             const std::function<void(int32_t, int32_t)>& func) {
+  if (jobs != NULL && rows * width >= kParallelTexels) {
+    jobs->ParallelFor(rows, kRowGrain, func);
+  } else {
+    func(0, rows);
+  }
+}
+
+//--------------------------------------------------------------------------------
+// Cache file
+//--------------------------------------------------------------------------------
+struct MIP_FILE_HEADER {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  int32_t width;
+  int32_t height;
+  int32_t level_count;
+  uint32_t reserved;
+};
+
+const uint32_t kMipFileMagic = 0x4350494d;  // "MIPC"
+const uint32_t kMipFileVersion = 1;
+
+}  // namespace
+
+//--------------------------------------------------------------------------------
+// MipChain
+//--------------------------------------------------------------------------------
+MipChain::MipChain() : base_(NULL) {}
+
+MipChain::~MipChain() {}
+
+void MipChain::Release() {
+  levels_.clear();
+  data_.clear();
+  file_.Release();
+  base_ = NULL;
+}
+
+void MipChain::SetLevels(int32_t width, int32_t height) {
+  levels_.clear();
+  size_t offset = 0;
+  for (;;) {
+    Level level = {width, height, offset};
+    levels_.push_back(level);
+    offset += static_cast<size_t>(width) * height * 4;
+    if (width == 1 && height == 1) break;
+    width = std::max(width / 2, 1);
+    height = std::max(height / 2, 1);
+  }
+}
+
+bool MipChain::Generate(const uint8_t* rgba, const int32_t width,
+                        const int32_t height, const MipmapOptions& options,
+                        JobSystem* jobs) {
+  Release();
+  if (width <= 0 || height <= 0 || width > 16384 || height > 16384)
+    return false;
+
+  SetLevels(width, height);
+  const Level& last = levels_.back();
+  data_.assign(rgba, rgba + static_cast<size_t>(width) * height * 4);
+  data_.resize(last.offset + 4);
+  base_ = data_.data();
+
+  const SrgbTables& tables = GetSrgbTables();
+  float color_to_linear[256];
+  for (int32_t k = 0; k < 256; ++k) {
+    color_to_linear[k] = options.srgb ? tables.to_linear[k] : k / 255.f;
+  }
+
+  // Levels in linear light as floats, color weighted by alpha. Level 0 is
+  // converted a row at a time as the first pass reads it.
+  std::vector<float> level, rows, next;
+  Filter filter;
+  for (size_t l = 1; l < levels_.size(); ++l) {
+    const Level& src = levels_[l - 1];
+    const Level& dst = levels_[l];
+
+    // Horizontal pass, then vertical. Level 0 has to be decoded even when
+    // only its height halves.
+    const bool resize_rows = dst.width != src.width;
+    if (resize_rows) BuildFilter(src.width, dst.width, options, &filter);
+    if (resize_rows || l == 1) {
+      rows.resize(static_cast<size_t>(dst.width) * src.height * 4);
+      ForRows(jobs, src.height, src.width, [&](int32_t begin, int32_t end) {
+        std::vector<float> decoded(
+            l == 1 && resize_rows ? static_cast<size_t>(width) * 4 : 0);
+        for (int32_t y = begin; y < end; ++y) {
+          float* row = &rows[static_cast<size_t>(y) * dst.width * 4];
+          const float* src_row;
+          if (l == 1) {
+            float* out = resize_rows ? decoded.data() : row;
+            DecodeRow(rgba + static_cast<size_t>(y) * width * 4,
+                      color_to_linear, width, out);
+            src_row = out;
+          } else {
+            src_row = &level[static_cast<size_t>(y) * src.width * 4];
+          }
+          if (resize_rows) FilterRow(src_row, row, dst.width, filter);
+        }
+      });
+    } else {
+      rows.swap(level);
+    }
+    if (dst.height != src.height) {
+      BuildFilter(src.height, dst.height, options, &filter);
+      next.resize(static_cast<size_t>(dst.width) * dst.height * 4);
+      ForRows(jobs, dst.height, dst.width, [&](int32_t begin, int32_t end) {
+        FilterColumns(rows.data(), next.data(), dst.width, filter, begin, end);
+      });
+    } else {
+      next.swap(rows);
+    }
+    level.swap(next);
+
+    // Back to 8 bits
+    uint8_t* out = data_.data() + dst.offset;
+    const bool srgb = options.srgb;
+    ForRows(jobs, dst.height, dst.width, [&](int32_t begin, int32_t end) {
+      for (size_t i = static_cast<size_t>(begin) * dst.width;
+           i < static_cast<size_t>(end) * dst.width; ++i) {
+        const float* texel = &level[i * 4];
+        const float alpha = texel[3];
+        const float inv_alpha = alpha > 0.f ? 1.f / alpha : 0.f;
+        for (int32_t c = 0; c < 3; ++c) {
+          const float v = texel[c] * inv_alpha;
+          out[i * 4 + c] = srgb ? LinearToSrgb8(tables, v) : ToUnorm8(v);
+        }
+        out[i * 4 + 3] = ToUnorm8(alpha);
+      }
+    });
+  }
+  return true;
+}
+
+bool MipChain::Store(const char* path, const uint64_t key) const {
+  if (levels_.empty()) return false;
+  MIP_FILE_HEADER header;
+  memset(&header, 0, sizeof(header));
+  header.magic = kMipFileMagic;
+  header.version = kMipFileVersion;
+  header.key = key;
+  header.width = levels_[0].width;
+  header.height = levels_[0].height;
+  header.level_count = GetLevelCount();
+  const Level& last = levels_.back();
+  const size_t size = last.offset + static_cast<size_t>(last.width) *
+                                        last.height * 4;
+
+  // Written aside first, a partial file must not be loaded next time
+  const std::string tmp_path = std::string(path) + ".tmp";
+  FILE* f = fopen(tmp_path.c_str(), "wb");
+  if (f == NULL) return false;
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+            fwrite(base_, 1, size, f) == size;
+  ok = fclose(f) == 0 && ok;
+  if (!ok || rename(tmp_path.c_str(), path) != 0) {
+    remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool MipChain::Load(const char* path, const uint64_t key) {
+  Release();
+  if (!AssetReader::MapFile(path, &file_)) return false;
+
+  MIP_FILE_HEADER header;
+  if (file_.GetSize() < sizeof(header)) {
+    Release();
+    return false;
+  }
+  memcpy(&header, file_.GetData(), sizeof(header));
+  if (header.magic != kMipFileMagic || header.version != kMipFileVersion ||
+      header.key != key || header.width <= 0 || header.height <= 0 ||
+      header.width > 16384 || header.height > 16384) {
+    Release();
+    return false;
+  }
+  SetLevels(header.width, header.height);
+  const Level& last = levels_.back();
+  const size_t size = last.offset + static_cast<size_t>(last.width) *
+                                        last.height * 4;
+  if (header.level_count != GetLevelCount() ||
+      file_.GetSize() != sizeof(header) + size) {
+    Release();
+    return false;
+  }
+  base_ = file_.GetData() + sizeof(header);
+  return true;
+}
+
+uint64_t MipChain::GetKey(const void* file_data, const size_t size,
+                          const MipmapOptions& options) {
+  const uint32_t settings[4] = {kMipFileVersion,
+                                static_cast<uint32_t>(options.filter),
+                                options.srgb, options.wrap};
+  return Hash(settings, sizeof(settings), Hash(file_data, size));
+}
+
+}  // namespace ndk_helper
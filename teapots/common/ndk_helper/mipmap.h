@@ -0,0 +1,120 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MIPMAP_H_
+#define MIPMAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "assetReader.h"
+
+namespace ndk_helper {
+
+class JobSystem;
+
+enum MIPMAP_FILTER {
+  // Average of the texels each level texel covers
+  MIPMAP_FILTER_BOX,
+  // Kaiser windowed sinc over two level texels each way, sharper
+  MIPMAP_FILTER_KAISER,
+};
+
+struct MipmapOptions {
+  MIPMAP_FILTER filter;
+  // Color channels are sRGB encoded, and filtered in linear light. Alpha is
+  // always linear.
+  bool srgb;
+  // Filters wrap around the edges, as with GL_REPEAT. Clamped otherwise.
+  bool wrap;
+
+  MipmapOptions() : filter(MIPMAP_FILTER_BOX), srgb(true), wrap(false) {}
+};
+
+/******************************************************************
+ * Mipmap chain of an RGBA8 image
+ * Generate() computes every level down to 1x1 on the CPU, ready for one
+ * glTexImage2D() per level. Each level is filtered from the previous one
+ * kept in linear light as floats, with color weighted by alpha, and only
+ * rounded to 8 bits for output. Filtering is separable, 4 floats (a texel)
+ * at a time with SSE or NEON when available, and split over the threads of
+ * a JobSystem for large images.
+ * Chains can be stored to a file and mapped back with Load(), to skip both
+ * decoding and filtering on later runs.
+ */
+class MipChain {
+ private:
+  struct Level {
+    int32_t width;
+    int32_t height;
+    size_t offset;
+  };
+
+  std::vector<Level> levels_;
+  std::vector<uint8_t> data_;
+
+  // What backs data when loaded from a file
+  AssetData file_;
+  const uint8_t* base_;
+
+  MipChain(const MipChain&);
+  MipChain& operator=(const MipChain&);
+
+  void SetLevels(int32_t width, int32_t height);
+
+ public:
+  MipChain();
+  ~MipChain();
+
+  /*
+   * Generate all the levels of an image
+   *
+   * arguments:
+   *  in: rgba, width * height texels of 4 bytes, rows packed
+   *  in: jobs, threads to split the work over, may be NULL
+   * return: false when the size is not valid
+   */
+  bool Generate(const uint8_t* rgba, const int32_t width, const int32_t height,
+                const MipmapOptions& options, JobSystem* jobs = NULL);
+
+  // Write the chain to path, through a temporary file renamed over it
+  bool Store(const char* path, const uint64_t key) const;
+  // Map a chain written by Store() with the same key
+  bool Load(const char* path, const uint64_t key);
+
+  /*
+   * Key identifying the chain of an image file, for Store() and Load() and
+   * to name cache files: a hash of the file contents and the options.
+   */
+  static uint64_t GetKey(const void* file_data, const size_t size,
+                         const MipmapOptions& options);
+
+  void Release();
+
+  int32_t GetLevelCount() const { return static_cast<int32_t>(levels_.size()); }
+  int32_t GetWidth(const int32_t level) const { return levels_[level].width; }
+  int32_t GetHeight(const int32_t level) const {
+    return levels_[level].height;
+  }
+  const uint8_t* GetLevel(const int32_t level) const {
+    return base_ + levels_[level].offset;
+  }
+};
+
+}  // namespace ndk_helper
+#endif /* MIPMAP_H_ */
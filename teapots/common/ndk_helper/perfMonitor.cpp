@@ -20,7 +20,7 @@ namespace ndk_helper {
 
 PerfMonitor::PerfMonitor()
     : current_FPS_(0),
-      tv_last_sec_(0),
+      last_fps_time_(0),
       last_tick_(0.f),
       tickindex_(0),
       ticksum_(0) {
@@ -39,17 +39,16 @@ double PerfMonitor::UpdateTick(double currentTick) {
 }
 
 bool PerfMonitor::Update(float &fFPS) {
-  struct timeval Time;
-  gettimeofday(&Time, NULL);
+  Profiler::GetInstance()->EndFrame();
 
-  double time = Time.tv_sec + Time.tv_usec * 1.0 / 1000000.0;
+  double time = GetCurrentTime();
   double tick = time - last_tick_;
   double d = UpdateTick(tick);
   last_tick_ = time;
 
-  if (Time.tv_sec - tv_last_sec_ >= 1) {
+  if (time - last_fps_time_ >= 1.0) {
     current_FPS_ = 1.f / d;
-    tv_last_sec_ = Time.tv_sec;
+    last_fps_time_ = time;
     fFPS = current_FPS_;
     return true;
   } else {
@@ -21,6 +21,7 @@
 #include <errno.h>
 #include <time.h>
 #include "JNIHelper.h"
+#include "profiler.h"
 
 namespace ndk_helper {
 
@@ -28,11 +29,13 @@ const int32_t kNumSamples = 100;
 
 /******************************************************************
  * Helper class for a performance monitoring and get current tick time
+ * Times come from the monotonic clock, in seconds. Update() is called once
+ * per frame and also closes the frame of the Profiler.
  */
 class PerfMonitor {
  private:
   float current_FPS_;
-  time_t tv_last_sec_;
+  double last_fps_time_;
 
   double last_tick_;
   int32_t tickindex_;
@@ -47,12 +50,7 @@ class PerfMonitor {
 
   bool Update(float &fFPS);
 
-  static double GetCurrentTime() {
-    struct timeval time;
-    gettimeofday(&time, NULL);
-    double ret = time.tv_sec + time.tv_usec * 1.0 / 1000000.0;
-    return ret;
-  }
+  static double GetCurrentTime() { return Profiler::GetTimeNs() / 1e9; }
 };
 
 }  // namespace ndkHelper
@@ -0,0 +1,298 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "profiler.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace ndk_helper {
+
+// Gives the buffer of a thread back when the thread exits
+struct ThreadBufferOwner {
+  Profiler::ThreadBuffer* buffer;
+
+  ThreadBufferOwner() : buffer(NULL) {}
+  ~ThreadBufferOwner() {
+    if (buffer == NULL) return;
+    Profiler* profiler = Profiler::GetInstance();
+    {
+      std::lock_guard<std::mutex> lock(profiler->names_mutex_);
+      profiler->thread_names_[buffer->id].clear();
+    }
+    buffer->depth = 0;
+    buffer->in_use.store(false, std::memory_order_release);
+  }
+};
+
+namespace {
+
+thread_local ThreadBufferOwner thread_buffer;
+
+bool SameName(const char* a, const char* b) {
+  if (a == b) return true;
+  if (a == NULL || b == NULL) return false;
+  return strcmp(a, b) == 0;
+}
+
+double ToMs(uint64_t ns) { return ns / 1000000.0; }
+
+void AppendJsonString(const char* str, std::string* json) {
+  json->push_back('"');
+  for (const char* p = str; *p != '\0'; ++p) {
+    if (*p == '"' || *p == '\\') json->push_back('\\');
+    if (static_cast<unsigned char>(*p) >= ' ') json->push_back(*p);
+  }
+  json->push_back('"');
+}
+
+}  // namespace
+
+//--------------------------------------------------------------------------------
+// Profiler
+//--------------------------------------------------------------------------------
+Profiler::Profiler()
+    : enabled_(false),
+      buffers_(NULL),
+      buffer_count_(0),
+      dropped_(0),
+      frame_start_ns_(GetTimeNs()),
+      frame_ns_(0),
+      frame_thread_(-1),
+      capture_limit_(0),
+      capture_start_ns_(0) {}
+
+Profiler* Profiler::GetInstance() {
+  static Profiler profiler;
+  return &profiler;
+}
+
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer() {
+  if (thread_buffer.buffer != NULL) return thread_buffer.buffer;
+
+  // Take the buffer of a thread that has exited, if any
+  ThreadBuffer* buffer = buffers_.load(std::memory_order_acquire);
+  for (; buffer != NULL; buffer = buffer->next) {
+    bool in_use = false;
+    if (!buffer->in_use.load(std::memory_order_relaxed) &&
+        buffer->in_use.compare_exchange_strong(in_use, true,
+                                               std::memory_order_acquire)) {
+      break;
+    }
+  }
+
+  if (buffer == NULL) {
+    buffer = new ThreadBuffer;
+    buffer->write.store(0, std::memory_order_relaxed);
+    buffer->read.store(0, std::memory_order_relaxed);
+    buffer->in_use.store(true, std::memory_order_relaxed);
+    buffer->depth = 0;
+    buffer->id = buffer_count_.fetch_add(1, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(names_mutex_);
+      if (thread_names_.size() <= static_cast<size_t>(buffer->id))
+        thread_names_.resize(buffer->id + 1);
+    }
+    buffer->next = buffers_.load(std::memory_order_relaxed);
+    while (!buffers_.compare_exchange_weak(buffer->next, buffer,
+                                           std::memory_order_release)) {
+    }
+  }
+  thread_buffer.buffer = buffer;
+  return buffer;
+}
+
+void Profiler::SetThreadName(const char* name) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> lock(names_mutex_);
+  thread_names_[buffer->id] = name;
+}
+
+std::string Profiler::GetThreadName(int32_t thread) const {
+  std::lock_guard<std::mutex> lock(names_mutex_);
+  if (static_cast<size_t>(thread) < thread_names_.size() &&
+      !thread_names_[thread].empty()) {
+    return thread_names_[thread];
+  }
+  char name[32];
+  snprintf(name, sizeof(name), "thread %d", thread);
+  return name;
+}
+
+void Profiler::AddEvent(const Event& event, int32_t thread) {
+  const uint64_t total = event.end_ns - event.start_ns;
+  const uint64_t self = total > event.child_ns ? total - event.child_ns : 0;
+
+  // A frame has a few dozen distinct zones at most
+  auto it = stats_.begin();
+  for (; it != stats_.end(); ++it) {
+    if (it->thread == thread && it->depth == event.depth &&
+        SameName(it->name, event.name) && SameName(it->parent, event.parent))
+      break;
+  }
+  if (it == stats_.end()) {
+    ZoneStats stats = {event.name, event.parent, event.depth, thread, 0,
+                       0,          0,            event.start_ns};
+    it = stats_.insert(stats_.end(), stats);
+  }
+  ++it->count;
+  it->total_ns += total;
+  it->self_ns += self;
+  it->first_start_ns = std::min(it->first_start_ns, event.start_ns);
+
+  if (capture_.size() < capture_limit_) {
+    CapturedEvent captured = {event.name, event.start_ns, event.end_ns, thread};
+    capture_.push_back(captured);
+  }
+}
+
+void Profiler::EndFrame() {
+  const uint64_t now = GetTimeNs();
+  frame_ns_ = now - frame_start_ns_;
+  stats_.clear();
+
+  for (ThreadBuffer* buffer = buffers_.load(std::memory_order_acquire);
+       buffer != NULL; buffer = buffer->next) {
+    const uint32_t write = buffer->write.load(std::memory_order_acquire);
+    uint32_t read = buffer->read.load(std::memory_order_relaxed);
+    for (; read != write; ++read)
+      AddEvent(buffer->events[read % kBufferSize], buffer->id);
+    buffer->read.store(read, std::memory_order_release);
+  }
+
+  if (frame_thread_ < 0) frame_thread_ = GetThreadBuffer()->id;
+  if (capture_.size() < capture_limit_) {
+    CapturedEvent frame = {"Frame", frame_start_ns_, now, frame_thread_};
+    capture_.push_back(frame);
+  }
+  frame_start_ns_ = now;
+}
+
+void Profiler::FormatFrame(std::string* text) const {
+  std::vector<ZoneStats> zones(stats_);
+  std::sort(zones.begin(), zones.end(),
+            [](const ZoneStats& a, const ZoneStats& b) {
+              if (a.thread != b.thread) return a.thread < b.thread;
+              return a.first_start_ns < b.first_start_ns;
+            });
+
+  char line[256];
+  snprintf(line, sizeof(line), "frame %.3f ms\n", ToMs(frame_ns_));
+  text->assign(line);
+  int32_t thread = -1;
+  for (const auto& zone : zones) {
+    if (zone.thread != thread) {
+      thread = zone.thread;
+      text->append(GetThreadName(thread));
+      text->append(":\n");
+    }
+    snprintf(line, sizeof(line), "%*s%s %.3f ms (self %.3f ms) x%d\n",
+             2 + 2 * zone.depth, "", zone.name, ToMs(zone.total_ns),
+             ToMs(zone.self_ns), zone.count);
+    text->append(line);
+  }
+}
+
+void Profiler::StartCapture(size_t max_events) {
+  capture_.clear();
+  capture_.reserve(max_events);
+  capture_limit_ = max_events;
+  capture_start_ns_ = frame_start_ns_;
+}
+
+void Profiler::StopCapture() { capture_limit_ = capture_.size(); }
+
+void Profiler::GetChromeTrace(std::string* json) const {
+  json->assign("{\"traceEvents\":[\n");
+  char line[128];
+  const int32_t thread_count = buffer_count_.load(std::memory_order_relaxed);
+  for (int32_t thread = 0; thread < thread_count; ++thread) {
+    snprintf(line, sizeof(line),
+             "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+             "\"args\":{\"name\":",
+             thread);
+    json->append(line);
+    AppendJsonString(GetThreadName(thread).c_str(), json);
+    json->append("}},\n");
+  }
+  for (size_t i = 0; i < capture_.size(); ++i) {
+    const CapturedEvent& event = capture_[i];
+    json->append("{\"name\":");
+    AppendJsonString(event.name, json);
+    // Timestamps are in microseconds
+    snprintf(line, sizeof(line),
+             ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+             event.thread, (event.start_ns - capture_start_ns_) / 1000.0,
+             (event.end_ns - event.start_ns) / 1000.0,
+             i + 1 < capture_.size() ? "," : "");
+    json->append(line);
+  }
+  json->append("]}\n");
+}
+
+bool Profiler::WriteChromeTrace(const char* path) const {
+  std::string json;
+  GetChromeTrace(&json);
+  FILE* file = fopen(path, "w");
+  if (file == NULL) return false;
+  const bool written = fwrite(json.data(), 1, json.size(), file) == json.size();
+  return fclose(file) == 0 && written;
+}
+
+//--------------------------------------------------------------------------------
+// ProfileZone
+//--------------------------------------------------------------------------------
+void ProfileZone::Begin(const char* name) {
+  buffer_ = Profiler::GetInstance()->GetThreadBuffer();
+  const int32_t depth = buffer_->depth++;
+  if (depth < Profiler::kMaxDepth) {
+    Profiler::ThreadBuffer::OpenZone& zone = buffer_->stack[depth];
+    zone.name = name;
+    zone.child_ns = 0;
+    zone.start_ns = Profiler::GetTimeNs();
+  }
+}
+
+void ProfileZone::End() {
+  const uint64_t end_ns = Profiler::GetTimeNs();
+  const int32_t depth = --buffer_->depth;
+  if (depth >= Profiler::kMaxDepth) {
+    Profiler::GetInstance()->dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  const Profiler::ThreadBuffer::OpenZone& zone = buffer_->stack[depth];
+  const uint64_t duration = end_ns - zone.start_ns;
+  if (depth > 0) buffer_->stack[depth - 1].child_ns += duration;
+
+  const uint32_t write = buffer_->write.load(std::memory_order_relaxed);
+  if (write - buffer_->read.load(std::memory_order_acquire) >=
+      Profiler::kBufferSize) {
+    Profiler::GetInstance()->dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Profiler::Event& event = buffer_->events[write % Profiler::kBufferSize];
+  event.name = zone.name;
+  event.parent = depth > 0 ? buffer_->stack[depth - 1].name : NULL;
+  event.start_ns = zone.start_ns;
+  event.end_ns = end_ns;
+  event.child_ns = zone.child_ns;
+  event.depth = depth;
+  buffer_->write.store(write + 1, std::memory_order_release);
+}
+
+}  // namespace ndk_helper
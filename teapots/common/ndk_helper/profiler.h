@@ -0,0 +1,212 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdint.h>
+#include <time.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ndk_helper {
+
+/******************************************************************
+ * Time spent in a zone during the last frame, for one thread and one
+ * place in the zone hierarchy
+ */
+struct ZoneStats {
+  const char* name;
+  const char* parent;  // NULL at the top level
+  int32_t depth;
+  int32_t thread;  // Profiler::SetThreadName() order, 0 for the first thread
+  int32_t count;
+  uint64_t total_ns;
+  uint64_t self_ns;  // total_ns without the nested zones
+  uint64_t first_start_ns;
+};
+
+/******************************************************************
+ * Hierarchical CPU profiler
+ * Zones are marked with NDK_HELPER_PROFILE_ZONE("name"), which times the
+ * rest of the enclosing scope. Zones nest, on any number of threads: each
+ * thread writes the zones it closes to a buffer of its own, without locks,
+ * and EndFrame(), called once per frame (PerfMonitor::Update() does it),
+ * reads them all back and adds them up per zone.
+ * Zone names are not copied, they must be string literals.
+ * The profiler starts disabled, when a zone costs one atomic load.
+ */
+class Profiler {
+ public:
+  static const int32_t kMaxDepth = 32;
+  // Zones a thread can close between two EndFrame(), more are dropped
+  static const uint32_t kBufferSize = 4096;
+
+  struct Event {
+    const char* name;
+    const char* parent;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint64_t child_ns;
+    int32_t depth;
+  };
+
+  // Events of one thread: single producer (the thread) and single consumer
+  // (EndFrame()) ring buffer. Buffers are never freed, the buffer of a
+  // thread that exits goes to the next new thread.
+  struct ThreadBuffer {
+    Event events[kBufferSize];
+    std::atomic<uint32_t> write;
+    std::atomic<uint32_t> read;
+    std::atomic<bool> in_use;
+    int32_t id;
+    ThreadBuffer* next;
+
+    // Open zones, only touched by the owning thread
+    struct OpenZone {
+      const char* name;
+      uint64_t start_ns;
+      uint64_t child_ns;
+    } stack[kMaxDepth];
+    int32_t depth;
+  };
+
+ private:
+  std::atomic<bool> enabled_;
+  std::atomic<ThreadBuffer*> buffers_;
+  std::atomic<int32_t> buffer_count_;
+  std::atomic<uint32_t> dropped_;
+
+  // EndFrame() side
+  uint64_t frame_start_ns_;
+  uint64_t frame_ns_;
+  int32_t frame_thread_;
+  std::vector<ZoneStats> stats_;
+
+  // Indexed by ThreadBuffer::id
+  mutable std::mutex names_mutex_;
+  std::vector<std::string> thread_names_;
+
+  // Chrome trace capture
+  struct CapturedEvent {
+    const char* name;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    int32_t thread;
+  };
+  std::vector<CapturedEvent> capture_;
+  size_t capture_limit_;
+  uint64_t capture_start_ns_;
+
+  Profiler();
+  Profiler(const Profiler&);
+  Profiler& operator=(const Profiler&);
+
+  void AddEvent(const Event& event, int32_t thread);
+  std::string GetThreadName(int32_t thread) const;
+
+  friend struct ThreadBufferOwner;
+  friend class ProfileZone;
+
+ public:
+  static Profiler* GetInstance();
+
+  static uint64_t GetTimeNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + now.tv_nsec;
+  }
+
+  void SetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Buffer of the calling thread, set up on the first call
+  ThreadBuffer* GetThreadBuffer();
+
+  // Names the calling thread in the trace and in FormatFrame()
+  void SetThreadName(const char* name);
+
+  /*
+   * Close the current frame: collect the zones closed by every thread since
+   * the previous call into GetFrameStats(), and into the capture if one is
+   * running. Call it from one thread only.
+   */
+  void EndFrame();
+
+  const std::vector<ZoneStats>& GetFrameStats() const { return stats_; }
+  uint64_t GetFrameTimeNs() const { return frame_ns_; }
+  // Zones lost to full buffers or to nesting deeper than kMaxDepth
+  uint32_t GetDroppedCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  // Last frame as an indented tree of zones, one per line
+  void FormatFrame(std::string* text) const;
+
+  // Keep the zones of the next frames, up to max_events of them. The
+  // capture is kept until the next StartCapture().
+  void StartCapture(size_t max_events);
+  void StopCapture();
+  bool IsCapturing() const { return capture_.size() < capture_limit_; }
+
+  /*
+   * Write the captured zones in the Chrome trace event format, to be opened
+   * in chrome://tracing or https://ui.perfetto.dev
+   *
+   * arguments:
+   * in: path, file to write
+   * return: true when the file could be written
+   */
+  bool WriteChromeTrace(const char* path) const;
+  void GetChromeTrace(std::string* json) const;
+};
+
+/******************************************************************
+ * Scoped zone, see NDK_HELPER_PROFILE_ZONE
+ */
+class ProfileZone {
+ private:
+  Profiler::ThreadBuffer* buffer_;
+
+  ProfileZone(const ProfileZone&);
+  ProfileZone& operator=(const ProfileZone&);
+
+  void Begin(const char* name);
+  void End();
+
+ public:
+  explicit ProfileZone(const char* name) : buffer_(NULL) {
+    if (Profiler::GetInstance()->IsEnabled()) Begin(name);
+  }
+  ~ProfileZone() {
+    if (buffer_ != NULL) End();
+  }
+};
+
+}  // namespace ndk_helper
+
+#define NDK_HELPER_PROFILE_CONCAT_(a, b) a##b
+#define NDK_HELPER_PROFILE_CONCAT(a, b) NDK_HELPER_PROFILE_CONCAT_(a, b)
+#define NDK_HELPER_PROFILE_ZONE(name)                             \
+  ndk_helper::ProfileZone NDK_HELPER_PROFILE_CONCAT(profile_zone_, \
+                                                    __LINE__)(name)
+
+#endif /* PROFILER_H_ */
@@ -18,7 +18,10 @@
 #include <GLES2/gl2.h>
 
 #include "shader.h"
+#include "GLContext.h"
 #include "JNIHelper.h"
+#include "gl3stub.h"
+#include "hash.h"
 
 namespace ndk_helper {
 
@@ -27,16 +30,18 @@ namespace ndk_helper {
 bool shader::CompileShader(
     GLuint *shader, const GLenum type, const char *str_file_name,
     const std::map<std::string, std::string> &map_parameters) {
-  std::vector<uint8_t> data;
-  if (!JNIHelper::GetInstance()->ReadFile(str_file_name, &data)) {
+  AssetData data;
+  if (!JNIHelper::GetInstance()->OpenFile(str_file_name, &data)) {
     LOGI("Can not open a file:%s", str_file_name);
     return false;
   }
 
   const char REPLACEMENT_TAG = '*';
   // Fill-in parameters
-  std::string str(data.begin(), data.end());
-  std::string str_replacement_map(data.size(), ' ');
+  std::string str(reinterpret_cast<const char *>(data.GetData()),
+                  data.GetSize());
+  std::string str_replacement_map(data.GetSize(), ' ');
+  data.Release();
 
   std::map<std::string, std::string>::const_iterator it =
       map_parameters.begin();
@@ -110,14 +115,17 @@ bool shader::CompileShader(GLuint *shader, const GLenum type,
 
 bool shader::CompileShader(GLuint *shader, const GLenum type,
                            const char *strFileName) {
-  std::vector<uint8_t> data;
-  bool b = JNIHelper::GetInstance()->ReadFile(strFileName, &data);
+  AssetData data;
+  bool b = JNIHelper::GetInstance()->OpenFile(strFileName, &data);
   if (!b) {
     LOGI("Can not open a file:%s", strFileName);
     return false;
   }
 
-  return shader::CompileShader(shader, type, data);
+  // Compiled straight from the mapped file
+  return shader::CompileShader(
+      shader, type, reinterpret_cast<const GLchar *>(data.GetData()),
+      static_cast<int32_t>(data.GetSize()));
 }
 
 bool shader::LinkProgram(const GLuint prog) {
@@ -145,6 +153,91 @@ bool shader::LinkProgram(const GLuint prog) {
   return true;
 }
 
+bool shader::ReadSource(const char *file_name, std::string *text) {
+  AssetData data;
+  if (!JNIHelper::GetInstance()->OpenFile(file_name, &data)) return false;
+  text->assign(reinterpret_cast<const char *>(data.GetData()),
+               data.GetSize());
+  return true;
+}
+
+bool shader::CreateProgram(GLuint *program, ShaderCache *cache,
+                           const ShaderVariant &vertex,
+                           const ShaderVariant &fragment) {
+  std::string error;
+  uint64_t vertex_key, fragment_key;
+  const std::string *vertex_source =
+      cache->GetSource(vertex, &vertex_key, &error);
+  const std::string *fragment_source =
+      vertex_source ? cache->GetSource(fragment, &fragment_key, &error) : NULL;
+  if (fragment_source == NULL) {
+    LOGI("Can not preprocess a shader: %s", error.c_str());
+    return false;
+  }
+  const uint64_t key =
+      Hash(&fragment_key, sizeof(fragment_key),
+           Hash(&vertex_key, sizeof(vertex_key)));
+  const bool binaries = GLContext::GetInstance()->GetGLVersion() >= 3.0f;
+
+  // A stored binary skips compiling and linking altogether
+  std::vector<uint8_t> binary;
+  uint32_t format;
+  if (binaries && cache->GetLoadBinary() &&
+      cache->GetLoadBinary()(key, &binary, &format)) {
+    GLuint prog = glCreateProgram();
+    glProgramBinary(prog, format, binary.data(), binary.size());
+    GLint status;
+    glGetProgramiv(prog, GL_LINK_STATUS, &status);
+    if (status) {
+      *program = prog;
+      return true;
+    }
+    LOGI("Program binary rejected, compiling it again");
+    glDeleteProgram(prog);
+  }
+
+  GLuint prog = glCreateProgram();
+  GLuint vert_shader, frag_shader;
+  if (!CompileShader(&vert_shader, GL_VERTEX_SHADER, vertex_source->c_str(),
+                     vertex_source->size())) {
+    LOGI("Failed to compile vertex shader %s", vertex.file_name.c_str());
+    glDeleteProgram(prog);
+    return false;
+  }
+  if (!CompileShader(&frag_shader, GL_FRAGMENT_SHADER,
+                     fragment_source->c_str(), fragment_source->size())) {
+    LOGI("Failed to compile fragment shader %s", fragment.file_name.c_str());
+    glDeleteShader(vert_shader);
+    glDeleteProgram(prog);
+    return false;
+  }
+  glAttachShader(prog, vert_shader);
+  glAttachShader(prog, frag_shader);
+  const bool store = binaries && cache->GetStoreBinary();
+  if (store) glProgramParameteri(prog, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, 1);
+  const bool linked = LinkProgram(prog);
+  glDeleteShader(vert_shader);
+  glDeleteShader(frag_shader);
+  if (!linked) {
+    glDeleteProgram(prog);
+    return false;
+  }
+
+  if (store) {
+    GLint length = 0;
+    glGetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length > 0) {
+      binary.resize(length);
+      GLenum binary_format;
+      glGetProgramBinary(prog, length, &length, &binary_format, binary.data());
+      binary.resize(length);
+      cache->GetStoreBinary()(key, binary, binary_format);
+    }
+  }
+  *program = prog;
+  return true;
+}
+
 bool shader::ValidateProgram(const GLuint prog) {
   GLint logLength, status;
 
@@ -29,6 +29,7 @@
 #include <android/log.h>
 
 #include "JNIHelper.h"
+#include "shaderPreprocessor.h"
 
 namespace ndk_helper {
 
@@ -105,6 +106,37 @@ bool CompileShader(GLuint *shader, const GLenum type, const char *str_file_name,
  */
 bool LinkProgram(const GLuint prog);
 
+/******************************************************************
+ * ReadSource()
+ * SourceLoader for ShaderCache, reads through JNIHelper::OpenFile()
+ *
+ * arguments:
+ *  in: file_name, shader file name
+ *  out: text, file contents
+ * return: true if the file could be read
+ *
+ */
+bool ReadSource(const char *file_name, std::string *text);
+
+/******************************************************************
+ * CreateProgram() from shader variants
+ * The variants are expanded through the cache. On GLES3, when the cache
+ * has program binary hooks, a binary stored for the same expanded sources
+ * is used instead of compiling, and newly linked programs are handed to
+ * the store hook. A binary the driver rejects (e.g. after an update) is
+ * compiled again.
+ *
+ * arguments:
+ *  out: program, linked program
+ *  in: cache, shader cache
+ *  in: vertex, vertex shader variant
+ *  in: fragment, fragment shader variant
+ * return: true if the program is ready to use, false if it failed
+ *
+ */
+bool CreateProgram(GLuint *program, ShaderCache *cache,
+                   const ShaderVariant &vertex, const ShaderVariant &fragment);
+
 /******************************************************************
  * validateProgram()
  *
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shaderPreprocessor.h"
+
+#include <ctype.h>
+#include <string.h>
+
+#include "hash.h"
+
+namespace ndk_helper {
+
+namespace shader {
+
+namespace {
+
+// Deeper includes are taken for a cycle
+const int32_t kMaxIncludeDepth = 16;
+
+bool IsNameChar(const char c) {
+  return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+const char* SkipBlanks(const char* p, const char* end) {
+  while (p < end && (*p == ' ' || *p == '\t')) ++p;
+  return p;
+}
+
+// Whether [p, end) starts with '#' and 'directive', returns what follows
+const char* MatchDirective(const char* p, const char* end,
+                           const char* directive) {
+  p = SkipBlanks(p, end);
+  if (p == end || *p != '#') return NULL;
+  p = SkipBlanks(p + 1, end);
+  const size_t length = strlen(directive);
+  if (static_cast<size_t>(end - p) < length ||
+      strncmp(p, directive, length) != 0) {
+    return NULL;
+  }
+  p += length;
+  if (p < end && IsNameChar(*p)) return NULL;
+  return p;
+}
+
+// File name of an '#include "name"' line
+bool MatchInclude(const char* p, const char* end, std::string* name) {
+  p = MatchDirective(p, end, "include");
+  if (p == NULL) return false;
+  p = SkipBlanks(p, end);
+  if (p == end || *p != '"') return false;
+  const char* last = static_cast<const char*>(memchr(p + 1, '"', end - p - 1));
+  if (last == NULL) return false;
+  name->assign(p + 1, last);
+  return true;
+}
+
+bool HasVersion(const std::string& source) {
+  const char* p = source.data();
+  const char* end = p + source.size();
+  while (p < end) {
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (eol == NULL) eol = end;
+    if (MatchDirective(p, eol, "version") != NULL) return true;
+    p = eol + 1;
+  }
+  return false;
+}
+
+void AppendDefines(const ShaderVariant& variant, std::string* text) {
+  for (const auto& define : variant.defines) {
+    text->append("#define ");
+    text->append(define.first);
+    if (!define.second.empty()) {
+      text->push_back(' ');
+      text->append(define.second);
+    }
+    text->push_back('\n');
+  }
+}
+
+// Appends [p, end) with the parameters replaced
+void AppendSubstituted(const char* p, const char* end,
+                       const std::map<std::string, std::string>& parameters,
+                       std::string* text) {
+  while (p < end) {
+    const char* percent = static_cast<const char*>(memchr(p, '%', end - p));
+    if (percent == NULL || parameters.empty()) {
+      text->append(p, end);
+      return;
+    }
+    text->append(p, percent);
+    const char* name = percent + 1;
+    const char* last = name;
+    while (last < end && IsNameChar(*last)) ++last;
+    if (last < end && *last == '%' && last > name) {
+      auto it = parameters.find(std::string(name, last));
+      if (it != parameters.end()) {
+        text->append(it->second);
+        p = last + 1;
+        continue;
+      }
+    }
+    text->push_back('%');
+    p = percent + 1;
+  }
+}
+
+bool Expand(const ShaderVariant& variant, const std::string& file_name,
+            const std::string& source, const SourceLoader& loader,
+            const int32_t depth, std::string* text, std::string* error) {
+  // Defines go after #version, which must come first
+  bool defines_pending = depth == 0 && !variant.defines.empty();
+  if (defines_pending && !HasVersion(source)) {
+    AppendDefines(variant, text);
+    defines_pending = false;
+  }
+
+  std::string include;
+  const char* p = source.data();
+  const char* end = p + source.size();
+  while (p < end) {
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    const char* line_end = eol != NULL ? eol : end;
+
+    if (MatchInclude(p, line_end, &include)) {
+      if (depth >= kMaxIncludeDepth) {
+        if (error) *error = file_name + ": includes nested too deeply";
+        return false;
+      }
+      if (include.find('/') == std::string::npos) {
+        const size_t slash = file_name.rfind('/');
+        if (slash != std::string::npos)
+          include.insert(0, file_name, 0, slash + 1);
+      }
+      std::string included;
+      if (!loader(include.c_str(), &included)) {
+        if (error) *error = file_name + ": can't read " + include;
+        return false;
+      }
+      if (!Expand(variant, include, included, loader, depth + 1, text, error))
+        return false;
+      if (!text->empty() && (*text)[text->size() - 1] != '\n')
+        text->push_back('\n');
+    } else {
+      AppendSubstituted(p, line_end, variant.parameters, text);
+      if (eol != NULL) text->push_back('\n');
+      if (defines_pending && MatchDirective(p, line_end, "version") != NULL) {
+        if (eol == NULL) text->push_back('\n');
+        AppendDefines(variant, text);
+        defines_pending = false;
+      }
+    }
+    p = line_end + 1;
+  }
+  return true;
+}
+
+uint64_t HashMap(const std::map<std::string, std::string>& map,
+                 uint64_t hash) {
+  // The terminating '\0's keep "a"="bc" apart from "ab"="c"
+  for (const auto& entry : map) {
+    hash = Hash(entry.first.c_str(), entry.first.size() + 1, hash);
+    hash = Hash(entry.second.c_str(), entry.second.size() + 1, hash);
+  }
+  return hash;
+}
+
+}  // namespace
+
+bool Preprocess(const ShaderVariant& variant, const std::string& source,
+                const SourceLoader& loader, std::string* text,
+                std::string* error) {
+  text->clear();
+  text->reserve(source.size() + 256);
+  return Expand(variant, variant.file_name, source, loader, 0, text, error);
+}
+
+//--------------------------------------------------------------------------------
+// ShaderCache
+//--------------------------------------------------------------------------------
+ShaderCache::ShaderCache(const SourceLoader& loader)
+    : loader_(loader), hits_(0), misses_(0) {}
+
+const std::string* ShaderCache::GetSource(const ShaderVariant& variant,
+                                          uint64_t* key, std::string* error) {
+  const char separator = 1;
+  uint64_t hash = Hash(variant.file_name.c_str(), variant.file_name.size() + 1);
+  hash = HashMap(variant.defines, Hash(&separator, 1, hash));
+  hash = HashMap(variant.parameters, Hash(&separator, 1, hash));
+
+  auto it = entries_.find(hash);
+  if (it != entries_.end()) {
+    ++hits_;
+  } else {
+    std::string source;
+    if (!loader_(variant.file_name.c_str(), &source)) {
+      if (error) *error = "can't read " + variant.file_name;
+      return NULL;
+    }
+    ++misses_;
+    Entry entry;
+    if (!Preprocess(variant, source, loader_, &entry.text, error)) return NULL;
+    entry.key = Hash(entry.text.data(), entry.text.size());
+    it = entries_.insert(std::make_pair(hash, entry)).first;
+  }
+  if (key) *key = it->second.key;
+  return &it->second.text;
+}
+
+}  // namespace shader
+
+}  // namespace ndk_helper
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SHADERPREPROCESSOR_H_
+#define SHADERPREPROCESSOR_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ndk_helper {
+
+namespace shader {
+
+/******************************************************************
+ * Shader variants
+ * namespace: ndkHelper::shader
+ *
+ * A variant is a shader file plus the defines and parameters it is
+ * expanded with. Expansion is one pass over the source, with no GL
+ * dependency so that it runs on the host:
+ * - '#include "file"' lines are replaced with the file, expanded too.
+ *   Names without a '/' are relative to the including file.
+ * - %NAME% is replaced with the value of parameter NAME. A '%' that doesn't
+ *   start a known parameter, like the GLSL modulo, is left as it is.
+ * - Defines become '#define NAME VALUE' lines after the #version line.
+ */
+struct ShaderVariant {
+  std::string file_name;
+  std::map<std::string, std::string> defines;
+  std::map<std::string, std::string> parameters;
+};
+
+// Reads a shader file, e.g. shader::ReadSource() on the device
+typedef std::function<bool(const char* file_name, std::string* text)>
+    SourceLoader;
+
+/******************************************************************
+ * Preprocess()
+ *
+ * arguments:
+ *  in: variant, what to expand
+ *  in: source, contents of variant.file_name
+ *  in: loader, reads included files
+ *  out: text, the expanded source
+ *  out: error, reason of a failure, may be NULL
+ * return: true on success, false if an include is missing or too deep
+ */
+bool Preprocess(const ShaderVariant& variant, const std::string& source,
+                const SourceLoader& loader, std::string* text,
+                std::string* error);
+
+/******************************************************************
+ * Cache of expanded shader variants
+ * Variants are looked up by a hash of their file name, defines and
+ * parameters, so a hit reads no file: files are read on the first
+ * expansion only, and a file changed since is expanded again after
+ * Clear(). Each expansion also gets a key of its expanded text, which is
+ * what identifies compiled programs, so variants expanding to the same
+ * text share them: hooks set with SetProgramBinaryHooks() can persist
+ * program binaries under it, see shader::CreateProgram().
+ * Not thread safe, use it from the GL thread.
+ */
+class ShaderCache {
+ public:
+  // Looks a program binary up, returns false if there is none
+  typedef std::function<bool(uint64_t key, std::vector<uint8_t>* binary,
+                             uint32_t* format)>
+      LoadBinary;
+  // Saves a program binary for later runs
+  typedef std::function<void(uint64_t key, const std::vector<uint8_t>& binary,
+                             uint32_t format)>
+      StoreBinary;
+
+ private:
+  struct Entry {
+    std::string text;
+    uint64_t key;
+  };
+
+  SourceLoader loader_;
+  std::unordered_map<uint64_t, Entry> entries_;
+  LoadBinary load_binary_;
+  StoreBinary store_binary_;
+  int32_t hits_;
+  int32_t misses_;
+
+  ShaderCache(const ShaderCache&);
+  ShaderCache& operator=(const ShaderCache&);
+
+ public:
+  explicit ShaderCache(const SourceLoader& loader);
+
+  /*
+   * Expanded source of a variant.
+   *
+   * arguments:
+   *  in: variant, what to expand
+   *  out: key, hash of the expanded text, may be NULL
+   *  out: error, reason of a failure, may be NULL
+   * return: the expanded text, valid until Clear(), NULL on failure
+   */
+  const std::string* GetSource(const ShaderVariant& variant, uint64_t* key,
+                               std::string* error = NULL);
+
+  void Clear() { entries_.clear(); }
+
+  void SetProgramBinaryHooks(const LoadBinary& load, const StoreBinary& store) {
+    load_binary_ = load;
+    store_binary_ = store;
+  }
+  const LoadBinary& GetLoadBinary() const { return load_binary_; }
+  const StoreBinary& GetStoreBinary() const { return store_binary_; }
+
+  int32_t GetHitCount() const { return hits_; }
+  int32_t GetMissCount() const { return misses_; }
+};
+
+}  // namespace shader
+
+}  // namespace ndk_helper
+#endif /* SHADERPREPROCESSOR_H_ */
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "textureFile.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "etc2.h"
+
+#if defined(__ANDROID__)
+#include "JNIHelper.h"
+#endif
+
+namespace ndk_helper {
+
+namespace {
+
+// Bytes per 4x4 block of a compressed format, 0 if not one
+int32_t BlockSize(const uint32_t internal_format) {
+  switch (internal_format) {
+    case TEXTURE_GL_COMPRESSED_RGB8_ETC2:
+    case TEXTURE_GL_COMPRESSED_SRGB8_ETC2:
+      return etc2::kRgbBlockSize;
+    case TEXTURE_GL_COMPRESSED_RGBA8_ETC2_EAC:
+    case TEXTURE_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+      return etc2::kRgbaBlockSize;
+    default:
+      return 0;
+  }
+}
+
+}  // namespace
+
+TextureFile::TextureFile() : header_(NULL), levels_(NULL), data_(NULL) {}
+
+TextureFile::~TextureFile() { Release(); }
+
+void TextureFile::Release() {
+  file_.Release();
+  header_ = NULL;
+  levels_ = NULL;
+  data_ = NULL;
+}
+
+bool TextureFile::Attach(const void* data, const size_t size) {
+  header_ = NULL;
+  levels_ = NULL;
+  data_ = NULL;
+
+  const TEXTURE_HEADER* header = static_cast<const TEXTURE_HEADER*>(data);
+  if (data == NULL || size < sizeof(TEXTURE_HEADER) ||
+      (reinterpret_cast<uintptr_t>(data) & 3) != 0 ||
+      memcmp(header->magic, TEXTURE_MAGIC, 4) != 0 ||
+      header->version != TEXTURE_VERSION) {
+    return false;
+  }
+
+  const int32_t block_size = BlockSize(header->gl_internal_format);
+  bool valid;
+  if (block_size != 0) {
+    valid = header->gl_format == 0 && header->gl_type == 0;
+  } else {
+    valid = (header->gl_internal_format == TEXTURE_GL_RGBA ||
+             header->gl_internal_format == TEXTURE_GL_SRGB8_ALPHA8) &&
+            header->gl_format == TEXTURE_GL_RGBA &&
+            header->gl_type == TEXTURE_GL_UNSIGNED_BYTE;
+  }
+  valid = valid && header->width >= 1 && header->width <= 16384 &&
+          header->height >= 1 && header->height <= 16384 &&
+          header->level_count >= 1 && header->level_count <= 15 &&
+          header->level_offset % 4 == 0 &&
+          header->level_offset +
+                  static_cast<uint64_t>(header->level_count) *
+                      sizeof(TEXTURE_LEVEL) <=
+              size;
+  if (!valid) return false;
+
+  // Everything GL may read must be inside the data, at the size the format
+  // implies
+  const TEXTURE_LEVEL* levels = reinterpret_cast<const TEXTURE_LEVEL*>(
+      static_cast<const uint8_t*>(data) + header->level_offset);
+  for (uint32_t l = 0; l < header->level_count; ++l) {
+    const TEXTURE_LEVEL& level = levels[l];
+    const uint32_t width = std::max(header->width >> l, 1u);
+    const uint32_t height = std::max(header->height >> l, 1u);
+    const uint64_t expected =
+        block_size != 0 ? static_cast<uint64_t>((width + 3) / 4) *
+                              ((height + 3) / 4) * block_size
+                        : static_cast<uint64_t>(width) * height * 4;
+    if (level.width != width || level.height != height ||
+        level.data_size != expected || level.data_offset % 4 != 0 ||
+        level.data_offset + expected > size) {
+      return false;
+    }
+  }
+
+  header_ = header;
+  levels_ = levels;
+  data_ = static_cast<const uint8_t*>(data);
+  return true;
+}
+
+bool TextureFile::LoadFile(const char* path) {
+  Release();
+  if (!AssetReader::MapFile(path, &file_) ||
+      !Attach(file_.GetData(), file_.GetSize())) {
+    file_.Release();
+    return false;
+  }
+  return true;
+}
+
+void TextureFile::DecodeLevel(const int32_t level,
+                              std::vector<uint8_t>* rgba) const {
+  const int32_t width = GetLevelWidth(level);
+  const int32_t height = GetLevelHeight(level);
+  if (!IsCompressed()) {
+    rgba->assign(GetLevelData(level), GetLevelData(level) + GetLevelSize(level));
+    return;
+  }
+  rgba->resize(static_cast<size_t>(width) * height * 4);
+  etc2::DecodeImage(
+      GetLevelData(level), width, height,
+      BlockSize(header_->gl_internal_format) == etc2::kRgbaBlockSize,
+      rgba->data());
+}
+
+#if defined(__ANDROID__)
+bool TextureFile::Load(const char* file_name) {
+  Release();
+  if (!JNIHelper::GetInstance()->OpenFile(file_name, &file_)) return false;
+  if (!Attach(file_.GetData(), file_.GetSize())) {
+    LOGI("Texture %s is invalid", file_name);
+    file_.Release();
+    return false;
+  }
+  return true;
+}
+
+bool TextureFile::Upload(const GLenum target, const bool mipmaps) const {
+  if (header_ == NULL) return false;
+  const int32_t level_count = mipmaps ? GetLevelCount() : 1;
+
+  // Only the errors of the upload count
+  for (int32_t i = 0; i < 8 && glGetError() != GL_NO_ERROR; ++i) {
+  }
+  for (int32_t l = 0; l < level_count; ++l) {
+    if (IsCompressed()) {
+      glCompressedTexImage2D(target, l, GetInternalFormat(), GetLevelWidth(l),
+                             GetLevelHeight(l), 0, GetLevelSize(l),
+                             GetLevelData(l));
+    } else {
+      glTexImage2D(target, l, GetInternalFormat(), GetLevelWidth(l),
+                   GetLevelHeight(l), 0, header_->gl_format,
+                   header_->gl_type, GetLevelData(l));
+    }
+  }
+  if (glGetError() == GL_NO_ERROR) return true;
+  if (!IsCompressed()) return false;
+
+  LOGI("Format 0x%x is not supported, decoding it", GetInternalFormat());
+  std::vector<uint8_t> rgba;
+  for (int32_t l = 0; l < level_count; ++l) {
+    DecodeLevel(l, &rgba);
+    glTexImage2D(target, l, GL_RGBA, GetLevelWidth(l), GetLevelHeight(l), 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+  }
+  return glGetError() == GL_NO_ERROR;
+}
+#endif
+
+}  // namespace ndk_helper
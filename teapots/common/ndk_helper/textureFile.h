@@ -0,0 +1,113 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TEXTUREFILE_H_
+#define TEXTUREFILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#if defined(__ANDROID__)
+#include <GLES2/gl2.h>
+#endif
+
+#include "assetReader.h"
+#include "textureFormat.h"
+
+namespace ndk_helper {
+
+/******************************************************************
+ * Read-only texture in the baked format of textureFormat.h
+ * As with Mesh, the file is mapped, not read: after a header check every
+ * level is handed to GL where it is, with no decoding. Textures are baked
+ * offline with teapots/host/texture-bake. Only Load() and Upload() need
+ * Android; the rest builds on the host too.
+ */
+class TextureFile {
+ private:
+  const TEXTURE_HEADER* header_;
+  const TEXTURE_LEVEL* levels_;
+  const uint8_t* data_;
+
+  // What backs data_, if the texture owns it
+  AssetData file_;
+
+  TextureFile(const TextureFile&);
+  TextureFile& operator=(const TextureFile&);
+
+ public:
+  TextureFile();
+  virtual ~TextureFile();
+
+#if defined(__ANDROID__)
+  // Loads file_name through JNIHelper::OpenFile(), like Mesh::Load(). Store
+  // the textures uncompressed in the APK (noCompress) so that the asset
+  // manager maps them.
+  bool Load(const char* file_name);
+
+  /*
+   * Upload the levels to target of the bound texture, GL_TEXTURE_2D or a
+   * cube map face. When GL rejects a compressed format, as ES 2 does ETC2,
+   * the levels are decoded on the CPU and uploaded as RGBA8 instead.
+   *
+   * arguments:
+   *  in: mipmaps, upload every level when true, else level 0 only
+   * return: false when GL rejected the levels
+   */
+  bool Upload(const GLenum target, const bool mipmaps = true) const;
+#endif
+
+  // Maps a file
+  bool LoadFile(const char* path);
+
+  // Uses a texture already in memory, which must stay valid and 4 byte
+  // aligned
+  bool Attach(const void* data, const size_t size);
+
+  void Release();
+
+  bool IsLoaded() const { return header_ != NULL; }
+  bool IsCompressed() const { return header_->gl_format == 0; }
+  bool IsSrgb() const { return (header_->flags & TEXTURE_FLAG_SRGB) != 0; }
+  bool IsOpaque() const {
+    return (header_->flags & TEXTURE_FLAG_OPAQUE) != 0;
+  }
+  uint32_t GetInternalFormat() const { return header_->gl_internal_format; }
+
+  int32_t GetWidth() const { return header_->width; }
+  int32_t GetHeight() const { return header_->height; }
+  int32_t GetLevelCount() const { return header_->level_count; }
+  int32_t GetLevelWidth(const int32_t level) const {
+    return levels_[level].width;
+  }
+  int32_t GetLevelHeight(const int32_t level) const {
+    return levels_[level].height;
+  }
+  const uint8_t* GetLevelData(const int32_t level) const {
+    return data_ + levels_[level].data_offset;
+  }
+  size_t GetLevelSize(const int32_t level) const {
+    return levels_[level].data_size;
+  }
+
+  // Level as RGBA8, decompressed if need be
+  void DecodeLevel(const int32_t level, std::vector<uint8_t>* rgba) const;
+};
+
+}  // namespace ndk_helper
+#endif /* TEXTUREFILE_H_ */
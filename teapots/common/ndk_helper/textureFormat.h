@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TEXTUREFORMAT_H_
+#define TEXTUREFORMAT_H_
+
+#include <stdint.h>
+
+/******************************************************************
+ * Baked texture file layout, shared by ndk_helper::TextureFile and the
+ * offline baker in teapots/host. It has no dependency so that host tools
+ * can include it.
+ *
+ * Like KTX, a file is a header holding the GL enums to upload with, then
+ * the levels exactly as glTexImage2D() or glCompressedTexImage2D() take
+ * them, so a loaded file is used in place:
+ * - TEXTURE_HEADER, then level_count TEXTURE_LEVEL entries at level_offset;
+ * - the data of each level at its data_offset, on a 16 byte boundary;
+ * - level l is max(width >> l, 1) x max(height >> l, 1), level 0 first;
+ * - rows go from the first one GL addresses (t = 0) to the last, packed:
+ *   RGBA8 rows are a multiple of 4 bytes, so the default unpack alignment
+ *   applies; compressed levels are rows of 4x4 blocks.
+ * Everything is little endian.
+ */
+#define TEXTURE_MAGIC "NDKT"
+#define TEXTURE_VERSION 1
+
+// The internal formats TEXTURE_HEADER may hold, values of the GL ES 3
+// headers, which host builds don't have
+#define TEXTURE_GL_RGBA 0x1908
+#define TEXTURE_GL_UNSIGNED_BYTE 0x1401
+#define TEXTURE_GL_SRGB8_ALPHA8 0x8C43
+#define TEXTURE_GL_COMPRESSED_RGB8_ETC2 0x9274
+#define TEXTURE_GL_COMPRESSED_SRGB8_ETC2 0x9275
+#define TEXTURE_GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#define TEXTURE_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC 0x9279
+
+enum TEXTURE_FLAG {
+  // Colors are sRGB encoded. Set along with the sRGB internal formats, and
+  // also on plain ones whose mipmaps were filtered in linear light.
+  TEXTURE_FLAG_SRGB = 1,
+  // Every alpha is 255
+  TEXTURE_FLAG_OPAQUE = 2,
+};
+
+struct TEXTURE_HEADER {
+  char magic[4];  // TEXTURE_MAGIC
+  uint32_t version;
+  uint32_t gl_internal_format;
+  uint32_t gl_format;  // 0 for compressed formats
+  uint32_t gl_type;    // 0 for compressed formats
+  uint32_t flags;      // TEXTURE_FLAG bits
+  uint32_t width;
+  uint32_t height;
+  uint32_t level_count;
+  uint32_t level_offset;  // From the start of the file
+  uint32_t reserved[2];
+};
+
+struct TEXTURE_LEVEL {
+  uint32_t width;
+  uint32_t height;
+  uint32_t data_offset;  // From the start of the file
+  uint32_t data_size;
+};
+
+#endif /* TEXTUREFORMAT_H_ */
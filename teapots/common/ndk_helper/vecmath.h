@@ -18,13 +18,19 @@
 #define VECMATH_H_
 
 #include <cmath>
+#if defined(__ANDROID__)
 #include "JNIHelper.h"
+#else
+// Host builds (teapots/host) have no JNIHelper, Dump() goes to stdout
+#include <stdio.h>
+#define LOGI(...) ((void)printf(__VA_ARGS__), (void)printf("\n"))
+#endif
 
 namespace ndk_helper {
 
 /******************************************************************
  * Helper class for vector math operations
- * Currently all implementations are in pure C++.
+ * Mat4 * Vec4 and Mat4::Inverse() use SSE or NEON when available.
  * Each class is an opaque class so caller does not have a direct access
  * to each element. This is for an ease of future optimization to use vector
  *operations.
@@ -35,6 +41,25 @@ class Vec2;
 class Vec3;
 class Vec4;
 class Mat4;
+class Frustum;
+
+/******************************************************************
+ * Structure-of-arrays storage for the batch operations of Mat4
+ * Element i of a Vec4Array is (x[i], y[i], z[i], w[i]), element i of a
+ * Mat4Array is the column major matrix made of f[0][i] .. f[15][i].
+ * The batch operations process 4 elements at a time with SSE or NEON
+ * when available, any count works.
+ */
+struct Vec4Array {
+  float* x;
+  float* y;
+  float* z;
+  float* w;
+};
+
+struct Mat4Array {
+  float* f[16];
+};
 
 /******************************************************************
  * 2 elements vector class
@@ -213,6 +238,7 @@ class Vec3 {
   friend class Vec4;
   friend class Mat4;
   friend class Quaternion;
+  friend class Frustum;
 
   Vec3() { x_ = y_ = z_ = 0.f; }
 
@@ -631,6 +657,7 @@ class Mat4 {
   friend class Vec3;
   friend class Vec4;
   friend class Quaternion;
+  friend class Frustum;
 
   Mat4();
   Mat4(const float*);
@@ -669,44 +696,7 @@ class Mat4 {
   }
 
   Mat4& operator*=(const Mat4& rhs) {
-    Mat4 ret;
-    ret.f_[0] = f_[0] * rhs.f_[0] + f_[4] * rhs.f_[1] + f_[8] * rhs.f_[2] +
-                f_[12] * rhs.f_[3];
-    ret.f_[1] = f_[1] * rhs.f_[0] + f_[5] * rhs.f_[1] + f_[9] * rhs.f_[2] +
-                f_[13] * rhs.f_[3];
-    ret.f_[2] = f_[2] * rhs.f_[0] + f_[6] * rhs.f_[1] + f_[10] * rhs.f_[2] +
-                f_[14] * rhs.f_[3];
-    ret.f_[3] = f_[3] * rhs.f_[0] + f_[7] * rhs.f_[1] + f_[11] * rhs.f_[2] +
-                f_[15] * rhs.f_[3];
-
-    ret.f_[4] = f_[0] * rhs.f_[4] + f_[4] * rhs.f_[5] + f_[8] * rhs.f_[6] +
-                f_[12] * rhs.f_[7];
-    ret.f_[5] = f_[1] * rhs.f_[4] + f_[5] * rhs.f_[5] + f_[9] * rhs.f_[6] +
-                f_[13] * rhs.f_[7];
-    ret.f_[6] = f_[2] * rhs.f_[4] + f_[6] * rhs.f_[5] + f_[10] * rhs.f_[6] +
-                f_[14] * rhs.f_[7];
-    ret.f_[7] = f_[3] * rhs.f_[4] + f_[7] * rhs.f_[5] + f_[11] * rhs.f_[6] +
-                f_[15] * rhs.f_[7];
-
-    ret.f_[8] = f_[0] * rhs.f_[8] + f_[4] * rhs.f_[9] + f_[8] * rhs.f_[10] +
-                f_[12] * rhs.f_[11];
-    ret.f_[9] = f_[1] * rhs.f_[8] + f_[5] * rhs.f_[9] + f_[9] * rhs.f_[10] +
-                f_[13] * rhs.f_[11];
-    ret.f_[10] = f_[2] * rhs.f_[8] + f_[6] * rhs.f_[9] + f_[10] * rhs.f_[10] +
-                 f_[14] * rhs.f_[11];
-    ret.f_[11] = f_[3] * rhs.f_[8] + f_[7] * rhs.f_[9] + f_[11] * rhs.f_[10] +
-                 f_[15] * rhs.f_[11];
-
-    ret.f_[12] = f_[0] * rhs.f_[12] + f_[4] * rhs.f_[13] + f_[8] * rhs.f_[14] +
-                 f_[12] * rhs.f_[15];
-    ret.f_[13] = f_[1] * rhs.f_[12] + f_[5] * rhs.f_[13] + f_[9] * rhs.f_[14] +
-                 f_[13] * rhs.f_[15];
-    ret.f_[14] = f_[2] * rhs.f_[12] + f_[6] * rhs.f_[13] + f_[10] * rhs.f_[14] +
-                 f_[14] * rhs.f_[15];
-    ret.f_[15] = f_[3] * rhs.f_[12] + f_[7] * rhs.f_[13] + f_[11] * rhs.f_[14] +
-                 f_[15] * rhs.f_[15];
-
-    *this = ret;
+    *this = *this * rhs;
     return *this;
   }
 
@@ -766,6 +756,29 @@ class Mat4 {
 
   float* Ptr() { return f_; }
 
+  //--------------------------------------------------------------------------------
+  // Batch operations, see Vec4Array and Mat4Array
+  //--------------------------------------------------------------------------------
+  static Mat4 Load(const Mat4Array& array, const int32_t index);
+  void Store(const Mat4Array& array, const int32_t index) const;
+
+  // out[i] = *this * in[i], out may be in
+  void TransformArray(const Vec4Array& in, const Vec4Array& out,
+                      const int32_t count) const;
+
+  // out[i] = *this * rhs[i], out may be rhs
+  void MultiplyArray(const Mat4Array& rhs, const Mat4Array& out,
+                     const int32_t count) const;
+
+  // out[i] = lhs[i] * rhs[i], out may be lhs or rhs
+  static void MultiplyArrays(const Mat4Array& lhs, const Mat4Array& rhs,
+                             const Mat4Array& out, const int32_t count);
+
+  // Copies count matrices from the array to out, one matrix every 'stride'
+  // floats, e.g. into a mapped uniform buffer
+  static void CopyArray(const Mat4Array& array, const int32_t count,
+                        float* out, const int32_t stride);
+
   //--------------------------------------------------------------------------------
   // Misc
   //--------------------------------------------------------------------------------
@@ -961,5 +974,40 @@ class Quaternion {
   }
 };
 
+/******************************************************************
+ * View frustum
+ * The 6 planes of a view-projection matrix, plus an optional maximum
+ * distance from the eye, for bounding sphere visibility tests.
+ * CullSpheres() tests 4 spheres at a time with SSE or NEON when available.
+ */
+enum FRUSTUM_TEST {
+  FRUSTUM_OUTSIDE,
+  FRUSTUM_INTERSECTS,
+  FRUSTUM_INSIDE
+};
+
+class Frustum {
+ private:
+  float planes_[6][4];  // Normalized, pointing inside
+  float eye_[3];
+  float max_distance_;  // 0 when there is no distance limit
+
+ public:
+  explicit Frustum(const Mat4& view_projection);
+
+  // Spheres further than max_distance from the eye are outside
+  void SetMaxDistance(const Vec3& eye, const float max_distance);
+
+  FRUSTUM_TEST TestSphere(const Vec3& center, const float radius) const;
+
+  // Writes first_index + i to 'visible' for each sphere i that is at least
+  // partly inside, in order, and returns how many were written. The spheres
+  // have centers (x[i], y[i], z[i]) and the same radius. 'visible' must have
+  // room for count entries.
+  int32_t CullSpheres(const float* x, const float* y, const float* z,
+                      const float radius, const int32_t count,
+                      const int32_t first_index, int32_t* visible) const;
+};
+
 }  // namespace ndk_helper
 #endif /* VECMATH_H_ */
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// asset-bench.cpp
+// Loads many small files through ndk_helper::AssetReader, serially and on
+// the job system, against the former JNIHelper::ReadFile() scheme (one
+// mutex around a std::ifstream copy, without its JNI calls).
+//
+//   asset-bench [-n files] [-s bytes] [-t threads] [-r repeats]
+//--------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "assetReader.h"
+#include "jobSystem.h"
+
+using ndk_helper::AssetData;
+using ndk_helper::AssetReader;
+
+static std::mutex legacy_mutex;
+
+static bool LegacyReadFile(const std::string& path,
+                           std::vector<uint8_t>* buffer) {
+  std::lock_guard<std::mutex> lock(legacy_mutex);
+  std::ifstream f(path.c_str(), std::ios::binary);
+  if (!f) return false;
+  f.seekg(0, std::ifstream::end);
+  int32_t size = f.tellg();
+  f.seekg(0, std::ifstream::beg);
+  buffer->reserve(size);
+  buffer->assign(std::istreambuf_iterator<char>(f),
+                 std::istreambuf_iterator<char>());
+  return true;
+}
+
+static uint32_t Checksum(const uint8_t* data, size_t size) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i < size; ++i) sum = sum * 31 + data[i];
+  return sum;
+}
+
+int main(int argc, char** argv) {
+  int32_t file_count = 500;
+  int32_t file_size = 4096;
+  int32_t threads = -1;
+  int32_t repeats = 20;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:s:t:r:")) != -1) {
+    switch (opt) {
+      case 'n':
+        file_count = atoi(optarg);
+        break;
+      case 's':
+        file_size = atoi(optarg);
+        break;
+      case 't':
+        threads = atoi(optarg);
+        break;
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-n files] [-s bytes] [-t threads] [-r repeats]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+
+  char dir[] = "/tmp/asset-bench-XXXXXX";
+  if (mkdtemp(dir) == NULL) {
+    perror("mkdtemp");
+    return 1;
+  }
+  std::vector<std::string> names(file_count);
+  std::vector<uint32_t> expected(file_count);
+  std::vector<uint8_t> contents(file_size);
+  for (int32_t i = 0; i < file_count; ++i) {
+    char name[32];
+    snprintf(name, sizeof(name), "asset%04d.bin", i);
+    names[i] = name;
+    for (int32_t k = 0; k < file_size; ++k) contents[k] = (i * 131 + k * 7) & 0xff;
+    expected[i] = Checksum(contents.data(), contents.size());
+    std::string path = std::string(dir) + "/" + name;
+    FILE* f = fopen(path.c_str(), "wb");
+    if (f == NULL || fwrite(contents.data(), 1, contents.size(), f) !=
+                         contents.size()) {
+      perror(path.c_str());
+      return 1;
+    }
+    fclose(f);
+  }
+
+  AssetReader reader;
+  reader.AddDirectory(dir);
+  ndk_helper::JobSystem jobs(threads);
+  std::vector<int32_t> errors(file_count);
+
+  // Each load checks the contents, so that mapped pages are really read
+  typedef std::function<bool(int32_t)> Load;
+  Load legacy = [&](int32_t i) {
+    std::vector<uint8_t> buffer;
+    return LegacyReadFile(std::string(dir) + "/" + names[i], &buffer) &&
+           Checksum(buffer.data(), buffer.size()) == expected[i];
+  };
+  Load copy = [&](int32_t i) {
+    std::vector<uint8_t> buffer;
+    return reader.ReadFile(names[i].c_str(), &buffer) &&
+           Checksum(buffer.data(), buffer.size()) == expected[i];
+  };
+  Load map = [&](int32_t i) {
+    AssetData data;
+    return reader.Open(names[i].c_str(), &data) &&
+           Checksum(data.GetData(), data.GetSize()) == expected[i];
+  };
+
+  printf("%d files of %d bytes, %d threads, median of %d runs\n", file_count,
+         file_size, jobs.GetThreadCount(), repeats);
+  struct {
+    const char* name;
+    Load* load;
+  } modes[] = {{"legacy (mutex + ifstream copy)", &legacy},
+               {"AssetReader::ReadFile (copy)", &copy},
+               {"AssetReader::Open (mapped)", &map}};
+  int32_t failures = 0;
+  for (const auto& mode : modes) {
+    for (int parallel = 0; parallel < 2; ++parallel) {
+      std::vector<double> times;
+      for (int32_t r = 0; r < repeats; ++r) {
+        std::fill(errors.begin(), errors.end(), 0);
+        auto run = [&](int32_t begin, int32_t end) {
+          for (int32_t i = begin; i < end; ++i) errors[i] = !(*mode.load)(i);
+        };
+        auto start = std::chrono::steady_clock::now();
+        if (parallel) {
+          jobs.ParallelFor(file_count, 8, run);
+        } else {
+          run(0, file_count);
+        }
+        auto stop = std::chrono::steady_clock::now();
+        times.push_back(
+            std::chrono::duration<double, std::milli>(stop - start).count());
+        for (int32_t e : errors) failures += e;
+      }
+      std::sort(times.begin(), times.end());
+      const double ms = times[times.size() / 2];
+      printf("  %-32s %-8s %8.3f ms  %7.1f us/file\n", mode.name,
+             parallel ? "parallel" : "serial", ms, 1000. * ms / file_count);
+    }
+  }
+
+  for (int32_t i = 0; i < file_count; ++i)
+    unlink((std::string(dir) + "/" + names[i]).c_str());
+  rmdir(dir);
+  if (failures) printf("%d loads FAILED\n", failures);
+  return failures ? 1 : 0;
+}
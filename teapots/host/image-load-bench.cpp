@@ -0,0 +1,153 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// image-load-bench.cpp
+// Decodes the six cubemap faces of the image-decoder sample one after the
+// other, as Texture used to on the GL thread, then through ImageLoader while
+// the calling thread keeps polling like a render loop would. AImageDecoder
+// is not available on the host, the minimal PNG decoder of imageFile.cpp
+// stands in.
+//
+//   image-load-bench [-t threads] [-r runs] [-l ms] [textures dir]
+//
+// -l adds a sleep to each decode, standing in for storage latency.
+//--------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ImageLoader.h"
+#include "imageFile.h"
+
+static double Ms(std::chrono::steady_clock::time_point a,
+                 std::chrono::steady_clock::time_point b) {
+  return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+static double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+int main(int argc, char** argv) {
+  int32_t threads = -1;
+  int32_t runs = 10;
+  int32_t latency_ms = 0;
+  int opt;
+  while ((opt = getopt(argc, argv, "t:r:l:")) != -1) {
+    switch (opt) {
+      case 't':
+        threads = atoi(optarg);
+        break;
+      case 'r':
+        runs = std::max(1, atoi(optarg));
+        break;
+      case 'l':
+        latency_ms = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-t threads] [-r runs] [-l ms] [textures dir]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  const std::string dir =
+      optind < argc ? argv[optind] : "image-decoder/src/main/assets/Textures";
+
+  // Cubemap order, as in ImageDecoderRender
+  const char* kFaces[6] = {"right.png", "left.png",  "top.png",
+                           "bottom.png", "front.png", "back.png"};
+  std::vector<std::string> files;
+  for (const char* face : kFaces) files.push_back(dir + "/" + face);
+  auto decode = [latency_ms](const std::string& file, DecodedImage* image) {
+    if (latency_ms > 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(latency_ms));
+    return ReadPng(file, &image->width, &image->height, &image->pixels);
+  };
+
+  // Serial: the GL thread is blocked for the whole time
+  std::vector<DecodedImage> expected(6);
+  std::vector<double> serial;
+  for (int32_t run = 0; run < runs; ++run) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < 6; ++i) {
+      if (!decode(files[i], &expected[i])) {
+        fprintf(stderr, "failed to decode %s\n", files[i].c_str());
+        return 1;
+      }
+    }
+    serial.push_back(Ms(t0, std::chrono::steady_clock::now()));
+  }
+
+  ImageLoader loader(threads);
+  std::vector<double> wall, blocked;
+  std::vector<ImageLoader::Result> results;
+  bool same = true;
+  for (int32_t run = 0; run < runs; ++run) {
+    auto t0 = std::chrono::steady_clock::now();
+    int32_t ids[6];
+    for (int32_t i = 0; i < 6; ++i) {
+      const std::string file = files[i];
+      ids[i] = loader.Submit([file, &decode](DecodedImage* image) {
+        return decode(file, image);
+      });
+    }
+    double in_calls = Ms(t0, std::chrono::steady_clock::now());
+
+    // A frame every millisecond, taking what is finished
+    int32_t received = 0;
+    while (received < 6) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      auto p0 = std::chrono::steady_clock::now();
+      loader.Poll(&results);
+      for (auto& result : results) {
+        const int32_t face =
+            static_cast<int32_t>(std::find(ids, ids + 6, result.id) - ids);
+        same = same && result.success && face < 6 &&
+               result.image.width == expected[face].width &&
+               result.image.pixels == expected[face].pixels;
+        loader.Recycle(&result.image);
+        ++received;
+      }
+      in_calls += Ms(p0, std::chrono::steady_clock::now());
+    }
+    wall.push_back(Ms(t0, std::chrono::steady_clock::now()));
+    blocked.push_back(in_calls);
+  }
+
+  printf("6 faces of %dx%d, %d runs, %d ms latency, %u cores\n",
+         expected[0].width, expected[0].height, runs, latency_ms,
+         std::thread::hardware_concurrency());
+  printf("  serial              %8.2f ms  (all of it on the calling thread)\n",
+         Median(serial));
+  printf("  ImageLoader (%d thr) %8.2f ms  (%.3f ms on the calling thread)\n",
+         loader.GetThreadCount(), Median(wall), Median(blocked));
+  if (!same) {
+    printf("FAILED: images differ from the serial decode\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "imageFile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+static bool ReadFile(const std::string& path, std::vector<uint8_t>* data) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == NULL) return false;
+  uint8_t chunk[65536];
+  size_t read;
+  while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    data->insert(data->end(), chunk, chunk + read);
+  fclose(file);
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+// PNG
+//--------------------------------------------------------------------------------
+static uint32_t ReadU32(const uint8_t* p) {
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+         (uint32_t(p[2]) << 8) | p[3];
+}
+
+static int32_t Paeth(int32_t a, int32_t b, int32_t c) {
+  const int32_t p = a + b - c;
+  const int32_t pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+  if (pa <= pb && pa <= pc) return a;
+  return pb <= pc ? b : c;
+}
+
+bool ReadPng(const std::string& path, int32_t* width_out, int32_t* height_out,
+             std::vector<uint8_t>* rgba) {
+  std::vector<uint8_t> data;
+  if (!ReadFile(path, &data)) return false;
+
+  static const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 26,
+                                        '\n'};
+  if (data.size() < 33 || memcmp(data.data(), kSignature, 8) != 0)
+    return false;
+  const uint32_t width = ReadU32(&data[16]);
+  const uint32_t height = ReadU32(&data[20]);
+  const uint8_t depth = data[24], color = data[25], interlace = data[28];
+  if (depth != 8 || (color != 2 && color != 6) || interlace != 0) return false;
+  const uint32_t channels = color == 6 ? 4 : 3;
+  const size_t row = width * channels;
+
+  std::vector<uint8_t> filtered((row + 1) * height);
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit(&stream) != Z_OK) return false;
+  stream.next_out = filtered.data();
+  stream.avail_out = filtered.size();
+  int status = Z_OK;
+  for (size_t pos = 8; pos + 12 <= data.size() && status == Z_OK;) {
+    const uint32_t length = ReadU32(&data[pos]);
+    if (pos + 12 + length > data.size()) break;
+    if (memcmp(&data[pos + 4], "IDAT", 4) == 0) {
+      stream.next_in = &data[pos + 8];
+      stream.avail_in = length;
+      status = inflate(&stream, Z_NO_FLUSH);
+    }
+    pos += 12 + length;
+  }
+  inflateEnd(&stream);
+  if (status != Z_STREAM_END || stream.avail_out != 0) return false;
+
+  // Undo the filters in place, then expand to RGBA
+  for (uint32_t y = 0; y < height; ++y) {
+    uint8_t* line = &filtered[y * (row + 1) + 1];
+    const uint8_t* prev = y > 0 ? line - (row + 1) : NULL;
+    const uint8_t filter = line[-1];
+    for (size_t x = 0; x < row; ++x) {
+      const int32_t a = x >= channels ? line[x - channels] : 0;
+      const int32_t b = prev ? prev[x] : 0;
+      const int32_t c = prev && x >= channels ? prev[x - channels] : 0;
+      switch (filter) {
+        case 1: line[x] += a; break;
+        case 2: line[x] += b; break;
+        case 3: line[x] += (a + b) / 2; break;
+        case 4: line[x] += Paeth(a, b, c); break;
+        default: break;
+      }
+    }
+  }
+  *width_out = width;
+  *height_out = height;
+  rgba->resize(width * height * 4);
+  for (uint32_t y = 0; y < height; ++y) {
+    const uint8_t* src = &filtered[y * (row + 1) + 1];
+    uint8_t* dst = &(*rgba)[y * width * 4];
+    for (uint32_t x = 0; x < width; ++x, src += channels, dst += 4) {
+      dst[0] = src[0];
+      dst[1] = src[1];
+      dst[2] = src[2];
+      dst[3] = channels == 4 ? src[3] : 255;
+    }
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+// TGA
+//--------------------------------------------------------------------------------
+bool ReadTga(const std::string& path, int32_t* width_out, int32_t* height_out,
+             std::vector<uint8_t>* rgba) {
+  std::vector<uint8_t> data;
+  if (!ReadFile(path, &data) || data.size() < 18) return false;
+  const uint8_t id_length = data[0], color_map = data[1], type = data[2];
+  const int32_t width = data[12] | (data[13] << 8);
+  const int32_t height = data[14] | (data[15] << 8);
+  const int32_t bytes = data[16] / 8;
+  const bool top_first = (data[17] & 0x20) != 0;
+  if (color_map != 0 || (type != 2 && type != 10) || (bytes != 3 && bytes != 4))
+    return false;
+
+  // BGR(A) texels in file order
+  const size_t count = static_cast<size_t>(width) * height;
+  std::vector<uint8_t> texels(count * 4);
+  const uint8_t* p = &data[18 + id_length];
+  const uint8_t* end = data.data() + data.size();
+  for (size_t i = 0; i < count;) {
+    size_t run = 1;
+    bool repeat = false;
+    if (type == 10) {
+      if (p >= end) return false;
+      repeat = (*p & 0x80) != 0;
+      run = (*p++ & 0x7f) + 1;
+      if (i + run > count) return false;
+    }
+    for (size_t k = 0; k < run; ++k, ++i) {
+      if (p + bytes > end) return false;
+      uint8_t* dst = &texels[i * 4];
+      dst[0] = p[2];
+      dst[1] = p[1];
+      dst[2] = p[0];
+      dst[3] = bytes == 4 ? p[3] : 255;
+      if (!repeat || k + 1 == run) p += bytes;
+    }
+  }
+
+  *width_out = width;
+  *height_out = height;
+  rgba->resize(count * 4);
+  const size_t row = static_cast<size_t>(width) * 4;
+  for (int32_t y = 0; y < height; ++y) {
+    const int32_t src = top_first ? y : height - 1 - y;
+    memcpy(&(*rgba)[y * row], &texels[src * row], row);
+  }
+  return true;
+}
+
+bool ReadImage(const std::string& path, int32_t* width, int32_t* height,
+               std::vector<uint8_t>* rgba) {
+  const size_t dot = path.rfind('.');
+  const std::string extension =
+      dot == std::string::npos ? std::string() : path.substr(dot);
+  if (extension == ".tga" || extension == ".TGA")
+    return ReadTga(path, width, height, rgba);
+  return ReadPng(path, width, height, rgba);
+}
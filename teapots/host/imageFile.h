@@ -0,0 +1,43 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// imageFile.h
+// Minimal readers for the image files of the samples, for the host tools,
+// which have neither stb nor AImageDecoder. Both return RGBA8 with the top
+// row first.
+//--------------------------------------------------------------------------------
+#ifndef IMAGEFILE_H_
+#define IMAGEFILE_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// 8 bit RGB or RGBA, not interlaced
+bool ReadPng(const std::string& path, int32_t* width, int32_t* height,
+             std::vector<uint8_t>* rgba);
+
+// Uncompressed or RLE true color, 24 or 32 bits
+bool ReadTga(const std::string& path, int32_t* width, int32_t* height,
+             std::vector<uint8_t>* rgba);
+
+// Either of them, by extension
+bool ReadImage(const std::string& path, int32_t* width, int32_t* height,
+               std::vector<uint8_t>* rgba);
+
+#endif /* IMAGEFILE_H_ */
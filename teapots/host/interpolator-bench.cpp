@@ -0,0 +1,280 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// interpolator-bench.cpp
+// Animates many values at once with ndk_helper::InterpolatorPool, against
+// the former ndk_helper::Interpolator (a std::list of queued segments and
+// a switch over the type per value), and checks the pool against a plain
+// evaluation of the same segments.
+//
+//   interpolator-bench [-n tracks] [-s segments per track] [-f frames]
+//--------------------------------------------------------------------------------
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "interpolatorPool.h"
+
+using ndk_helper::INTERPOLATOR_TYPE;
+using ndk_helper::InterpolatorParams;
+using ndk_helper::InterpolatorPool;
+
+// The former ndk_helper::Interpolator, with the time of Set() passed in
+class LegacyInterpolator {
+  double start_time_;
+  double dest_time_;
+  INTERPOLATOR_TYPE type_;
+  float start_value_;
+  float dest_value_;
+  std::list<InterpolatorParams> list_params_;
+
+  float GetFormula(const INTERPOLATOR_TYPE type, const float t, const float b,
+                   const float d, const float c) {
+    float t1;
+    switch (type) {
+      case ndk_helper::INTERPOLATOR_TYPE_LINEAR:
+        return (c * t / d + b);
+      case ndk_helper::INTERPOLATOR_TYPE_EASEINQUAD:
+        t1 = t / d;
+        return (c * t1 * t1 + b);
+      case ndk_helper::INTERPOLATOR_TYPE_EASEOUTQUAD:
+        t1 = t / d;
+        return (-c * t1 * (t1 - 2) + b);
+      case ndk_helper::INTERPOLATOR_TYPE_EASEINOUTQUAD:
+        t1 = t / d / 2;
+        if (t1 < 1) return (c / 2 * t1 * t1 + b);
+        t1 = t1 - 1;
+        return (-c / 2 * (t1 * (t1 - 2) - 1) + b);
+      case ndk_helper::INTERPOLATOR_TYPE_EASEINCUBIC:
+        t1 = t / d;
+        return (c * t1 * t1 * t1 + b);
+      case ndk_helper::INTERPOLATOR_TYPE_EASEOUTCUBIC:
+        t1 = t / d - 1;
+        return (c * (t1 * t1 * t1 + 1) + b);
+      case ndk_helper::INTERPOLATOR_TYPE_EASEINOUTCUBIC:
+        t1 = t / d / 2;
+        if (t1 < 1) return (c / 2 * t1 * t1 * t1 + b);
+        t1 -= 2;
+        return (c / 2 * (t1 * t1 * t1 + 2) + b);
+      case ndk_helper::INTERPOLATOR_TYPE_EASEINQUART:
+        t1 = t / d;
+        return (c * t1 * t1 * t1 * t1 + b);
+      case ndk_helper::INTERPOLATOR_TYPE_EASEINEXPO:
+        if (t == 0) return b;
+        return (c * powf(2, (10 * (t / d - 1))) + b);
+      case ndk_helper::INTERPOLATOR_TYPE_EASEOUTEXPO:
+        if (t == d) return (b + c);
+        return (c * (-powf(2, -10 * t / d) + 1) + b);
+      default:
+        return 0;
+    }
+  }
+
+ public:
+  void Set(const float start, const float dest, const INTERPOLATOR_TYPE type,
+           double duration, double current_time) {
+    start_time_ = current_time;
+    dest_time_ = start_time_ + duration;
+    type_ = type;
+    start_value_ = start;
+    dest_value_ = dest;
+  }
+
+  void Add(const float dest, const INTERPOLATOR_TYPE type,
+           const double duration) {
+    InterpolatorParams param;
+    param.dest_value_ = dest;
+    param.type_ = type;
+    param.duration_ = duration;
+    list_params_.push_back(param);
+  }
+
+  bool Update(const double current_time, float& p) {
+    if (current_time >= dest_time_) {
+      p = dest_value_;
+      if (list_params_.empty()) return false;
+      InterpolatorParams& item = list_params_.front();
+      Set(dest_value_, item.dest_value_, item.type_, item.duration_,
+          current_time);
+      list_params_.pop_front();
+      return true;
+    }
+    float t = (float)(current_time - start_time_);
+    float d = (float)(dest_time_ - start_time_);
+    p = GetFormula(type_, t, start_value_, d, dest_value_ - start_value_);
+    return true;
+  }
+};
+
+struct Segment {
+  float dest;
+  float duration;
+  INTERPOLATOR_TYPE type;
+};
+
+// Value of a track whose segments start at time 0 from 'start'
+static float Reference(float start, const Segment* segments, int32_t count,
+                       double time) {
+  double begin = 0.0;
+  for (int32_t i = 0; i < count; ++i) {
+    if (time < begin + segments[i].duration) {
+      const float u = (float)((time - begin) / segments[i].duration);
+      return start +
+             (segments[i].dest - start) * ndk_helper::Ease(segments[i].type, u);
+    }
+    begin += segments[i].duration;
+    start = segments[i].dest;
+  }
+  return start;
+}
+
+static double Ms(std::chrono::steady_clock::time_point a,
+                 std::chrono::steady_clock::time_point b) {
+  return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+int main(int argc, char** argv) {
+  int32_t track_count = 100000;
+  int32_t segment_count = 12;
+  int32_t frame_count = 300;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:s:f:")) != -1) {
+    switch (opt) {
+      case 'n':
+        track_count = atoi(optarg);
+        break;
+      case 's':
+        segment_count = atoi(optarg);
+        break;
+      case 'f':
+        frame_count = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-n tracks] [-s segments per track] [-f frames]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+
+  // Random segments of 0.5 to 1 s, frames at 60 Hz
+  std::mt19937 random(1);
+  std::uniform_real_distribution<float> value(-100.f, 100.f);
+  std::uniform_real_distribution<float> duration(0.5f, 1.f);
+  std::uniform_int_distribution<int> type(0,
+                                          ndk_helper::INTERPOLATOR_TYPE_COUNT - 1);
+  std::vector<float> starts(track_count);
+  std::vector<Segment> segments(track_count * segment_count);
+  for (int32_t i = 0; i < track_count; ++i) {
+    starts[i] = value(random);
+    for (int32_t k = 0; k < segment_count; ++k) {
+      Segment& segment = segments[i * segment_count + k];
+      segment.dest = value(random);
+      segment.duration = duration(random);
+      segment.type = static_cast<INTERPOLATOR_TYPE>(type(random));
+    }
+  }
+  const double kFrameTime = 1.0 / 60.0;
+  const double start_time = 1000.0;
+
+  printf("%d tracks of %d segments, %d frames\n", track_count, segment_count,
+         frame_count);
+  std::vector<float> values(track_count);
+  volatile float sink = 0.f;
+
+  // Legacy: each segment is a list node
+  {
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<LegacyInterpolator> interpolators(track_count);
+    for (int32_t i = 0; i < track_count; ++i) {
+      const Segment* s = &segments[i * segment_count];
+      interpolators[i].Set(starts[i], s[0].dest, s[0].type, s[0].duration,
+                           start_time);
+      for (int32_t k = 1; k < segment_count; ++k)
+        interpolators[i].Add(s[k].dest, s[k].type, s[k].duration);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int32_t f = 1; f <= frame_count; ++f) {
+      const double now = start_time + f * kFrameTime;
+      for (int32_t i = 0; i < track_count; ++i)
+        interpolators[i].Update(now, values[i]);
+      sink = sink + values[f % track_count];
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    printf("  Interpolator (list)   setup %8.2f ms  update %7.3f ms/frame  "
+           "%6.2f ns/track\n",
+           Ms(t0, t1), Ms(t1, t2) / frame_count,
+           1e6 * Ms(t1, t2) / frame_count / track_count);
+  }
+
+  // Pool
+  {
+    auto t0 = std::chrono::steady_clock::now();
+    InterpolatorPool pool;
+    pool.Reserve(track_count, track_count * segment_count);
+    std::vector<InterpolatorPool::Track> tracks(track_count);
+    for (int32_t i = 0; i < track_count; ++i) {
+      const Segment* s = &segments[i * segment_count];
+      tracks[i] = pool.Create(starts[i]);
+      pool.Set(tracks[i], starts[i], s[0].dest, s[0].type, s[0].duration,
+               start_time);
+      for (int32_t k = 1; k < segment_count; ++k)
+        pool.Add(tracks[i], s[k].dest, s[k].type, s[k].duration);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double max_error = 0.0;
+    int32_t animated = 0;
+    double update_ms = 0.0;
+    for (int32_t f = 1; f <= frame_count; ++f) {
+      const double now = start_time + f * kFrameTime;
+      auto u0 = std::chrono::steady_clock::now();
+      animated = pool.Update(now);
+      for (int32_t i = 0; i < track_count; ++i)
+        values[i] = pool.GetValue(tracks[i]);
+      update_ms += Ms(u0, std::chrono::steady_clock::now());
+      sink = sink + values[f % track_count];
+
+      // Checked on a few frames, out of the timing
+      if (f % 50 == 0 || f == frame_count) {
+        for (int32_t i = 0; i < track_count; ++i) {
+          const float expected =
+              Reference(starts[i], &segments[i * segment_count],
+                        segment_count, now - start_time);
+          max_error = fmax(max_error, fabs(values[i] - expected));
+        }
+      }
+    }
+    printf("  InterpolatorPool      setup %8.2f ms  update %7.3f ms/frame  "
+           "%6.2f ns/track\n",
+           Ms(t0, t1), update_ms / frame_count,
+           1e6 * update_ms / frame_count / track_count);
+    printf("  %d tracks still animated, largest difference from the "
+           "reference %g\n",
+           animated, max_error);
+    if (max_error > 1e-2) {
+      printf("FAILED\n");
+      return 1;
+    }
+  }
+  return 0;
+}
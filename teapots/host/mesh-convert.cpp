@@ -0,0 +1,421 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// mesh-convert.cpp
+// Offline converter to the binary mesh format of ndk_helper/meshFormat.h
+//
+//   mesh-convert [-N] [-T] [-n] input.{obj,inl} output.mesh
+//
+// Inputs are Wavefront OBJ files, or C sources with float arrays named
+// *Positions, *Normals and *TexCoords (3 floats per vertex) and a uint16_t
+// array named *Indices, like the teapot.inl the samples used to compile in.
+// -N and -T drop the normals and texture coordinates.
+// Triangles and vertices are reordered for the GPU vertex caches unless -n
+// is given; the cache miss ratio is printed before and after.
+//--------------------------------------------------------------------------------
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "meshFormat.h"
+#include "meshOptimizer.h"
+
+namespace optimizer = ndk_helper::mesh_optimizer;
+
+struct SourceMesh {
+  std::vector<float> positions;  // 3 per vertex
+  std::vector<float> normals;    // 3 per vertex, or empty
+  std::vector<float> texcoords;  // 2 per vertex, or empty
+  std::vector<uint32_t> indices;
+};
+
+static bool ReadText(const char* path, std::string* text) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f) return false;
+  std::stringstream ss;
+  ss << f.rdbuf();
+  *text = ss.str();
+  return true;
+}
+
+static bool EndsWith(const std::string& s, const char* suffix) {
+  size_t n = strlen(suffix);
+  return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+//--------------------------------------------------------------------------------
+// C arrays
+//--------------------------------------------------------------------------------
+// Numbers of the initializer of the array whose name ends with 'suffix'
+static bool ParseArray(const std::string& text, const char* suffix,
+                       std::vector<double>* values) {
+  std::string key = std::string(suffix) + "[]";
+  size_t pos = text.find(key);
+  if (pos == std::string::npos) return false;
+  size_t begin = text.find('{', pos);
+  size_t end = text.find('}', begin);
+  if (begin == std::string::npos || end == std::string::npos) return false;
+
+  const char* p = text.c_str() + begin + 1;
+  const char* last = text.c_str() + end;
+  while (p < last) {
+    char* next;
+    double v = strtod(p, &next);
+    if (next == p) {
+      ++p;  // Separator
+      continue;
+    }
+    values->push_back(v);
+    p = next;
+  }
+  return true;
+}
+
+static bool LoadArrays(const std::string& text, SourceMesh* mesh) {
+  std::vector<double> positions, normals, texcoords, indices;
+  if (!ParseArray(text, "Positions", &positions) ||
+      !ParseArray(text, "Indices", &indices) || positions.size() % 3 != 0) {
+    fprintf(stderr, "no *Positions[] and *Indices[] arrays\n");
+    return false;
+  }
+  const size_t count = positions.size() / 3;
+  mesh->positions.assign(positions.begin(), positions.end());
+  if (ParseArray(text, "Normals", &normals)) {
+    if (normals.size() != count * 3) {
+      fprintf(stderr, "*Normals[] doesn't match *Positions[]\n");
+      return false;
+    }
+    mesh->normals.assign(normals.begin(), normals.end());
+  }
+  if (ParseArray(text, "TexCoords", &texcoords)) {
+    if (texcoords.size() != count * 3) {
+      fprintf(stderr, "*TexCoords[] doesn't match *Positions[]\n");
+      return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      mesh->texcoords.push_back(static_cast<float>(texcoords[3 * i]));
+      mesh->texcoords.push_back(static_cast<float>(texcoords[3 * i + 1]));
+    }
+  }
+  for (double index : indices) {
+    if (index < 0 || index >= count) {
+      fprintf(stderr, "index %g out of range\n", index);
+      return false;
+    }
+    mesh->indices.push_back(static_cast<uint32_t>(index));
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+// OBJ
+//--------------------------------------------------------------------------------
+// 1 based OBJ index, negative ones count from the end; returns -1 if invalid
+static int32_t ObjIndex(long index, size_t count) {
+  if (index > 0 && static_cast<size_t>(index) <= count) return index - 1;
+  if (index < 0 && static_cast<size_t>(-index) <= count)
+    return static_cast<int32_t>(count + index);
+  return -1;
+}
+
+static bool LoadObj(const std::string& text, SourceMesh* mesh) {
+  std::vector<float> v, vn, vt;
+  std::map<std::tuple<int32_t, int32_t, int32_t>, uint32_t> vertices;
+  bool has_normals = true;
+  bool has_texcoords = true;
+  std::vector<std::tuple<int32_t, int32_t, int32_t> > corners;
+
+  std::istringstream lines(text);
+  std::string line;
+  int line_number = 0;
+  while (std::getline(lines, line)) {
+    ++line_number;
+    std::istringstream ls(line);
+    std::string tag;
+    ls >> tag;
+    if (tag == "v" || tag == "vn" || tag == "vt") {
+      std::vector<float>& dst = tag == "v" ? v : tag == "vn" ? vn : vt;
+      int n = tag == "vt" ? 2 : 3;
+      for (int i = 0; i < n; ++i) {
+        float f = 0.f;
+        ls >> f;
+        dst.push_back(f);
+      }
+    } else if (tag == "f") {
+      corners.clear();
+      std::string corner;
+      while (ls >> corner) {
+        long iv = 0, it = 0, in = 0;
+        const char* p = corner.c_str();
+        char* next;
+        iv = strtol(p, &next, 10);
+        if (*next == '/') {
+          p = next + 1;
+          it = strtol(p, &next, 10);
+          if (*next == '/') in = strtol(next + 1, &next, 10);
+        }
+        int32_t pv = ObjIndex(iv, v.size() / 3);
+        int32_t pt = it ? ObjIndex(it, vt.size() / 2) : -1;
+        int32_t pn = in ? ObjIndex(in, vn.size() / 3) : -1;
+        if (pv < 0 || (it && pt < 0) || (in && pn < 0)) {
+          fprintf(stderr, "line %d: bad face index\n", line_number);
+          return false;
+        }
+        has_texcoords = has_texcoords && pt >= 0;
+        has_normals = has_normals && pn >= 0;
+        corners.push_back(std::make_tuple(pv, pt, pn));
+      }
+      // Fan triangulation of polygons
+      for (size_t i = 2; i < corners.size(); ++i) {
+        const size_t triangle[3] = {0, i - 1, i};
+        for (size_t k : triangle) {
+          auto it = vertices.find(corners[k]);
+          if (it == vertices.end()) {
+            uint32_t index = static_cast<uint32_t>(vertices.size());
+            it = vertices.insert(std::make_pair(corners[k], index)).first;
+          }
+          mesh->indices.push_back(it->second);
+        }
+      }
+    }
+  }
+
+  const size_t count = vertices.size();
+  mesh->positions.resize(count * 3);
+  if (has_normals) mesh->normals.resize(count * 3);
+  if (has_texcoords) mesh->texcoords.resize(count * 2);
+  for (const auto& vertex : vertices) {
+    const uint32_t i = vertex.second;
+    const int32_t pv = std::get<0>(vertex.first);
+    const int32_t pt = std::get<1>(vertex.first);
+    const int32_t pn = std::get<2>(vertex.first);
+    for (int k = 0; k < 3; ++k) mesh->positions[3 * i + k] = v[3 * pv + k];
+    if (has_normals) {
+      for (int k = 0; k < 3; ++k) mesh->normals[3 * i + k] = vn[3 * pn + k];
+    }
+    if (has_texcoords) {
+      for (int k = 0; k < 2; ++k) mesh->texcoords[2 * i + k] = vt[2 * pt + k];
+    }
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+// Optimization
+//--------------------------------------------------------------------------------
+static void Optimize(SourceMesh* mesh) {
+  const int32_t index_count = static_cast<int32_t>(mesh->indices.size());
+  const int32_t vertex_count = static_cast<int32_t>(mesh->positions.size() / 3);
+  const float acmr =
+      optimizer::ComputeACMR(mesh->indices.data(), index_count, vertex_count);
+
+  // Meshes authored as rows of patches can already beat the optimizer on
+  // the FIFO, keep their order then.
+  std::vector<uint32_t> optimized = mesh->indices;
+  optimizer::OptimizeVertexCache(optimized.data(), index_count, vertex_count);
+  const bool reordered =
+      optimizer::ComputeACMR(optimized.data(), index_count, vertex_count) <
+      acmr;
+  if (reordered) mesh->indices.swap(optimized);
+  uint32_t* indices = mesh->indices.data();
+
+  std::vector<uint32_t> remap(vertex_count);
+  const int32_t used = optimizer::OptimizeVertexFetchRemap(
+      indices, index_count, vertex_count, remap.data());
+
+  // Move every attribute array to the new vertex order
+  SourceMesh source = *mesh;
+  mesh->positions.resize(used * 3);
+  if (!mesh->normals.empty()) mesh->normals.resize(used * 3);
+  if (!mesh->texcoords.empty()) mesh->texcoords.resize(used * 2);
+  for (int32_t v = 0; v < vertex_count; ++v) {
+    const uint32_t i = remap[v];
+    if (i == optimizer::kUnusedVertex) continue;
+    for (int k = 0; k < 3; ++k)
+      mesh->positions[3 * i + k] = source.positions[3 * v + k];
+    if (!mesh->normals.empty()) {
+      for (int k = 0; k < 3; ++k)
+        mesh->normals[3 * i + k] = source.normals[3 * v + k];
+    }
+    if (!mesh->texcoords.empty()) {
+      for (int k = 0; k < 2; ++k)
+        mesh->texcoords[2 * i + k] = source.texcoords[2 * v + k];
+    }
+  }
+
+  printf("ACMR (%d entry FIFO) %.3f -> %.3f", optimizer::kDefaultCacheSize,
+         acmr, optimizer::ComputeACMR(indices, index_count, used));
+  if (!reordered) printf(", input triangle order kept");
+  if (used != vertex_count)
+    printf(", %d unused vertices dropped", vertex_count - used);
+  printf("\n");
+}
+
+//--------------------------------------------------------------------------------
+// Output
+//--------------------------------------------------------------------------------
+static uint32_t Align16(uint32_t offset) { return (offset + 15) & ~15u; }
+
+static int16_t QuantizeNormal(float f) {
+  f = std::min(std::max(f, -1.f), 1.f);
+  return static_cast<int16_t>(lrintf(f * 32767.f));
+}
+
+static bool WriteMesh(const SourceMesh& mesh, const char* path) {
+  const uint32_t vertex_count =
+      static_cast<uint32_t>(mesh.positions.size() / 3);
+  if (vertex_count > 65536) {
+    fprintf(stderr, "%u vertices, 16 bit indices address 65536 at most\n",
+            vertex_count);
+    return false;
+  }
+
+  MESH_HEADER header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, MESH_MAGIC, 4);
+  header.version = MESH_VERSION;
+  header.vertex_count = vertex_count;
+  header.index_count = static_cast<uint32_t>(mesh.indices.size());
+  header.vertex_stride = 3 * sizeof(float);
+  if (!mesh.normals.empty()) {
+    header.attributes |= MESH_ATTRIBUTE_NORMAL;
+    header.normal_offset = header.vertex_stride;
+    header.vertex_stride += 4 * sizeof(int16_t);  // 3 + padding
+  }
+  if (!mesh.texcoords.empty()) {
+    header.attributes |= MESH_ATTRIBUTE_TEXCOORD;
+    header.texcoord_offset = header.vertex_stride;
+    header.vertex_stride += 2 * sizeof(float);
+  }
+  header.vertex_data_offset = Align16(sizeof(MESH_HEADER));
+  header.index_data_offset = Align16(header.vertex_data_offset +
+                                     vertex_count * header.vertex_stride);
+
+  std::vector<uint8_t> file(header.index_data_offset +
+                            header.index_count * sizeof(uint16_t));
+  float radius2 = 0.f;
+  for (int k = 0; k < 3; ++k) {
+    header.bounds_min[k] = vertex_count ? mesh.positions[k] : 0.f;
+    header.bounds_max[k] = header.bounds_min[k];
+  }
+  for (uint32_t i = 0; i < vertex_count; ++i) {
+    uint8_t* vertex =
+        file.data() + header.vertex_data_offset + i * header.vertex_stride;
+    const float* p = &mesh.positions[3 * i];
+    memcpy(vertex, p, 3 * sizeof(float));
+    for (int k = 0; k < 3; ++k) {
+      header.bounds_min[k] = std::min(header.bounds_min[k], p[k]);
+      header.bounds_max[k] = std::max(header.bounds_max[k], p[k]);
+    }
+    radius2 = std::max(radius2, p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+
+    if (header.attributes & MESH_ATTRIBUTE_NORMAL) {
+      int16_t n[4] = {QuantizeNormal(mesh.normals[3 * i]),
+                      QuantizeNormal(mesh.normals[3 * i + 1]),
+                      QuantizeNormal(mesh.normals[3 * i + 2]), 0};
+      memcpy(vertex + header.normal_offset, n, sizeof(n));
+    }
+    if (header.attributes & MESH_ATTRIBUTE_TEXCOORD) {
+      memcpy(vertex + header.texcoord_offset, &mesh.texcoords[2 * i],
+             2 * sizeof(float));
+    }
+  }
+  header.radius = sqrtf(radius2);
+
+  uint16_t* indices =
+      reinterpret_cast<uint16_t*>(file.data() + header.index_data_offset);
+  for (size_t i = 0; i < mesh.indices.size(); ++i)
+    indices[i] = static_cast<uint16_t>(mesh.indices[i]);
+  memcpy(file.data(), &header, sizeof(header));
+
+  // Write a temporary file first so that a failure leaves no partial mesh.
+  std::string tmp_path = std::string(path) + ".tmp";
+  FILE* f = fopen(tmp_path.c_str(), "wb");
+  if (f == NULL) {
+    perror(tmp_path.c_str());
+    return false;
+  }
+  bool ok = fwrite(file.data(), 1, file.size(), f) == file.size();
+  ok = fclose(f) == 0 && ok;
+  if (!ok || rename(tmp_path.c_str(), path) != 0) {
+    perror(path);
+    remove(tmp_path.c_str());
+    return false;
+  }
+
+  printf("%s: %u vertices of %u bytes, %u indices, %zu bytes\n", path,
+         vertex_count, header.vertex_stride, header.index_count, file.size());
+  printf("  bounds (%g %g %g) - (%g %g %g), radius %g\n", header.bounds_min[0],
+         header.bounds_min[1], header.bounds_min[2], header.bounds_max[0],
+         header.bounds_max[1], header.bounds_max[2], header.radius);
+  return true;
+}
+
+static void Usage(const char* argv0) {
+  fprintf(stderr,
+          "usage: %s [-N] [-T] [-n] input.{obj,inl,h} output.mesh\n"
+          "  -N  drop the normals\n"
+          "  -T  drop the texture coordinates\n"
+          "  -n  keep the input order of triangles and vertices\n",
+          argv0);
+}
+
+int main(int argc, char** argv) {
+  bool keep_normals = true;
+  bool keep_texcoords = true;
+  bool optimize = true;
+  int arg = 1;
+  for (; arg < argc && argv[arg][0] == '-'; ++arg) {
+    if (strcmp(argv[arg], "-N") == 0) {
+      keep_normals = false;
+    } else if (strcmp(argv[arg], "-T") == 0) {
+      keep_texcoords = false;
+    } else if (strcmp(argv[arg], "-n") == 0) {
+      optimize = false;
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+  if (argc - arg != 2) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  std::string text;
+  if (!ReadText(argv[arg], &text)) {
+    perror(argv[arg]);
+    return 1;
+  }
+  SourceMesh mesh;
+  bool ok = EndsWith(argv[arg], ".obj") ? LoadObj(text, &mesh)
+                                        : LoadArrays(text, &mesh);
+  if (!ok) return 1;
+  if (!keep_normals) mesh.normals.clear();
+  if (!keep_texcoords) mesh.texcoords.clear();
+  if (optimize) Optimize(&mesh);
+  return WriteMesh(mesh, argv[arg + 1]) ? 0 : 1;
+}
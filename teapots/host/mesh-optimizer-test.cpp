@@ -0,0 +1,248 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// mesh-optimizer-test.cpp
+// Checks ndk_helper::mesh_optimizer with 16 and 32-bit indices, on a
+// regular grid, random triangle soups with unused vertices, and meshes with
+// degenerate triangles:
+// - OptimizeVertexCache() keeps the same set of triangles, each with its
+//   winding, and doesn't make the cache miss ratio of the grid worse,
+// - OptimizeVertexFetch() keeps every triangle pointing at the same vertex
+//   data, numbers the vertices in the order of first use and drops the
+//   unused ones; OptimizeVertexFetchRemap() fills its table to match,
+// - ComputeACMR() gives the expected ratio on small known cases.
+// Exits with 1 if any check fails.
+//
+//   mesh-optimizer-test [-s seed]
+//--------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "meshOptimizer.h"
+
+namespace optimizer = ndk_helper::mesh_optimizer;
+
+static int32_t failures = 0;
+
+static void Check(const bool ok, const std::string& mesh, const char* what) {
+  if (!ok) {
+    printf("  %s: %s FAILED\n", mesh.c_str(), what);
+    ++failures;
+  }
+}
+
+struct Mesh {
+  std::string name;
+  int32_t vertex_count;
+  std::vector<uint32_t> indices;
+};
+
+// Triangles as sorted (a, b, c) triples, each rotated to start with its
+// smallest vertex, which keeps the winding
+static std::vector<uint64_t> Triangles(const std::vector<uint32_t>& indices) {
+  std::vector<uint64_t> ret;
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    uint32_t t[3] = {indices[i], indices[i + 1], indices[i + 2]};
+    while (t[0] > t[1] || t[0] > t[2]) std::rotate(t, t + 1, t + 3);
+    ret.push_back(static_cast<uint64_t>(t[0]) << 42 |
+                  static_cast<uint64_t>(t[1]) << 21 | t[2]);
+  }
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+static Mesh Grid(const int32_t size) {
+  Mesh mesh;
+  mesh.name = "grid " + std::to_string(size) + "x" + std::to_string(size);
+  mesh.vertex_count = (size + 1) * (size + 1);
+  for (int32_t y = 0; y < size; ++y) {
+    for (int32_t x = 0; x < size; ++x) {
+      const uint32_t a = y * (size + 1) + x, b = a + 1, c = a + size + 1,
+                     d = c + 1;
+      const uint32_t quad[6] = {a, b, d, a, d, c};
+      mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+    }
+  }
+  return mesh;
+}
+
+// Random triangles over the first 'used' of 'vertex_count' vertices, some
+// of them degenerate if 'degenerate'
+static Mesh Soup(const int32_t triangle_count, const int32_t vertex_count,
+                 const int32_t used, const bool degenerate,
+                 std::mt19937* rng) {
+  Mesh mesh;
+  mesh.name = std::string(degenerate ? "degenerate soup " : "soup ") +
+              std::to_string(triangle_count) + " triangles, " +
+              std::to_string(used) + "/" + std::to_string(vertex_count) +
+              " vertices used";
+  mesh.vertex_count = vertex_count;
+  std::uniform_int_distribution<uint32_t> vertex(0, used - 1);
+  for (int32_t t = 0; t < triangle_count; ++t) {
+    uint32_t a = vertex(*rng), b = vertex(*rng), c = vertex(*rng);
+    if (degenerate) {
+      switch (t % 4) {
+        case 1:
+          b = a;
+          break;
+        case 2:
+          b = c = a;
+          break;
+        case 3:
+          c = b;
+          break;
+      }
+    }
+    mesh.indices.push_back(a);
+    mesh.indices.push_back(b);
+    mesh.indices.push_back(c);
+  }
+  return mesh;
+}
+
+template <typename T>
+static void CheckMesh(const Mesh& mesh, const bool expect_better_acmr) {
+  const int32_t index_count = static_cast<int32_t>(mesh.indices.size());
+  const std::string name = mesh.name + (sizeof(T) == 2 ? " (16" : " (32") +
+                           "-bit indices)";
+  std::vector<T> indices(mesh.indices.begin(), mesh.indices.end());
+
+  const float acmr_before =
+      optimizer::ComputeACMR(indices.data(), index_count, mesh.vertex_count);
+  optimizer::OptimizeVertexCache(indices.data(), index_count,
+                                 mesh.vertex_count);
+  const float acmr_after =
+      optimizer::ComputeACMR(indices.data(), index_count, mesh.vertex_count);
+  std::vector<uint32_t> reordered(indices.begin(), indices.end());
+  Check(Triangles(reordered) == Triangles(mesh.indices), name,
+        "triangles or winding changed by OptimizeVertexCache()");
+  if (expect_better_acmr)
+    Check(acmr_after <= acmr_before, name, "ACMR got worse");
+
+  // Each vertex holds its old number, and some padding to move along
+  struct Vertex {
+    uint32_t old_index;
+    float padding[3];
+  };
+  std::vector<Vertex> vertices(mesh.vertex_count);
+  for (int32_t v = 0; v < mesh.vertex_count; ++v) {
+    vertices[v].old_index = v;
+    vertices[v].padding[0] = vertices[v].padding[1] =
+        vertices[v].padding[2] = static_cast<float>(v);
+  }
+  std::vector<T> fetch_indices = indices;
+  const int32_t kept = optimizer::OptimizeVertexFetch(
+      vertices.data(), fetch_indices.data(), index_count, mesh.vertex_count,
+      sizeof(Vertex));
+
+  std::vector<bool> used(mesh.vertex_count, false);
+  int32_t used_count = 0;
+  for (const T v : indices) {
+    used_count += !used[v];
+    used[v] = true;
+  }
+  Check(kept == used_count, name, "vertex count after OptimizeVertexFetch()");
+
+  bool same_data = true, first_use_order = true;
+  uint32_t next = 0;
+  for (int32_t i = 0; i < index_count; ++i) {
+    const T v = fetch_indices[i];
+    if (static_cast<int32_t>(v) >= kept ||
+        vertices[v].old_index != indices[i] ||
+        vertices[v].padding[2] != static_cast<float>(indices[i]))
+      same_data = false;
+    if (v > next) first_use_order = false;
+    if (v == next) ++next;
+  }
+  Check(same_data, name, "vertex data after OptimizeVertexFetch()");
+  Check(first_use_order, name, "first use order of OptimizeVertexFetch()");
+
+  std::vector<T> remap_indices = indices;
+  std::vector<uint32_t> remap(mesh.vertex_count);
+  const int32_t remapped = optimizer::OptimizeVertexFetchRemap(
+      remap_indices.data(), index_count, mesh.vertex_count, remap.data());
+  bool remap_ok = remapped == kept && remap_indices == fetch_indices;
+  std::vector<bool> taken(kept > 0 ? kept : 0, false);
+  for (int32_t v = 0; v < mesh.vertex_count && remap_ok; ++v) {
+    if (!used[v]) {
+      remap_ok = remap[v] == optimizer::kUnusedVertex;
+    } else {
+      remap_ok = remap[v] < static_cast<uint32_t>(kept) && !taken[remap[v]] &&
+                 vertices[remap[v]].old_index == static_cast<uint32_t>(v);
+      if (remap_ok) taken[remap[v]] = true;
+    }
+  }
+  Check(remap_ok, name, "remap table of OptimizeVertexFetchRemap()");
+
+  printf("  %-60s ACMR %.3f -> %.3f, %d -> %d vertices\n", name.c_str(),
+         acmr_before, acmr_after, mesh.vertex_count, kept);
+}
+
+int main(int argc, char** argv) {
+  uint32_t seed = 1;
+  int opt;
+  while ((opt = getopt(argc, argv, "s:")) != -1) {
+    switch (opt) {
+      case 's':
+        seed = static_cast<uint32_t>(atoi(optarg));
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-s seed]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  // Known cache miss ratios
+  const uint32_t one[] = {0, 1, 2};
+  const uint32_t quad[] = {0, 1, 2, 2, 1, 3};
+  const uint32_t far_apart[] = {0, 1, 2, 3, 4, 5, 0, 1, 2};
+  Check(optimizer::ComputeACMR(one, 3, 3) == 3.f, "one triangle", "ACMR");
+  Check(optimizer::ComputeACMR(quad, 6, 4) == 2.f, "quad", "ACMR");
+  Check(optimizer::ComputeACMR(far_apart, 9, 6, 3) == 3.f, "FIFO of 3",
+        "ACMR");
+  Check(optimizer::ComputeACMR(far_apart, 9, 6, 6) == 2.f, "FIFO of 6",
+        "ACMR");
+
+  std::mt19937 rng(seed);
+  std::vector<Mesh> meshes;
+  meshes.push_back(Grid(1));
+  meshes.push_back(Grid(64));
+  meshes.push_back(Soup(1, 3, 3, false, &rng));
+  meshes.push_back(Soup(2000, 1000, 1000, false, &rng));
+  meshes.push_back(Soup(2000, 3000, 900, false, &rng));
+  meshes.push_back(Soup(2000, 500, 400, true, &rng));
+  meshes.push_back(Soup(8, 2, 1, true, &rng));
+  for (const Mesh& mesh : meshes) {
+    CheckMesh<uint16_t>(mesh, mesh.name.compare(0, 4, "grid") == 0);
+    CheckMesh<uint32_t>(mesh, mesh.name.compare(0, 4, "grid") == 0);
+  }
+
+  // Empty mesh: nothing to do, nothing to crash on
+  Mesh empty;
+  empty.name = "empty";
+  empty.vertex_count = 4;
+  CheckMesh<uint32_t>(empty, false);
+
+  if (failures) printf("%d checks FAILED\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,288 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// mipmap-bench.cpp
+// Checks ndk_helper::MipChain against a plain double precision reference
+// (2D filter weights, pow() for sRGB), round trips a chain through its cache
+// file, then times Generate().
+//
+//   mipmap-bench [-s size] [-t threads] [-r runs]
+//--------------------------------------------------------------------------------
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "jobSystem.h"
+#include "mipmap.h"
+
+using ndk_helper::MipChain;
+using ndk_helper::MipmapOptions;
+
+static double ToLinear(double c) {
+  return c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+}
+static double ToSrgb(double v) {
+  return v <= 0.0031308 ? v * 12.92 : 1.055 * pow(v, 1.0 / 2.4) - 0.055;
+}
+
+static double ReferenceKernel(double x, bool kaiser) {
+  if (!kaiser) return fabs(x) < 0.5 ? 1.0 : 0.0;
+  const double radius = 2.0, alpha = 4.0;
+  if (fabs(x) >= radius) return 0.0;
+  auto i0 = [](double y) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 40; ++k) {
+      term *= (y / (2.0 * k)) * (y / (2.0 * k));
+      sum += term;
+    }
+    return sum;
+  };
+  const double sinc = x == 0.0 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+  return sinc * i0(alpha * sqrt(1.0 - (x / radius) * (x / radius))) / i0(alpha);
+}
+
+// Weights of the src texels for dst texel i, indexed by texel after wrap or
+// clamp
+static std::vector<double> ReferenceWeights(int src, int dst, int i,
+                                            const MipmapOptions& options) {
+  std::vector<double> w(src, 0.0);
+  if (src == dst) {
+    w[i] = 1.0;
+    return w;
+  }
+  const double scale = double(src) / dst;
+  const bool kaiser = options.filter == ndk_helper::MIPMAP_FILTER_KAISER;
+  double sum = 0.0;
+  for (int j = -4 * src; j < 5 * src; ++j) {
+    double weight;
+    if (kaiser) {
+      weight = ReferenceKernel((j + 0.5 - (i + 0.5) * scale) / scale, true);
+    } else {
+      const double lo = i * scale, hi = (i + 1) * scale;
+      weight = std::max(0.0, std::min(j + 1.0, hi) - std::max(double(j), lo));
+    }
+    if (weight == 0.0) continue;
+    const int texel =
+        options.wrap ? ((j % src) + src) % src : std::min(std::max(j, 0), src - 1);
+    w[texel] += weight;
+    sum += weight;
+  }
+  for (auto& v : w) v /= sum;
+  return w;
+}
+
+// Largest difference of any channel of any level, and the number of
+// channels that differ
+static int Compare(const MipChain& chain, const std::vector<uint8_t>& image,
+                   int width, int height, const MipmapOptions& options,
+                   int* differing) {
+  *differing = 0;
+  // Level 0 in linear light, premultiplied
+  std::vector<double> level(width * height * 4);
+  for (int i = 0; i < width * height; ++i) {
+    const double a = image[i * 4 + 3] / 255.0;
+    for (int c = 0; c < 3; ++c) {
+      const double v = image[i * 4 + c] / 255.0;
+      level[i * 4 + c] = (options.srgb ? ToLinear(v) : v) * a;
+    }
+    level[i * 4 + 3] = a;
+  }
+  int max_diff = 0;
+  for (int l = 1; l < chain.GetLevelCount(); ++l) {
+    const int w = std::max(width / 2, 1), h = std::max(height / 2, 1);
+    if (chain.GetWidth(l) != w || chain.GetHeight(l) != h) return 255;
+    std::vector<std::vector<double>> wx(w), wy(h);
+    for (int x = 0; x < w; ++x) wx[x] = ReferenceWeights(width, w, x, options);
+    for (int y = 0; y < h; ++y) wy[y] = ReferenceWeights(height, h, y, options);
+
+    std::vector<double> next(w * h * 4, 0.0);
+    const uint8_t* out = chain.GetLevel(l);
+    for (int y = 0; y < h; ++y) {
+      for (int x = 0; x < w; ++x) {
+        double* t = &next[(y * w + x) * 4];
+        for (int sy = 0; sy < height; ++sy) {
+          if (wy[y][sy] == 0.0) continue;
+          for (int sx = 0; sx < width; ++sx) {
+            const double weight = wy[y][sy] * wx[x][sx];
+            if (weight == 0.0) continue;
+            for (int c = 0; c < 4; ++c)
+              t[c] += weight * level[(sy * width + sx) * 4 + c];
+          }
+        }
+        const double a = t[3];
+        for (int c = 0; c < 4; ++c) {
+          double v = c < 3 ? (a > 0.0 ? t[c] / a : 0.0) : a;
+          v = std::min(std::max(v, 0.0), 1.0);
+          if (c < 3 && options.srgb) v = ToSrgb(v);
+          const int expected = int(v * 255.0 + 0.5);
+          const int diff = abs(expected - out[(y * w + x) * 4 + c]);
+          if (diff != 0) ++*differing;
+          max_diff = std::max(max_diff, diff);
+        }
+      }
+    }
+    level.swap(next);
+    width = w;
+    height = h;
+  }
+  return max_diff;
+}
+
+// Smooth gradients, hard edges, noise and varying alpha
+static std::vector<uint8_t> TestImage(int width, int height, bool opaque) {
+  std::mt19937 random(width * 31 + height);
+  std::vector<uint8_t> image(width * height * 4);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      uint8_t* t = &image[(y * width + x) * 4];
+      t[0] = uint8_t(255 * x / std::max(width - 1, 1));
+      t[1] = ((x / 3 + y / 3) & 1) ? 255 : 0;
+      t[2] = uint8_t(random());
+      t[3] = opaque ? 255 : uint8_t(random() % 4 == 0 ? 0 : 128 + y % 128);
+    }
+  }
+  return image;
+}
+
+static double Ms(std::chrono::steady_clock::time_point a,
+                 std::chrono::steady_clock::time_point b) {
+  return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+int main(int argc, char** argv) {
+  int size = 2048;
+  int threads = -1;
+  int runs = 5;
+  int opt;
+  while ((opt = getopt(argc, argv, "s:t:r:")) != -1) {
+    switch (opt) {
+      case 's':
+        size = atoi(optarg);
+        break;
+      case 't':
+        threads = atoi(optarg);
+        break;
+      case 'r':
+        runs = std::max(1, atoi(optarg));
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-s size] [-t threads] [-r runs]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  ndk_helper::JobSystem jobs(threads);
+  bool failed = false;
+
+  // Against the reference, on sizes that hit odd and 1 texel dimensions
+  const int kSizes[][2] = {{64, 64}, {80, 40}, {45, 27}, {1, 33}, {7, 1}};
+  for (int filter = 0; filter < 2; ++filter) {
+    for (int flags = 0; flags < 4; ++flags) {
+      MipmapOptions options;
+      options.filter = static_cast<ndk_helper::MIPMAP_FILTER>(filter);
+      options.srgb = (flags & 1) != 0;
+      options.wrap = (flags & 2) != 0;
+      int max_diff = 0, differing = 0, channels = 0;
+      for (const auto& dims : kSizes) {
+        for (int opaque = 0; opaque < 2; ++opaque) {
+          const std::vector<uint8_t> image =
+              TestImage(dims[0], dims[1], opaque != 0);
+          MipChain chain;
+          if (!chain.Generate(image.data(), dims[0], dims[1], options,
+                              &jobs)) {
+            max_diff = 255;
+            continue;
+          }
+          int d;
+          max_diff = std::max(max_diff, Compare(chain, image, dims[0],
+                                                dims[1], options, &d));
+          differing += d;
+          for (int l = 1; l < chain.GetLevelCount(); ++l)
+            channels += chain.GetWidth(l) * chain.GetHeight(l) * 4;
+        }
+      }
+      printf("%-6s %-6s %-5s largest difference %d, %d of %d channels off\n",
+             filter ? "kaiser" : "box", options.srgb ? "srgb" : "linear",
+             options.wrap ? "wrap" : "clamp", max_diff, differing, channels);
+      if (max_diff > 1) failed = true;
+    }
+  }
+
+  // Cache file round trip
+  {
+    const std::vector<uint8_t> image = TestImage(45, 27, false);
+    MipmapOptions options;
+    MipChain chain, loaded;
+    chain.Generate(image.data(), 45, 27, options);
+    const uint64_t key = MipChain::GetKey(image.data(), image.size(), options);
+    const char* path = "mipmap-bench.mips";
+    bool same = chain.Store(path, key) && loaded.Load(path, key) &&
+                loaded.GetLevelCount() == chain.GetLevelCount();
+    for (int l = 0; same && l < chain.GetLevelCount(); ++l) {
+      same = std::equal(chain.GetLevel(l),
+                        chain.GetLevel(l) +
+                            chain.GetWidth(l) * chain.GetHeight(l) * 4,
+                        loaded.GetLevel(l));
+    }
+    const bool rejected = !loaded.Load(path, key + 1);
+    remove(path);
+    printf("cache file: %s, other key %s\n", same ? "same" : "DIFFERENT",
+           rejected ? "rejected" : "ACCEPTED");
+    if (!same || !rejected) failed = true;
+  }
+
+  // Timing, and threads must not change the result
+  const std::vector<uint8_t> image = TestImage(size, size, true);
+  for (int filter = 0; filter < 2; ++filter) {
+    MipmapOptions options;
+    options.filter = static_cast<ndk_helper::MIPMAP_FILTER>(filter);
+    MipChain chains[2];
+    for (int parallel = 0; parallel < 2; ++parallel) {
+      std::vector<double> times;
+      MipChain& chain = chains[parallel];
+      for (int run = 0; run < runs; ++run) {
+        auto t0 = std::chrono::steady_clock::now();
+        chain.Generate(image.data(), size, size, options,
+                       parallel ? &jobs : NULL);
+        times.push_back(Ms(t0, std::chrono::steady_clock::now()));
+      }
+      std::sort(times.begin(), times.end());
+      printf("%dx%d sRGB %-6s %d thread(s): %7.2f ms, %d levels\n", size,
+             size, filter ? "kaiser" : "box",
+             parallel ? jobs.GetThreadCount() : 1, times[times.size() / 2],
+             chain.GetLevelCount());
+    }
+    const int32_t last = chains[0].GetLevelCount() - 1;
+    const uint8_t* end = chains[0].GetLevel(last) + 4;
+    if (!std::equal(chains[0].GetLevel(0), end, chains[1].GetLevel(0))) {
+      printf("threaded chain DIFFERS\n");
+      failed = true;
+    }
+  }
+
+  if (failed) {
+    printf("FAILED\n");
+    return 1;
+  }
+  return 0;
+}
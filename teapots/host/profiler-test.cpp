@@ -0,0 +1,525 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// profiler-test.cpp
+// Checks ndk_helper::Profiler:
+// - nested zones add up per name, parent and depth, with the self time of
+//   a zone being its total without its children,
+// - zones beyond kMaxDepth and beyond kBufferSize per frame are dropped and
+//   counted, and the profiler works normally afterwards,
+// - the buffer of a thread that exits goes to the next new thread,
+// - the Chrome trace is valid JSON, with one complete event per captured
+//   zone and frame, and names escaped.
+// Exits with 1 if any check fails.
+//
+//   profiler-test
+//--------------------------------------------------------------------------------
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "profiler.h"
+
+using ndk_helper::Profiler;
+using ndk_helper::ZoneStats;
+
+static int32_t failures = 0;
+
+static void Check(const bool ok, const char* what) {
+  if (!ok) {
+    printf("  %s FAILED\n", what);
+    ++failures;
+  }
+}
+
+static void Sleep(const int32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// Stats of the last frame for a zone, NULL if there are none
+static const ZoneStats* Find(const char* name, const char* parent) {
+  for (const ZoneStats& zone : Profiler::GetInstance()->GetFrameStats()) {
+    if (strcmp(zone.name, name) == 0 &&
+        (parent == NULL ? zone.parent == NULL
+                        : zone.parent != NULL && !strcmp(zone.parent, parent)))
+      return &zone;
+  }
+  return NULL;
+}
+
+//--------------------------------------------------------------------------------
+// Minimal JSON parser, strict enough to validate the trace
+//--------------------------------------------------------------------------------
+struct Json {
+  enum Type { kNull, kBool, kNumber, kString, kArray, kObject } type;
+  double number;
+  std::string string;
+  std::vector<Json> items;
+  std::vector<std::pair<std::string, Json>> members;
+
+  Json() : type(kNull), number(0.) {}
+
+  const Json* Get(const char* name) const {
+    for (const auto& member : members) {
+      if (member.first == name) return &member.second;
+    }
+    return NULL;
+  }
+};
+
+class JsonParser {
+  const char* p_;
+  const char* end_;
+
+  void SkipSpaces() {
+    while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' ||
+                         *p_ == '\r'))
+      ++p_;
+  }
+
+  bool Literal(const char* word) {
+    const size_t length = strlen(word);
+    if (static_cast<size_t>(end_ - p_) < length ||
+        strncmp(p_, word, length) != 0)
+      return false;
+    p_ += length;
+    return true;
+  }
+
+  bool Digits() {
+    const char* start = p_;
+    while (p_ < end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+    return p_ > start;
+  }
+
+  bool ParseString(std::string* out) {
+    if (p_ == end_ || *p_ != '"') return false;
+    for (++p_; p_ < end_ && *p_ != '"'; ++p_) {
+      if (static_cast<unsigned char>(*p_) < ' ') return false;
+      if (*p_ != '\\') {
+        out->push_back(*p_);
+        continue;
+      }
+      if (++p_ == end_) return false;
+      switch (*p_) {
+        case '"':
+        case '\\':
+        case '/':
+          out->push_back(*p_);
+          break;
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+          out->push_back(' ');
+          break;
+        case 'u':
+          for (int32_t i = 0; i < 4; ++i) {
+            if (++p_ == end_ || !isxdigit(static_cast<unsigned char>(*p_)))
+              return false;
+          }
+          out->push_back('?');
+          break;
+        default:
+          return false;
+      }
+    }
+    if (p_ == end_) return false;
+    ++p_;
+    return true;
+  }
+
+  bool ParseNumber(double* out) {
+    const char* start = p_;
+    if (p_ < end_ && *p_ == '-') ++p_;
+    if (p_ < end_ && *p_ == '0') {
+      ++p_;
+    } else if (!Digits()) {
+      return false;
+    }
+    if (p_ < end_ && *p_ == '.') {
+      ++p_;
+      if (!Digits()) return false;
+    }
+    if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+      ++p_;
+      if (p_ < end_ && (*p_ == '+' || *p_ == '-')) ++p_;
+      if (!Digits()) return false;
+    }
+    *out = strtod(std::string(start, p_).c_str(), NULL);
+    return true;
+  }
+
+  bool ParseValue(Json* value) {
+    SkipSpaces();
+    if (p_ == end_) return false;
+    switch (*p_) {
+      case '{':
+        value->type = Json::kObject;
+        ++p_;
+        SkipSpaces();
+        if (p_ < end_ && *p_ == '}') {
+          ++p_;
+          return true;
+        }
+        for (;;) {
+          std::pair<std::string, Json> member;
+          SkipSpaces();
+          if (!ParseString(&member.first)) return false;
+          SkipSpaces();
+          if (p_ == end_ || *p_++ != ':') return false;
+          if (!ParseValue(&member.second)) return false;
+          value->members.push_back(member);
+          SkipSpaces();
+          if (p_ == end_) return false;
+          if (*p_ == '}') {
+            ++p_;
+            return true;
+          }
+          if (*p_++ != ',') return false;
+        }
+      case '[':
+        value->type = Json::kArray;
+        ++p_;
+        SkipSpaces();
+        if (p_ < end_ && *p_ == ']') {
+          ++p_;
+          return true;
+        }
+        for (;;) {
+          value->items.push_back(Json());
+          if (!ParseValue(&value->items.back())) return false;
+          SkipSpaces();
+          if (p_ == end_) return false;
+          if (*p_ == ']') {
+            ++p_;
+            return true;
+          }
+          if (*p_++ != ',') return false;
+        }
+      case '"':
+        value->type = Json::kString;
+        return ParseString(&value->string);
+      case 't':
+      case 'f':
+        value->type = Json::kBool;
+        return Literal("true") || Literal("false");
+      case 'n':
+        return Literal("null");
+      default:
+        value->type = Json::kNumber;
+        return ParseNumber(&value->number);
+    }
+  }
+
+ public:
+  // Whether 'text' is exactly one JSON value
+  bool Parse(const std::string& text, Json* value) {
+    p_ = text.data();
+    end_ = p_ + text.size();
+    if (!ParseValue(value)) return false;
+    SkipSpaces();
+    return p_ == end_;
+  }
+};
+
+//--------------------------------------------------------------------------------
+// Checks
+//--------------------------------------------------------------------------------
+static void CheckNesting() {
+  Profiler* profiler = Profiler::GetInstance();
+  profiler->EndFrame();
+  {
+    NDK_HELPER_PROFILE_ZONE("outer");
+    Sleep(2);
+    {
+      NDK_HELPER_PROFILE_ZONE("inner");
+      Sleep(3);
+    }
+    {
+      NDK_HELPER_PROFILE_ZONE("inner");
+      NDK_HELPER_PROFILE_ZONE("leaf");
+      Sleep(1);
+    }
+    {
+      NDK_HELPER_PROFILE_ZONE("other");
+      NDK_HELPER_PROFILE_ZONE("leaf");
+    }
+  }
+  profiler->EndFrame();
+
+  const ZoneStats* outer = Find("outer", NULL);
+  const ZoneStats* inner = Find("inner", "outer");
+  const ZoneStats* other = Find("other", "outer");
+  const ZoneStats* inner_leaf = Find("leaf", "inner");
+  const ZoneStats* other_leaf = Find("leaf", "other");
+  Check(profiler->GetFrameStats().size() == 5 && outer && inner && other &&
+            inner_leaf && other_leaf,
+        "zones by name and parent");
+  if (!(outer && inner && other && inner_leaf && other_leaf)) return;
+  Check(outer->depth == 0 && inner->depth == 1 && other->depth == 1 &&
+            inner_leaf->depth == 2 && other_leaf->depth == 2,
+        "zone depths");
+  Check(outer->count == 1 && inner->count == 2 && other->count == 1 &&
+            inner_leaf->count == 1,
+        "zone counts");
+  Check(outer->total_ns >= 6000000 && inner->total_ns >= 4000000 &&
+            inner_leaf->total_ns >= 1000000,
+        "zone times cover the sleeps");
+  Check(outer->self_ns + inner->total_ns + other->total_ns == outer->total_ns,
+        "self time of outer is its total without its children");
+  Check(inner->self_ns + inner_leaf->total_ns == inner->total_ns &&
+            inner_leaf->self_ns == inner_leaf->total_ns,
+        "self time of inner and leaf");
+  Check(outer->total_ns <= profiler->GetFrameTimeNs(), "zone within frame");
+
+  std::string text;
+  profiler->FormatFrame(&text);
+  Check(text.find("\n  outer ") != std::string::npos &&
+            text.find("\n    inner ") != std::string::npos &&
+            text.find(") x2\n") != std::string::npos &&
+            text.find("\n      leaf ") != std::string::npos,
+        "FormatFrame() tree");
+
+  // Nothing is recorded while disabled
+  profiler->SetEnabled(false);
+  { NDK_HELPER_PROFILE_ZONE("disabled"); }
+  profiler->SetEnabled(true);
+  profiler->EndFrame();
+  Check(profiler->GetFrameStats().empty(), "no zones while disabled");
+}
+
+static void Nest(const int32_t levels) {
+  NDK_HELPER_PROFILE_ZONE("nest");
+  if (levels > 1) Nest(levels - 1);
+}
+
+static void CheckDrops() {
+  Profiler* profiler = Profiler::GetInstance();
+  profiler->EndFrame();
+
+  // Too deep: the zones past kMaxDepth are dropped, the others kept
+  uint32_t dropped = profiler->GetDroppedCount();
+  Nest(Profiler::kMaxDepth + 3);
+  profiler->EndFrame();
+  int32_t deepest = -1, zones = 0;
+  for (const ZoneStats& zone : profiler->GetFrameStats()) {
+    deepest = zone.depth > deepest ? zone.depth : deepest;
+    zones += zone.count;
+  }
+  Check(profiler->GetDroppedCount() == dropped + 3 &&
+            zones == Profiler::kMaxDepth &&
+            deepest == Profiler::kMaxDepth - 1,
+        "zones past kMaxDepth dropped");
+
+  // Buffer full: the zones past kBufferSize in one frame are dropped
+  dropped = profiler->GetDroppedCount();
+  for (uint32_t i = 0; i < Profiler::kBufferSize + 100; ++i) {
+    NDK_HELPER_PROFILE_ZONE("many");
+  }
+  profiler->EndFrame();
+  const ZoneStats* many = Find("many", NULL);
+  Check(many != NULL &&
+            many->count == static_cast<int32_t>(Profiler::kBufferSize) &&
+            profiler->GetDroppedCount() == dropped + 100,
+        "zones past kBufferSize dropped");
+
+  // Both recover on the next frame
+  dropped = profiler->GetDroppedCount();
+  for (int32_t i = 0; i < 10; ++i) Nest(2);
+  profiler->EndFrame();
+  const ZoneStats* top = Find("nest", NULL);
+  const ZoneStats* nested = Find("nest", "nest");
+  Check(top != NULL && top->count == 10 && nested != NULL &&
+            nested->count == 10 && nested->depth == 1 &&
+            profiler->GetDroppedCount() == dropped,
+        "zones recorded again after drops");
+}
+
+static void CheckThreads() {
+  Profiler* profiler = Profiler::GetInstance();
+  profiler->EndFrame();
+  const int32_t main_thread = profiler->GetThreadBuffer()->id;
+
+  Profiler::ThreadBuffer* first = NULL;
+  Profiler::ThreadBuffer* second = NULL;
+  std::thread worker([&] {
+    profiler->SetThreadName("worker");
+    first = profiler->GetThreadBuffer();
+    NDK_HELPER_PROFILE_ZONE("work");
+  });
+  worker.join();
+
+  // The zones of a thread that has exited are still collected
+  profiler->EndFrame();
+  const ZoneStats* work = Find("work", NULL);
+  Check(first != NULL && first->id != main_thread && work != NULL &&
+            work->thread == first->id,
+        "zone of an exited thread");
+
+  std::string text;
+  profiler->FormatFrame(&text);
+  Check(text.find("worker:") == std::string::npos,
+        "name of an exited thread cleared");
+
+  // The next threads take the free buffer, a concurrent one gets another
+  std::thread reuse([&] {
+    profiler->SetThreadName("reuse");
+    second = profiler->GetThreadBuffer();
+    NDK_HELPER_PROFILE_ZONE("reused");
+    Profiler::ThreadBuffer* concurrent = NULL;
+    std::thread other([&] { concurrent = profiler->GetThreadBuffer(); });
+    other.join();
+    Check(concurrent != NULL && concurrent != second,
+          "concurrent threads get their own buffers");
+  });
+  reuse.join();
+  Check(second == first, "buffer of an exited thread reused");
+
+  profiler->EndFrame();
+  const ZoneStats* reused = Find("reused", NULL);
+  Check(reused != NULL && first != NULL && reused->thread == first->id &&
+            reused->count == 1,
+        "zone on a reused buffer");
+}
+
+static void CheckTrace() {
+  Profiler* profiler = Profiler::GetInstance();
+  profiler->EndFrame();
+  profiler->StartCapture(1000);
+  const int32_t frames = 3;
+  for (int32_t f = 0; f < frames; ++f) {
+    NDK_HELPER_PROFILE_ZONE("quote\" back\\slash\ttab");
+    std::thread worker([] { NDK_HELPER_PROFILE_ZONE("worker zone"); });
+    worker.join();
+    Nest(2);
+    profiler->EndFrame();
+  }
+  profiler->StopCapture();
+
+  std::string json;
+  profiler->GetChromeTrace(&json);
+  Json trace;
+  JsonParser parser;
+  if (!parser.Parse(json, &trace)) {
+    printf("  trace is not valid JSON FAILED\n%s", json.c_str());
+    ++failures;
+    return;
+  }
+  const Json* events = trace.Get("traceEvents");
+  Check(events != NULL && events->type == Json::kArray, "traceEvents array");
+  if (events == NULL) return;
+
+  // The first zone of each frame is only closed after its EndFrame(), and
+  // so is captured with the next frame, but the last one.
+  int32_t complete = 0, frame_events = 0, metadata = 0, escaped = 0;
+  bool fields_ok = true;
+  for (const Json& event : events->items) {
+    const Json* name = event.Get("name");
+    const Json* ph = event.Get("ph");
+    const Json* tid = event.Get("tid");
+    if (name == NULL || name->type != Json::kString || ph == NULL ||
+        ph->type != Json::kString || tid == NULL ||
+        tid->type != Json::kNumber) {
+      fields_ok = false;
+      continue;
+    }
+    if (ph->string == "M") {
+      ++metadata;
+      const Json* args = event.Get("args");
+      fields_ok = fields_ok && args != NULL && args->Get("name") != NULL;
+    } else if (ph->string == "X") {
+      ++complete;
+      const Json* ts = event.Get("ts");
+      const Json* dur = event.Get("dur");
+      fields_ok = fields_ok && ts != NULL && ts->type == Json::kNumber &&
+                  ts->number >= 0. && dur != NULL &&
+                  dur->type == Json::kNumber && dur->number >= 0.;
+      if (name->string == "Frame") ++frame_events;
+      // Control characters are dropped
+      if (name->string == "quote\" back\\slashtab") ++escaped;
+    } else {
+      fields_ok = false;
+    }
+  }
+  Check(fields_ok, "trace event fields");
+  Check(metadata >= 2, "thread name events");
+  Check(frame_events == frames, "one Frame event per frame");
+  Check(escaped == frames - 1, "escaped zone names");
+  // Per frame: the worker zone and 2 nest zones, plus the previous
+  // frame's first zone from the second frame on
+  Check(complete == frames * 4 + frames - 1, "one event per zone and frame");
+
+  // Written to a file as is
+  char path[] = "/tmp/profiler-test-XXXXXX";
+  const int fd = mkstemp(path);
+  std::string written;
+  if (fd >= 0 && profiler->WriteChromeTrace(path)) {
+    FILE* file = fopen(path, "r");
+    char buffer[4096];
+    size_t size;
+    while (file != NULL && (size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+      written.append(buffer, size);
+    if (file != NULL) fclose(file);
+  }
+  if (fd >= 0) {
+    close(fd);
+    unlink(path);
+  }
+  Check(written == json, "WriteChromeTrace() writes GetChromeTrace()");
+
+  // The capture stops at its limit
+  profiler->StartCapture(5);
+  for (int32_t f = 0; f < 3; ++f) {
+    Nest(3);
+    profiler->EndFrame();
+  }
+  Check(!profiler->IsCapturing(), "capture stops at its limit");
+  profiler->GetChromeTrace(&json);
+  Json limited;
+  Check(parser.Parse(json, &limited), "limited trace is valid JSON");
+  int32_t limited_complete = 0;
+  if (limited.Get("traceEvents") != NULL) {
+    for (const Json& event : limited.Get("traceEvents")->items) {
+      const Json* ph = event.Get("ph");
+      limited_complete += ph != NULL && ph->string == "X";
+    }
+  }
+  Check(limited_complete == 5, "limited trace has max_events events");
+}
+
+int main() {
+  Profiler* profiler = Profiler::GetInstance();
+  profiler->SetThreadName("main");
+  profiler->SetEnabled(true);
+  CheckNesting();
+  CheckDrops();
+  CheckThreads();
+  CheckTrace();
+  if (failures) printf("%d checks FAILED\n", failures);
+  else printf("all checks passed\n");
+  return failures ? 1 : 0;
+}
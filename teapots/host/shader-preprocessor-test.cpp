@@ -0,0 +1,403 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// shader-preprocessor-test.cpp
+// Checks ndk_helper::shader::Preprocess() and ShaderCache on sources held
+// in memory:
+// - %NAME% parameters, the GLSL '%' modulo and unknown names left as they
+//   are,
+// - defines after the #version line, or first without one,
+// - nested includes, relative to the including file unless they have a
+//   '/', and the errors of missing and cyclic includes,
+// - cache hits and misses, which files are read again, and which changes
+//   of a variant give a new entry or a new key.
+// Exits with 1 if any check fails.
+// With a shader file, also times a ShaderCache hit and a miss on it with
+// the parameters of MoreTeapotsRenderer, against the find/replace that
+// shader::CompileShader() did on every load before ShaderCache.
+//
+//   shader-preprocessor-test [-n iterations] [shader]
+//--------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "shaderPreprocessor.h"
+
+using ndk_helper::shader::Preprocess;
+using ndk_helper::shader::ShaderCache;
+using ndk_helper::shader::ShaderVariant;
+
+static int32_t failures = 0;
+
+static void Check(const bool ok, const char* what) {
+  if (!ok) {
+    printf("  %s FAILED\n", what);
+    ++failures;
+  }
+}
+
+// In-memory files, counting how often each is read
+struct Files {
+  std::map<std::string, std::string> contents;
+  std::map<std::string, int32_t> reads;
+
+  bool Load(const char* file_name, std::string* text) {
+    ++reads[file_name];
+    auto it = contents.find(file_name);
+    if (it == contents.end()) return false;
+    *text = it->second;
+    return true;
+  }
+};
+
+// Preprocesses variant.file_name out of 'files', then compares the text, or
+// the error if 'expected_error' is set
+static void CheckExpansion(const char* what, Files* files,
+                           const ShaderVariant& variant,
+                           const std::string& expected,
+                           const bool expected_error = false) {
+  std::string text, error;
+  const bool ok = Preprocess(
+      variant, files->contents[variant.file_name],
+      [files](const char* name, std::string* t) {
+        return files->Load(name, t);
+      },
+      &text, &error);
+  const std::string& actual = expected_error ? error : text;
+  if (ok == expected_error || actual != expected) {
+    printf("  %s FAILED\n  expected %s:\n%s\n  got %s:\n%s\n", what,
+           expected_error ? "error" : "text", expected.c_str(),
+           ok ? "text" : "error", (ok ? text : error).c_str());
+    ++failures;
+  }
+}
+
+static void CheckParameters() {
+  Files files;
+  ShaderVariant variant;
+  variant.file_name = "p.frag";
+  variant.parameters["COUNT"] = "4";
+  variant.parameters["SCALE"] = "0.5";
+  files.contents["p.frag"] =
+      "int i = j % 3;\n"
+      "int k = j %COUNT% 2;\n"
+      "float s = %SCALE%*%SCALE%;\n"
+      "// %UNKNOWN% 100% %% % COUNT% %COUNT\n"
+      "light[%COUNT%]%";
+  CheckExpansion("parameters", &files, variant,
+                 "int i = j % 3;\n"
+                 "int k = j 4 2;\n"
+                 "float s = 0.5*0.5;\n"
+                 "// %UNKNOWN% 100% %% % COUNT% %COUNT\n"
+                 "light[4]%");
+
+  variant.parameters.clear();
+  CheckExpansion("no parameters", &files, variant, files.contents["p.frag"]);
+}
+
+static void CheckDefines() {
+  Files files;
+  ShaderVariant variant;
+  variant.defines["USE_FOG"] = "";
+  variant.defines["LIGHTS"] = "2";
+
+  variant.file_name = "version.vert";
+  files.contents["version.vert"] =
+      "// header comment\n"
+      "#version 300 es\n"
+      "precision mediump float;\n";
+  CheckExpansion("defines after #version", &files, variant,
+                 "// header comment\n"
+                 "#version 300 es\n"
+                 "#define LIGHTS 2\n"
+                 "#define USE_FOG\n"
+                 "precision mediump float;\n");
+
+  variant.file_name = "last.vert";
+  files.contents["last.vert"] = "  #  version 100";
+  CheckExpansion("defines after a last #version line", &files, variant,
+                 "  #  version 100\n"
+                 "#define LIGHTS 2\n"
+                 "#define USE_FOG\n");
+
+  variant.file_name = "none.vert";
+  files.contents["none.vert"] =
+      "#versionless\n"
+      "void main() {}\n";
+  CheckExpansion("defines without #version", &files, variant,
+                 "#define LIGHTS 2\n"
+                 "#define USE_FOG\n"
+                 "#versionless\n"
+                 "void main() {}\n");
+
+  // Defines go to the top level file only, not after an included #version
+  variant.file_name = "outer.vert";
+  files.contents["outer.vert"] =
+      "#include \"inner.vert\"\n"
+      "void main() {}\n";
+  files.contents["inner.vert"] = "#version 300 es\n";
+  CheckExpansion("defines with an included #version", &files, variant,
+                 "#define LIGHTS 2\n"
+                 "#define USE_FOG\n"
+                 "#version 300 es\n"
+                 "void main() {}\n");
+}
+
+static void CheckIncludes() {
+  Files files;
+  ShaderVariant variant;
+  variant.parameters["N"] = "3";
+  variant.file_name = "shaders/main.frag";
+  files.contents["shaders/main.frag"] =
+      "#version 300 es\n"
+      "#include \"common.glsl\"\n"
+      "  # include \"lib/light.glsl\"  // trailing comment\n"
+      "void main() {}";
+  files.contents["shaders/common.glsl"] = "const int n = %N%;";
+  files.contents["lib/light.glsl"] =
+      "#include \"brdf.glsl\"\n"
+      "vec3 Light();\n";
+  files.contents["lib/brdf.glsl"] = "float Brdf();\n";
+  CheckExpansion("nested and relative includes", &files, variant,
+                 "#version 300 es\n"
+                 "const int n = 3;\n"
+                 "float Brdf();\n"
+                 "vec3 Light();\n"
+                 "void main() {}");
+
+  files.contents["lib/light.glsl"] = "#include \"missing.glsl\"\n";
+  CheckExpansion("missing include", &files, variant,
+                 "lib/light.glsl: can't read lib/missing.glsl", true);
+
+  files.contents["lib/light.glsl"] = "#include \"../lib/cycle.glsl\"\n";
+  files.contents["../lib/cycle.glsl"] = "#include \"lib/light.glsl\"\n";
+  CheckExpansion("include cycle", &files, variant,
+                 "../lib/cycle.glsl: includes nested too deeply", true);
+}
+
+static void CheckCache() {
+  Files files;
+  ShaderCache cache([&files](const char* name, std::string* text) {
+    return files.Load(name, text);
+  });
+  files.contents["a.frag"] =
+      "#version 300 es\n"
+      "#include \"inc.glsl\"\n"
+      "float x = %X%;\n";
+  files.contents["b.frag"] = files.contents["a.frag"];
+  files.contents["inc.glsl"] = "float y;\n";
+
+  ShaderVariant variant;
+  variant.file_name = "a.frag";
+  variant.parameters["X"] = "1.0";
+  uint64_t key = 0, other_key = 0;
+  const std::string* text = cache.GetSource(variant, &key);
+  const std::string* again = cache.GetSource(variant, &other_key);
+  Check(text != NULL && again == text && other_key == key,
+        "cache hit returns the same text and key");
+  Check(cache.GetMissCount() == 1 && cache.GetHitCount() == 1,
+        "1 miss then 1 hit");
+  Check(files.reads["a.frag"] == 1 && files.reads["inc.glsl"] == 1,
+        "files only read on a miss");
+
+  // Each of these is a new entry; 'same_key' if the expanded text is the
+  // same as the first variant's
+  struct Change {
+    const char* what;
+    ShaderVariant variant;
+    bool same_key;
+  } changes[] = {
+      {"other parameter value", variant, false},
+      {"parameter as a define", variant, false},
+      {"other file, same contents", variant, true},
+      {"unused parameter", variant, true},
+  };
+  changes[0].variant.parameters["X"] = "2.0";
+  changes[1].variant.parameters.clear();
+  changes[1].variant.defines["X"] = "1.0";
+  changes[2].variant.file_name = "b.frag";
+  changes[3].variant.parameters["Y"] = "1.0";
+  int32_t misses = cache.GetMissCount();
+  for (const Change& change : changes) {
+    const std::string* changed = cache.GetSource(change.variant, &other_key);
+    Check(changed != NULL && cache.GetMissCount() == ++misses, change.what);
+    Check((other_key == key) == change.same_key, change.what);
+  }
+
+  // The names and values of the maps don't run into each other
+  ShaderVariant split_a = variant, split_b = variant;
+  split_a.defines["a"] = "bc";
+  split_b.defines["ab"] = "c";
+  cache.GetSource(split_a, &key);
+  cache.GetSource(split_b, &other_key);
+  misses += 2;
+  Check(cache.GetMissCount() == misses && key != other_key,
+        "define a=bc against ab=c");
+
+  // A changed file is expanded again only after Clear()
+  files.contents["a.frag"] += "float z;\n";
+  text = cache.GetSource(variant, NULL);
+  Check(cache.GetMissCount() == misses && cache.GetHitCount() == 2 &&
+            text != NULL && text->find("float z;") == std::string::npos,
+        "changed file is a hit until Clear()");
+  cache.Clear();
+  text = cache.GetSource(variant, NULL);
+  Check(cache.GetMissCount() == ++misses && text != NULL &&
+            text->find("float z;") != std::string::npos,
+        "changed file is a miss after Clear()");
+
+  // Failures aren't cached
+  std::string error;
+  files.contents["inc.glsl"] = "#include \"gone.glsl\"\n";
+  files.contents["c.frag"] = "#include \"inc.glsl\"\n";
+  ShaderVariant broken;
+  broken.file_name = "c.frag";
+  Check(cache.GetSource(broken, NULL, &error) == NULL &&
+            error == "inc.glsl: can't read gone.glsl",
+        "error of a broken include");
+  files.contents["gone.glsl"] = "float w;\n";
+  const std::string* fixed = cache.GetSource(broken, NULL, &error);
+  Check(fixed != NULL && *fixed == "float w;\n", "fixed include");
+  misses += 2;
+  ShaderVariant missing;
+  missing.file_name = "missing.frag";
+  Check(cache.GetSource(missing, NULL, &error) == NULL &&
+            error == "can't read missing.frag",
+        "error of a missing file");
+  Check(cache.GetMissCount() == misses && cache.GetHitCount() == 2,
+        "final hit and miss counts");
+}
+
+// Parameter replacement of shader::CompileShader() before ShaderCache, the
+// keys include the '%'
+static std::string FindReplace(
+    const std::string& source,
+    const std::map<std::string, std::string>& map_parameters) {
+  const char REPLACEMENT_TAG = '*';
+  std::string str(source);
+  std::string str_replacement_map(source.size(), ' ');
+  for (auto it = map_parameters.begin(); it != map_parameters.end(); ++it) {
+    size_t pos = 0;
+    while ((pos = str.find(it->first, pos)) != std::string::npos) {
+      size_t replaced_pos = str_replacement_map.find(REPLACEMENT_TAG, pos);
+      if (replaced_pos == std::string::npos || replaced_pos > pos) {
+        str.replace(pos, it->first.length(), it->second);
+        str_replacement_map.replace(pos, it->first.length(), it->first.length(),
+                                    REPLACEMENT_TAG);
+      }
+      pos += it->second.length();
+    }
+  }
+  return str;
+}
+
+static double Ns(std::chrono::steady_clock::time_point a,
+                 std::chrono::steady_clock::time_point b, int32_t n) {
+  return std::chrono::duration<double, std::nano>(b - a).count() / n;
+}
+
+// Times the lookups of 'file_name' against FindReplace(), the file is read
+// once and then held in memory, as the cache sees it after its first read
+static void TimeCache(const char* file_name, const int32_t iterations) {
+  std::ifstream in(file_name, std::ios::binary);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  if (!in) {
+    Check(false, "reading the timed shader");
+    return;
+  }
+  Files files;
+  files.contents[file_name] = contents.str();
+  ShaderCache cache([&files](const char* name, std::string* text) {
+    return files.Load(name, text);
+  });
+
+  ShaderVariant variant;
+  variant.file_name = file_name;
+  variant.parameters["NUM_TEAPOT"] = "512";
+  variant.parameters["LOCATION_VERTEX"] = "0";
+  variant.parameters["LOCATION_NORMAL"] = "1";
+  variant.parameters["ARB"] = "ARB";
+  std::map<std::string, std::string> map_parameters;
+  for (const auto& parameter : variant.parameters) {
+    map_parameters["%" + parameter.first + "%"] = parameter.second;
+  }
+
+  const std::string* text = cache.GetSource(variant, NULL);
+  Check(text != NULL && *text == FindReplace(files.contents[file_name],
+                                             map_parameters),
+        "timed shader expands as with find/replace");
+  volatile size_t sink = 0;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int32_t i = 0; i < iterations; ++i) {
+    sink = sink + FindReplace(files.contents[file_name], map_parameters).size();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int32_t i = 0; i < iterations; ++i) {
+    sink = sink + cache.GetSource(variant, NULL)->size();
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  for (int32_t i = 0; i < iterations; ++i) {
+    cache.Clear();
+    sink = sink + cache.GetSource(variant, NULL)->size();
+  }
+  auto t3 = std::chrono::steady_clock::now();
+  Check(files.reads[file_name] == iterations + 1,
+        "timed shader only read on a miss");
+
+  printf("%s, %zu bytes, %d iterations\n", file_name,
+         files.contents[file_name].size(), iterations);
+  printf("  %-24s %8.0f ns\n", "find/replace", Ns(t0, t1, iterations));
+  printf("  %-24s %8.0f ns\n", "ShaderCache hit", Ns(t1, t2, iterations));
+  printf("  %-24s %8.0f ns\n", "ShaderCache miss", Ns(t2, t3, iterations));
+}
+
+int main(int argc, char** argv) {
+  int32_t iterations = 100000;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:")) != -1) {
+    switch (opt) {
+      case 'n':
+        iterations = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-n iterations] [shader]\n", argv[0]);
+        return 1;
+    }
+  }
+  if (iterations < 1) {
+    fprintf(stderr, "need at least 1 iteration\n");
+    return 1;
+  }
+
+  CheckParameters();
+  CheckDefines();
+  CheckIncludes();
+  CheckCache();
+  if (optind < argc) TimeCache(argv[optind], iterations);
+  if (failures) printf("%d checks FAILED\n", failures);
+  else printf("all checks passed\n");
+  return failures ? 1 : 0;
+}
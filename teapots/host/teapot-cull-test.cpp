@@ -0,0 +1,156 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// teapot-cull-test.cpp
+// Checks TeapotInstances::Cull() (grid cells, then Frustum::CullSpheres())
+// against testing the bounding sphere of every instance with
+// Frustum::TestSphere(), over random views of a grid of teapots, half of
+// them with a distance limit. Then times both.
+//
+// Both test the same planes in the same order, so the visible sets are
+// expected to be identical. Exits with 1 if any view differs.
+//
+//   teapot-cull-test [-n instances] [-v views] [-r radius]
+//--------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "TeapotInstances.h"
+#include "vecmath.h"
+
+using ndk_helper::Frustum;
+using ndk_helper::Mat4;
+using ndk_helper::Vec3;
+
+// Same grid as the renderer, an edge is 500 across
+const float kGridWidth = 500.f;
+
+int main(int argc, char** argv) {
+  int32_t count = 20000;
+  int32_t views = 500;
+  float radius = 20.f;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:v:r:")) != -1) {
+    switch (opt) {
+      case 'n':
+        count = atoi(optarg);
+        break;
+      case 'v':
+        views = atoi(optarg);
+        break;
+      case 'r':
+        radius = static_cast<float>(atof(optarg));
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-n instances] [-v views] [-r radius]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  if (count < 1 || views < 1) {
+    fprintf(stderr, "need at least 1 instance and 1 view\n");
+    return 1;
+  }
+
+  // The color of each instance is its index, to find it after BuildGrid()
+  int32_t side = 1;
+  while (side * side * side < count) ++side;
+  const float gap = side > 1 ? kGridWidth / (side - 1) : 0.f;
+  std::vector<Vec3> centers;
+  TeapotInstances instances;
+  instances.Init(count);
+  for (int32_t i = 0; i < count; ++i) {
+    const int32_t x = i / (side * side), y = i / side % side, z = i % side;
+    centers.push_back(Vec3(x * gap - kGridWidth / 2.f,
+                           y * gap - kGridWidth / 2.f,
+                           z * gap - kGridWidth / 2.f));
+    instances.SetInstance(i, Mat4::Translation(centers.back()),
+                          Vec3(float(i), 0.f, 0.f), 0.f, 0.f, 0.f, 0.f);
+  }
+  instances.BuildGrid(radius);
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> eye_position(-2000.f, 2000.f);
+  std::uniform_real_distribution<float> target_position(-kGridWidth,
+                                                        kGridWidth);
+  std::uniform_real_distribution<float> aspect(0.4f, 1.f);
+  std::uniform_real_distribution<float> max_distance(200.f, 3000.f);
+
+  std::vector<int32_t> expected, actual;
+  double cull_ms = 0., brute_ms = 0.;
+  int64_t visible_total = 0;
+  int32_t failures = 0;
+  for (int32_t v = 0; v < views; ++v) {
+    const Vec3 eye(eye_position(rng), eye_position(rng), eye_position(rng));
+    const Vec3 target(target_position(rng), target_position(rng),
+                      target_position(rng));
+    const Mat4 view = Mat4::LookAt(eye, target, Vec3(0.f, 1.f, 0.f));
+    const float a = aspect(rng);
+    const Mat4 projection = v & 2 ? Mat4::Perspective(a, 1.f, 5.f, 10000.f)
+                                  : Mat4::Perspective(1.f, a, 5.f, 10000.f);
+    Frustum frustum(projection * view);
+    if (v & 1) frustum.SetMaxDistance(eye, max_distance(rng));
+
+    auto start = std::chrono::steady_clock::now();
+    instances.Cull(frustum);
+    auto middle = std::chrono::steady_clock::now();
+    expected.clear();
+    for (int32_t i = 0; i < count; ++i) {
+      if (frustum.TestSphere(centers[i], radius) != ndk_helper::FRUSTUM_OUTSIDE)
+        expected.push_back(i);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    cull_ms +=
+        std::chrono::duration<double, std::milli>(middle - start).count();
+    brute_ms +=
+        std::chrono::duration<double, std::milli>(stop - middle).count();
+
+    actual.clear();
+    for (int32_t i = 0; i < instances.GetVisibleCount(); ++i) {
+      float index, unused_y, unused_z;
+      instances.GetColor(i).Value(index, unused_y, unused_z);
+      actual.push_back(static_cast<int32_t>(index));
+    }
+    std::sort(actual.begin(), actual.end());
+    visible_total += static_cast<int64_t>(actual.size());
+    if (actual != expected) {
+      if (failures < 10) {
+        printf("view %d: Cull() keeps %d instances, TestSphere() %d\n", v,
+               static_cast<int32_t>(actual.size()),
+               static_cast<int32_t>(expected.size()));
+      }
+      ++failures;
+    }
+  }
+
+  printf("%d instances, radius %g, %d views, %.1f%% visible on average\n",
+         count, radius, views, 100. * visible_total / views / count);
+  printf("  %-28s %8.3f ms/view  %9.1f instances/ms\n",
+         "TestSphere() per instance", brute_ms / views,
+         count * views / brute_ms);
+  printf("  %-28s %8.3f ms/view  %9.1f instances/ms  (%.2fx)\n",
+         "TeapotInstances::Cull()", cull_ms / views, count * views / cull_ms,
+         brute_ms / cull_ms);
+  if (failures) printf("%d of %d views FAILED\n", failures, views);
+  return failures ? 1 : 0;
+}
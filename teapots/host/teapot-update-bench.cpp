@@ -0,0 +1,228 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// teapot-update-bench.cpp
+// Times the per-frame work of more-teapots on a grid of teapots:
+// TeapotInstances::Update() and Write() into a uniform buffer layout, inline
+// and on the job system, against the former per-instance loop of
+// MoreTeapotsRenderer::Render() (Mat4 products, then a memcpy of each
+// matrix). Also checks that both give the same matrices, and exits with 1
+// if they don't.
+//
+//   teapot-update-bench [-n instances] [-t threads] [-f frames]
+//--------------------------------------------------------------------------------
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "TeapotInstances.h"
+#include "jobSystem.h"
+#include "vecmath.h"
+
+using ndk_helper::Mat4;
+using ndk_helper::Vec3;
+
+// Same as the renderer: an edge of the grid is 500 across, the camera is
+// 2000 away from its center.
+const float kGridWidth = 500.f;
+const float kCameraDistance = 2000.f;
+
+// Uniform buffer layout of the renderer on most drivers
+const int32_t kMatrixStride = 16;
+const int32_t kVectorStride = 4;
+
+struct Scene {
+  std::vector<Mat4> models;
+  std::vector<float> rotation_x;
+  std::vector<float> rotation_y;
+  std::vector<float> speed_x;
+  std::vector<float> speed_y;
+};
+
+static void MakeScene(const int32_t count, Scene* scene) {
+  int32_t side = 1;
+  while (side * side * side < count) ++side;
+  const float gap = side > 1 ? kGridWidth / (side - 1) : 0.f;
+  srand(1);
+  for (int32_t i = 0; i < count; ++i) {
+    const int32_t x = i / (side * side), y = i / side % side, z = i % side;
+    scene->models.push_back(Mat4::Translation(x * gap - kGridWidth / 2.f,
+                                              y * gap - kGridWidth / 2.f,
+                                              z * gap - kGridWidth / 2.f));
+    const float rotation_x = rand() / float(RAND_MAX) - 0.5f;
+    const float rotation_y = rand() / float(RAND_MAX) - 0.5f;
+    scene->rotation_x.push_back(rotation_x * M_PI);
+    scene->rotation_y.push_back(rotation_y * M_PI);
+    scene->speed_x.push_back(rotation_x * 0.05f);
+    scene->speed_y.push_back(rotation_y * 0.05f);
+  }
+}
+
+// The color of each instance is its index, to find it after BuildGrid()
+static void InitInstances(const Scene& scene, TeapotInstances* instances) {
+  const int32_t count = static_cast<int32_t>(scene.models.size());
+  instances->Init(count);
+  for (int32_t i = 0; i < count; ++i) {
+    instances->SetInstance(i, scene.models[i], Vec3(float(i), 0.f, 0.f),
+                           scene.rotation_x[i], scene.rotation_y[i],
+                           scene.speed_x[i], scene.speed_y[i]);
+  }
+  instances->BuildGrid(1.f);
+}
+
+// The former loop, rotations are advanced in 'scene'
+static void LegacyUpdate(const Mat4& view, const Mat4& projection,
+                         Scene* scene, float* mvp, float* mv) {
+  const int32_t count = static_cast<int32_t>(scene->models.size());
+  for (int32_t i = 0; i < count; ++i) {
+    scene->rotation_x[i] += scene->speed_x[i];
+    scene->rotation_y[i] += scene->speed_y[i];
+    Mat4 mat_rotation = Mat4::RotationX(scene->rotation_x[i]) *
+                        Mat4::RotationY(scene->rotation_y[i]);
+    Mat4 mat_v = view * scene->models[i] * mat_rotation;
+    Mat4 mat_vp = projection * mat_v;
+    memcpy(mvp + i * kMatrixStride, mat_vp.Ptr(), sizeof(mat_vp));
+    memcpy(mv + i * kMatrixStride, mat_v.Ptr(), sizeof(mat_v));
+  }
+}
+
+static bool Matches(const float* expected, const float* actual) {
+  float scale = 1.f;
+  for (int32_t k = 0; k < 16; ++k) scale = fmaxf(scale, fabsf(expected[k]));
+  for (int32_t k = 0; k < 16; ++k) {
+    if (fabsf(expected[k] - actual[k]) > 1e-5f * scale) return false;
+  }
+  return true;
+}
+
+static double Median(std::vector<double>* times) {
+  std::sort(times->begin(), times->end());
+  return (*times)[times->size() / 2];
+}
+
+int main(int argc, char** argv) {
+  int32_t count = 20000;
+  int32_t threads = -1;
+  int32_t frames = 100;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:t:f:")) != -1) {
+    switch (opt) {
+      case 'n':
+        count = atoi(optarg);
+        break;
+      case 't':
+        threads = atoi(optarg);
+        break;
+      case 'f':
+        frames = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-n instances] [-t threads] [-f frames]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  if (count < 1 || frames < 1) {
+    fprintf(stderr, "need at least 1 instance and 1 frame\n");
+    return 1;
+  }
+
+  const Mat4 view = Mat4::LookAt(Vec3(0.f, 0.f, kCameraDistance),
+                                 Vec3(0.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+  const Mat4 projection = Mat4::Perspective(1.f, 0.5625f, 5.f, 10000.f);
+  Scene scene;
+  MakeScene(count, &scene);
+
+  // The mvp then the mv matrices of every instance, as in the uniform
+  // buffer of the renderer
+  std::vector<float> legacy_ubo(2 * count * kMatrixStride);
+  std::vector<float> ubo(2 * count * kMatrixStride);
+  std::vector<float> colors(count * kVectorStride);
+
+  std::vector<double> legacy_times;
+  Scene legacy_scene = scene;
+  for (int32_t f = 0; f < frames; ++f) {
+    auto start = std::chrono::steady_clock::now();
+    LegacyUpdate(view, projection, &legacy_scene, legacy_ubo.data(),
+                 legacy_ubo.data() + count * kMatrixStride);
+    auto stop = std::chrono::steady_clock::now();
+    legacy_times.push_back(
+        std::chrono::duration<double, std::milli>(stop - start).count());
+  }
+  const double legacy_ms = Median(&legacy_times);
+
+  ndk_helper::JobSystem inline_jobs(0);
+  ndk_helper::JobSystem parallel_jobs(threads);
+  printf("%d instances, median of %d frames\n", count, frames);
+  printf("  %-36s %8.3f ms  %8.1f instances/ms\n",
+         "legacy (Mat4 per instance + memcpy)", legacy_ms, count / legacy_ms);
+
+  int32_t failures = 0;
+  struct {
+    const char* name;
+    ndk_helper::JobSystem* jobs;
+  } modes[] = {{"inline", &inline_jobs}, {"parallel", &parallel_jobs}};
+  for (const auto& mode : modes) {
+    TeapotInstances instances;
+    InitInstances(scene, &instances);
+    std::vector<double> update_times, write_times;
+    for (int32_t f = 0; f < frames; ++f) {
+      auto start = std::chrono::steady_clock::now();
+      instances.Update(view, projection, *mode.jobs);
+      auto middle = std::chrono::steady_clock::now();
+      instances.Write(ubo.data(), ubo.data() + count * kMatrixStride,
+                      colors.data(), kMatrixStride, kVectorStride,
+                      *mode.jobs);
+      auto stop = std::chrono::steady_clock::now();
+      update_times.push_back(
+          std::chrono::duration<double, std::milli>(middle - start).count());
+      write_times.push_back(
+          std::chrono::duration<double, std::milli>(stop - middle).count());
+    }
+    const double update_ms = Median(&update_times);
+    const double write_ms = Median(&write_times);
+    const double total_ms = update_ms + write_ms;
+    printf("  TeapotInstances %-8s %2d threads  %8.3f ms  %8.1f instances/ms"
+           "  (Update %.3f ms, Write %.3f ms, %.2fx)\n",
+           mode.name, mode.jobs->GetThreadCount(), total_ms,
+           count / total_ms, update_ms, write_ms, legacy_ms / total_ms);
+
+    // Write() packs the instances in grid order, the color gives the index
+    int32_t mismatches = 0;
+    for (int32_t i = 0; i < count; ++i) {
+      const int32_t index = static_cast<int32_t>(colors[i * kVectorStride]);
+      if (index < 0 || index >= count ||
+          !Matches(&legacy_ubo[index * kMatrixStride],
+                   &ubo[i * kMatrixStride]) ||
+          !Matches(&legacy_ubo[(count + index) * kMatrixStride],
+                   &ubo[(count + i) * kMatrixStride]))
+        ++mismatches;
+    }
+    if (mismatches) {
+      printf("  %d instances differ from the legacy loop, FAILED\n",
+             mismatches);
+      ++failures;
+    }
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// texture-bake.cpp
+// Offline baker to the texture format of ndk_helper/textureFormat.h
+//
+//   texture-bake [-m] [-k] [-l] [-w] [-c] [-S] [-y] input.{png,tga} out.tex
+//
+// -m adds the mipmaps, filtered by ndk_helper::MipChain (-k, -l and -w pick
+// its options) and -c compresses every level to ETC2. The PSNR of each
+// compressed level against its source is printed.
+// -y flips the image vertically, as the samples do when they load with
+// stbi_set_flip_vertically_on_load(1).
+//--------------------------------------------------------------------------------
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "etc2.h"
+#include "imageFile.h"
+#include "jobSystem.h"
+#include "mipmap.h"
+#include "textureFormat.h"
+
+static uint32_t Align16(uint32_t offset) { return (offset + 15) & ~15u; }
+
+static double Psnr(const uint8_t* a, const uint8_t* b, const size_t texels,
+                   const bool alpha) {
+  const int32_t channels = alpha ? 4 : 3;
+  double sum = 0.0;
+  for (size_t i = 0; i < texels; ++i) {
+    for (int32_t c = 0; c < channels; ++c) {
+      const double d = a[i * 4 + c] - b[i * 4 + c];
+      sum += d * d;
+    }
+  }
+  if (sum == 0.0) return INFINITY;
+  return 10.0 * log10(255.0 * 255.0 * texels * channels / sum);
+}
+
+static void Usage(const char* argv0) {
+  fprintf(stderr,
+          "usage: %s [-m] [-k] [-l] [-w] [-c] [-S] [-y] input.{png,tga} "
+          "output.tex\n"
+          "  -m  add the mipmaps\n"
+          "  -k  filter them with a Kaiser window instead of a box\n"
+          "  -l  colors are linear, not sRGB\n"
+          "  -w  filter across the edges, for GL_REPEAT\n"
+          "  -c  compress to ETC2\n"
+          "  -S  use the sRGB internal formats\n"
+          "  -y  flip vertically\n",
+          argv0);
+}
+
+int main(int argc, char** argv) {
+  bool mipmaps = false;
+  bool compress = false;
+  bool srgb_format = false;
+  bool flip = false;
+  ndk_helper::MipmapOptions options;
+  int arg = 1;
+  for (; arg < argc && argv[arg][0] == '-'; ++arg) {
+    if (strcmp(argv[arg], "-m") == 0) {
+      mipmaps = true;
+    } else if (strcmp(argv[arg], "-k") == 0) {
+      options.filter = ndk_helper::MIPMAP_FILTER_KAISER;
+    } else if (strcmp(argv[arg], "-l") == 0) {
+      options.srgb = false;
+    } else if (strcmp(argv[arg], "-w") == 0) {
+      options.wrap = true;
+    } else if (strcmp(argv[arg], "-c") == 0) {
+      compress = true;
+    } else if (strcmp(argv[arg], "-S") == 0) {
+      srgb_format = true;
+    } else if (strcmp(argv[arg], "-y") == 0) {
+      flip = true;
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+  if (argc - arg != 2 || (srgb_format && !options.srgb)) {
+    Usage(argv[0]);
+    return 1;
+  }
+  const char* input = argv[arg];
+  const char* output = argv[arg + 1];
+
+  int32_t width, height;
+  std::vector<uint8_t> image;
+  if (!ReadImage(input, &width, &height, &image)) {
+    fprintf(stderr, "%s: can't read, PNG and TGA only\n", input);
+    return 1;
+  }
+  if (flip) {
+    const size_t row = static_cast<size_t>(width) * 4;
+    for (int32_t y = 0; y < height / 2; ++y)
+      std::swap_ranges(&image[y * row], &image[(y + 1) * row],
+                       &image[(height - 1 - y) * row]);
+  }
+  bool opaque = true;
+  for (size_t i = 3; i < image.size() && opaque; i += 4)
+    opaque = image[i] == 255;
+
+  ndk_helper::JobSystem jobs;
+  ndk_helper::MipChain chain;
+  if (!chain.Generate(image.data(), width, height, options, &jobs)) {
+    fprintf(stderr, "%s: %dx%d is too large\n", input, width, height);
+    return 1;
+  }
+  const int32_t level_count = mipmaps ? chain.GetLevelCount() : 1;
+
+  TEXTURE_HEADER header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, TEXTURE_MAGIC, 4);
+  header.version = TEXTURE_VERSION;
+  if (compress) {
+    header.gl_internal_format =
+        opaque ? (srgb_format ? TEXTURE_GL_COMPRESSED_SRGB8_ETC2
+                              : TEXTURE_GL_COMPRESSED_RGB8_ETC2)
+               : (srgb_format ? TEXTURE_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC
+                              : TEXTURE_GL_COMPRESSED_RGBA8_ETC2_EAC);
+  } else {
+    header.gl_internal_format =
+        srgb_format ? TEXTURE_GL_SRGB8_ALPHA8 : TEXTURE_GL_RGBA;
+    header.gl_format = TEXTURE_GL_RGBA;
+    header.gl_type = TEXTURE_GL_UNSIGNED_BYTE;
+  }
+  header.flags = (options.srgb ? TEXTURE_FLAG_SRGB : 0) |
+                 (opaque ? TEXTURE_FLAG_OPAQUE : 0);
+  header.width = width;
+  header.height = height;
+  header.level_count = level_count;
+  header.level_offset = Align16(sizeof(header));
+
+  std::vector<TEXTURE_LEVEL> levels(level_count);
+  std::vector<std::vector<uint8_t> > data(level_count);
+  uint32_t offset = Align16(header.level_offset +
+                            level_count * sizeof(TEXTURE_LEVEL));
+  printf("%s: %dx%d, %s, %d level(s)\n", output, width, height,
+         opaque ? "opaque" : "with alpha", level_count);
+  for (int32_t l = 0; l < level_count; ++l) {
+    const int32_t w = chain.GetWidth(l), h = chain.GetHeight(l);
+    const uint8_t* texels = chain.GetLevel(l);
+    if (compress) {
+      data[l].resize(ndk_helper::etc2::GetImageSize(w, h, !opaque));
+      ndk_helper::etc2::EncodeImage(texels, w, h, !opaque, data[l].data(),
+                                    &jobs);
+      std::vector<uint8_t> decoded(static_cast<size_t>(w) * h * 4);
+      ndk_helper::etc2::DecodeImage(data[l].data(), w, h, !opaque,
+                                    decoded.data());
+      printf("  level %2d %4dx%-4d %8zu bytes, PSNR %.2f dB\n", l, w, h,
+             data[l].size(),
+             Psnr(texels, decoded.data(), static_cast<size_t>(w) * h,
+                  !opaque));
+    } else {
+      data[l].assign(texels, texels + static_cast<size_t>(w) * h * 4);
+    }
+    levels[l].width = w;
+    levels[l].height = h;
+    levels[l].data_offset = offset;
+    levels[l].data_size = static_cast<uint32_t>(data[l].size());
+    offset = Align16(offset + levels[l].data_size);
+  }
+
+  std::vector<uint8_t> file(levels.back().data_offset +
+                            levels.back().data_size);
+  memcpy(file.data(), &header, sizeof(header));
+  memcpy(&file[header.level_offset], levels.data(),
+         level_count * sizeof(TEXTURE_LEVEL));
+  for (int32_t l = 0; l < level_count; ++l)
+    memcpy(&file[levels[l].data_offset], data[l].data(), data[l].size());
+
+  // Write a temporary file first so that a failure leaves no partial texture.
+  std::string tmp_path = std::string(output) + ".tmp";
+  FILE* f = fopen(tmp_path.c_str(), "wb");
+  if (f == NULL) {
+    perror(tmp_path.c_str());
+    return 1;
+  }
+  bool ok = fwrite(file.data(), 1, file.size(), f) == file.size();
+  ok = fclose(f) == 0 && ok;
+  if (!ok || rename(tmp_path.c_str(), output) != 0) {
+    perror(output);
+    remove(tmp_path.c_str());
+    return 1;
+  }
+  printf("  %zu bytes, level 0 at %.2f bits per texel\n", file.size(),
+         data[0].size() * 8.0 / (static_cast<double>(width) * height));
+  return 0;
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// texture-bench.cpp
+// Startup cost of the six cubemap faces of the textured-teapot (TGA) or
+// image-decoder (PNG) sample, up to the point where the texels are ready for
+// glTexImage2D():
+// - tga, png:  decoding the images, level 0 only, as the samples first did;
+// - +mips:     decoding them and filtering the mipmaps with MipChain;
+// - baked:     mapping the .tex files of texture-bake, reading every level
+//              once as the upload would.
+// The images are the .tga files of the directory, or its .png files when
+// it has no TGA.
+// Each mode runs in its own process so that its peak resident memory is its
+// own. The sizes GL is handed are printed as well.
+//
+//   texture-bench [-r runs] [-c] [textures dir]
+//
+// -c drops the files from the page cache before each run (cold start).
+//--------------------------------------------------------------------------------
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "imageFile.h"
+#include "jobSystem.h"
+#include "mipmap.h"
+#include "textureFile.h"
+
+static double Ms(std::chrono::steady_clock::time_point a,
+                 std::chrono::steady_clock::time_point b) {
+  return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+static double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+// VmRSS or VmHWM of this process in KiB
+static int64_t StatusKb(const char* field) {
+  FILE* f = fopen("/proc/self/status", "r");
+  if (f == NULL) return -1;
+  char line[256];
+  int64_t kb = -1;
+  const size_t length = strlen(field);
+  while (fgets(line, sizeof(line), f)) {
+    if (strncmp(line, field, length) == 0 && line[length] == ':') {
+      kb = atoll(line + length + 1);
+      break;
+    }
+  }
+  fclose(f);
+  return kb;
+}
+
+// Restarts VmHWM from the current resident size
+static bool ResetPeak() {
+  FILE* f = fopen("/proc/self/clear_refs", "w");
+  if (f == NULL) return false;
+  const bool ok = fputs("5", f) >= 0;
+  return fclose(f) == 0 && ok;
+}
+
+static void DropCache(const std::string& path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return;
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+enum Mode { MODE_IMAGE, MODE_IMAGE_MIPS, MODE_BAKED };
+
+struct Sample {
+  double ms;
+  int64_t peak_kb;  // Above the resident size before the run
+  uint64_t gl_bytes;  // What glTexImage2D() is handed
+  uint32_t checksum;  // Keeps the reads from being optimized out
+};
+
+// One load of the six faces, what stays alive until the upload is done
+static bool Run(const Mode mode, const std::vector<std::string>& files,
+                Sample* sample) {
+  const int64_t base_kb = StatusKb("VmRSS");
+  const bool reset = ResetPeak();
+  auto t0 = std::chrono::steady_clock::now();
+
+  uint32_t checksum = 0;
+  uint64_t gl_bytes = 0;
+  if (mode == MODE_BAKED) {
+    ndk_helper::TextureFile faces[6];
+    for (int32_t i = 0; i < 6; ++i) {
+      if (!faces[i].LoadFile(files[i].c_str())) return false;
+      for (int32_t l = 0; l < faces[i].GetLevelCount(); ++l) {
+        const uint8_t* data = faces[i].GetLevelData(l);
+        const size_t size = faces[i].GetLevelSize(l);
+        for (size_t b = 0; b < size; b += 4)
+          checksum =
+              checksum * 31 + *reinterpret_cast<const uint32_t*>(data + b);
+        gl_bytes += size;
+      }
+    }
+  } else {
+    ndk_helper::JobSystem jobs;
+    ndk_helper::MipmapOptions options;
+    std::vector<uint8_t> images[6];
+    ndk_helper::MipChain chains[6];
+    for (int32_t i = 0; i < 6; ++i) {
+      int32_t width, height;
+      if (!ReadImage(files[i], &width, &height, &images[i])) return false;
+      if (mode == MODE_IMAGE) {
+        for (size_t b = 0; b < images[i].size(); b += 4)
+          checksum = checksum * 31 + images[i][b];
+        gl_bytes += images[i].size();
+        continue;
+      }
+      if (!chains[i].Generate(images[i].data(), width, height, options, &jobs))
+        return false;
+      std::vector<uint8_t>().swap(images[i]);
+      for (int32_t l = 0; l < chains[i].GetLevelCount(); ++l) {
+        const size_t size = static_cast<size_t>(chains[i].GetWidth(l)) *
+                            chains[i].GetHeight(l) * 4;
+        checksum = checksum * 31 + chains[i].GetLevel(l)[size - 1];
+        gl_bytes += size;
+      }
+    }
+  }
+
+  sample->ms = Ms(t0, std::chrono::steady_clock::now());
+  sample->peak_kb = reset ? StatusKb("VmHWM") - base_kb : -1;
+  sample->gl_bytes = gl_bytes;
+  sample->checksum = checksum;
+  return true;
+}
+
+// Runs a mode in a child process, runs times
+static bool Measure(const Mode mode, const std::vector<std::string>& files,
+                    const int32_t runs, const bool cold,
+                    std::vector<Sample>* samples) {
+  for (int32_t run = 0; run < runs; ++run) {
+    if (cold)
+      for (const std::string& file : files) DropCache(file);
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    const pid_t pid = fork();
+    if (pid == 0) {
+      close(fds[0]);
+      Sample sample;
+      const bool ok = Run(mode, files, &sample) &&
+                      write(fds[1], &sample, sizeof(sample)) == sizeof(sample);
+      _exit(ok ? 0 : 1);
+    }
+    close(fds[1]);
+    Sample sample;
+    const bool received =
+        pid > 0 && read(fds[0], &sample, sizeof(sample)) == sizeof(sample);
+    close(fds[0]);
+    int status = 0;
+    if (pid > 0) waitpid(pid, &status, 0);
+    if (!received || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      return false;
+    samples->push_back(sample);
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int32_t runs = 5;
+  bool cold = false;
+  int opt;
+  while ((opt = getopt(argc, argv, "r:c")) != -1) {
+    switch (opt) {
+      case 'r':
+        runs = std::max(1, atoi(optarg));
+        break;
+      case 'c':
+        cold = true;
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-r runs] [-c] [textures dir]\n", argv[0]);
+        return 1;
+    }
+  }
+  const std::string dir = optind < argc
+                              ? argv[optind]
+                              : "textured-teapot/src/main/assets/Textures";
+
+  // Cubemap order, as in TexturedTeapotRender
+  const char* kFaces[6] = {"right", "left", "bottom", "top", "front", "back"};
+  const std::string extension =
+      access((dir + "/" + kFaces[0] + ".tga").c_str(), R_OK) == 0 ? "tga"
+                                                                    : "png";
+  std::vector<std::string> images, tex;
+  for (const char* face : kFaces) {
+    images.push_back(dir + "/" + face + "." + extension);
+    tex.push_back(dir + "/" + face + ".tex");
+  }
+
+  const std::string mips = extension + "+mips";
+  struct {
+    Mode mode;
+    const char* name;
+    const std::vector<std::string>* files;
+  } modes[3] = {{MODE_IMAGE, extension.c_str(), &images},
+                {MODE_IMAGE_MIPS, mips.c_str(), &images},
+                {MODE_BAKED, "baked", &tex}};
+  printf("6 faces, %d runs, %s page cache\n", runs, cold ? "cold" : "warm");
+  printf("  %-9s %10s %14s %14s\n", "", "time", "peak RSS", "handed to GL");
+  for (const auto& m : modes) {
+    std::vector<Sample> samples;
+    if (!Measure(m.mode, *m.files, runs, cold, &samples)) {
+      fprintf(stderr, "%s: failed to load the faces in %s\n", m.name,
+              dir.c_str());
+      return 1;
+    }
+    std::vector<double> ms, peak;
+    for (const Sample& s : samples) {
+      ms.push_back(s.ms);
+      peak.push_back(static_cast<double>(s.peak_kb));
+    }
+    const double peak_kb = Median(peak);
+    printf("  %-9s %7.2f ms ", m.name, Median(ms));
+    if (peak_kb >= 0)
+      printf("%10.0f KiB ", peak_kb);
+    else
+      printf("%14s ", "n/a");
+    printf("%10.0f KiB\n", samples[0].gl_bytes / 1024.0);
+  }
+  return 0;
+}
@@ -0,0 +1,450 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// vecmath-test.cpp
+// Checks the SSE/NEON paths of ndk_helper::Mat4 (Mat4 * Vec4, Inverse()
+// and the structure-of-arrays batch functions) against the scalar build of
+// the same code (vecmathScalar.h), then times both. Mat4 * Mat4 is scalar
+// in both builds; it is still checked and timed, as the baseline that kept
+// it scalar.
+//
+// The SIMD paths do the same operations in the same order, so the results
+// are expected to be bit-identical; the check only fails beyond a few ulps
+// of the magnitude of the terms, since a compiler may still contract the
+// scalar code into fused multiply-adds.
+//
+//   vecmath-test [-n cases] [-i iterations]
+//--------------------------------------------------------------------------------
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "vecmath.h"
+#include "vecmathScalar.h"
+
+using ndk_helper::Mat4;
+using ndk_helper::Mat4Array;
+using ndk_helper::Vec4;
+using ndk_helper::Vec4Array;
+
+namespace {
+
+// Keeps the benchmark loops from being optimized away
+volatile float g_sink;
+
+// Mismatches of one operation
+struct Check {
+  const char* name;
+  int64_t values;
+  int64_t identical;
+  int64_t failures;
+  double max_error;  // relative to the bound of each value
+};
+
+void Compare(Check* check, const float actual, const float expected,
+             const double bound) {
+  const double error = fabs((double)actual - (double)expected);
+  check->values++;
+  if (memcmp(&actual, &expected, sizeof(float)) == 0) {
+    check->identical++;
+    return;
+  }
+  if (!(error <= bound)) {
+    if (check->failures++ < 5)
+      printf("  %s: %.9g instead of %.9g\n", check->name, actual, expected);
+  }
+  if (bound > 0 && error / bound > check->max_error)
+    check->max_error = error / bound;
+}
+
+// A few ulps of the sum of the magnitudes of the 4 products of element
+// 'row' of lhs * rhs, rhs being one column
+double ProductBound(const float* lhs, const float* rhs, const int32_t row) {
+  double sum = 0;
+  for (int32_t k = 0; k < 4; ++k)
+    sum += fabs((double)lhs[k * 4 + row] * rhs[k]);
+  return 4 * FLT_EPSILON * sum + FLT_MIN;
+}
+
+void RandomMatrix(std::mt19937* rng, float* m) {
+  std::uniform_real_distribution<float> value(-10.f, 10.f);
+  for (int32_t i = 0; i < 16; ++i) m[i] = value(*rng);
+}
+
+// Rotation, scale and translation, the matrices Inverse() is meant for
+void RandomAffine(std::mt19937* rng, float* m) {
+  std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+  std::uniform_real_distribution<float> scale(0.25f, 4.f);
+  std::uniform_real_distribution<float> offset(-100.f, 100.f);
+  Mat4 ret = Mat4::Translation(offset(*rng), offset(*rng), offset(*rng)) *
+             Mat4::RotationX(angle(*rng)) * Mat4::RotationY(angle(*rng)) *
+             Mat4::RotationZ(angle(*rng)) *
+             Mat4::Scale(scale(*rng), scale(*rng), scale(*rng));
+  memcpy(m, ret.Ptr(), 16 * sizeof(float));
+}
+
+void CheckMultiply(Check* check, const float* lhs, const float* rhs,
+                   const float* actual) {
+  float expected[16];
+  vecmath_scalar::Multiply(lhs, rhs, expected);
+  for (int32_t i = 0; i < 16; ++i)
+    Compare(check, actual[i], expected[i],
+            ProductBound(lhs, rhs + (i & ~3), i & 3));
+}
+
+void CheckTransform(Check* check, const float* m, const float* v,
+                    const float* actual) {
+  float expected[4];
+  vecmath_scalar::Transform(m, v, expected);
+  for (int32_t i = 0; i < 4; ++i)
+    Compare(check, actual[i], expected[i], ProductBound(m, v, i));
+}
+
+void CheckInverse(Check* check, const float* m, const float* actual) {
+  float expected[16];
+  float largest = 0;
+  vecmath_scalar::Inverse(m, expected);
+  for (int32_t i = 0; i < 16; ++i)
+    largest = fmaxf(largest, fabsf(expected[i]));
+  for (int32_t i = 0; i < 16; ++i)
+    Compare(check, actual[i], expected[i], 16 * FLT_EPSILON * largest);
+}
+
+bool Report(const Check& check) {
+  printf("  %-16s %9lld values  %9lld bit-identical  largest error %.2f of "
+         "the bound  %s\n",
+         check.name, (long long)check.values, (long long)check.identical,
+         check.max_error, check.failures ? "FAILED" : "ok");
+  return check.failures == 0;
+}
+
+// Structure-of-arrays storage for 'count' elements
+struct Vec4Storage {
+  int32_t stride;
+  std::vector<float> data;
+  explicit Vec4Storage(const int32_t count)
+      : stride(count + 1), data(4 * stride) {}
+  Vec4Array Array() {
+    float* p = data.data();
+    return {p, p + stride, p + 2 * stride, p + 3 * stride};
+  }
+  void Get(const int32_t i, float* v) const {
+    for (int32_t k = 0; k < 4; ++k) v[k] = data[k * stride + i];
+  }
+  void Set(const int32_t i, const float* v) {
+    for (int32_t k = 0; k < 4; ++k) data[k * stride + i] = v[k];
+  }
+};
+
+struct Mat4Storage {
+  int32_t stride;
+  std::vector<float> data;
+  explicit Mat4Storage(const int32_t count)
+      : stride(count + 1), data(16 * stride) {}
+  Mat4Array Array() {
+    Mat4Array ret;
+    for (int32_t k = 0; k < 16; ++k) ret.f[k] = data.data() + k * stride;
+    return ret;
+  }
+  void Get(const int32_t i, float* m) const {
+    for (int32_t k = 0; k < 16; ++k) m[k] = data[k * stride + i];
+  }
+  void Set(const int32_t i, const float* m) {
+    for (int32_t k = 0; k < 16; ++k) data[k * stride + i] = m[k];
+  }
+};
+
+// Every batch function for every count up to 'max_count', in place and
+// not, checked element by element against the scalar single operations
+void CheckBatches(std::mt19937* rng, const int32_t max_count,
+                  Check* transform, Check* multiply, Check* multiplies,
+                  Check* copy) {
+  for (int32_t count = 0; count <= max_count; ++count) {
+    for (int32_t in_place = 0; in_place < 2; ++in_place) {
+      float m[16];
+      RandomMatrix(rng, m);
+      Mat4 mat(m);
+
+      Vec4Storage vin(count), vout(count);
+      std::uniform_real_distribution<float> value(-10.f, 10.f);
+      for (int32_t i = 0; i < count; ++i) {
+        float v[4];
+        for (int32_t k = 0; k < 4; ++k) v[k] = value(*rng);
+        vin.Set(i, v);
+      }
+      const Vec4Storage vsaved = vin;
+      Vec4Storage* vdst = in_place ? &vin : &vout;
+      mat.TransformArray(vin.Array(), vdst->Array(), count);
+      for (int32_t i = 0; i < count; ++i) {
+        float v[4], actual[4];
+        vsaved.Get(i, v);
+        vdst->Get(i, actual);
+        CheckTransform(transform, m, v, actual);
+      }
+
+      Mat4Storage lhs(count), rhs(count), out(count);
+      for (int32_t i = 0; i < count; ++i) {
+        float a[16], b[16];
+        RandomMatrix(rng, a);
+        RandomMatrix(rng, b);
+        lhs.Set(i, a);
+        rhs.Set(i, b);
+      }
+      const Mat4Storage lhs_saved = lhs;
+      const Mat4Storage rhs_saved = rhs;
+      Mat4Storage* dst = in_place ? &rhs : &out;
+      mat.MultiplyArray(rhs.Array(), dst->Array(), count);
+      for (int32_t i = 0; i < count; ++i) {
+        float b[16], actual[16];
+        rhs_saved.Get(i, b);
+        dst->Get(i, actual);
+        CheckMultiply(multiply, m, b, actual);
+      }
+
+      // Restore rhs, which may have been overwritten
+      for (int32_t i = 0; i < count; ++i) {
+        float b[16];
+        rhs_saved.Get(i, b);
+        rhs.Set(i, b);
+      }
+      dst = in_place ? &lhs : &out;
+      Mat4::MultiplyArrays(lhs.Array(), rhs.Array(), dst->Array(), count);
+      for (int32_t i = 0; i < count; ++i) {
+        float a[16], b[16], actual[16];
+        lhs_saved.Get(i, a);
+        rhs_saved.Get(i, b);
+        dst->Get(i, actual);
+        CheckMultiply(multiplies, a, b, actual);
+      }
+
+      // CopyArray is a transpose, it has to be exact
+      const int32_t stride = 16 + in_place * 4;
+      Mat4Storage source = rhs_saved;
+      std::vector<float> copied(count * stride + 1);
+      Mat4::CopyArray(source.Array(), count, copied.data(), stride);
+      for (int32_t i = 0; i < count; ++i) {
+        float b[16];
+        rhs_saved.Get(i, b);
+        for (int32_t k = 0; k < 16; ++k)
+          Compare(copy, copied[i * stride + k], b[k], 0);
+      }
+    }
+  }
+}
+
+double NsPer(std::chrono::steady_clock::time_point a,
+             std::chrono::steady_clock::time_point b, const int64_t count) {
+  return std::chrono::duration<double, std::nano>(b - a).count() / count;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int32_t cases = 200000;
+  int32_t iterations = 2000000;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:i:")) != -1) {
+    switch (opt) {
+      case 'n':
+        cases = atoi(optarg);
+        break;
+      case 'i':
+        iterations = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-n cases] [-i iterations]\n", argv[0]);
+        return 1;
+    }
+  }
+  if (cases <= 0 || iterations <= 0) {
+    fprintf(stderr, "usage: %s [-n cases] [-i iterations]\n", argv[0]);
+    return 1;
+  }
+
+  std::mt19937 rng(1234);
+  Check mul = {"Mat4 * Mat4"}, transform = {"Mat4 * Vec4"},
+        inverse = {"Inverse"}, transform_array = {"TransformArray"},
+        multiply_array = {"MultiplyArray"},
+        multiply_arrays = {"MultiplyArrays"}, copy_array = {"CopyArray"};
+
+  printf("%d random cases per operation, batch counts 0..67\n", cases);
+  for (int32_t n = 0; n < cases; ++n) {
+    float a[16], b[16], v[4], actual[16];
+    std::uniform_real_distribution<float> value(-10.f, 10.f);
+    RandomMatrix(&rng, a);
+    RandomMatrix(&rng, b);
+    for (int32_t i = 0; i < 4; ++i) v[i] = value(rng);
+
+    Mat4 product = Mat4(a) * Mat4(b);
+    CheckMultiply(&mul, a, b, product.Ptr());
+
+    Vec4 t = Mat4(a) * Vec4(v[0], v[1], v[2], v[3]);
+    t.Value(actual[0], actual[1], actual[2], actual[3]);
+    CheckTransform(&transform, a, v, actual);
+
+    RandomAffine(&rng, a);
+    Mat4 inv = Mat4(a).Inverse();
+    CheckInverse(&inverse, a, inv.Ptr());
+  }
+  CheckBatches(&rng, 67, &transform_array, &multiply_array, &multiply_arrays,
+               &copy_array);
+
+  bool ok = Report(mul);
+  ok &= Report(transform);
+  ok &= Report(inverse);
+  ok &= Report(transform_array);
+  ok &= Report(multiply_array);
+  ok &= Report(multiply_arrays);
+  ok &= Report(copy_array);
+
+  // Timings over a set of inputs that stays in the cache
+  const int32_t kSet = 256;
+  std::vector<float> mats(kSet * 16), vecs(kSet * 4);
+  for (int32_t i = 0; i < kSet; ++i) {
+    RandomAffine(&rng, &mats[i * 16]);
+    for (int32_t k = 0; k < 4; ++k) vecs[i * 4 + k] = (float)(i + k);
+  }
+  printf("ns per operation, %d iterations:\n", iterations);
+  printf("  %-16s %9s %9s\n", "", "scalar", "SIMD");
+
+  {
+    float out[16];
+    float sum = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int32_t n = 0; n < iterations; ++n) {
+      const int32_t i = n & (kSet - 1), j = (n * 7 + 1) & (kSet - 1);
+      vecmath_scalar::Multiply(&mats[i * 16], &mats[j * 16], out);
+      sum += out[n & 15];
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int32_t n = 0; n < iterations; ++n) {
+      const int32_t i = n & (kSet - 1), j = (n * 7 + 1) & (kSet - 1);
+      Mat4 ret = Mat4(&mats[i * 16]) * Mat4(&mats[j * 16]);
+      sum += ret.Ptr()[n & 15];
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    g_sink = sum;
+    printf("  %-16s %9.2f %9.2f\n", "Mat4 * Mat4", NsPer(t0, t1, iterations),
+           NsPer(t1, t2, iterations));
+  }
+  {
+    float out[4];
+    float sum = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int32_t n = 0; n < iterations; ++n) {
+      const int32_t i = n & (kSet - 1);
+      vecmath_scalar::Transform(&mats[i * 16], &vecs[i * 4], out);
+      sum += out[n & 3];
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int32_t n = 0; n < iterations; ++n) {
+      const int32_t i = n & (kSet - 1);
+      Vec4 ret = Mat4(&mats[i * 16]) * Vec4(&vecs[i * 4]);
+      ret.Value(out[0], out[1], out[2], out[3]);
+      sum += out[n & 3];
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    g_sink = sum;
+    printf("  %-16s %9.2f %9.2f\n", "Mat4 * Vec4", NsPer(t0, t1, iterations),
+           NsPer(t1, t2, iterations));
+  }
+  {
+    float out[16];
+    float sum = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int32_t n = 0; n < iterations; ++n) {
+      vecmath_scalar::Inverse(&mats[(n & (kSet - 1)) * 16], out);
+      sum += out[n & 15];
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int32_t n = 0; n < iterations; ++n) {
+      Mat4 ret = Mat4(&mats[(n & (kSet - 1)) * 16]).Inverse();
+      sum += ret.Ptr()[n & 15];
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    g_sink = sum;
+    printf("  %-16s %9.2f %9.2f\n", "Inverse", NsPer(t0, t1, iterations),
+           NsPer(t1, t2, iterations));
+  }
+
+  // Batches, per element: the scalar column is the loop of single scalar
+  // operations over the same arrays
+  {
+    Vec4Storage in(kSet), out(kSet);
+    Mat4Storage rhs(kSet), dst(kSet);
+    for (int32_t i = 0; i < kSet; ++i) {
+      in.Set(i, &vecs[i * 4]);
+      rhs.Set(i, &mats[i * 16]);
+    }
+    const int32_t rounds = iterations / kSet + 1;
+    const int64_t elements = (int64_t)rounds * kSet;
+    const Mat4 m(&mats[0]);
+    float sum = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int32_t r = 0; r < rounds; ++r) {
+      for (int32_t i = 0; i < kSet; ++i) {
+        float v[4], ret[4];
+        in.Get(i, v);
+        vecmath_scalar::Transform(&mats[0], v, ret);
+        out.Set(i, ret);
+      }
+      sum += out.data[r & (kSet - 1)];
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int32_t r = 0; r < rounds; ++r) {
+      m.TransformArray(in.Array(), out.Array(), kSet);
+      sum += out.data[r & (kSet - 1)];
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    printf("  %-16s %9.2f %9.2f  per element\n", "TransformArray",
+           NsPer(t0, t1, elements), NsPer(t1, t2, elements));
+
+    t0 = std::chrono::steady_clock::now();
+    for (int32_t r = 0; r < rounds; ++r) {
+      for (int32_t i = 0; i < kSet; ++i) {
+        float b[16], ret[16];
+        rhs.Get(i, b);
+        vecmath_scalar::Multiply(&mats[0], b, ret);
+        dst.Set(i, ret);
+      }
+      sum += dst.data[r & (kSet - 1)];
+    }
+    t1 = std::chrono::steady_clock::now();
+    for (int32_t r = 0; r < rounds; ++r) {
+      m.MultiplyArray(rhs.Array(), dst.Array(), kSet);
+      sum += dst.data[r & (kSet - 1)];
+    }
+    t2 = std::chrono::steady_clock::now();
+    printf("  %-16s %9.2f %9.2f  per element\n", "MultiplyArray",
+           NsPer(t0, t1, elements), NsPer(t1, t2, elements));
+    g_sink = sum;
+  }
+
+  if (!ok) {
+    printf("FAILED\n");
+    return 1;
+  }
+  return 0;
+}
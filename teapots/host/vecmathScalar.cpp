@@ -0,0 +1,44 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// vecmathScalar.cpp
+// Built with VECMATH_NO_SIMD and ndk_helper renamed to ndk_helper_scalar,
+// next to the scalar build of vecmath.cpp.
+//--------------------------------------------------------------------------------
+#include "vecmathScalar.h"
+
+#include "vecmath.h"
+
+namespace vecmath_scalar {
+
+void Multiply(const float* lhs, const float* rhs, float* out) {
+  ndk_helper::Mat4 ret = ndk_helper::Mat4(lhs) * ndk_helper::Mat4(rhs);
+  for (int i = 0; i < 16; ++i) out[i] = ret.Ptr()[i];
+}
+
+void Transform(const float* m, const float* v, float* out) {
+  ndk_helper::Vec4 ret =
+      ndk_helper::Mat4(m) * ndk_helper::Vec4(v[0], v[1], v[2], v[3]);
+  ret.Value(out[0], out[1], out[2], out[3]);
+}
+
+void Inverse(const float* m, float* out) {
+  ndk_helper::Mat4 ret = ndk_helper::Mat4(m).Inverse();
+  for (int i = 0; i < 16; ++i) out[i] = ret.Ptr()[i];
+}
+
+}  // namespace vecmath_scalar
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// vecmathScalar.h
+// The scalar code of ndk_helper's vecmath.cpp, built a second time with
+// VECMATH_NO_SIMD in its own namespace (see CMakeLists.txt) so that
+// vecmath-test can check the SSE/NEON paths against it. Matrices are column
+// major float[16], vectors float[4].
+//--------------------------------------------------------------------------------
+#ifndef VECMATHSCALAR_H_
+#define VECMATHSCALAR_H_
+
+namespace vecmath_scalar {
+
+// out = lhs * rhs
+void Multiply(const float* lhs, const float* rhs, float* out);
+
+// out = m * v
+void Transform(const float* m, const float* v, float* out);
+
+// out = inverse of the affine matrix m
+void Inverse(const float* m, float* out);
+
+}  // namespace vecmath_scalar
+
+#endif  // VECMATHSCALAR_H_
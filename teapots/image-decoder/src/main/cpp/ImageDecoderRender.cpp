@@ -18,18 +18,21 @@
 
 /**
  * Texture Coordinators for 2D texture:
- *    they are declared in file model file teapot.inl with tiles
+ *    they are stored in the model file teapot.mesh with tiles
  *    for front and back teapot faces. If you do not want see
  *    the tiles but would like to see the stretched version, simply
  *    divide the texCoord by 2. Macro TILED_TEXTURE is for this purpose.
- *
- * teapot.inl file already included in TeapotRenderer.cpp, we directly
- * use! -- nice
  */
 #define TILED_TEXTURE 0
 
-extern float teapotTexCoords[];
-constexpr int32_t kCoordElementCount = (TILED_TEXTURE ? 3 : 2);
+constexpr float kTexCoordScale = (TILED_TEXTURE ? 1.f : 0.5f);
+
+/**
+ * Decode the texture images on ImageLoader threads, the teapot shows with a
+ * placeholder until they are uploaded. When false, Init() decodes them one
+ * after the other before returning, as it used to.
+ */
+#define ASYNC_TEXTURE_LOAD 1
 
 /**
  * Constructor: all work is done inside Init() function.
@@ -80,28 +83,24 @@ void ImageDecoderRender::Init(AAssetManager* assetMgr) {
     assert(texVbo_ != GL_INVALID_VALUE);
 
     /*
-     * Loading Texture coord directly from data declared in model file
-     *   teapot.inl
-     * which is 3 floats/vertex.
+     * Texture coords come from the model file teapot.mesh, scaled into
+     * their own buffer.
      */
     glBindBuffer(GL_ARRAY_BUFFER, texVbo_);
 
-#if (TILED_TEXTURE)
-    glBufferData(GL_ARRAY_BUFFER,
-                 kCoordElementCount * sizeof(float) * num_vertices_,
-                 teapotTexCoords, GL_STATIC_DRAW);
-#else
     std::vector<float> coords;
+    coords.reserve(2 * num_vertices_);
     for (int32_t idx = 0; idx < num_vertices_; idx++) {
-      coords.push_back(teapotTexCoords[3 * idx] / 2);
-      coords.push_back(teapotTexCoords[3 * idx + 1] / 2);
+      ndk_helper::Vec2 coord = mesh_.GetTexCoord(idx) * kTexCoordScale;
+      float uv[2];
+      coord.Value(uv[0], uv[1]);
+      coords.push_back(uv[0]);
+      coords.push_back(uv[1]);
     }
-    glBufferData(GL_ARRAY_BUFFER,
-                 kCoordElementCount * sizeof(float) * num_vertices_,
+    glBufferData(GL_ARRAY_BUFFER, 2 * sizeof(float) * num_vertices_,
                  coords.data(), GL_STATIC_DRAW);
-#endif
-    glVertexAttribPointer(ATTRIB_UV, 2, GL_FLOAT, GL_FALSE,
-                          kCoordElementCount * sizeof(float), BUFFER_OFFSET(0));
+    glVertexAttribPointer(ATTRIB_UV, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float),
+                          BUFFER_OFFSET(0));
     glEnableVertexAttribArray(ATTRIB_UV);
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -121,8 +120,19 @@ void ImageDecoderRender::Init(AAssetManager* assetMgr) {
     textures[0] = std::string("Textures/front.png");
   }
 
-  texObj_ = Texture::Create(type, textures, assetMgr);
+  load_start_time_ = ndk_helper::PerfMonitor::GetCurrentTime();
+  ImageLoader* loader = nullptr;
+  if (ASYNC_TEXTURE_LOAD) {
+    if (!loader_) loader_.reset(new ImageLoader());
+    loader = loader_.get();
+  }
+  texObj_ = Texture::Create(type, textures, assetMgr, loader);
   assert(texObj_);
+  if (texObj_->IsReady()) {
+    LOGI("Textures loaded in %.1f ms",
+         (ndk_helper::PerfMonitor::GetCurrentTime() - load_start_time_) *
+             1000.0);
+  }
 
   std::vector<std::string> samplers;
   std::vector<GLint> units;
@@ -141,7 +151,32 @@ void ImageDecoderRender::Init(AAssetManager* assetMgr) {
  *   enable states for rendering and reader a frame.
  *   For Texture, simply inform GL to stream texture coord from _texVbo
  */
-void ImageDecoderRender::Render() { TeapotRenderer::Render(); }
+void ImageDecoderRender::Render() {
+  UploadTextures();
+  TeapotRenderer::Render();
+}
+
+/**
+ * UploadTextures()
+ *    hand the images decoded since the last frame to the texture, on the GL
+ *    thread. Images of a texture unloaded meanwhile go back to the loader.
+ */
+void ImageDecoderRender::UploadTextures() {
+  if (!loader_) return;
+  loader_->Poll(&results_);
+  for (auto& result : results_) {
+    if (texObj_ && texObj_->Upload(result)) {
+      if (texObj_->IsReady()) {
+        LOGI("Textures decoded in %.1f ms on %d threads",
+             (ndk_helper::PerfMonitor::GetCurrentTime() - load_start_time_) *
+                 1000.0,
+             loader_->GetThreadCount());
+      }
+    } else {
+      loader_->Recycle(&result.image);
+    }
+  }
+}
 
 /**
  * Unload()
@@ -153,6 +188,8 @@ void ImageDecoderRender::Unload() {
     glDeleteBuffers(1, &texVbo_);
     texVbo_ = GL_INVALID_VALUE;
   }
+  // Decodes not started are of no use anymore
+  if (loader_) loader_->Cancel();
   if (texObj_) {
     Texture::Delete(texObj_);
     texObj_ = nullptr;
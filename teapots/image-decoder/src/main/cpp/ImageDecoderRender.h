@@ -16,6 +16,9 @@
 
 #ifndef TEAPOTS_IMAGEDECODERRENDER_H
 #define TEAPOTS_IMAGEDECODERRENDER_H
+#include <memory>
+
+#include "ImageLoader.h"
 #include "TeapotRenderer.h"
 #include "Texture.h"
 /**
@@ -29,6 +32,13 @@ class ImageDecoderRender : public TeapotRenderer {
   GLuint texVbo_ = GL_INVALID_VALUE;
   Texture* texObj_ = nullptr;
 
+  // Decodes the texture images while the teapot renders with a placeholder
+  std::unique_ptr<ImageLoader> loader_;
+  std::vector<ImageLoader::Result> results_;
+  double load_start_time_ = 0.0;
+
+  void UploadTextures();
+
  public:
   ImageDecoderRender();
   virtual ~ImageDecoderRender();
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ImageLoader.h"
+
+#include <utility>
+
+// Buffers kept for reuse, a cubemap worth
+static const size_t kMaxFreeBuffers = 6;
+
+ImageLoader::ImageLoader(int32_t numThreads)
+    : next_id_(0), running_(0), pending_(0), quit_(false) {
+  if (numThreads < 0) {
+    numThreads = static_cast<int32_t>(std::thread::hardware_concurrency()) - 1;
+    // Decoding must not fall back on the GL thread
+    if (numThreads < 1) numThreads = 1;
+  }
+  for (int32_t i = 0; i < numThreads; ++i) {
+    threads_.push_back(std::thread(&ImageLoader::WorkerMain, this));
+  }
+}
+
+ImageLoader::~ImageLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.clear();
+    quit_ = true;
+  }
+  wake_.notify_all();
+  for (auto& thread : threads_) thread.join();
+}
+
+int32_t ImageLoader::Submit(const DecodeFunc& decode) {
+  int32_t id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    id = next_id_++;
+    Job job = {id, decode};
+    jobs_.push_back(std::move(job));
+    ++pending_;
+  }
+  wake_.notify_one();
+  return id;
+}
+
+void ImageLoader::WorkerMain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    wake_.wait(lock, [this] { return quit_ || !jobs_.empty(); });
+    if (quit_) return;
+    Job job = std::move(jobs_.front());
+    jobs_.pop_front();
+    Result result;
+    result.id = job.id;
+    if (!buffers_.empty()) {
+      result.image.pixels.swap(buffers_.back());
+      buffers_.pop_back();
+    }
+    ++running_;
+    lock.unlock();
+
+    result.success = job.decode(&result.image);
+    if (!result.success) result.image.width = result.image.height = 0;
+
+    lock.lock();
+    results_.push_back(std::move(result));
+    if (--running_ == 0 && jobs_.empty()) idle_.notify_all();
+  }
+}
+
+void ImageLoader::Poll(std::vector<Result>* results) {
+  results->clear();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (results_.empty()) return;
+  results->swap(results_);
+  pending_ -= static_cast<int32_t>(results->size());
+}
+
+void ImageLoader::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_.wait(lock, [this] { return running_ == 0 && jobs_.empty(); });
+}
+
+void ImageLoader::Cancel() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_ -= static_cast<int32_t>(jobs_.size());
+  jobs_.clear();
+  if (running_ == 0) idle_.notify_all();
+}
+
+void ImageLoader::Recycle(DecodedImage* image) {
+  std::vector<uint8_t> pixels;
+  pixels.swap(image->pixels);
+  image->width = image->height = 0;
+  if (pixels.capacity() == 0) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (buffers_.size() < kMaxFreeBuffers) buffers_.push_back(std::move(pixels));
+}
+
+int32_t ImageLoader::GetPendingCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_;
+}
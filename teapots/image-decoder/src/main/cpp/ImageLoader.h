@@ -0,0 +1,123 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TEAPOTS_IMAGELOADER_H
+#define TEAPOTS_IMAGELOADER_H
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A decoded RGBA_8888 image, rows packed
+ */
+struct DecodedImage {
+  int32_t width = 0;
+  int32_t height = 0;
+  std::vector<uint8_t> pixels;
+};
+
+/**
+ *  class ImageLoader
+ *    decodes images on worker threads, off the GL thread
+ *     - Submit() queues a decode and returns at once
+ *     - the GL thread picks up the finished images with Poll() and
+ *       uploads them
+ *     - uploaded images go back with Recycle(), so that later decodes
+ *       reuse their pixel buffers as staging memory
+ *  Nothing here touches GL, decoders only fill a DecodedImage.
+ */
+class ImageLoader {
+ public:
+  /**
+   * Fills image (its pixels are a recycled buffer, to be resized as
+   * needed), returns false when the image could not be decoded.
+   * Called on a worker thread.
+   */
+  typedef std::function<bool(DecodedImage* image)> DecodeFunc;
+
+  struct Result {
+    int32_t id;
+    bool success;
+    DecodedImage image;
+  };
+
+  /**
+   * @param numThreads number of worker threads, -1 for one per core but
+   *     the calling one (at least one)
+   */
+  explicit ImageLoader(int32_t numThreads = -1);
+  ~ImageLoader();
+
+  /**
+   * Queue a decode
+   * @return the id of its Result
+   */
+  int32_t Submit(const DecodeFunc& decode);
+
+  /**
+   * Move the results finished since the last call to results, in the order
+   * they finished. Never blocks.
+   */
+  void Poll(std::vector<Result>* results);
+
+  // Wait for all the submitted decodes to finish
+  void Wait();
+
+  // Drop the decodes not started yet
+  void Cancel();
+
+  // Give a buffer back once its image is uploaded
+  void Recycle(DecodedImage* image);
+
+  // Decodes submitted whose result has not been polled yet
+  int32_t GetPendingCount();
+
+  int32_t GetThreadCount() const {
+    return static_cast<int32_t>(threads_.size());
+  }
+
+ private:
+  struct Job {
+    int32_t id;
+    DecodeFunc decode;
+  };
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+
+  std::deque<Job> jobs_;
+  std::vector<Result> results_;
+  std::vector<std::vector<uint8_t>> buffers_;
+  int32_t next_id_;
+  int32_t running_;
+  int32_t pending_;
+  bool quit_;
+
+  void WorkerMain();
+
+  ImageLoader(const ImageLoader&);
+  ImageLoader& operator=(const ImageLoader&);
+};
+
+#endif  // TEAPOTS_IMAGELOADER_H
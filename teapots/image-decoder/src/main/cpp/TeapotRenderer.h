@@ -42,11 +42,6 @@
 
 #define BUFFER_OFFSET(i) ((char*)NULL + (i))
 
-struct TEAPOT_VERTEX {
-  float pos[3];
-  float normal[3];
-};
-
 enum SHADER_ATTRIBUTES {
   ATTRIB_VERTEX,
   ATTRIB_NORMAL,
@@ -76,6 +71,7 @@ class TeapotRenderer {
   int32_t num_vertices_;
   GLuint ibo_;
   GLuint vbo_;
+  ndk_helper::Mesh mesh_;
 
   SHADER_PARAMS shader_param_;
   bool LoadShaders(SHADER_PARAMS* params, const char* strVsh,
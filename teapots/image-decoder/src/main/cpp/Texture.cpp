@@ -20,19 +20,19 @@
 
 #include "Texture.h"
 #include <android/imagedecoder.h>
+#include "textureFile.h"
 
 #define MODULE_NAME "Teapot::Texture"
 #include "android_debug.h"
 
 /**
- * Load2DTextureFromAsset(): Load one RGBA 2d texture from asset into
- * the given GL texture with NDK's ImageDecoder interface.
+ * DecodeImageFromAsset(): Decode one image from asset into RGBA with NDK's
+ * ImageDecoder interface. Touches no GL state, so that it may run on an
+ * ImageLoader thread: the asset manager may be shared between threads, the
+ * asset and the decoder are not.
  */
-static bool Load2DTextureFromAsset(std::string& assetFile, AAssetManager* mgr,
-                                   GLenum target) {
-  int32_t imgWidth, imgHeight;
-  std::vector<uint8_t> imgBits;
-
+static bool DecodeImageFromAsset(const std::string& assetFile,
+                                 AAssetManager* mgr, DecodedImage* image) {
   // Open the asset with the give name from the APK's assets folder.
   AAsset* assetDescriptor =
       AAssetManager_open(mgr, assetFile.c_str(), AASSET_MODE_BUFFER);
@@ -69,32 +69,122 @@ static bool Load2DTextureFromAsset(std::string& assetFile, AAssetManager* mgr,
            "Failed to set SRGB color space %s", assetFile.c_str());
   }
 
-  imgWidth = AImageDecoderHeaderInfo_getWidth(headerInfo);
-  imgHeight = AImageDecoderHeaderInfo_getHeight(headerInfo);
+  image->width = AImageDecoderHeaderInfo_getWidth(headerInfo);
+  image->height = AImageDecoderHeaderInfo_getHeight(headerInfo);
   size_t stride = AImageDecoder_getMinimumStride(decoder);
 
   // by design, ImageDecoder decode the image into packed format, no padding.
   // Let's make sure there is no padding; otherwise it would be bug, and app
   // need to pack.
-  ASSERT(stride == imgWidth * 4, "ImageDecoder padded  decoded image");
+  ASSERT(stride == image->width * 4, "ImageDecoder padded  decoded image");
 
-  imgBits.clear();
-  imgBits.resize(imgHeight * stride);
+  // The buffer may be a recycled one, every byte is decoded over
+  image->pixels.resize(image->height * stride);
 
-  status = AImageDecoder_decodeImage(decoder, imgBits.data(), stride,
-                                     imgBits.size());
+  status = AImageDecoder_decodeImage(decoder, image->pixels.data(), stride,
+                                     image->pixels.size());
   ASSERT(status == ANDROID_IMAGE_DECODER_SUCCESS, "Failed to decode image %s",
          assetFile.c_str());
 
-  glTexImage2D(target, 0, GL_RGBA, imgWidth, imgHeight, 0, GL_RGBA,
-               GL_UNSIGNED_BYTE, imgBits.data());
-
   // release decoder and asset
   AImageDecoder_delete(decoder);
   AAsset_close(assetDescriptor);
   return true;
 }
 
+static void UploadImage(const DecodedImage& image, GLenum target) {
+  glTexImage2D(target, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA,
+               GL_UNSIGNED_BYTE, image.pixels.data());
+}
+
+/**
+ * Upload the texture host/texture-bake made of fileName, the .tex next to the
+ * image, without decoding it. Its mipmaps were filtered offline.
+ * @param mipmapped is set to whether all levels went in
+ * @return false when there is no such texture, fileName is to be decoded then
+ */
+static bool UploadBaked(GLenum target, const std::string& fileName,
+                        bool* mipmapped) {
+  const size_t dot = fileName.rfind('.');
+  if (dot == std::string::npos) return false;
+  const std::string bakedName = fileName.substr(0, dot) + ".tex";
+  ndk_helper::TextureFile file;
+  if (!file.Load(bakedName.c_str())) return false;
+  const bool allLevels = file.GetLevelCount() > 1;
+  if (!file.Upload(target, allLevels)) {
+    LOGE("Failed to upload %s", bakedName.c_str());
+    return false;
+  }
+  *mipmapped = allLevels;
+  return true;
+}
+
+/**
+ * Stands in for an image until it is decoded: one grey texel, so the teapot
+ * shows flat shaded rather than black.
+ */
+static void UploadPlaceholder(GLenum target) {
+  static const uint8_t kGrey[4] = {128, 128, 128, 255};
+  glTexImage2D(target, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, kGrey);
+}
+
+/**
+ * The images of one texture being decoded by an ImageLoader. They are held
+ * until all of them are decoded, as a cubemap with faces of different sizes
+ * is incomplete and samples black.
+ */
+class ImageBatch {
+  ImageLoader* loader_ = nullptr;
+  std::vector<int32_t> ids_;
+  std::vector<DecodedImage> images_;
+  size_t received_ = 0;
+  bool failed_ = false;
+
+ public:
+  ~ImageBatch() { Release(); }
+
+  void Submit(std::vector<std::string>& files, size_t count,
+              AAssetManager* mgr, ImageLoader* loader) {
+    loader_ = loader;
+    ids_.resize(count);
+    images_.resize(count);
+    for (size_t i = 0; i < count; i++) {
+      const std::string file = files[i];
+      ids_[i] = loader->Submit([file, mgr](DecodedImage* image) {
+        return DecodeImageFromAsset(file, mgr, image);
+      });
+    }
+  }
+
+  // Keep the result if it is one of the batch
+  bool Take(ImageLoader::Result& result) {
+    for (size_t i = 0; i < ids_.size(); i++) {
+      if (ids_[i] != result.id) continue;
+      ids_[i] = -1;
+      images_[i].width = result.image.width;
+      images_[i].height = result.image.height;
+      images_[i].pixels.swap(result.image.pixels);
+      loader_->Recycle(&result.image);
+      if (!result.success) failed_ = true;
+      received_++;
+      return true;
+    }
+    return false;
+  }
+
+  bool IsComplete() const { return !ids_.empty() && received_ == ids_.size(); }
+  bool HasFailed() const { return failed_; }
+  const DecodedImage& GetImage(size_t i) const { return images_[i]; }
+
+  // Hand the buffers back to the loader, and forget the images
+  void Release() {
+    for (auto& image : images_) loader_->Recycle(&image);
+    images_.clear();
+    ids_.clear();
+    received_ = 0;
+  }
+};
+
 /**
  * Cubemap and Texture2d implementations for Class Texture.
  */
@@ -102,32 +192,41 @@ class TextureCubemap : public Texture {
  protected:
   GLuint texId_ = GL_INVALID_VALUE;
   bool activated_ = false;
+  bool ready_ = false;
+  ImageBatch batch_;
 
  public:
   virtual ~TextureCubemap();
   TextureCubemap(std::vector<std::string>& texFiles,
-                 AAssetManager* assetManager);
+                 AAssetManager* assetManager, ImageLoader* loader);
   virtual bool GetActiveSamplerInfo(std::vector<std::string>& names,
                                     std::vector<GLint>& units);
   virtual bool Activate(void);
   virtual GLuint GetTexType();
   virtual GLuint GetTexId();
+  virtual bool Upload(ImageLoader::Result& result);
+  virtual bool IsReady();
 };
 
 class Texture2d : public Texture {
  protected:
   GLuint texId_ = GL_INVALID_VALUE;
   bool activated_ = false;
+  bool ready_ = false;
+  ImageBatch batch_;
 
  public:
   virtual ~Texture2d();
   // Implement just one texture
-  Texture2d(std::string& texFiles, AAssetManager* assetManager);
+  Texture2d(std::vector<std::string>& texFiles, AAssetManager* assetManager,
+            ImageLoader* loader);
   virtual bool GetActiveSamplerInfo(std::vector<std::string>& names,
                                     std::vector<GLint>& units);
   virtual bool Activate(void);
   virtual GLuint GetTexType();
   virtual GLuint GetTexId();
+  virtual bool Upload(ImageLoader::Result& result);
+  virtual bool IsReady();
 };
 
 /**
@@ -146,14 +245,17 @@ Texture::~Texture() {}
  * @param texFiles holds the texture file name(s) under APK's assets
  * @param type should be one (GL_TEXTURE_2D / GL_TEXTURE_CUBE_MAP)
  * @param assetManager is used to open texture files inside assets
+ * @param loader decodes the images in the background, when not null
  * @return is the newly created Texture Object
  */
 Texture* Texture::Create(GLuint type, std::vector<std::string>& texFiles,
-                         AAssetManager* assetManager) {
+                         AAssetManager* assetManager, ImageLoader* loader) {
   if (type == GL_TEXTURE_2D) {
-    return dynamic_cast<Texture*>(new Texture2d(texFiles[0], assetManager));
+    return dynamic_cast<Texture*>(
+        new Texture2d(texFiles, assetManager, loader));
   } else if (type == GL_TEXTURE_CUBE_MAP) {
-    return dynamic_cast<Texture*>(new TextureCubemap(texFiles, assetManager));
+    return dynamic_cast<Texture*>(
+        new TextureCubemap(texFiles, assetManager, loader));
   }
 
   LOGE("Unknown texture type %x to created", type);
@@ -209,7 +311,7 @@ GLuint TextureCubemap::GetTexId() {
 }
 
 TextureCubemap::TextureCubemap(std::vector<std::string>& files,
-                               AAssetManager* mgr) {
+                               AAssetManager* mgr, ImageLoader* loader) {
   // For Cubemap, we use world normal to sample the textures
   // so no texture vbo necessary
 
@@ -226,12 +328,35 @@ TextureCubemap::TextureCubemap(std::vector<std::string>& files,
     return;
   }
 
-  for (GLuint i = 0; i < 6; i++) {
-    Load2DTextureFromAsset(files[i], mgr, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
+  // Baked faces need no decoding; if one is missing, all six are decoded
+  bool baked = true;
+  bool mipmapped = true;
+  for (GLuint i = 0; i < 6 && baked; i++) {
+    bool faceMipmapped = false;
+    baked = UploadBaked(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, files[i],
+                        &faceMipmapped);
+    mipmapped = faceMipmapped && mipmapped;
+  }
+
+  if (baked) {
+    ready_ = true;
+  } else if (loader) {
+    for (GLuint i = 0; i < 6; i++) {
+      UploadPlaceholder(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
+    }
+    batch_.Submit(files, 6, mgr, loader);
+  } else {
+    DecodedImage image;
+    for (GLuint i = 0; i < 6; i++) {
+      DecodeImageFromAsset(files[i], mgr, &image);
+      UploadImage(image, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
+    }
+    ready_ = true;
   }
 
   glTexParameterf(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameterf(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameterf(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER,
+                  baked && mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_REPEAT);
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_REPEAT);
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_REPEAT);
@@ -252,6 +377,29 @@ TextureCubemap::~TextureCubemap() {
   }
 }
 
+/**
+ * Upload the six faces at once, when the last of them is decoded. The
+ * placeholder stays if any failed.
+ */
+bool TextureCubemap::Upload(ImageLoader::Result& result) {
+  if (!batch_.Take(result)) return false;
+  if (!batch_.IsComplete()) return true;
+
+  if (batch_.HasFailed()) {
+    LOGE("Failed to decode cubemap faces, keeping the placeholder");
+  } else {
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texId_);
+    for (GLuint i = 0; i < 6; i++) {
+      UploadImage(batch_.GetImage(i), GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
+    }
+    ready_ = true;
+  }
+  batch_.Release();
+  return true;
+}
+
+bool TextureCubemap::IsReady() { return ready_; }
+
 /**
   Return used sampler names and units
       so application could configure shader's sampler uniform(s).
@@ -270,7 +418,8 @@ bool TextureCubemap::GetActiveSamplerInfo(std::vector<std::string>& names,
 /**
  * Texture2D implementation
  */
-Texture2d::Texture2d(std::string& fileName, AAssetManager* assetManager) {
+Texture2d::Texture2d(std::vector<std::string>& files,
+                     AAssetManager* assetManager, ImageLoader* loader) {
   if (!assetManager) {
     LOGE("AssetManager to Texture2D() could not be null!!!");
     assert(false);
@@ -285,10 +434,24 @@ Texture2d::Texture2d(std::string& fileName, AAssetManager* assetManager) {
     return;
   }
 
-  Load2DTextureFromAsset(fileName, assetManager, GL_TEXTURE_2D);
+  // The baked textures are the cubemap faces, their mipmaps are clamped at
+  // the edges: close enough for the repeated 2D texture
+  bool mipmapped = false;
+  if (UploadBaked(GL_TEXTURE_2D, files[0], &mipmapped)) {
+    ready_ = true;
+  } else if (loader) {
+    UploadPlaceholder(GL_TEXTURE_2D);
+    batch_.Submit(files, 1, assetManager, loader);
+  } else {
+    DecodedImage image;
+    DecodeImageFromAsset(files[0], assetManager, &image);
+    UploadImage(image, GL_TEXTURE_2D);
+    ready_ = true;
+  }
 
   glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                  mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
@@ -303,6 +466,21 @@ Texture2d::~Texture2d() {
   activated_ = false;
 }
 
+bool Texture2d::Upload(ImageLoader::Result& result) {
+  if (!batch_.Take(result)) return false;
+  if (batch_.HasFailed()) {
+    LOGE("Failed to decode texture, keeping the placeholder");
+  } else {
+    glBindTexture(GL_TEXTURE_2D, texId_);
+    UploadImage(batch_.GetImage(0), GL_TEXTURE_2D);
+    ready_ = true;
+  }
+  batch_.Release();
+  return true;
+}
+
+bool Texture2d::IsReady() { return ready_; }
+
 /**
  * Same as the Cubemap::GetActiveSamplerInfo()
  */
@@ -24,6 +24,8 @@
 #include <string>
 #include <vector>
 
+#include "ImageLoader.h"
+
 /**
  *  class Texture
  *    adding texture into teapot
@@ -44,12 +46,27 @@ class Texture {
    *     2d texture uses the very first image texFiles[0]
    *     cube map needs 6 (direction of +x, -x, +y, -y, +z, -z)
    * @param assetManager Java side assetManager object
+   * @param loader decodes the images in the background when given: the
+   *     texture holds a placeholder until Upload() has all its images.
+   *     Otherwise they are decoded before Create() returns. Images baked
+   *     into a .tex next to them by host/texture-bake are not decoded, the
+   *     texture is ready at once.
    * @return newly created texture object, or nullptr in case of errors
    */
   static Texture* Create(GLuint type, std::vector<std::string>& texFiles,
-                         AAssetManager* assetManager);
+                         AAssetManager* assetManager,
+                         ImageLoader* loader = nullptr);
   static void Delete(Texture* obj);
 
+  /**
+   * Take a finished decode from the loader, on the GL thread
+   * @return false when the result is not one of this texture's images,
+   *     it is left to the caller then
+   */
+  virtual bool Upload(ImageLoader::Result& result) = 0;
+  // Whether the images replaced the placeholder
+  virtual bool IsReady() = 0;
+
   virtual bool GetActiveSamplerInfo(std::vector<std::string>& names,
                                     std::vector<GLint>& units) = 0;
   virtual bool Activate(void) = 0;
@@ -43,6 +43,9 @@ const int32_t NUM_TEAPOTS_X = 8;
 const int32_t NUM_TEAPOTS_Y = 8;
 const int32_t NUM_TEAPOTS_Z = 8;
 
+// Zones kept for the trace written by debug builds, a few seconds worth
+const size_t PROFILE_TRACE_EVENTS = 20000;
+
 //-------------------------------------------------------------------------
 // Shared state for our app.
 //-------------------------------------------------------------------------
@@ -54,6 +57,7 @@ class Engine {
 
   bool initialized_resources_;
   bool has_focus_;
+  bool trace_written_;
 
   ndk_helper::DoubletapDetector doubletap_detector_;
   ndk_helper::PinchDetector pinch_detector_;
@@ -69,6 +73,7 @@ class Engine {
   ASensorEventQueue* sensor_event_queue_;
 
   void UpdateFPS(float fps);
+  void LogProfile();
   void ShowUI();
   void TransformPosition(ndk_helper::Vec2& vec);
 
@@ -101,6 +106,7 @@ class Engine {
 Engine::Engine()
     : initialized_resources_(false),
       has_focus_(false),
+      trace_written_(false),
       app_(NULL),
       sensor_manager_(NULL),
       accelerometer_sensor_(NULL),
@@ -131,6 +137,14 @@ void Engine::UnloadResources() { renderer_.Unload(); }
  */
 int Engine::InitDisplay(android_app *app) {
   if (!initialized_resources_) {
+#ifndef NDEBUG
+    // Debug builds log where the frame time goes, and keep a trace of the
+    // first frames for chrome://tracing, see LogProfile()
+    ndk_helper::Profiler* profiler = ndk_helper::Profiler::GetInstance();
+    profiler->SetThreadName("android_main");
+    profiler->SetEnabled(true);
+    profiler->StartCapture(PROFILE_TRACE_EVENTS);
+#endif
     gl_context_->Init(app_->window);
     LoadResources();
     initialized_resources_ = true;
@@ -178,7 +192,9 @@ void Engine::DrawFrame() {
   float fps;
   if (monitor_.Update(fps)) {
     UpdateFPS(fps);
+    LogProfile();
   }
+  NDK_HELPER_PROFILE_ZONE("Engine::DrawFrame");
   double dTime = monitor_.GetCurrentTime();
   renderer_.Update(dTime);
 
@@ -390,6 +406,30 @@ void Engine::UpdateFPS(float fps) {
   return;
 }
 
+/**
+ * Log the zones of the last frame, and write the trace once it is complete.
+ */
+void Engine::LogProfile() {
+  ndk_helper::Profiler* profiler = ndk_helper::Profiler::GetInstance();
+  if (!profiler->IsEnabled()) return;
+
+  std::string text;
+  profiler->FormatFrame(&text);
+  LOGI("%s", text.c_str());
+
+  if (trace_written_ || profiler->IsCapturing()) return;
+  trace_written_ = true;
+  std::string dir = ndk_helper::JNIHelper::GetInstance()->GetExternalFilesDir();
+  if (!dir.empty()) {
+    std::string path = dir + "/trace.json";
+    if (profiler->WriteChromeTrace(path.c_str())) {
+      LOGI("Wrote %s", path.c_str());
+    } else {
+      LOGW("Failed to write %s", path.c_str());
+    }
+  }
+}
+
 Engine g_engine;
 
 /**
@@ -23,18 +23,55 @@
 //--------------------------------------------------------------------------------
 #include "MoreTeapotsRenderer.h"
 
+#include <stdio.h>
 #include <string.h>
 
 //--------------------------------------------------------------------------------
-// Teapot model data
+// Program binaries, kept in the external files directory so that later runs
+// skip compiling the shaders
 //--------------------------------------------------------------------------------
-#include "teapot.inl"
+static std::string ProgramBinaryPath(const uint64_t key) {
+  char name[64];
+  snprintf(name, sizeof(name), "/program-%016llx.bin",
+           static_cast<unsigned long long>(key));
+  return ndk_helper::JNIHelper::GetInstance()->GetExternalFilesDir() + name;
+}
+
+static bool LoadProgramBinary(const uint64_t key, std::vector<uint8_t>* binary,
+                              uint32_t* format) {
+  ndk_helper::AssetData data;
+  if (!ndk_helper::AssetReader::MapFile(ProgramBinaryPath(key).c_str(),
+                                        &data) ||
+      data.GetSize() <= sizeof(uint32_t)) {
+    return false;
+  }
+  memcpy(format, data.GetData(), sizeof(uint32_t));
+  binary->assign(data.GetData() + sizeof(uint32_t),
+                 data.GetData() + data.GetSize());
+  return true;
+}
+
+static void StoreProgramBinary(const uint64_t key,
+                               const std::vector<uint8_t>& binary,
+                               const uint32_t format) {
+  // Written aside first, a partial file must not be loaded next time
+  const std::string path = ProgramBinaryPath(key);
+  const std::string tmp_path = path + ".tmp";
+  FILE* f = fopen(tmp_path.c_str(), "wb");
+  if (f == NULL) return;
+  bool ok = fwrite(&format, sizeof(format), 1, f) == 1 &&
+            fwrite(binary.data(), 1, binary.size(), f) == binary.size();
+  ok = fclose(f) == 0 && ok;
+  if (!ok || rename(tmp_path.c_str(), path.c_str()) != 0)
+    remove(tmp_path.c_str());
+}
 
 //--------------------------------------------------------------------------------
 // Ctor
 //--------------------------------------------------------------------------------
 MoreTeapotsRenderer::MoreTeapotsRenderer()
-    : geometry_instancing_support_(false) {}
+    : shader_cache_(ndk_helper::shader::ReadSource),
+      geometry_instancing_support_(false) {}
 
 //--------------------------------------------------------------------------------
 // Dtor
@@ -61,40 +98,36 @@ void MoreTeapotsRenderer::Init(const int32_t numX, const int32_t numY,
   // Settings
   glFrontFace(GL_CCW);
 
-  // Create Index buffer
-  num_indices_ = sizeof(teapotIndices) / sizeof(teapotIndices[0]);
-  glGenBuffers(1, &ibo_);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(teapotIndices), teapotIndices,
-               GL_STATIC_DRAW);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-  // Create VBO
-  num_vertices_ = sizeof(teapotPositions) / sizeof(teapotPositions[0]) / 3;
-  int32_t stride = sizeof(TEAPOT_VERTEX);
-  int32_t index = 0;
-  TEAPOT_VERTEX* p = new TEAPOT_VERTEX[num_vertices_];
-  for (int32_t i = 0; i < num_vertices_; ++i) {
-    p[i].pos[0] = teapotPositions[index];
-    p[i].pos[1] = teapotPositions[index + 1];
-    p[i].pos[2] = teapotPositions[index + 2];
-
-    p[i].normal[0] = teapotNormals[index];
-    p[i].normal[1] = teapotNormals[index + 1];
-    p[i].normal[2] = teapotNormals[index + 2];
-    index += 3;
+  // Load the model, its vertex and index data are uploaded as stored
+  num_indices_ = 0;
+  num_vertices_ = 0;
+  if (mesh_.Load("Models/teapot.mesh")) {
+    num_indices_ = mesh_.GetIndexCount();
+    num_vertices_ = mesh_.GetVertexCount();
+
+    // Create Index buffer
+    glGenBuffers(1, &ibo_);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh_.GetIndexDataSize(),
+                 mesh_.GetIndices(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    // Create VBO
+    glGenBuffers(1, &vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferData(GL_ARRAY_BUFFER, mesh_.GetVertexDataSize(),
+                 mesh_.GetVertexData(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  } else {
+    LOGI("Failed to load the teapot model");
   }
-  glGenBuffers(1, &vbo_);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-  glBufferData(GL_ARRAY_BUFFER, stride * num_vertices_, p, GL_STATIC_DRAW);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  delete[] p;
+  const float bounding_radius = mesh_.IsLoaded() ? mesh_.GetRadius() : 0.f;
 
   // Init Projection matrices
   teapot_x_ = numX;
   teapot_y_ = numY;
   teapot_z_ = numZ;
-  vec_mat_models_.reserve(teapot_x_ * teapot_y_ * teapot_z_);
+  instances_.Init(teapot_x_ * teapot_y_ * teapot_z_);
 
   UpdateViewport();
 
@@ -106,39 +139,46 @@ void MoreTeapotsRenderer::Init(const int32_t numX, const int32_t numY,
   float offset_y = -total_width / 2.f;
   float offset_z = -total_width / 2.f;
 
+  int32_t instance = 0;
   for (int32_t x = 0; x < teapot_x_; ++x)
     for (int32_t y = 0; y < teapot_y_; ++y)
       for (int32_t z = 0; z < teapot_z_; ++z) {
-        vec_mat_models_.push_back(ndk_helper::Mat4::Translation(
-            x * gap_x + offset_x, y * gap_y + offset_y,
-            z * gap_z + offset_z));
-        vec_colors_.push_back(ndk_helper::Vec3(
-            random() / float(RAND_MAX * 1.1), random() / float(RAND_MAX * 1.1),
-            random() / float(RAND_MAX * 1.1)));
+        ndk_helper::Mat4 model = ndk_helper::Mat4::Translation(
+            x * gap_x + offset_x, y * gap_y + offset_y, z * gap_z + offset_z);
+        ndk_helper::Vec3 color(random() / float(RAND_MAX * 1.1),
+                               random() / float(RAND_MAX * 1.1),
+                               random() / float(RAND_MAX * 1.1));
 
         float rotation_x = random() / float(RAND_MAX) - 0.5f;
         float rotation_y = random() / float(RAND_MAX) - 0.5f;
-        vec_rotations_.push_back(ndk_helper::Vec2(rotation_x * 0.05f, rotation_y * 0.05f));
-        vec_current_rotations_.push_back(
-            ndk_helper::Vec2(rotation_x * M_PI, rotation_y * M_PI));
+        instances_.SetInstance(instance++, model, color, rotation_x * M_PI,
+                               rotation_y * M_PI, rotation_x * 0.05f,
+                               rotation_y * 0.05f);
       }
+  instances_.BuildGrid(bounding_radius);
 
   if (geometry_instancing_support_) {
     //
-    // Create parameter dictionary for shader patch
-    std::map<std::string, std::string> param;
-    param[std::string("%NUM_TEAPOT%")] =
+    // Shader variants for this number of teapots, %NAME% in the shaders is
+    // replaced with parameter NAME
+    ndk_helper::shader::ShaderVariant vertex;
+    vertex.file_name = "Shaders/VS_ShaderPlainES3.vsh";
+    vertex.parameters["NUM_TEAPOT"] =
         ToString(teapot_x_ * teapot_y_ * teapot_z_);
-    param[std::string("%LOCATION_VERTEX%")] = ToString(ATTRIB_VERTEX);
-    param[std::string("%LOCATION_NORMAL%")] = ToString(ATTRIB_NORMAL);
-    if (arb_support_)
-      param[std::string("%ARB%")] = std::string("ARB");
-    else
-      param[std::string("%ARB%")] = std::string("");
+    vertex.parameters["LOCATION_VERTEX"] = ToString(ATTRIB_VERTEX);
+    vertex.parameters["LOCATION_NORMAL"] = ToString(ATTRIB_NORMAL);
+    vertex.parameters["ARB"] = arb_support_ ? "ARB" : "";
+    ndk_helper::shader::ShaderVariant fragment;
+    fragment.file_name = "Shaders/ShaderPlainES3.fsh";
+    fragment.parameters = vertex.parameters;
+
+    if (!ndk_helper::JNIHelper::GetInstance()->GetExternalFilesDir().empty()) {
+      shader_cache_.SetProgramBinaryHooks(LoadProgramBinary,
+                                          StoreProgramBinary);
+    }
 
     // Load shader
-    bool b = LoadShadersES3(&shader_param_, "Shaders/VS_ShaderPlainES3.vsh",
-                            "Shaders/ShaderPlainES3.fsh", param);
+    bool b = LoadShadersES3(&shader_param_, vertex, fragment);
     if (b) {
       //
       // Create uniform buffer
@@ -166,22 +206,13 @@ void MoreTeapotsRenderer::Init(const int32_t numX, const int32_t numY,
       glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
       glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, ubo_);
 
-      // Store color value which wouldn't be updated every frame
+      // The colors are written every frame along with the matrices, as the
+      // visible instances are packed at the start of the arrays.
       int32_t size = teapot_x_ * teapot_y_ * teapot_z_ *
                       (ubo_matrix_stride_ + ubo_matrix_stride_ +
                        ubo_vector_stride_);  // Mat4 + Mat4 + Vec3 + 1 stride
-      float* pBuffer = new float[size];
-      float* pColor =
-          pBuffer + teapot_x_ * teapot_y_ * teapot_z_ * ubo_matrix_stride_ * 2;
-      for (int32_t i = 0; i < teapot_x_ * teapot_y_ * teapot_z_; ++i) {
-        memcpy(pColor, &vec_colors_[i], 3 * sizeof(float));
-        pColor += ubo_vector_stride_;  // Assuming std140 layout which is 4
-                                       // DWORD stride for vectors
-      }
-
-      glBufferData(GL_UNIFORM_BUFFER, size * sizeof(float), pBuffer,
+      glBufferData(GL_UNIFORM_BUFFER, size * sizeof(float), NULL,
                    GL_DYNAMIC_DRAW);
-      delete[] pBuffer;
     } else {
       LOGI("Shader compilation failed!! Falls back to ES2.0 pass");
       // This happens some devices.
@@ -236,12 +267,15 @@ void MoreTeapotsRenderer::Unload() {
     glDeleteProgram(shader_param_.program_);
     shader_param_.program_ = 0;
   }
+
+  mesh_.Release();
 }
 
 //--------------------------------------------------------------------------------
 // Update
 //--------------------------------------------------------------------------------
 void MoreTeapotsRenderer::Update(float fTime) {
+  NDK_HELPER_PROFILE_ZONE("MoreTeapotsRenderer::Update");
   const float CAM_X = 0.f;
   const float CAM_Y = 0.f;
   const float CAM_Z = 2000.f;
@@ -261,18 +295,12 @@ void MoreTeapotsRenderer::Update(float fTime) {
 // Render
 //--------------------------------------------------------------------------------
 void MoreTeapotsRenderer::Render() {
+  NDK_HELPER_PROFILE_ZONE("MoreTeapotsRenderer::Render");
   // Bind the VBO
   glBindBuffer(GL_ARRAY_BUFFER, vbo_);
 
-  int32_t iStride = sizeof(TEAPOT_VERTEX);
   // Pass the vertex data
-  glVertexAttribPointer(ATTRIB_VERTEX, 3, GL_FLOAT, GL_FALSE, iStride,
-                        BUFFER_OFFSET(0));
-  glEnableVertexAttribArray(ATTRIB_VERTEX);
-
-  glVertexAttribPointer(ATTRIB_NORMAL, 3, GL_FLOAT, GL_FALSE, iStride,
-                        BUFFER_OFFSET(3 * sizeof(GLfloat)));
-  glEnableVertexAttribArray(ATTRIB_NORMAL);
+  mesh_.SetVertexAttribPointers(ATTRIB_VERTEX, ATTRIB_NORMAL);
 
   // Bind the IB
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_);
@@ -293,61 +321,59 @@ void MoreTeapotsRenderer::Render() {
 
   glUniform3f(shader_param_.light0_, 100.f, -200.f, -600.f);
 
+  // Cull the teapots out of the view or too far from the eye, the grid
+  // is about 2000 away from the camera when it is not zoomed.
+  const float CULL_DISTANCE = 5000.f;
+  ndk_helper::Mat4 mat_view_inverse = mat_view_;
+  mat_view_inverse.Inverse();
+  ndk_helper::Frustum frustum(mat_projection_ * mat_view_);
+  frustum.SetMaxDistance(
+      ndk_helper::Vec3(mat_view_inverse * ndk_helper::Vec4(0.f, 0.f, 0.f, 1.f)),
+      CULL_DISTANCE);
+  instances_.Cull(frustum);
+
+  // Rotate the teapots and compute their matrices, in parallel and before
+  // mapping the UBO so that it stays mapped only for the copy.
+  instances_.Update(mat_view_, mat_projection_, jobs_);
+  const int32_t visible_count = instances_.GetVisibleCount();
+
   if (geometry_instancing_support_) {
     //
     // Geometry instancing, new feature in GLES3.0
     //
 
-    // Update UBO
-    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
-    float* p = (float*)glMapBufferRange(
-        GL_UNIFORM_BUFFER, 0, teapot_x_ * teapot_y_ * teapot_z_ *
-                                  (ubo_matrix_stride_ * 2) * sizeof(float),
-        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
-    float* mat_mvp = p;
-    float* mat_mv = p + teapot_x_ * teapot_y_ * teapot_z_ * ubo_matrix_stride_;
-    for (int32_t i = 0; i < teapot_x_ * teapot_y_ * teapot_z_; ++i) {
-      // Rotation
-      float x, y;
-      vec_current_rotations_[i] += vec_rotations_[i];
-      vec_current_rotations_[i].Value(x, y);
-      ndk_helper::Mat4 mat_rotation =
-          ndk_helper::Mat4::RotationX(x) * ndk_helper::Mat4::RotationY(y);
-
-      // Feed Projection and Model View matrices to the shaders
-      ndk_helper::Mat4 mat_v = mat_view_ * vec_mat_models_[i] * mat_rotation;
-      ndk_helper::Mat4 mat_vp = mat_projection_ * mat_v;
-
-      memcpy(mat_mvp, mat_vp.Ptr(), sizeof(mat_v));
-      mat_mvp += ubo_matrix_stride_;
-
-      memcpy(mat_mv, mat_v.Ptr(), sizeof(mat_v));
-      mat_mv += ubo_matrix_stride_;
+    // Update UBO, only the first visible_count entries of each array are
+    // used so the whole buffer is invalidated.
+    if (visible_count > 0) {
+      const int32_t count = teapot_x_ * teapot_y_ * teapot_z_;
+      glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+      float* p = (float*)glMapBufferRange(
+          GL_UNIFORM_BUFFER, 0,
+          count * (ubo_matrix_stride_ * 2 + ubo_vector_stride_) *
+              sizeof(float),
+          GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+      float* mat_mvp = p;
+      float* mat_mv = p + count * ubo_matrix_stride_;
+      float* color = p + count * ubo_matrix_stride_ * 2;
+      instances_.Write(mat_mvp, mat_mv, color, ubo_matrix_stride_,
+                       ubo_vector_stride_, jobs_);
+      glUnmapBuffer(GL_UNIFORM_BUFFER);
+
+      // Instanced rendering
+      glDrawElementsInstanced(GL_TRIANGLES, num_indices_, GL_UNSIGNED_SHORT,
+                              BUFFER_OFFSET(0), visible_count);
     }
-    glUnmapBuffer(GL_UNIFORM_BUFFER);
-
-    // Instanced rendering
-    glDrawElementsInstanced(GL_TRIANGLES, num_indices_, GL_UNSIGNED_SHORT,
-                            BUFFER_OFFSET(0),
-                            teapot_x_ * teapot_y_ * teapot_z_);
-
   } else {
     // Regular rendering pass
-    for (int32_t i = 0; i < teapot_x_ * teapot_y_ * teapot_z_; ++i) {
+    for (int32_t i = 0; i < visible_count; ++i) {
       // Set diffuse
       float x, y, z;
-      vec_colors_[i].Value(x, y, z);
+      instances_.GetColor(i).Value(x, y, z);
       glUniform4f(shader_param_.material_diffuse_, x, y, z, 1.f);
 
-      // Rotation
-      vec_current_rotations_[i] += vec_rotations_[i];
-      vec_current_rotations_[i].Value(x, y);
-      ndk_helper::Mat4 mat_rotation =
-          ndk_helper::Mat4::RotationX(x) * ndk_helper::Mat4::RotationY(y);
-
       // Feed Projection and Model View matrices to the shaders
-      ndk_helper::Mat4 mat_v = mat_view_ * vec_mat_models_[i] * mat_rotation;
-      ndk_helper::Mat4 mat_vp = mat_projection_ * mat_v;
+      ndk_helper::Mat4 mat_v = instances_.GetModelView(i);
+      ndk_helper::Mat4 mat_vp = instances_.GetModelViewProjection(i);
       glUniformMatrix4fv(shader_param_.matrix_projection_, 1, GL_FALSE,
                          mat_vp.Ptr());
       glUniformMatrix4fv(shader_param_.matrix_view_, 1, GL_FALSE, mat_v.Ptr());
@@ -442,60 +468,21 @@ bool MoreTeapotsRenderer::LoadShaders(SHADER_PARAMS* params, const char* strVsh,
 }
 
 bool MoreTeapotsRenderer::LoadShadersES3(
-    SHADER_PARAMS* params, const char* strVsh, const char* strFsh,
-    std::map<std::string, std::string>& shaderParams) {
+    SHADER_PARAMS* params, const ndk_helper::shader::ShaderVariant& vertex,
+    const ndk_helper::shader::ShaderVariant& fragment) {
   //
   // Shader load for GLES3
   // In GLES3.0, shader attribute index can be described in a shader code
   // directly with layout() attribute
+  // The program comes from a stored binary when there is one.
   //
   GLuint program;
-  GLuint vertShader, fragShader;
-
-  // Create shader program
-  program = glCreateProgram();
-  LOGI("Created Shader %d", program);
-
-  // Create and compile vertex shader
-  if (!ndk_helper::shader::CompileShader(&vertShader, GL_VERTEX_SHADER, strVsh,
-                                         shaderParams)) {
-    LOGI("Failed to compile vertex shader");
-    glDeleteProgram(program);
-    return false;
-  }
-
-  // Create and compile fragment shader
-  if (!ndk_helper::shader::CompileShader(&fragShader, GL_FRAGMENT_SHADER,
-                                         strFsh, shaderParams)) {
-    LOGI("Failed to compile fragment shader");
-    glDeleteProgram(program);
-    return false;
-  }
-
-  // Attach vertex shader to program
-  glAttachShader(program, vertShader);
-
-  // Attach fragment shader to program
-  glAttachShader(program, fragShader);
-
-  // Link program
-  if (!ndk_helper::shader::LinkProgram(program)) {
-    LOGI("Failed to link program: %d", program);
-
-    if (vertShader) {
-      glDeleteShader(vertShader);
-      vertShader = 0;
-    }
-    if (fragShader) {
-      glDeleteShader(fragShader);
-      fragShader = 0;
-    }
-    if (program) {
-      glDeleteProgram(program);
-    }
-
+  if (!ndk_helper::shader::CreateProgram(&program, &shader_cache_, vertex,
+                                         fragment)) {
+    LOGI("Failed to create program");
     return false;
   }
+  LOGI("Created Shader %d", program);
 
   // Get uniform locations
   params->light0_ = glGetUniformLocation(program, "vLight0");
@@ -503,10 +490,6 @@ bool MoreTeapotsRenderer::LoadShadersES3(
   params->material_specular_ =
       glGetUniformLocation(program, "vMaterialSpecular");
 
-  // Release vertex and fragment shaders
-  if (vertShader) glDeleteShader(vertShader);
-  if (fragShader) glDeleteShader(fragShader);
-
   params->program_ = program;
   return true;
 }
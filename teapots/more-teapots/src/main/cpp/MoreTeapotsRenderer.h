@@ -41,14 +41,10 @@
 #define APPLICATION_CLASS_NAME "com/sample/moreteapots/MoreTeapotsApplication"
 
 #include "NDKHelper.h"
+#include "TeapotInstances.h"
 
 #define BUFFER_OFFSET(i) ((char*)NULL + (i))
 
-struct TEAPOT_VERTEX {
-  float pos[3];
-  float normal[3];
-};
-
 enum SHADER_ATTRIBUTES {
   ATTRIB_VERTEX,
   ATTRIB_NORMAL,
@@ -78,20 +74,20 @@ class MoreTeapotsRenderer {
   GLuint ibo_;
   GLuint vbo_;
   GLuint ubo_;
+  ndk_helper::Mesh mesh_;
 
   SHADER_PARAMS shader_param_;
+  ndk_helper::shader::ShaderCache shader_cache_;
   bool LoadShaders(SHADER_PARAMS* params, const char* strVsh,
                    const char* strFsh);
-  bool LoadShadersES3(SHADER_PARAMS* params, const char* strVsh,
-                      const char* strFsh,
-                      std::map<std::string, std::string>& shaderParameters);
+  bool LoadShadersES3(SHADER_PARAMS* params,
+                      const ndk_helper::shader::ShaderVariant& vertex,
+                      const ndk_helper::shader::ShaderVariant& fragment);
 
   ndk_helper::Mat4 mat_projection_;
   ndk_helper::Mat4 mat_view_;
-  std::vector<ndk_helper::Mat4> vec_mat_models_;
-  std::vector<ndk_helper::Vec3> vec_colors_;
-  std::vector<ndk_helper::Vec2> vec_rotations_;
-  std::vector<ndk_helper::Vec2> vec_current_rotations_;
+  TeapotInstances instances_;
+  ndk_helper::JobSystem jobs_;
 
   ndk_helper::TapCamera* camera_;
 
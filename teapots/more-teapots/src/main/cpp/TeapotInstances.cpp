@@ -0,0 +1,309 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// TeapotInstances.cpp
+// Per-instance transforms of the teapots
+//--------------------------------------------------------------------------------
+#include "TeapotInstances.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "profiler.h"
+
+// Instances per job, enough to amortize the scheduling
+const int32_t kInstancesPerJob = 256;
+
+// Instances updated in one go, so that the 4 matrix streams they go
+// through stay in the L1 cache between the passes.
+const int32_t kInstancesPerBlock = 64;
+
+// Average instances per grid cell: large enough for the per-instance tests
+// to run on full SIMD batches, small enough for cells to be culled whole.
+const int32_t kInstancesPerCell = 64;
+
+TeapotInstances::TeapotInstances()
+    : count_(0), bounding_radius_(0.f), visible_count_(0) {}
+
+void TeapotInstances::Init(const int32_t count) {
+  count_ = count;
+  bounding_radius_ = 0.f;
+  rotation_x_.assign(count, 0.f);
+  rotation_y_.assign(count, 0.f);
+  speed_x_.assign(count, 0.f);
+  speed_y_.assign(count, 0.f);
+  colors_.assign(3 * count, 0.f);
+  models_.assign(16 * count, 0.f);
+  model_views_.assign(16 * count, 0.f);
+  model_view_projections_.assign(16 * count, 0.f);
+
+  // Everything is visible until the first Cull()
+  cells_.clear();
+  visible_.resize(count);
+  for (int32_t i = 0; i < count; ++i) visible_[i] = i;
+  visible_count_ = count;
+}
+
+ndk_helper::Mat4Array TeapotInstances::Streams(
+    const std::vector<float>& storage, int32_t begin) const {
+  // Mat4Array has no const variant, the const methods only read through it.
+  ndk_helper::Mat4Array ret;
+  float* data = const_cast<float*>(storage.data());
+  for (int32_t i = 0; i < 16; ++i) ret.f[i] = data + i * count_ + begin;
+  return ret;
+}
+
+void TeapotInstances::SetInstance(const int32_t index,
+                                  const ndk_helper::Mat4& model,
+                                  const ndk_helper::Vec3& color,
+                                  const float rotation_x,
+                                  const float rotation_y, const float speed_x,
+                                  const float speed_y) {
+  model.Store(Streams(models_, 0), index);
+  ndk_helper::Vec3 c = color;
+  c.Value(colors_[3 * index], colors_[3 * index + 1], colors_[3 * index + 2]);
+  rotation_x_[index] = rotation_x;
+  rotation_y_[index] = rotation_y;
+  speed_x_[index] = speed_x;
+  speed_y_[index] = speed_y;
+}
+
+void TeapotInstances::BuildGrid(const float bounding_radius) {
+  bounding_radius_ = bounding_radius;
+  cells_.clear();
+  if (count_ == 0) return;
+
+  // The sphere centers are the model translations
+  const float* center[3] = {models_.data() + 12 * count_,
+                            models_.data() + 13 * count_,
+                            models_.data() + 14 * count_};
+  float lo[3], hi[3];
+  for (int32_t k = 0; k < 3; ++k) {
+    lo[k] = hi[k] = center[k][0];
+    for (int32_t i = 1; i < count_; ++i) {
+      lo[k] = fminf(lo[k], center[k][i]);
+      hi[k] = fmaxf(hi[k], center[k][i]);
+    }
+  }
+
+  int32_t cells_per_axis = static_cast<int32_t>(
+      cbrtf(static_cast<float>(count_) / kInstancesPerCell) + 0.5f);
+  if (cells_per_axis < 1) cells_per_axis = 1;
+  const int32_t cell_count = cells_per_axis * cells_per_axis * cells_per_axis;
+
+  std::vector<int32_t> cell_of(count_);
+  for (int32_t i = 0; i < count_; ++i) {
+    int32_t cell = 0;
+    for (int32_t k = 2; k >= 0; --k) {
+      const float extent = hi[k] - lo[k];
+      int32_t c = extent > 0.f ? static_cast<int32_t>((center[k][i] - lo[k]) /
+                                                      extent * cells_per_axis)
+                               : 0;
+      if (c >= cells_per_axis) c = cells_per_axis - 1;
+      cell = cell * cells_per_axis + c;
+    }
+    cell_of[i] = cell;
+  }
+
+  // Counting sort of the instances by cell, stable so that each cell keeps
+  // the original order.
+  std::vector<int32_t> first(cell_count + 1, 0);
+  for (int32_t i = 0; i < count_; ++i) ++first[cell_of[i] + 1];
+  for (int32_t c = 0; c < cell_count; ++c) first[c + 1] += first[c];
+  std::vector<int32_t> order(count_);
+  {
+    std::vector<int32_t> next(first.begin(), first.end() - 1);
+    for (int32_t i = 0; i < count_; ++i) order[next[cell_of[i]]++] = i;
+  }
+
+  std::vector<float> scratch;
+  auto reorder = [&](std::vector<float>& values, const int32_t components) {
+    scratch = values;
+    for (int32_t i = 0; i < count_; ++i) {
+      for (int32_t k = 0; k < components; ++k)
+        values[i * components + k] = scratch[order[i] * components + k];
+    }
+  };
+  reorder(rotation_x_, 1);
+  reorder(rotation_y_, 1);
+  reorder(speed_x_, 1);
+  reorder(speed_y_, 1);
+  reorder(colors_, 3);
+  scratch = models_;
+  for (int32_t k = 0; k < 16; ++k) {
+    for (int32_t i = 0; i < count_; ++i)
+      models_[k * count_ + i] = scratch[k * count_ + order[i]];
+  }
+
+  // Bounding sphere of each non-empty cell
+  for (int32_t c = 0; c < cell_count; ++c) {
+    if (first[c] == first[c + 1]) continue;
+    Cell cell;
+    cell.begin = first[c];
+    cell.end = first[c + 1];
+    float cell_lo[3], cell_hi[3];
+    for (int32_t k = 0; k < 3; ++k) {
+      cell_lo[k] = cell_hi[k] = center[k][cell.begin];
+      for (int32_t i = cell.begin + 1; i < cell.end; ++i) {
+        cell_lo[k] = fminf(cell_lo[k], center[k][i]);
+        cell_hi[k] = fmaxf(cell_hi[k], center[k][i]);
+      }
+    }
+    ndk_helper::Vec3 half_size((cell_hi[0] - cell_lo[0]) * 0.5f,
+                               (cell_hi[1] - cell_lo[1]) * 0.5f,
+                               (cell_hi[2] - cell_lo[2]) * 0.5f);
+    cell.center = ndk_helper::Vec3(cell_lo[0], cell_lo[1], cell_lo[2]) +
+                  half_size;
+    cell.radius = half_size.Length() + bounding_radius;
+    cells_.push_back(cell);
+  }
+
+  for (int32_t i = 0; i < count_; ++i) visible_[i] = i;
+  visible_count_ = count_;
+}
+
+void TeapotInstances::Cull(const ndk_helper::Frustum& frustum) {
+  NDK_HELPER_PROFILE_ZONE("TeapotInstances::Cull");
+  const float* x = models_.data() + 12 * count_;
+  const float* y = models_.data() + 13 * count_;
+  const float* z = models_.data() + 14 * count_;
+  int32_t* visible = visible_.data();
+  int32_t count = 0;
+  for (const Cell& cell : cells_) {
+    switch (frustum.TestSphere(cell.center, cell.radius)) {
+      case ndk_helper::FRUSTUM_OUTSIDE:
+        break;
+      case ndk_helper::FRUSTUM_INSIDE:
+        for (int32_t i = cell.begin; i < cell.end; ++i) visible[count++] = i;
+        break;
+      case ndk_helper::FRUSTUM_INTERSECTS:
+        count += frustum.CullSpheres(
+            x + cell.begin, y + cell.begin, z + cell.begin, bounding_radius_,
+            cell.end - cell.begin, cell.begin, visible + count);
+        break;
+    }
+  }
+  visible_count_ = count;
+}
+
+void TeapotInstances::UpdateRange(const ndk_helper::Mat4& view,
+                                  const ndk_helper::Mat4& projection,
+                                  int32_t begin, int32_t end) {
+  const int32_t count = end - begin;
+  ndk_helper::Mat4Array mv = Streams(model_views_, begin);
+  ndk_helper::Mat4Array mvp = Streams(model_view_projections_, begin);
+
+  // visible_ is sorted, so the range is contiguous when its ends are
+  // 'count' apart; then the models are used in place, else they are
+  // gathered into mv.
+  const int32_t first = visible_[begin];
+  const bool contiguous = visible_[end - 1] - first == count - 1;
+  ndk_helper::Mat4Array models = Streams(models_, first);
+  if (!contiguous) {
+    const ndk_helper::Mat4Array all_models = Streams(models_, 0);
+    for (int32_t i = 0; i < count; ++i) {
+      const int32_t index = visible_[begin + i];
+      for (int32_t k = 0; k < 16; ++k) mv.f[k][i] = all_models.f[k][index];
+    }
+    models = mv;
+  }
+
+  // RotationX(x) * RotationY(y), written out; mvp is used as scratch.
+  for (int32_t i = 0; i < count; ++i) {
+    const int32_t index = visible_[begin + i];
+    float x = rotation_x_[index];
+    float y = rotation_y_[index];
+    float cos_x = cosf(x), sin_x = sinf(x);
+    float cos_y = cosf(y), sin_y = sinf(y);
+    mvp.f[0][i] = cos_y;
+    mvp.f[1][i] = sin_x * sin_y;
+    mvp.f[2][i] = cos_x * sin_y;
+    mvp.f[3][i] = 0.f;
+    mvp.f[4][i] = 0.f;
+    mvp.f[5][i] = cos_x;
+    mvp.f[6][i] = -sin_x;
+    mvp.f[7][i] = 0.f;
+    mvp.f[8][i] = -sin_y;
+    mvp.f[9][i] = sin_x * cos_y;
+    mvp.f[10][i] = cos_x * cos_y;
+    mvp.f[11][i] = 0.f;
+    mvp.f[12][i] = 0.f;
+    mvp.f[13][i] = 0.f;
+    mvp.f[14][i] = 0.f;
+    mvp.f[15][i] = 1.f;
+  }
+
+  // Same association as before: (view * model) * rotation
+  view.MultiplyArray(models, mv, count);
+  ndk_helper::Mat4::MultiplyArrays(mv, mvp, mv, count);
+  projection.MultiplyArray(mv, mvp, count);
+}
+
+void TeapotInstances::Update(const ndk_helper::Mat4& view,
+                             const ndk_helper::Mat4& projection,
+                             ndk_helper::JobSystem& jobs) {
+  NDK_HELPER_PROFILE_ZONE("TeapotInstances::Update");
+
+  // Culled teapots keep spinning, so that they don't jump when they show up
+  for (int32_t i = 0; i < count_; ++i) {
+    rotation_x_[i] += speed_x_[i];
+    rotation_y_[i] += speed_y_[i];
+  }
+
+  jobs.ParallelFor(visible_count_, kInstancesPerJob,
+                   [&](int32_t begin, int32_t end) {
+    NDK_HELPER_PROFILE_ZONE("TeapotInstances::UpdateRange");
+    for (int32_t i = begin; i < end; i += kInstancesPerBlock) {
+      UpdateRange(view, projection, i,
+                  i + kInstancesPerBlock < end ? i + kInstancesPerBlock : end);
+    }
+  });
+}
+
+void TeapotInstances::Write(float* mvp, float* mv, float* color,
+                            const int32_t matrix_stride,
+                            const int32_t vector_stride,
+                            ndk_helper::JobSystem& jobs) const {
+  NDK_HELPER_PROFILE_ZONE("TeapotInstances::Write");
+  jobs.ParallelFor(visible_count_, kInstancesPerJob,
+                   [&](int32_t begin, int32_t end) {
+    NDK_HELPER_PROFILE_ZONE("TeapotInstances::WriteRange");
+    ndk_helper::Mat4::CopyArray(Streams(model_view_projections_, begin),
+                                end - begin, mvp + begin * matrix_stride,
+                                matrix_stride);
+    ndk_helper::Mat4::CopyArray(Streams(model_views_, begin), end - begin,
+                                mv + begin * matrix_stride, matrix_stride);
+    for (int32_t i = begin; i < end; ++i) {
+      memcpy(color + i * vector_stride, &colors_[3 * visible_[i]],
+             3 * sizeof(float));
+    }
+  });
+}
+
+ndk_helper::Mat4 TeapotInstances::GetModelView(const int32_t i) const {
+  return ndk_helper::Mat4::Load(Streams(model_views_, 0), i);
+}
+
+ndk_helper::Mat4 TeapotInstances::GetModelViewProjection(
+    const int32_t i) const {
+  return ndk_helper::Mat4::Load(Streams(model_view_projections_, 0), i);
+}
+
+ndk_helper::Vec3 TeapotInstances::GetColor(const int32_t i) const {
+  const float* color = &colors_[3 * visible_[i]];
+  return ndk_helper::Vec3(color[0], color[1], color[2]);
+}
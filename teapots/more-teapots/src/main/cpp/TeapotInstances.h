@@ -0,0 +1,113 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// TeapotInstances.h
+// Per-instance transforms of the teapots
+//--------------------------------------------------------------------------------
+#ifndef _TeapotInstances_H
+#define _TeapotInstances_H
+
+#include <vector>
+
+#include "vecmath.h"
+#include "jobSystem.h"
+
+/******************************************************************
+ * Model, rotation and output matrices of every teapot, stored as
+ * structure-of-arrays so that the per-frame update runs on 4 instances
+ * at a time with the batch operations of ndk_helper::Mat4, and is split
+ * across the threads of a JobSystem.
+ * Cull() keeps the instances whose bounding sphere touches the view
+ * frustum; Update() and Write() then only process those, packed at the
+ * start of the outputs, so that the renderer draws GetVisibleCount()
+ * instances. The instances are sorted into the cells of a uniform grid so
+ * that whole cells are accepted or rejected with one test.
+ * This class doesn't use GL, the renderer copies the results to its
+ * uniform buffer with Write().
+ */
+class TeapotInstances {
+  struct Cell {
+    int32_t begin;
+    int32_t end;
+    ndk_helper::Vec3 center;
+    float radius;
+  };
+
+  int32_t count_;
+  float bounding_radius_;
+
+  std::vector<float> rotation_x_;
+  std::vector<float> rotation_y_;
+  std::vector<float> speed_x_;
+  std::vector<float> speed_y_;
+  std::vector<float> colors_;  // 3 per instance
+
+  // Mat4Array storage, 16 streams of count_ floats each. The models are
+  // indexed by instance, the outputs by position in visible_.
+  std::vector<float> models_;
+  std::vector<float> model_views_;
+  std::vector<float> model_view_projections_;
+
+  std::vector<Cell> cells_;
+  std::vector<int32_t> visible_;
+  int32_t visible_count_;
+
+  ndk_helper::Mat4Array Streams(const std::vector<float>& storage,
+                                int32_t begin) const;
+  void UpdateRange(const ndk_helper::Mat4& view,
+                   const ndk_helper::Mat4& projection, int32_t begin,
+                   int32_t end);
+
+ public:
+  TeapotInstances();
+
+  void Init(const int32_t count);
+  void SetInstance(const int32_t index, const ndk_helper::Mat4& model,
+                   const ndk_helper::Vec3& color, const float rotation_x,
+                   const float rotation_y, const float speed_x,
+                   const float speed_y);
+
+  // Call once the instances are set. 'bounding_radius' is the radius of a
+  // sphere around the model origin that holds the mesh in any rotation.
+  // This reorders the instances and makes all of them visible.
+  void BuildGrid(const float bounding_radius);
+
+  // Keeps the instances at least partly inside 'frustum', needs BuildGrid()
+  void Cull(const ndk_helper::Frustum& frustum);
+
+  // Advances the rotations of all instances and computes
+  // view * model * rotation and its product with the projection for the
+  // visible ones.
+  void Update(const ndk_helper::Mat4& view, const ndk_helper::Mat4& projection,
+              ndk_helper::JobSystem& jobs);
+
+  // Copies the matrices of the last Update() to 'mvp' and 'mv', one matrix
+  // every 'matrix_stride' floats, and the colors to 'color', one every
+  // 'vector_stride' floats, e.g. into a mapped uniform buffer.
+  void Write(float* mvp, float* mv, float* color, const int32_t matrix_stride,
+             const int32_t vector_stride, ndk_helper::JobSystem& jobs) const;
+
+  // Accessors of the i-th visible instance
+  ndk_helper::Mat4 GetModelView(const int32_t i) const;
+  ndk_helper::Mat4 GetModelViewProjection(const int32_t i) const;
+  ndk_helper::Vec3 GetColor(const int32_t i) const;
+
+  int32_t GetCount() const { return count_; }
+  int32_t GetVisibleCount() const { return visible_count_; }
+};
+
+#endif
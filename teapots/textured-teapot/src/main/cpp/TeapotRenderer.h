@@ -44,11 +44,6 @@
 
 #define BUFFER_OFFSET(i) ((char*)NULL + (i))
 
-struct TEAPOT_VERTEX {
-  float pos[3];
-  float normal[3];
-};
-
 enum SHADER_ATTRIBUTES {
   ATTRIB_VERTEX,
   ATTRIB_NORMAL,
@@ -78,6 +73,7 @@ protected:
   int32_t num_vertices_;
   GLuint ibo_;
   GLuint vbo_;
+  ndk_helper::Mesh mesh_;
 
   SHADER_PARAMS shader_param_;
   bool LoadShaders(SHADER_PARAMS* params, const char* strVsh,
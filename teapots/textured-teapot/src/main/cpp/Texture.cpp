@@ -19,7 +19,13 @@
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
+#include <stdio.h>
+#include <string.h>
+#include <memory>
 #include "AssetUtil.h"
+#include "jobSystem.h"
+#include "mipmap.h"
+#include "textureFile.h"
 
 #define MODULE_NAME "Teapot::Texture"
 #include "android_debug.h"
@@ -35,7 +41,7 @@ protected:
 public:
     virtual ~TextureCubemap();
     TextureCubemap(std::vector<std::string>& texFiles,
-                   AAssetManager* assetManager);
+                   AAssetManager* assetManager, const std::string& cacheDir);
     virtual bool GetActiveSamplerInfo(std::vector<std::string>& names,
                                       std::vector<GLint>& units);
     virtual bool Activate(void);
@@ -50,7 +56,8 @@ protected:
 public:
     virtual ~Texture2d();
     // Implement just one texture
-    Texture2d(std::string &texFiles, AAssetManager* assetManager);
+    Texture2d(std::string &texFiles, AAssetManager* assetManager,
+              const std::string& cacheDir);
     virtual bool GetActiveSamplerInfo(std::vector<std::string>& names,
                                       std::vector<GLint>& units);
     virtual bool Activate(void);
@@ -63,6 +70,116 @@ public:
  */
 static const std::string supportedTextureTypes = "GL_TEXTURE_2D(0x0DE1) GL_TEXTURE_CUBE_MAP(0x8513)";
 
+/**
+ * Mipmaps are generated on the CPU from the decoded image, filtered in linear
+ * light, and kept in cacheDir so that later runs skip decoding and filtering.
+ * ES2 only mipmaps power of two sizes without GL_OES_texture_npot, the
+ * textures are left with level 0 then.
+ */
+static bool MipmapsSupported(int32_t width, int32_t height) {
+    if ((width & (width - 1)) == 0 && (height & (height - 1)) == 0) {
+        return true;
+    }
+    const char* version =
+        reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    const char* extensions =
+        reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    return (version && strncmp(version, "OpenGL ES 2.", 12) != 0) ||
+           (extensions && strstr(extensions, "GL_OES_texture_npot"));
+}
+
+// The job system is only created when a chain has to be generated, so that
+// loads from the cache don't start threads; 'jobs' keeps it for the next
+// calls.
+static bool LoadMipChain(AAssetManager* mgr, std::string& fileName,
+                         const ndk_helper::MipmapOptions& options,
+                         const std::string& cacheDir,
+                         std::unique_ptr<ndk_helper::JobSystem>* jobs,
+                         ndk_helper::MipChain* chain) {
+    std::vector<uint8_t> fileBits;
+    if (!AssetReadFile(mgr, fileName, fileBits)) {
+        LOGE("Failed to read %s", fileName.c_str());
+        return false;
+    }
+
+    std::string cachePath;
+    uint64_t key = 0;
+    if (!cacheDir.empty()) {
+        key = ndk_helper::MipChain::GetKey(fileBits.data(), fileBits.size(),
+                                           options);
+        char name[64];
+        snprintf(name, sizeof(name), "/mips-%016llx.bin",
+                 static_cast<unsigned long long>(key));
+        cachePath = cacheDir + name;
+        if (chain->Load(cachePath.c_str(), key)) {
+            return true;
+        }
+    }
+
+    // tga/bmp files are saved as vertical mirror images ( at least more than half ).
+    stbi_set_flip_vertically_on_load(1);
+
+    int32_t imgWidth, imgHeight, channelCount;
+    uint8_t* imageBits = stbi_load_from_memory(
+        fileBits.data(), fileBits.size(),
+        &imgWidth, &imgHeight, &channelCount, 4);
+    if (!imageBits) {
+        LOGE("Failed to decode %s", fileName.c_str());
+        return false;
+    }
+    if (!*jobs) {
+        jobs->reset(new ndk_helper::JobSystem);
+    }
+    bool generated = chain->Generate(imageBits, imgWidth, imgHeight, options,
+                                     jobs->get());
+    stbi_image_free(imageBits);
+    if (generated && !cachePath.empty()) {
+        chain->Store(cachePath.c_str(), key);
+    }
+    return generated;
+}
+
+/**
+ * Upload the levels of a chain to target, or only level 0
+ * @return true when all levels went in
+ */
+static bool UploadMipChain(GLenum target, const ndk_helper::MipChain& chain) {
+    const bool allLevels = MipmapsSupported(chain.GetWidth(0), chain.GetHeight(0));
+    const int32_t levels = allLevels ? chain.GetLevelCount() : 1;
+    for (int32_t level = 0; level < levels; level++) {
+        glTexImage2D(target, level, GL_RGBA,
+                     chain.GetWidth(level), chain.GetHeight(level),
+                     0, GL_RGBA, GL_UNSIGNED_BYTE, chain.GetLevel(level));
+    }
+    return allLevels;
+}
+
+/**
+ * Upload the texture texture-bake made of fileName, the .tex next to the .tga,
+ * without decoding it. Its mipmaps were filtered offline.
+ * @param mipmapped is set to whether all levels went in
+ * @return false when there is no such texture, fileName is to be loaded then
+ */
+static bool UploadBaked(GLenum target, const std::string& fileName,
+                        bool* mipmapped) {
+    const size_t dot = fileName.rfind('.');
+    if (dot == std::string::npos) {
+        return false;
+    }
+    const std::string bakedName = fileName.substr(0, dot) + ".tex";
+    ndk_helper::TextureFile file;
+    if (!file.Load(bakedName.c_str())) {
+        return false;
+    }
+    const bool allLevels = file.GetLevelCount() > 1 &&
+                           MipmapsSupported(file.GetWidth(), file.GetHeight());
+    if (!file.Upload(target, allLevels)) {
+        LOGE("Failed to upload %s", bakedName.c_str());
+        return false;
+    }
+    *mipmapped = allLevels;
+    return true;
+}
 
 /**
  * Interface implementations
@@ -74,14 +191,17 @@ Texture::~Texture() {}
  * @param texFiles holds the texture file name(s) under APK's assets
  * @param type should be one (GL_TEXTURE_2D / GL_TEXTURE_CUBE_MAP)
  * @param assetManager is used to open texture files inside assets
+ * @param cacheDir holds generated mipmaps, none are kept if empty
  * @return is the newly created Texture Object
  */
 Texture* Texture::Create( GLuint type, std::vector<std::string>& texFiles,
-                       AAssetManager* assetManager) {
+                       AAssetManager* assetManager, const std::string& cacheDir) {
     if (type == GL_TEXTURE_2D) {
-        return dynamic_cast<Texture*>(new Texture2d(texFiles[0], assetManager));
+        return dynamic_cast<Texture*>(
+            new Texture2d(texFiles[0], assetManager, cacheDir));
     } else if (type == GL_TEXTURE_CUBE_MAP) {
-        return dynamic_cast<Texture*>(new TextureCubemap(texFiles, assetManager));
+        return dynamic_cast<Texture*>(
+            new TextureCubemap(texFiles, assetManager, cacheDir));
     }
 
     LOGE("Unknow texture type %x to created", type);
@@ -139,13 +259,11 @@ GLuint TextureCubemap::GetTexId() {
 }
 
 TextureCubemap::TextureCubemap(std::vector<std::string> &files,
-                                    AAssetManager *mgr) {
+                               AAssetManager *mgr,
+                               const std::string& cacheDir) {
     // For Cubemap, we use world normal to sample the textures
     // so no texture vbo necessary
 
-    int32_t imgWidth, imgHeight, channelCount;
-    std::vector<uint8_t> fileBits;
-
     if (!mgr || files.size() != 6) {
         assert(false);
         return;
@@ -159,27 +277,31 @@ TextureCubemap::TextureCubemap(std::vector<std::string> &files,
         return;
     }
 
+    // Faces are filtered on their own, clamped at the edges. The job system
+    // is shared by the faces that have to be generated, if any.
+    ndk_helper::MipmapOptions options;
+    std::unique_ptr<ndk_helper::JobSystem> jobs;
+    ndk_helper::MipChain chain;
+    bool mipmapped = true;
     for(GLuint i = 0; i < 6; i++) {
-        fileBits.clear();
-        AssetReadFile(mgr, files[i], fileBits);
-
-        // tga/bmp files are saved as vertical mirror images ( at least more than half ).
-        stbi_set_flip_vertically_on_load(1);
-
-        uint8_t* imageBits = stbi_load_from_memory(
-            fileBits.data(), fileBits.size(),
-            &imgWidth, &imgHeight, &channelCount, 4);
-
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                     0, GL_RGBA,
-                     imgWidth, imgHeight,
-                     0, GL_RGBA,
-                     GL_UNSIGNED_BYTE, imageBits);
-        stbi_image_free(imageBits);
+        bool faceMipmapped;
+        if (UploadBaked(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, files[i],
+                        &faceMipmapped)) {
+            mipmapped = faceMipmapped && mipmapped;
+            continue;
+        }
+        if (!LoadMipChain(mgr, files[i], options, cacheDir, &jobs, &chain)) {
+            assert(false);
+            mipmapped = false;
+            continue;
+        }
+        mipmapped = UploadMipChain(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, chain) &&
+                    mipmapped;
     }
 
     glTexParameterf(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameterf(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameterf(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER,
+                    mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_REPEAT );
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_REPEAT );
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_REPEAT );
@@ -218,16 +340,15 @@ TextureCubemap::~TextureCubemap() {
 /**
  * Texture2D implementation
  */
-Texture2d::Texture2d(std::string& fileName, AAssetManager* assetManager)  {
+Texture2d::Texture2d(std::string& fileName, AAssetManager* assetManager,
+                     const std::string& cacheDir)  {
     if (!assetManager) {
         LOGE("AssetManager to Texture2D() could not be null!!!");
         assert(false);
         return;
     }
 
-    int32_t imgWidth, imgHeight, channelCount;
     std::string texName(fileName);
-    std::vector<uint8_t> fileBits;
 
     glGenTextures(1, &texId_);
     glBindTexture(GL_TEXTURE_2D, texId_);
@@ -237,28 +358,30 @@ Texture2d::Texture2d(std::string& fileName, AAssetManager* assetManager)  {
         return;
     }
 
-    AssetReadFile(assetManager, texName, fileBits);
-
-    // tga/bmp files are saved as vertical mirror images ( at least more than half ).
-    stbi_set_flip_vertically_on_load(1);
-
-    uint8_t* imageBits = stbi_load_from_memory(
-            fileBits.data(), fileBits.size(),
-            &imgWidth, &imgHeight, &channelCount, 4);
-    glTexImage2D(GL_TEXTURE_2D, 0,  // mip level
-                 GL_RGBA,
-                 imgWidth, imgHeight,
-                 0,                // border color
-                 GL_RGBA, GL_UNSIGNED_BYTE, imageBits);
+    // The baked textures are the cubemap faces, their mipmaps are clamped at
+    // the edges: close enough for the repeated 2D texture
+    bool mipmapped = false;
+    if (!UploadBaked(GL_TEXTURE_2D, texName, &mipmapped)) {
+        // Repeated, so filtered across the edges too
+        ndk_helper::MipmapOptions options;
+        options.wrap = true;
+        std::unique_ptr<ndk_helper::JobSystem> jobs;
+        ndk_helper::MipChain chain;
+        if (LoadMipChain(assetManager, texName, options, cacheDir, &jobs,
+                         &chain)) {
+            mipmapped = UploadMipChain(GL_TEXTURE_2D, chain);
+        } else {
+            assert(false);
+        }
+    }
 
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                    mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
 
     glActiveTexture(GL_TEXTURE0);
-
-    stbi_image_free(imageBits);
 }
 
 Texture2d::~Texture2d() {
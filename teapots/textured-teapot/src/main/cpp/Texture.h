@@ -47,10 +47,12 @@ class Texture {
      *     2d texture uses the very first image texFiles[0]
      *     cube map needs 6 (direction of +x, -x, +y, -y, +z, -z)
      * @param assetManager Java side assetManager object
+     * @param cacheDir directory to keep generated mipmaps in, none if empty
      * @return newly created texture object, or nullptr in case of errors
      */
     static Texture* Create( GLuint type, std::vector<std::string>& texFiles,
-              AAssetManager* assetManager);
+              AAssetManager* assetManager,
+              const std::string& cacheDir = std::string());
     static void Delete(Texture *obj);
 
     virtual bool GetActiveSamplerInfo(std::vector<std::string> &names,
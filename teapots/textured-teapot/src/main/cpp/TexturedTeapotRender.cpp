@@ -18,18 +18,14 @@
 
 /**
  * Texture Coordinators for 2D texture:
- *    they are declared in file model file teapot.inl with tiles
+ *    they are stored in the model file teapot.mesh with tiles
  *    for front and back teapot faces. If you do not want see
  *    the tiles but would like to see the stretched version, simply
  *    divide the texCoord by 2. Macro TILED_TEXTURE is for this purpose.
- *
- * teapot.inl file already included in TeapotRenderer.cpp, we directly
- * use! -- nice
  */
 #define TILED_TEXTURE 0
 
-extern float  teapotTexCoords[];
-constexpr  int32_t kCoordElementCount = (TILED_TEXTURE ? 3 : 2);
+constexpr float kTexCoordScale = (TILED_TEXTURE ? 1.f : 0.5f);
 
 
 /**
@@ -88,28 +84,23 @@ void TexturedTeapotRender::Init(AAssetManager* assetMgr) {
         assert(texVbo_ != GL_INVALID_VALUE);
 
         /*
-         * Loading Texture coord directly from data declared in model file
-         *   teapot.inl
-         * which is 3 floats/vertex.
+         * Texture coords come from the model file teapot.mesh, scaled into
+         * their own buffer.
          */
         glBindBuffer(GL_ARRAY_BUFFER, texVbo_);
 
-#if (TILED_TEXTURE)
-        glBufferData(GL_ARRAY_BUFFER,
-                 kCoordElementCount * sizeof(float) * num_vertices_,
-                 teapotTexCoords, GL_STATIC_DRAW);
-#else
         std::vector<float> coords;
+        coords.reserve(2 * num_vertices_);
         for (int32_t idx = 0; idx < num_vertices_; idx++) {
-            coords.push_back(teapotTexCoords[3 * idx] / 2);
-            coords.push_back(teapotTexCoords[3* idx + 1] / 2);
+          ndk_helper::Vec2 coord = mesh_.GetTexCoord(idx) * kTexCoordScale;
+          float uv[2];
+          coord.Value(uv[0], uv[1]);
+          coords.push_back(uv[0]);
+          coords.push_back(uv[1]);
         }
-        glBufferData(GL_ARRAY_BUFFER,
-                     kCoordElementCount * sizeof(float) * num_vertices_,
+        glBufferData(GL_ARRAY_BUFFER, 2 * sizeof(float) * num_vertices_,
                      coords.data(), GL_STATIC_DRAW);
-#endif
-        glVertexAttribPointer(ATTRIB_UV, 2, GL_FLOAT, GL_FALSE,
-                              kCoordElementCount * sizeof(float),
+        glVertexAttribPointer(ATTRIB_UV, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float),
                               BUFFER_OFFSET(0));
         glEnableVertexAttribArray(ATTRIB_UV);
 
@@ -130,7 +121,8 @@ void TexturedTeapotRender::Init(AAssetManager* assetMgr) {
         textures[0] = std::string("Textures/front.tga");
     }
 
-    texObj_ = Texture::Create(type, textures, assetMgr);
+    texObj_ = Texture::Create(type, textures, assetMgr,
+            ndk_helper::JNIHelper::GetInstance()->GetExternalFilesDir());
     assert(texObj_);
 
     std::vector<std::string> samplers;